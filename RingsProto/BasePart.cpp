@@ -1,5 +1,24 @@
 #include "BasePart.h"
+#include "Instrumentation.h"
 
+void BasePart::setLayout(const BasePartLayout& layout)
+{
+    lineLength = layout.lineLength;
+    cornerMiddleRadius = layout.cornerMiddleRadius;
+    outerWidth = layout.outerWidth;
+    innerWidth = layout.innerWidth;
+    height = layout.height;
+    wallThickness = layout.wallThickness;
+    floorThickness = layout.floorThickness;
+    circlesOnSquareRadius = layout.circlesOnSquareRadius;
+    circlesOnSquarePeriodRadius = layout.circlesOnSquarePeriodRadius;
+    leftCenterPoint = ToPoint3D(layout.leftCenterPoint);
+    rightCenterPoint = ToPoint3D(layout.rightCenterPoint);
+    zMoveShift = layout.zMoveShift;
+    topEdgeFilletRadius = layout.topEdgeFilletRadius;
+    verticalEdgeFilletRadius = layout.verticalEdgeFilletRadius;
+    otherEdgeFilletRadius = layout.otherEdgeFilletRadius;
+}
 
 
 Ptr<BRepBody> BasePart::createPairedSquares(Ptr<Component> component, double size, double cornerOuterRadius, double rotateAngel, double thickness, double height)
@@ -29,26 +48,36 @@ Ptr<Sketch> BasePart::createCirclesSketch(Ptr<Component> component, double circl
 
 void BasePart::filletBody(Ptr<Component> component, Ptr<BRepBody> body)
 {
-    auto edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsVerticalLine(edge) && abs(edge->endVertex()->geometry()->x()) <= 0.01 && abs(edge->endVertex()->geometry()->y()) < innerWidth + outerWidth; });
-    auto minY = GetMin(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()); });
-    edges = GetEdges(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()) < minY + 0.01; });
-    Fillet(component, edges, verticalEdgeFilletRadius / 2.0);
-
-    edges = GetEdges(body, EdgeIsVerticalLine);
-    Fillet(component, edges, verticalEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && edge->endVertex()->geometry()->z() > floorThickness * 1.1; });
-    Fillet(component, edges, topEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && Equal(edge->length(), GetCircleLength(circlesOnSquareRadius), 0.1); });
-    Fillet(component, edges, floorThickness / 3.0);
+    FilletPlanner planner;
+    addVerticalFilletRules(planner);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && topology.endZ[edge] > floorThickness * 1.1; }, topEdgeFilletRadius);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && Equal(topology.length[edge], GetCircleLength(circlesOnSquareRadius), 0.1); }, floorThickness / 3.0);
+    planner.add(IsHorizontalEdge, otherEdgeFilletRadius);
+    planner.fillet(component, body);
+}
 
-    edges = GetEdges(body, EdgeIsHorizontal);
-    Fillet(component, edges, otherEdgeFilletRadius);
+void BasePart::addVerticalFilletRules(FilletPlanner& planner, bool isHalf)
+{
+    // the cut over the xz plane is mirrored later, its edges are not edges of the part
+    if (isHalf)
+        planner.skip([](const BodyTopology& topology, int edge) {return abs(topology.startY[edge]) < 0.001 && abs(topology.endY[edge]) < 0.001 && abs(topology.pointY[edge]) < 0.001; });
+    // the vertical edges where the two squares meet get the half radius
+    planner.add([=](const BodyTopology& topology, int edge) {return IsVerticalLineEdge(topology, edge) && abs(topology.endX[edge]) <= 0.01 && abs(topology.endY[edge]) < innerWidth + outerWidth; },
+        verticalEdgeFilletRadius / 2.0, [](const BodyTopology& topology, const std::vector<int>& edges)
+    {
+        double minY = INT32_MAX;
+        for (auto edge : edges)
+            minY = fmin(minY, abs(topology.endY[edge]));
+        return FilletPlanner::EdgeRule([=](const BodyTopology& topology, int edge) {return abs(topology.endY[edge]) < minY + 0.01; });
+    });
+    planner.add(IsVerticalLineEdge, verticalEdgeFilletRadius);
+    // the horizontal edges go around the rounded vertical ones
+    planner.nextPass();
 }
 
 Ptr<BRepBody> BasePart::createBody(Ptr<Component> component)
 {
+    INSTRUMENT_PART("BasePart");
     auto cornerOuterRadius = cornerMiddleRadius + outerWidth;
     auto width = outerWidth + innerWidth;
 
@@ -59,13 +88,65 @@ Ptr<BRepBody> BasePart::createBody(Ptr<Component> component)
 
     auto magnetSketch = createCirclesSketch(component, circlesOnSquareRadius, 0);
 
-    for (int i = 0; i < magnetSketch->profiles()->count(); i++)
-    {
-        auto magnetBody = Extrude(component, magnetSketch->profiles()->item(i), floorThickness * 3.0, false);
-        body = Combine(component, CutFeatureOperation, body, magnetBody->bodies()->item(0));
-    }
+    auto magnetProfiles = GetProfiles(magnetSketch);
+    auto magnetExtrude = Extrude(component, magnetProfiles, floorThickness * 3.0, false);
+    body = Combine(component, CutFeatureOperation, body, magnetExtrude->bodies());
 
     filletBody(component, body);
 
     return body;
+}
+
+bool BasePart::edgeIsCircle(const BodyTopology& topology, int edge, double radius, double delta)
+{
+    if (Equal(topology.length[edge], GetCircleLength(radius), delta))
+        return true;
+    // a circle on the xz plane is halved in a symmetric build
+    return Equal(topology.length[edge], GetCircleLength(radius) / 2.0, delta / 2.0) && abs(topology.startY[edge]) < 0.001 && abs(topology.endY[edge]) < 0.001;
+}
+
+Ptr<BRepBody> BasePart::cutToSymmetryDomain(Ptr<Component> component, Ptr<BRepBody> body, bool isQuarter)
+{
+    auto box = body->boundingBox();
+    auto left = isQuarter ? 0.0 : box->minPoint()->x() - 1.0;
+    auto bottom = box->minPoint()->z() - 1.0;
+    auto domainBody = CreateBox(component, Point3D::create(left, 0), Point3D::create(box->maxPoint()->x() + 1.0, box->maxPoint()->y() + 1.0), box->maxPoint()->z() + 1.0 - bottom);
+    domainBody = Move(component, domainBody, component->zConstructionAxis(), bottom);
+    return Combine(component, IntersectFeatureOperation, body, domainBody);
+}
+
+std::vector<Ptr<Point3D>> BasePart::GetQuarterPoints(const std::vector<Ptr<Point3D>>& points)
+{
+    std::vector<Ptr<Point3D>> result;
+    for (auto& point : points)
+        if (point->x() > 0 && point->y() > 0)
+            result.push_back(point);
+    return result;
+}
+
+bool BasePart::IsInQuarter(Ptr<Profile> profile)
+{
+    auto maxPoint = profile->boundingBox()->maxPoint();
+    return maxPoint->x() > 0 && maxPoint->y() > 0;
+}
+
+bool BasePart::isSymmetricBuildChecked() const
+{
+#ifdef RINGS_INSTRUMENTATION
+    return isSymmetricBuild;
+#else
+    return isSymmetricBuild && !isSymmetricBuildTrusted;
+#endif
+}
+
+Ptr<BRepBody> BasePart::ChooseVerifiedBody(Ptr<BRepBody> symmetricBody, Ptr<BRepBody> wholeBody, bool& isMatching)
+{
+    if (IsSameShape(symmetricBody, wholeBody))
+    {
+        wholeBody->deleteMe();
+        return symmetricBody;
+    }
+    isMatching = false;
+    symmetricBody->deleteMe();
+    return wholeBody;
 }
\ No newline at end of file
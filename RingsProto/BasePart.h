@@ -1,6 +1,8 @@
 #pragma once
 #include "FusionEnvironment.h"
 #include "Sketcher.h"
+#include "FilletPlanner.h"
+#include "PartLayouts.h"
 
 class BasePart
 {
@@ -21,7 +23,15 @@ public:
     double topEdgeFilletRadius = 0;
     double verticalEdgeFilletRadius = 0;
     double otherEdgeFilletRadius = 0;
+    // Symmetric build of the rectangled parts: the booleans run on the x >= 0, y >= 0
+    // quarter, the fillets on the y >= 0 half, and mirrors over the yz and xz planes
+    // give the rest. The first symmetric build is checked against a whole build, which is
+    // kept when they differ; once they match the symmetric build is trusted. With
+    // RINGS_INSTRUMENTATION every symmetric build is checked.
+    bool isSymmetricBuild = false;
+    bool isSymmetricBuildTrusted = false;
 
+    void setLayout(const BasePartLayout& layout);
     Ptr<BRepBody> createBody(Ptr<Component> component);
     Ptr<Sketch> createCirclesSketch(Ptr<Component> component, double circleRadius, int count);
 protected:
@@ -29,4 +39,15 @@ protected:
     Ptr<BRepBody> createPairedSquares(Ptr<Component> component, double size, double cornerOuterRadius, double rotateAngel, double thickness, double height);
 
     void filletBody(Ptr<Component> component, Ptr<BRepBody> body);
+    void addVerticalFilletRules(FilletPlanner& planner, bool isHalf = false);
+    bool edgeIsCircle(const BodyTopology& topology, int edge, double radius, double delta);
+
+    // intersects the body with the x >= 0, y >= 0 quarter, or with the y >= 0 half
+    Ptr<BRepBody> cutToSymmetryDomain(Ptr<Component> component, Ptr<BRepBody> body, bool isQuarter);
+    static std::vector<Ptr<Point3D>> GetQuarterPoints(const std::vector<Ptr<Point3D>>& points);
+    static bool IsInQuarter(Ptr<Profile> profile);
+    bool isSymmetricBuildChecked() const;
+    // returns the symmetric body when it matches the whole one, deletes the other;
+    // isMatching is cleared on a mismatch
+    static Ptr<BRepBody> ChooseVerifiedBody(Ptr<BRepBody> symmetricBody, Ptr<BRepBody> wholeBody, bool& isMatching);
 };
\ No newline at end of file
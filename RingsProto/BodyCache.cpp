@@ -0,0 +1,81 @@
+#include "BodyCache.h"
+#include "Instrumentation.h"
+
+BodyCacheKey::BodyCacheKey(const std::string& partName) : partName(partName), hash(14695981039346656037ULL)
+{
+    addBytes(partName.data(), partName.size());
+}
+
+void BodyCacheKey::addBytes(const void* data, size_t size)
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+BodyCacheKey& BodyCacheKey::add(double value)
+{
+    // -0.0 and 0.0 build the same body
+    if (value == 0)
+        value = 0;
+    values.push_back(value);
+    addBytes(&value, sizeof(value));
+    return *this;
+}
+
+bool BodyCacheKey::operator==(const BodyCacheKey& other) const
+{
+    return hash == other.hash && partName == other.partName && values == other.values;
+}
+
+static Ptr<Vector3D> ToVector(Ptr<Point3D> point)
+{
+    return point != nullptr ? point->asVector() : Vector3D::create(0, 0, 0);
+}
+
+Ptr<BRepBody> BodyCache::find(Ptr<Component> component, const BodyCacheKey& key, Ptr<Point3D> origin)
+{
+    auto item = entries.find(key.getHash());
+    if (item != entries.end())
+    {
+        for (auto& entry : item->second)
+        {
+            if (!(entry.key == key))
+                continue;
+
+            INSTRUMENT_OPERATION("BodyCacheCopy");
+            hitCount++;
+            auto manager = TemporaryBRepManager::get();
+            auto body = manager->copy(entry.body);
+            auto vector = ToVector(origin);
+            vector->subtract(ToVector(entry.origin));
+            if (vector->length() > 0)
+            {
+                auto matrix = Matrix3D::create();
+                matrix->translation(vector);
+                manager->transform(body, matrix);
+            }
+            return CommitBody(component, body);
+        }
+    }
+    missCount++;
+    return nullptr;
+}
+
+void BodyCache::add(const BodyCacheKey& key, Ptr<BRepBody> body, Ptr<Point3D> origin)
+{
+    auto copy = TemporaryBRepManager::get()->copy(body);
+    if (copy == nullptr)
+        return;
+    entries[key.getHash()].push_back({ key, copy, origin != nullptr ? origin->copy() : origin });
+}
+
+void BodyCache::clear()
+{
+    entries.clear();
+    hitCount = 0;
+    missCount = 0;
+}
\ No newline at end of file
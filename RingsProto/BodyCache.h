@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "FusionEnvironment.h"
+
+// The parameters of a part build without its placement. Parts with equal keys build
+// the same body up to a translation.
+class BodyCacheKey
+{
+public:
+    explicit BodyCacheKey(const std::string& partName);
+
+    BodyCacheKey& add(double value);
+    // FNV-1a of the part name and the values, the same in every run
+    unsigned long long getHash() const { return hash; }
+    bool operator==(const BodyCacheKey& other) const;
+
+private:
+    std::string partName;
+    std::vector<double> values;
+    unsigned long long hash;
+
+    void addBytes(const void* data, size_t size);
+};
+
+// Built bodies by the keys of their parts. The cache keeps a temporary copy of every
+// added body, a hit commits a copy of it moved to the new placement instead of a rebuild.
+// A null origin is the origin of the coordinates.
+class BodyCache
+{
+public:
+    // the cached body moved from its origin to the given one, nullptr on a miss
+    Ptr<BRepBody> find(Ptr<Component> component, const BodyCacheKey& key, Ptr<Point3D> origin = nullptr);
+    void add(const BodyCacheKey& key, Ptr<BRepBody> body, Ptr<Point3D> origin = nullptr);
+    void clear();
+
+    int getHitCount() const { return hitCount; }
+    int getMissCount() const { return missCount; }
+
+private:
+    struct Entry
+    {
+        BodyCacheKey key;
+        Ptr<BRepBody> body;
+        Ptr<Point3D> origin;
+    };
+
+    std::unordered_map<unsigned long long, std::vector<Entry>> entries;
+    int hitCount = 0;
+    int missCount = 0;
+};
\ No newline at end of file
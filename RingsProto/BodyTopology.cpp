@@ -0,0 +1,160 @@
+#include "BodyTopology.h"
+#include "Instrumentation.h"
+#include <cmath>
+
+BodyTopology::BodyTopology(Ptr<BRepBody> body, int columns) : body(body), columns(columns)
+{
+    read();
+}
+
+bool BodyTopology::isValid() const
+{
+    return revision == GetDesignRevision();
+}
+
+void BodyTopology::update()
+{
+    if (!isValid())
+        read();
+}
+
+void BodyTopology::read()
+{
+    INSTRUMENT_OPERATION("BodyTopology");
+    revision = GetDesignRevision();
+    if (columns & EdgeColumns)
+        readEdges();
+    if (columns & FaceColumns)
+        readFaces();
+}
+
+void BodyTopology::readEdges()
+{
+    auto bodyEdges = body->edges();
+    auto count = bodyEdges->count();
+    edges.resize(count);
+    startX.resize(count);
+    startY.resize(count);
+    startZ.resize(count);
+    endX.resize(count);
+    endY.resize(count);
+    endZ.resize(count);
+    pointX.resize(count);
+    pointY.resize(count);
+    pointZ.resize(count);
+    length.resize(count);
+    isDegenerate.resize(count);
+    tangentChainSize.assign(columns & TangentChainColumn ? count : 0, 0);
+
+    for (int i = 0; i < count; i++)
+    {
+        auto edge = bodyEdges->item(i);
+        auto start = edge->startVertex()->geometry();
+        auto end = edge->endVertex()->geometry();
+        edges[i] = edge;
+        startX[i] = start->x();
+        startY[i] = start->y();
+        startZ[i] = start->z();
+        endX[i] = end->x();
+        endY[i] = end->y();
+        endZ[i] = end->z();
+        auto point = edge->pointOnEdge();
+        pointX[i] = point->x();
+        pointY[i] = point->y();
+        pointZ[i] = point->z();
+        length[i] = edge->length();
+        isDegenerate[i] = edge->isDegenerate();
+        if (columns & TangentChainColumn)
+            tangentChainSize[i] = edge->tangentiallyConnectedEdges()->count();
+    }
+
+    // no API calls from here, the loops run over the plain columns
+    isHorizontal.resize(count);
+    isVerticalLine.resize(count);
+    for (int i = 0; i < count; i++)
+    {
+        auto height = std::abs(startZ[i] - endZ[i]);
+        isHorizontal[i] = height < 0.01 && !isDegenerate[i];
+        isVerticalLine[i] = std::abs(height - length[i]) < 0.01 && !isDegenerate[i];
+    }
+}
+
+void BodyTopology::readFaces()
+{
+    auto bodyFaces = body->faces();
+    auto count = bodyFaces->count();
+    faces.resize(count);
+    for (auto column : { &normalX, &normalY, &normalZ, &centroidX, &centroidY, &centroidZ, &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+        column->resize(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        auto face = bodyFaces->item(i);
+        faces[i] = face;
+        Ptr<Vector3D> normal;
+        face->evaluator()->getNormalAtPoint(face->pointOnFace(), normal);
+        normalX[i] = normal->x();
+        normalY[i] = normal->y();
+        normalZ[i] = normal->z();
+        auto centroid = face->centroid();
+        centroidX[i] = centroid->x();
+        centroidY[i] = centroid->y();
+        centroidZ[i] = centroid->z();
+        auto box = face->boundingBox();
+        minX[i] = box->minPoint()->x();
+        minY[i] = box->minPoint()->y();
+        minZ[i] = box->minPoint()->z();
+        maxX[i] = box->maxPoint()->x();
+        maxY[i] = box->maxPoint()->y();
+        maxZ[i] = box->maxPoint()->z();
+    }
+}
+
+BodyTopology::Mask BodyTopology::selectEdges(const EdgeRule& isGoodEdge) const
+{
+    Mask mask(edges.size());
+    for (int i = 0; i < edgeCount(); i++)
+        mask[i] = isGoodEdge(*this, i);
+    return mask;
+}
+
+Ptr<ObjectCollection> BodyTopology::getEdges(const Mask& mask) const
+{
+    auto collection = ObjectCollection::create();
+    for (size_t i = 0; i < edges.size(); i++)
+        if (mask[i])
+            collection->add(edges[i]);
+    return collection;
+}
+
+Ptr<ObjectCollection> BodyTopology::getEdges(const EdgeRule& isGoodEdge) const
+{
+    return getEdges(selectEdges(isGoodEdge));
+}
+
+int BodyTopology::findFace(double x, double y, double z) const
+{
+    for (int i = 0; i < faceCount(); i++)
+        if (normalX[i] * x + normalY[i] * y + normalZ[i] * z > 0)
+            return i;
+    return -1;
+}
+
+Ptr<BRepFace> BodyTopology::getFace(CubeFaceType faceType) const
+{
+    auto face = findFace(
+        faceType == Right ? 1 : (faceType == Left ? -1 : 0),
+        faceType == Fron ? 1 : (faceType == Back ? -1 : 0),
+        faceType == Top ? 1 : (faceType == Bottom ? -1 : 0));
+    return face >= 0 ? faces[face] : nullptr;
+}
+
+bool IsHorizontalEdge(const BodyTopology& topology, int edge)
+{
+    return topology.isHorizontal[edge] != 0;
+}
+
+bool IsVerticalLineEdge(const BodyTopology& topology, int edge)
+{
+    return topology.isVerticalLine[edge] != 0;
+}
\ No newline at end of file
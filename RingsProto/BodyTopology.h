@@ -0,0 +1,65 @@
+#pragma once
+#include "FusionEnvironment.h"
+
+// A snapshot of the edges and faces of a body, read through the API in one pass. The
+// data is kept as columns of plain arrays, so edge and face rules run over them without
+// API calls. The snapshot is stale after any change of the design, see update.
+class BodyTopology
+{
+public:
+    enum Columns { EdgeColumns = 1, FaceColumns = 2, TangentChainColumn = 4, AllColumns = 7 };
+    typedef std::vector<char> Mask;
+    typedef std::function<bool(const BodyTopology& topology, int edge)> EdgeRule;
+
+    // edges, by index
+    std::vector<double> startX, startY, startZ;
+    std::vector<double> endX, endY, endZ;
+    // a point inside the edge, not on its vertices
+    std::vector<double> pointX, pointY, pointZ;
+    std::vector<double> length;
+    std::vector<char> isDegenerate;
+    // the same tests as EdgeIsHorizontal and EdgeIsVerticalLine
+    Mask isHorizontal;
+    Mask isVerticalLine;
+    // count of the tangentially connected edges, only with TangentChainColumn
+    std::vector<int> tangentChainSize;
+
+    // faces, by index; the normal is taken at the point on the face
+    std::vector<double> normalX, normalY, normalZ;
+    std::vector<double> centroidX, centroidY, centroidZ;
+    std::vector<double> minX, minY, minZ;
+    std::vector<double> maxX, maxY, maxZ;
+
+    BodyTopology(Ptr<BRepBody> body, int columns = EdgeColumns);
+
+    bool isValid() const;
+    // reads the body again when the design was changed since the last read
+    void update();
+
+    Ptr<BRepBody> getBody() const { return body; }
+    int edgeCount() const { return (int)edges.size(); }
+    int faceCount() const { return (int)faces.size(); }
+    Ptr<BRepEdge> getEdge(int edge) const { return edges[edge]; }
+    Ptr<BRepFace> getFace(int face) const { return faces[face]; }
+
+    Mask selectEdges(const EdgeRule& isGoodEdge) const;
+    Ptr<ObjectCollection> getEdges(const Mask& mask) const;
+    Ptr<ObjectCollection> getEdges(const EdgeRule& isGoodEdge) const;
+    // the first face with the normal less than 90 degrees from the given direction, -1 if none
+    int findFace(double x, double y, double z) const;
+    Ptr<BRepFace> getFace(CubeFaceType faceType) const;
+
+private:
+    Ptr<BRepBody> body;
+    int columns;
+    int revision;
+    std::vector<Ptr<BRepEdge>> edges;
+    std::vector<Ptr<BRepFace>> faces;
+
+    void read();
+    void readEdges();
+    void readFaces();
+};
+
+bool IsHorizontalEdge(const BodyTopology& topology, int edge);
+bool IsVerticalLineEdge(const BodyTopology& topology, int edge);
\ No newline at end of file
@@ -43,11 +43,8 @@ void createBody(Ptr<Design> design)
     auto ribs6CutBody = CreateBox(component, Point3D::create(towerRibs6Shift, towerRadius), Point3D::create(towerRibs6Shift + towerRadius, -towerRadius), towerHeight);
     Move(component, ribs6CutBody, zAxis, towerRibs6Bottom);
     
-    for (int i = 1; i <= ribsCount; i++)
-    {
-        auto cutBody = Rotate(component, ribs6CutBody, zAxis, i * RAD_360 / ribsCount, i < ribsCount);
-        body = Combine(component, CutFeatureOperation, body, cutBody);
-    }
+    auto ribsCutBodies = CircularPattern(component, ribs6CutBody, zAxis, (int)ribsCount, RAD_360 / ribsCount, NewBodyFeatureOperation);
+    body = Combine(component, CutFeatureOperation, body, ribsCutBodies);
 
     auto centerCutBody = CreateCylinder(component, Point3D::create(), towerRadius - towerWallThickness, towerHeight - towerWallThickness);
     centerCutBody = Move(component, centerCutBody, zAxis, -towerShift);
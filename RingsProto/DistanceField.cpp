@@ -0,0 +1,858 @@
+#include "DistanceField.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace
+{
+    double Length(double x, double y)
+    {
+        return sqrt(x * x + y * y);
+    }
+
+    // Round blends of hg_sdf: a quarter circle of radius r replaces the sharp edge.
+    double UnionRound(double a, double b, double r)
+    {
+        if (r <= 0)
+            return fmin(a, b);
+        return fmax(r, fmin(a, b)) - Length(fmax(r - a, 0.0), fmax(r - b, 0.0));
+    }
+
+    double IntersectionRound(double a, double b, double r)
+    {
+        if (r <= 0)
+            return fmax(a, b);
+        return fmin(-r, fmax(a, b)) + Length(fmax(r + a, 0.0), fmax(r + b, 0.0));
+    }
+
+    MeshBox CreateMeshBox(double minX, double minY, double minZ, double maxX, double maxY, double maxZ)
+    {
+        MeshBox box;
+        box.minPoint = { minX, minY, minZ };
+        box.maxPoint = { maxX, maxY, maxZ };
+        return box;
+    }
+
+    MeshBox Expand(const MeshBox& box, double distance)
+    {
+        return CreateMeshBox(box.minPoint.x - distance, box.minPoint.y - distance, box.minPoint.z - distance,
+            box.maxPoint.x + distance, box.maxPoint.y + distance, box.maxPoint.z + distance);
+    }
+
+    MeshBox Merge(const MeshBox& a, const MeshBox& b)
+    {
+        return CreateMeshBox(fmin(a.minPoint.x, b.minPoint.x), fmin(a.minPoint.y, b.minPoint.y), fmin(a.minPoint.z, b.minPoint.z),
+            fmax(a.maxPoint.x, b.maxPoint.x), fmax(a.maxPoint.y, b.maxPoint.y), fmax(a.maxPoint.z, b.maxPoint.z));
+    }
+
+    MeshBox Overlap(const MeshBox& a, const MeshBox& b)
+    {
+        return CreateMeshBox(fmax(a.minPoint.x, b.minPoint.x), fmax(a.minPoint.y, b.minPoint.y), fmax(a.minPoint.z, b.minPoint.z),
+            fmin(a.maxPoint.x, b.maxPoint.x), fmin(a.maxPoint.y, b.maxPoint.y), fmin(a.maxPoint.z, b.maxPoint.z));
+    }
+
+    class SphereField : public DistanceField
+    {
+    public:
+        PlainPoint3D center;
+        double radius;
+
+        SphereField(const PlainPoint3D& center, double radius) : center(center), radius(radius)
+        {
+            bounds = CreateMeshBox(center.x - radius, center.y - radius, center.z - radius, center.x + radius, center.y + radius, center.z + radius);
+        }
+
+        double distance(const PlainPoint3D& point) const override
+        {
+            auto x = point.x - center.x;
+            auto y = point.y - center.y;
+            auto z = point.z - center.z;
+            return sqrt(x * x + y * y + z * z) - radius;
+        }
+    };
+
+    // Rounded rectangle; a circle is a square rounded by half of its size.
+    class RectangleProfile : public DistanceProfile
+    {
+    public:
+        double centerX;
+        double centerY;
+        double halfSizeX;
+        double halfSizeY;
+        double cornerRadius;
+        double cosA;
+        double sinA;
+
+        RectangleProfile(double centerX, double centerY, double halfSizeX, double halfSizeY, double cornerRadius, double rotateAngel)
+            : centerX(centerX), centerY(centerY), halfSizeX(halfSizeX), halfSizeY(halfSizeY),
+            cornerRadius(fmax(0.0, fmin(cornerRadius, fmin(halfSizeX, halfSizeY)))), cosA(cos(rotateAngel)), sinA(sin(rotateAngel))
+        {
+            auto extentX = fabs(cosA) * (halfSizeX - this->cornerRadius) + fabs(sinA) * (halfSizeY - this->cornerRadius) + this->cornerRadius;
+            auto extentY = fabs(sinA) * (halfSizeX - this->cornerRadius) + fabs(cosA) * (halfSizeY - this->cornerRadius) + this->cornerRadius;
+            bounds = CreateMeshBox(centerX - extentX, centerY - extentY, 0, centerX + extentX, centerY + extentY, 0);
+        }
+
+        double distance(double x, double y) const override
+        {
+            auto dx = x - centerX;
+            auto dy = y - centerY;
+            auto qx = fabs(dx * cosA + dy * sinA) - halfSizeX + cornerRadius;
+            auto qy = fabs(-dx * sinA + dy * cosA) - halfSizeY + cornerRadius;
+            return Length(fmax(qx, 0.0), fmax(qy, 0.0)) + fmin(fmax(qx, qy), 0.0) - cornerRadius;
+        }
+    };
+
+    // The second operand is usually the small tool body, so it is skipped by its bounds
+    // wherever it can not change the result. Skipping keeps the sign and never makes
+    // the distance larger than it is, which is all the octree relies on.
+    template <typename GetDistance2>
+    double CombineDistances(MeshOperation operation, double distance1, double boundsDistance2, double filletRadius, const GetDistance2& getDistance2)
+    {
+        auto isFar = boundsDistance2 > 0 && boundsDistance2 >= filletRadius;
+        if (operation == JoinMeshOperation)
+        {
+            if (isFar && boundsDistance2 > distance1)
+                return distance1;
+            return UnionRound(distance1, getDistance2(), filletRadius);
+        }
+        if (operation == CutMeshOperation)
+        {
+            if (isFar)
+                return distance1 > -filletRadius ? distance1 : fmax(distance1, -boundsDistance2);
+            return IntersectionRound(distance1, -getDistance2(), filletRadius);
+        }
+        if (isFar)
+            return fmax(distance1, boundsDistance2);
+        return IntersectionRound(distance1, getDistance2(), filletRadius);
+    }
+
+    // A blend mixes the gradients of its operands, which may stretch the distance by sqrt(2).
+    double CombineLipschitz(double lipschitz1, double lipschitz2, double filletRadius)
+    {
+        return fmax(lipschitz1, lipschitz2) * (filletRadius > 0 ? sqrt(2.0) : 1.0);
+    }
+
+    MeshBox CombineBounds(MeshOperation operation, const MeshBox& bounds1, const MeshBox& bounds2, double filletRadius)
+    {
+        if (operation == JoinMeshOperation)
+            return Expand(Merge(bounds1, bounds2), filletRadius);
+        if (operation == CutMeshOperation)
+            return bounds1;
+        return Overlap(bounds1, bounds2);
+    }
+
+    class CombinedProfile : public DistanceProfile
+    {
+    public:
+        MeshOperation operation;
+        DistanceProfilePtr profile1;
+        DistanceProfilePtr profile2;
+        double filletRadius;
+
+        CombinedProfile(MeshOperation operation, const DistanceProfilePtr& profile1, const DistanceProfilePtr& profile2, double filletRadius)
+            : operation(operation), profile1(profile1), profile2(profile2), filletRadius(fmax(filletRadius, 0.0))
+        {
+            bounds = CombineBounds(operation, profile1->bounds, profile2->bounds, this->filletRadius);
+            lipschitz = CombineLipschitz(profile1->lipschitz, profile2->lipschitz, this->filletRadius);
+        }
+
+        double distance(double x, double y) const override
+        {
+            return CombineDistances(operation, profile1->distance(x, y), profile2->boundsDistance(x, y), filletRadius, [&]() { return profile2->distance(x, y); });
+        }
+    };
+
+    class ExtrudedField : public DistanceField
+    {
+    public:
+        DistanceProfilePtr profile;
+        double top;
+        double bottomEdgeFilletRadius;
+        double topEdgeFilletRadius;
+
+        ExtrudedField(const DistanceProfilePtr& profile, double top, double bottomEdgeFilletRadius, double topEdgeFilletRadius)
+            : profile(profile), top(top), bottomEdgeFilletRadius(bottomEdgeFilletRadius), topEdgeFilletRadius(topEdgeFilletRadius)
+        {
+            bounds = profile->bounds;
+            bounds.maxPoint.z = top;
+            // the profile gradient is horizontal, so a single cap blend does not stretch it;
+            // the two caps only do where their blends meet
+            lipschitz = fmax(profile->lipschitz, 1.0);
+            if (bottomEdgeFilletRadius > 0 && topEdgeFilletRadius > 0 && top < bottomEdgeFilletRadius + topEdgeFilletRadius)
+                lipschitz *= sqrt(2.0);
+        }
+
+        double distance(const PlainPoint3D& point) const override
+        {
+            auto result = IntersectionRound(profile->distance(point.x, point.y), -point.z, bottomEdgeFilletRadius);
+            return IntersectionRound(result, point.z - top, topEdgeFilletRadius);
+        }
+    };
+
+    class MovedField : public DistanceField
+    {
+    public:
+        DistanceFieldPtr field;
+        PlainPoint3D shift;
+
+        MovedField(const DistanceFieldPtr& field, const PlainPoint3D& shift) : field(field), shift(shift)
+        {
+            bounds = CreateMeshBox(field->bounds.minPoint.x + shift.x, field->bounds.minPoint.y + shift.y, field->bounds.minPoint.z + shift.z,
+                field->bounds.maxPoint.x + shift.x, field->bounds.maxPoint.y + shift.y, field->bounds.maxPoint.z + shift.z);
+            lipschitz = field->lipschitz;
+        }
+
+        double distance(const PlainPoint3D& point) const override
+        {
+            return field->distance({ point.x - shift.x, point.y - shift.y, point.z - shift.z });
+        }
+    };
+
+    class CombinedField : public DistanceField
+    {
+    public:
+        MeshOperation operation;
+        DistanceFieldPtr field1;
+        DistanceFieldPtr field2;
+        double filletRadius;
+
+        CombinedField(MeshOperation operation, const DistanceFieldPtr& field1, const DistanceFieldPtr& field2, double filletRadius)
+            : operation(operation), field1(field1), field2(field2), filletRadius(fmax(filletRadius, 0.0))
+        {
+            bounds = CombineBounds(operation, field1->bounds, field2->bounds, this->filletRadius);
+            lipschitz = CombineLipschitz(field1->lipschitz, field2->lipschitz, this->filletRadius);
+        }
+
+        double distance(const PlainPoint3D& point) const override
+        {
+            return CombineDistances(operation, field1->distance(point), field2->boundsDistance(point), filletRadius, [&]() { return field2->distance(point); });
+        }
+    };
+
+    void ParallelFor(size_t count, int threadCount, const std::function<void(size_t, size_t)>& body)
+    {
+        const size_t chunkSize = 256;
+        std::atomic<size_t> next(0);
+        auto worker = [&]()
+        {
+            for (;;)
+            {
+                auto begin = next.fetch_add(chunkSize);
+                if (begin >= count)
+                    return;
+                body(begin, std::min(count, begin + chunkSize));
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i < threadCount; i++)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    const int KEY_BITS = 21;
+    const uint64_t KEY_MASK = (1ull << KEY_BITS) - 1;
+
+    uint64_t MakeKey(uint64_t i, uint64_t j, uint64_t k)
+    {
+        return (i << (2 * KEY_BITS)) | (j << KEY_BITS) | k;
+    }
+
+    int64_t FindKey(const std::vector<uint64_t>& keys, uint64_t key)
+    {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        return it != keys.end() && *it == key ? it - keys.begin() : -1;
+    }
+
+    struct OctreeCell
+    {
+        uint32_t i;
+        uint32_t j;
+        uint32_t k;
+        uint32_t size;
+    };
+
+    struct Grid
+    {
+        PlainPoint3D origin;
+        double cellSize;
+        uint32_t countX;
+        uint32_t countY;
+        uint32_t countZ;
+
+        PlainPoint3D point(double i, double j, double k) const
+        {
+            return { origin.x + i * cellSize, origin.y + j * cellSize, origin.z + k * cellSize };
+        }
+    };
+
+    // Collects the leaf cells the surface may pass through. A cell whose center value
+    // exceeds what the field can change over its half diagonal is dropped with its subtree.
+    void CollectLeaves(const DistanceField& field, const Grid& grid, const OctreeCell& cell, std::vector<OctreeCell>* leaves, std::vector<OctreeCell>* pending, uint32_t pendingSize)
+    {
+        if (cell.i >= grid.countX || cell.j >= grid.countY || cell.k >= grid.countZ)
+            return;
+        auto half = cell.size / 2.0;
+        auto center = grid.point(cell.i + half, cell.j + half, cell.k + half);
+        if (fabs(field.distance(center)) > half * grid.cellSize * sqrt(3.0) * field.lipschitz * 1.001)
+            return;
+        if (cell.size == 1)
+        {
+            leaves->push_back(cell);
+            return;
+        }
+        if (cell.size == pendingSize && pending != nullptr)
+        {
+            pending->push_back(cell);
+            return;
+        }
+        auto size = cell.size / 2;
+        for (uint32_t n = 0; n < 8; n++)
+        {
+            OctreeCell child = { cell.i + (n & 1) * size, cell.j + ((n >> 1) & 1) * size, cell.k + ((n >> 2) & 1) * size, size };
+            CollectLeaves(field, grid, child, leaves, pending, pendingSize);
+        }
+    }
+
+    // Least squares point of the edge crossing planes. Directions the normals leave
+    // undetermined keep the mass point, so flat areas stay smooth and edges sharp.
+    struct Qef
+    {
+        double ata[3][3] = { { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } };
+        double atb[3] = { 0, 0, 0 };
+        double mass[3] = { 0, 0, 0 };
+        int count = 0;
+
+        void add(const PlainPoint3D& point, const PlainPoint3D& normal)
+        {
+            double n[3] = { normal.x, normal.y, normal.z };
+            auto d = normal.x * point.x + normal.y * point.y + normal.z * point.z;
+            for (int r = 0; r < 3; r++)
+            {
+                for (int c = 0; c < 3; c++)
+                    ata[r][c] += n[r] * n[c];
+                atb[r] += n[r] * d;
+            }
+            mass[0] += point.x;
+            mass[1] += point.y;
+            mass[2] += point.z;
+            count++;
+        }
+
+        PlainPoint3D solve() const
+        {
+            double m[3] = { mass[0] / count, mass[1] / count, mass[2] / count };
+            double rhs[3];
+            for (int r = 0; r < 3; r++)
+                rhs[r] = atb[r] - (ata[r][0] * m[0] + ata[r][1] * m[1] + ata[r][2] * m[2]);
+
+            // Jacobi eigen decomposition of the symmetric matrix
+            double a[3][3];
+            double v[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+            std::copy(&ata[0][0], &ata[0][0] + 9, &a[0][0]);
+            for (int sweep = 0; sweep < 8; sweep++)
+            {
+                for (int p = 0; p < 2; p++)
+                {
+                    for (int q = p + 1; q < 3; q++)
+                    {
+                        if (fabs(a[p][q]) < 1e-12)
+                            continue;
+                        auto theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                        auto t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                        auto c = 1.0 / sqrt(t * t + 1.0);
+                        auto s = t * c;
+                        for (int k = 0; k < 3; k++)
+                        {
+                            auto akp = a[k][p];
+                            auto akq = a[k][q];
+                            a[k][p] = c * akp - s * akq;
+                            a[k][q] = s * akp + c * akq;
+                        }
+                        for (int k = 0; k < 3; k++)
+                        {
+                            auto apk = a[p][k];
+                            auto aqk = a[q][k];
+                            a[p][k] = c * apk - s * aqk;
+                            a[q][k] = s * apk + c * aqk;
+                        }
+                        for (int k = 0; k < 3; k++)
+                        {
+                            auto vkp = v[k][p];
+                            auto vkq = v[k][q];
+                            v[k][p] = c * vkp - s * vkq;
+                            v[k][q] = s * vkp + c * vkq;
+                        }
+                    }
+                }
+            }
+
+            auto maxEigenvalue = fmax(fabs(a[0][0]), fmax(fabs(a[1][1]), fabs(a[2][2])));
+            double x[3] = { m[0], m[1], m[2] };
+            for (int e = 0; e < 3; e++)
+            {
+                if (fabs(a[e][e]) < 0.05 * maxEigenvalue)
+                    continue;
+                auto projection = (v[0][e] * rhs[0] + v[1][e] * rhs[1] + v[2][e] * rhs[2]) / a[e][e];
+                for (int r = 0; r < 3; r++)
+                    x[r] += projection * v[r][e];
+            }
+            return { x[0], x[1], x[2] };
+        }
+    };
+
+    // Corner order: bit 0 is +X, bit 1 is +Y, bit 2 is +Z.
+    const int CELL_EDGES[12][2] = {
+        { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+        { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+        { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+
+    // The corners of a cell face in order around it, and the edges from each corner to the next.
+    const int FACE_CORNERS[6][4] = {
+        { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 }, { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 } };
+    const int FACE_EDGES[6][4] = {
+        { 4, 10, 6, 8 }, { 5, 11, 7, 9 }, { 0, 9, 2, 8 }, { 1, 11, 3, 10 }, { 0, 5, 1, 4 }, { 2, 7, 3, 6 } };
+
+    PlainPoint3D FindCrossing(const DistanceField& field, PlainPoint3D point1, double value1, PlainPoint3D point2, double value2)
+    {
+        PlainPoint3D point = point1;
+        for (int iteration = 0; iteration < 4; iteration++)
+        {
+            auto t = value1 / (value1 - value2);
+            point = { point1.x + (point2.x - point1.x) * t, point1.y + (point2.y - point1.y) * t, point1.z + (point2.z - point1.z) * t };
+            auto value = field.distance(point);
+            if (fabs(value) < 1e-9)
+                break;
+            if ((value < 0) == (value1 < 0))
+            {
+                point1 = point;
+                value1 = value;
+            }
+            else
+            {
+                point2 = point;
+                value2 = value;
+            }
+        }
+        return point;
+    }
+
+    double SquaredDistance(const PlainPoint3D& a, const PlainPoint3D& b)
+    {
+        return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z);
+    }
+}
+
+double DistanceField::boundsDistance(const PlainPoint3D& point) const
+{
+    auto x = fmax(fmax(bounds.minPoint.x - point.x, point.x - bounds.maxPoint.x), 0.0);
+    auto y = fmax(fmax(bounds.minPoint.y - point.y, point.y - bounds.maxPoint.y), 0.0);
+    auto z = fmax(fmax(bounds.minPoint.z - point.z, point.z - bounds.maxPoint.z), 0.0);
+    return sqrt(x * x + y * y + z * z);
+}
+
+PlainPoint3D DistanceField::normal(const PlainPoint3D& point, double step) const
+{
+    // tetrahedral differences: four evaluations instead of six
+    auto a = distance({ point.x + step, point.y - step, point.z - step });
+    auto b = distance({ point.x - step, point.y - step, point.z + step });
+    auto c = distance({ point.x - step, point.y + step, point.z - step });
+    auto d = distance({ point.x + step, point.y + step, point.z + step });
+    PlainPoint3D result = { a - b - c + d, -a - b + c + d, -a + b - c + d };
+    auto length = sqrt(result.x * result.x + result.y * result.y + result.z * result.z);
+    if (length > 0)
+        result = { result.x / length, result.y / length, result.z / length };
+    return result;
+}
+
+double DistanceProfile::boundsDistance(double x, double y) const
+{
+    auto dx = fmax(fmax(bounds.minPoint.x - x, x - bounds.maxPoint.x), 0.0);
+    auto dy = fmax(fmax(bounds.minPoint.y - y, y - bounds.maxPoint.y), 0.0);
+    return Length(dx, dy);
+}
+
+DistanceProfilePtr CreateCircleProfile(const PlainPoint3D& center, double radius)
+{
+    return std::make_shared<RectangleProfile>(center.x, center.y, radius, radius, radius, 0.0);
+}
+
+DistanceProfilePtr CreateRectangleProfile(const PlainPoint3D& point1, const PlainPoint3D& point2, double cornerRadius)
+{
+    auto halfSizeX = fabs(point2.x - point1.x) / 2.0;
+    auto halfSizeY = fabs(point2.y - point1.y) / 2.0;
+    return std::make_shared<RectangleProfile>((point1.x + point2.x) / 2.0, (point1.y + point2.y) / 2.0, halfSizeX, halfSizeY, cornerRadius, 0.0);
+}
+
+DistanceProfilePtr CreateSquareProfile(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel)
+{
+    auto halfSize = size / 2.0 + cornerOuterRadius;
+    return std::make_shared<RectangleProfile>(center.x, center.y, halfSize, halfSize, cornerOuterRadius, rotateAngel);
+}
+
+DistanceProfilePtr Combine(MeshOperation operation, const DistanceProfilePtr& profile1, const DistanceProfilePtr& profile2, double filletRadius)
+{
+    return std::make_shared<CombinedProfile>(operation, profile1, profile2, filletRadius);
+}
+
+DistanceFieldPtr Extrude(const DistanceProfilePtr& profile, double distance, double bottomEdgeFilletRadius, double topEdgeFilletRadius)
+{
+    return std::make_shared<ExtrudedField>(profile, distance, bottomEdgeFilletRadius, topEdgeFilletRadius);
+}
+
+DistanceFieldPtr CreateSphereField(const PlainPoint3D& center, double radius)
+{
+    return std::make_shared<SphereField>(center, radius);
+}
+
+DistanceFieldPtr CreateCylinderField(const PlainPoint3D& center, double radius, double height, double bottomEdgeFilletRadius, double topEdgeFilletRadius)
+{
+    auto field = Extrude(CreateCircleProfile(center, radius), height, bottomEdgeFilletRadius, topEdgeFilletRadius);
+    return center.z != 0 ? Move(field, ZMeshAxis(), center.z) : field;
+}
+
+DistanceFieldPtr CreateBoxField(const PlainPoint3D& point1, const PlainPoint3D& point2, double height, double verticalCornerFilletRadius, double bottomEdgeFilletRadius, double topEdgeFilletRadius)
+{
+    return Extrude(CreateRectangleProfile(point1, point2, verticalCornerFilletRadius), height, bottomEdgeFilletRadius, topEdgeFilletRadius);
+}
+
+DistanceFieldPtr Move(const DistanceFieldPtr& field, const MeshAxis& axis, double distance)
+{
+    auto& direction = axis.direction;
+    auto length = sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    return std::make_shared<MovedField>(field, PlainPoint3D{ direction.x / length * distance, direction.y / length * distance, direction.z / length * distance });
+}
+
+DistanceFieldPtr Combine(MeshOperation operation, const DistanceFieldPtr& field1, const DistanceFieldPtr& field2, double filletRadius)
+{
+    return std::make_shared<CombinedField>(operation, field1, field2, filletRadius);
+}
+
+DistanceFieldPtr Combine(const std::vector<DistanceFieldPtr>& fields)
+{
+    if (fields.empty())
+        return nullptr;
+    auto level = fields;
+    while (level.size() > 1)
+    {
+        std::vector<DistanceFieldPtr> next;
+        for (size_t i = 0; i + 1 < level.size(); i += 2)
+            next.push_back(Combine(JoinMeshOperation, level[i], level[i + 1]));
+        if (level.size() % 2 == 1)
+            next.push_back(level.back());
+        level = next;
+    }
+    return level[0];
+}
+
+MeshBody ToMesh(const DistanceFieldPtr& field, double cellSize, int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+
+    auto bounds = Expand(field->bounds, 2.0 * cellSize);
+    Grid grid;
+    grid.origin = bounds.minPoint;
+    grid.cellSize = cellSize;
+    grid.countX = (uint32_t)ceil((bounds.maxPoint.x - bounds.minPoint.x) / cellSize);
+    grid.countY = (uint32_t)ceil((bounds.maxPoint.y - bounds.minPoint.y) / cellSize);
+    grid.countZ = (uint32_t)ceil((bounds.maxPoint.z - bounds.minPoint.z) / cellSize);
+    uint32_t rootSize = 1;
+    while (rootSize < grid.countX || rootSize < grid.countY || rootSize < grid.countZ)
+        rootSize *= 2;
+    MeshBody body;
+    if (rootSize > KEY_MASK)
+        return body;
+
+    // the top levels are split here, the subtrees below go to the threads
+    std::vector<OctreeCell> leaves;
+    std::vector<OctreeCell> subtrees;
+    auto subtreeSize = rootSize;
+    while (subtreeSize > 1 && (uint64_t)(rootSize / subtreeSize) * (rootSize / subtreeSize) * (rootSize / subtreeSize) < 64ull * threadCount)
+        subtreeSize /= 2;
+    CollectLeaves(*field, grid, { 0, 0, 0, rootSize }, &leaves, &subtrees, subtreeSize);
+
+    std::vector<std::vector<OctreeCell>> subtreeLeaves(subtrees.size());
+    ParallelFor(subtrees.size(), threadCount, [&](size_t begin, size_t end)
+    {
+        for (auto i = begin; i < end; i++)
+            CollectLeaves(*field, grid, subtrees[i], &subtreeLeaves[i], nullptr, 0);
+    });
+    for (auto& part : subtreeLeaves)
+        leaves.insert(leaves.end(), part.begin(), part.end());
+
+    std::vector<uint64_t> leafKeys(leaves.size());
+    for (size_t i = 0; i < leaves.size(); i++)
+        leafKeys[i] = MakeKey(leaves[i].i, leaves[i].j, leaves[i].k);
+    std::sort(leafKeys.begin(), leafKeys.end());
+
+    // corner values, each shared corner evaluated once
+    std::vector<uint64_t> cornerKeys;
+    std::vector<double> cornerValues;
+    auto getCornerValues = [&](uint64_t key, double* values)
+    {
+        for (uint64_t n = 0; n < 8; n++)
+            values[n] = cornerValues[FindKey(cornerKeys, key + MakeKey(n & 1, (n >> 1) & 1, (n >> 2) & 1))];
+    };
+
+    // A crossed edge needs all four cells around it for its quad. The field may still
+    // change faster than its bound where the skipped operands switch, so the cells the
+    // pruning dropped next to a crossed edge are added as leaves until none is missing.
+    auto newKeys = leafKeys;
+    while (!newKeys.empty())
+    {
+        std::vector<uint64_t> newCornerKeys;
+        newCornerKeys.reserve(newKeys.size() * 8);
+        for (auto key : newKeys)
+            for (uint64_t n = 0; n < 8; n++)
+            {
+                auto cornerKey = key + MakeKey(n & 1, (n >> 1) & 1, (n >> 2) & 1);
+                if (FindKey(cornerKeys, cornerKey) < 0)
+                    newCornerKeys.push_back(cornerKey);
+            }
+        std::sort(newCornerKeys.begin(), newCornerKeys.end());
+        newCornerKeys.erase(std::unique(newCornerKeys.begin(), newCornerKeys.end()), newCornerKeys.end());
+
+        std::vector<double> newCornerValues(newCornerKeys.size());
+        ParallelFor(newCornerKeys.size(), threadCount, [&](size_t begin, size_t end)
+        {
+            for (auto i = begin; i < end; i++)
+            {
+                auto key = newCornerKeys[i];
+                newCornerValues[i] = field->distance(grid.point((double)(key >> (2 * KEY_BITS)), (double)((key >> KEY_BITS) & KEY_MASK), (double)(key & KEY_MASK)));
+            }
+        });
+
+        std::vector<uint64_t> mergedKeys(cornerKeys.size() + newCornerKeys.size());
+        std::vector<double> mergedValues(mergedKeys.size());
+        for (size_t m = 0, a = 0, b = 0; m < mergedKeys.size(); m++)
+        {
+            auto isOld = b == newCornerKeys.size() || (a < cornerKeys.size() && cornerKeys[a] < newCornerKeys[b]);
+            mergedKeys[m] = isOld ? cornerKeys[a] : newCornerKeys[b];
+            mergedValues[m] = isOld ? cornerValues[a++] : newCornerValues[b++];
+        }
+        cornerKeys.swap(mergedKeys);
+        cornerValues.swap(mergedValues);
+
+        std::vector<std::vector<uint64_t>> chunkMissing((newKeys.size() + 255) / 256);
+        ParallelFor(newKeys.size(), threadCount, [&](size_t begin, size_t end)
+        {
+            auto& missing = chunkMissing[begin / 256];
+            for (auto l = begin; l < end; l++)
+            {
+                auto key = newKeys[l];
+                double values[8];
+                getCornerValues(key, values);
+                for (int e = 0; e < 12; e++)
+                {
+                    auto& edge = CELL_EDGES[e];
+                    if ((values[edge[0]] < 0) == (values[edge[1]] < 0))
+                        continue;
+                    // the cells around the edge share its start corner, minus 0 or 1 on the other two axes
+                    auto axis = e / 4;
+                    int64_t start[3] = { (int64_t)(key >> (2 * KEY_BITS)) + (edge[0] & 1), (int64_t)((key >> KEY_BITS) & KEY_MASK) + ((edge[0] >> 1) & 1), (int64_t)(key & KEY_MASK) + ((edge[0] >> 2) & 1) };
+                    for (int n = 0; n < 4; n++)
+                    {
+                        int64_t cell[3] = { start[0], start[1], start[2] };
+                        cell[(axis + 1) % 3] -= n & 1;
+                        cell[(axis + 2) % 3] -= (n >> 1) & 1;
+                        if (cell[0] < 0 || cell[1] < 0 || cell[2] < 0 || cell[0] >= grid.countX || cell[1] >= grid.countY || cell[2] >= grid.countZ)
+                            continue;
+                        auto cellKey = MakeKey(cell[0], cell[1], cell[2]);
+                        if (FindKey(leafKeys, cellKey) < 0)
+                            missing.push_back(cellKey);
+                    }
+                }
+            }
+        });
+
+        newKeys.clear();
+        for (auto& missing : chunkMissing)
+            newKeys.insert(newKeys.end(), missing.begin(), missing.end());
+        std::sort(newKeys.begin(), newKeys.end());
+        newKeys.erase(std::unique(newKeys.begin(), newKeys.end()), newKeys.end());
+        auto leafCount = leafKeys.size();
+        leafKeys.insert(leafKeys.end(), newKeys.begin(), newKeys.end());
+        std::inplace_merge(leafKeys.begin(), leafKeys.begin() + leafCount, leafKeys.end());
+    }
+
+    // A vertex per surface piece in a leaf. The crossed edges of a face pair up into the
+    // segments the surface cuts it along; on a face with four crossed edges the field at
+    // its center tells which corners the segments cut off, the same for both its cells.
+    // A single vertex there would join two sheets by an edge of four quads.
+    std::vector<PlainPoint3D> leafVertices(leafKeys.size() * 4);
+    std::vector<uint8_t> vertexCounts(leafKeys.size(), 0);
+    std::vector<uint8_t> edgeVertices(leafKeys.size() * 12, 0);
+    ParallelFor(leafKeys.size(), threadCount, [&](size_t begin, size_t end)
+    {
+        for (auto l = begin; l < end; l++)
+        {
+            auto key = leafKeys[l];
+            double values[8];
+            getCornerValues(key, values);
+            PlainPoint3D corners[8];
+            for (int n = 0; n < 8; n++)
+                corners[n] = grid.point((double)((key >> (2 * KEY_BITS)) + (n & 1)), (double)(((key >> KEY_BITS) & KEY_MASK) + ((n >> 1) & 1)), (double)((key & KEY_MASK) + ((n >> 2) & 1)));
+
+            int pieces[12];
+            for (int e = 0; e < 12; e++)
+                pieces[e] = e;
+            auto find = [&](int e)
+            {
+                while (pieces[e] != e)
+                    e = pieces[e] = pieces[pieces[e]];
+                return e;
+            };
+            auto isCrossed = [&](int e) { return (values[CELL_EDGES[e][0]] < 0) != (values[CELL_EDGES[e][1]] < 0); };
+            for (int f = 0; f < 6; f++)
+            {
+                auto& faceEdges = FACE_EDGES[f];
+                auto crossedCount = 0;
+                for (int m = 0; m < 4; m++)
+                    crossedCount += isCrossed(faceEdges[m]) ? 1 : 0;
+                if (crossedCount == 2)
+                {
+                    int crossed[2];
+                    for (int m = 0, c = 0; m < 4; m++)
+                        if (isCrossed(faceEdges[m]))
+                            crossed[c++] = faceEdges[m];
+                    pieces[find(crossed[0])] = find(crossed[1]);
+                }
+                else if (crossedCount == 4)
+                {
+                    auto& faceCorners = FACE_CORNERS[f];
+                    auto& a = corners[faceCorners[0]];
+                    auto& b = corners[faceCorners[2]];
+                    auto isCenterInside = field->distance({ (a.x + b.x) / 2, (a.y + b.y) / 2, (a.z + b.z) / 2 }) < 0;
+                    // the segments go around the corners on the other side than the center
+                    for (int m = 0; m < 4; m++)
+                        if ((values[faceCorners[m]] < 0) != isCenterInside)
+                            pieces[find(faceEdges[(m + 3) % 4])] = find(faceEdges[m]);
+                }
+            }
+
+            Qef qefs[4];
+            int roots[4];
+            auto count = 0;
+            for (int e = 0; e < 12; e++)
+            {
+                if (!isCrossed(e))
+                    continue;
+                auto root = find(e);
+                auto v = 0;
+                while (v < count && roots[v] != root)
+                    v++;
+                if (v == count)
+                    roots[count++] = root;
+                edgeVertices[l * 12 + e] = (uint8_t)v;
+                auto& edge = CELL_EDGES[e];
+                auto crossing = FindCrossing(*field, corners[edge[0]], values[edge[0]], corners[edge[1]], values[edge[1]]);
+                qefs[v].add(crossing, field->normal(crossing, cellSize * 0.05));
+            }
+
+            for (int v = 0; v < count; v++)
+            {
+                auto& qef = qefs[v];
+                auto vertex = qef.solve();
+                auto& minCorner = corners[0];
+                auto& maxCorner = corners[7];
+                auto margin = cellSize * 0.5;
+                if (vertex.x < minCorner.x - margin || vertex.x > maxCorner.x + margin ||
+                    vertex.y < minCorner.y - margin || vertex.y > maxCorner.y + margin ||
+                    vertex.z < minCorner.z - margin || vertex.z > maxCorner.z + margin)
+                    vertex = { qef.mass[0] / qef.count, qef.mass[1] / qef.count, qef.mass[2] / qef.count };
+                leafVertices[l * 4 + v] = vertex;
+            }
+            vertexCounts[l] = (uint8_t)count;
+        }
+    });
+
+    std::vector<uint32_t> vertexIndexes(leafKeys.size(), 0);
+    for (size_t l = 0; l < leafKeys.size(); l++)
+    {
+        vertexIndexes[l] = (uint32_t)body.vertices.size();
+        body.vertices.insert(body.vertices.end(), leafVertices.begin() + l * 4, leafVertices.begin() + l * 4 + vertexCounts[l]);
+    }
+
+    // a quad around every crossed edge, the edge belongs to the leaf at its start
+    std::vector<std::vector<MeshTriangle>> chunkTriangles((leafKeys.size() + 255) / 256);
+    ParallelFor(leafKeys.size(), threadCount, [&](size_t begin, size_t end)
+    {
+        auto& triangles = chunkTriangles[begin / 256];
+        for (auto l = begin; l < end; l++)
+        {
+            auto key = leafKeys[l];
+            auto i = key >> (2 * KEY_BITS);
+            auto j = (key >> KEY_BITS) & KEY_MASK;
+            auto k = key & KEY_MASK;
+            double values[8];
+            getCornerValues(key, values);
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                auto value2 = values[1 << axis];
+                if ((values[0] < 0) == (value2 < 0))
+                    continue;
+                // the grid is padded by two cells, the surface never reaches its sides
+                if ((axis != 0 && i == 0) || (axis != 1 && j == 0) || (axis != 2 && k == 0))
+                    continue;
+
+                // the four cells counter-clockwise around the axis direction
+                uint64_t cells[4];
+                if (axis == 0)
+                {
+                    cells[0] = MakeKey(i, j, k);
+                    cells[1] = MakeKey(i, j - 1, k);
+                    cells[2] = MakeKey(i, j - 1, k - 1);
+                    cells[3] = MakeKey(i, j, k - 1);
+                }
+                else if (axis == 1)
+                {
+                    cells[0] = MakeKey(i, j, k);
+                    cells[1] = MakeKey(i, j, k - 1);
+                    cells[2] = MakeKey(i - 1, j, k - 1);
+                    cells[3] = MakeKey(i - 1, j, k);
+                }
+                else
+                {
+                    cells[0] = MakeKey(i, j, k);
+                    cells[1] = MakeKey(i - 1, j, k);
+                    cells[2] = MakeKey(i - 1, j - 1, k);
+                    cells[3] = MakeKey(i, j - 1, k);
+                }
+
+                // the cells are leaves, they were added for this edge; the edge is at the
+                // cell side the cell is shifted to, on the two other axes
+                uint32_t quad[4];
+                for (int n = 0; n < 4; n++)
+                {
+                    auto index = FindKey(leafKeys, cells[n]);
+                    auto bit1 = ((cells[n] >> (axis == 0 ? KEY_BITS : 2 * KEY_BITS)) & KEY_MASK) != (axis == 0 ? j : i) ? 1 : 0;
+                    auto bit2 = ((cells[n] >> (axis == 2 ? KEY_BITS : 0)) & KEY_MASK) != (axis == 2 ? j : k) ? 1 : 0;
+                    quad[n] = vertexIndexes[index] + edgeVertices[index * 12 + axis * 4 + bit1 + 2 * bit2];
+                }
+                if (values[0] >= 0)
+                    std::swap(quad[1], quad[3]);
+
+                auto& v = body.vertices;
+                if (SquaredDistance(v[quad[0]], v[quad[2]]) <= SquaredDistance(v[quad[1]], v[quad[3]]))
+                {
+                    triangles.push_back({ quad[0], quad[1], quad[2] });
+                    triangles.push_back({ quad[0], quad[2], quad[3] });
+                }
+                else
+                {
+                    triangles.push_back({ quad[0], quad[1], quad[3] });
+                    triangles.push_back({ quad[1], quad[2], quad[3] });
+                }
+            }
+        }
+    });
+
+    for (auto& triangles : chunkTriangles)
+        body.triangles.insert(body.triangles.end(), triangles.begin(), triangles.end());
+    return body;
+}
\ No newline at end of file
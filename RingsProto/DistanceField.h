@@ -0,0 +1,63 @@
+#pragma once
+#include "MeshEnvironment.h"
+#include <memory>
+
+// Signed distance field bodies: distance is negative inside. Combine blends with a
+// radius, so the edges a join or cut creates come out filleted by that radius
+// without any fillet feature. The round blends are exact for perpendicular faces;
+// elsewhere they stretch the distance, up to sqrt(2) per blend, and lipschitz keeps
+// the bound of that stretch so the octree does not prune the surface away.
+
+class DistanceField
+{
+public:
+    MeshBox bounds; // the body is inside
+    double lipschitz = 1; // the distance changes at most this much per unit of length
+
+    virtual ~DistanceField() {}
+    virtual double distance(const PlainPoint3D& point) const = 0;
+    // Lower bound of the distance, 0 inside bounds.
+    double boundsDistance(const PlainPoint3D& point) const;
+    PlainPoint3D normal(const PlainPoint3D& point, double step) const;
+};
+
+// Signed distance on the XY plane, the counterpart of a sketch profile. Vertical edges
+// are rounded by combining profiles: blending extruded bodies would also bulge over
+// their coplanar top and bottom faces.
+class DistanceProfile
+{
+public:
+    MeshBox bounds; // z is not used
+    double lipschitz = 1;
+
+    virtual ~DistanceProfile() {}
+    virtual double distance(double x, double y) const = 0;
+    double boundsDistance(double x, double y) const;
+};
+
+typedef std::shared_ptr<const DistanceField> DistanceFieldPtr;
+typedef std::shared_ptr<const DistanceProfile> DistanceProfilePtr;
+
+DistanceProfilePtr CreateCircleProfile(const PlainPoint3D& center, double radius);
+DistanceProfilePtr CreateRectangleProfile(const PlainPoint3D& point1, const PlainPoint3D& point2, double cornerRadius = 0);
+// Profile of Sketcher::AddSquareCurves.
+DistanceProfilePtr CreateSquareProfile(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel);
+DistanceProfilePtr Combine(MeshOperation operation, const DistanceProfilePtr& profile1, const DistanceProfilePtr& profile2, double filletRadius = 0);
+// Extrudes from z = 0; the edge radii round the bottom and top outlines.
+DistanceFieldPtr Extrude(const DistanceProfilePtr& profile, double distance, double bottomEdgeFilletRadius = 0, double topEdgeFilletRadius = 0);
+
+DistanceFieldPtr CreateSphereField(const PlainPoint3D& center, double radius);
+// Cylinder along Z from center.z.
+DistanceFieldPtr CreateCylinderField(const PlainPoint3D& center, double radius, double height, double bottomEdgeFilletRadius = 0, double topEdgeFilletRadius = 0);
+DistanceFieldPtr CreateBoxField(const PlainPoint3D& point1, const PlainPoint3D& point2, double height, double verticalCornerFilletRadius = 0, double bottomEdgeFilletRadius = 0, double topEdgeFilletRadius = 0);
+
+DistanceFieldPtr Move(const DistanceFieldPtr& field, const MeshAxis& axis, double distance);
+DistanceFieldPtr Combine(MeshOperation operation, const DistanceFieldPtr& field1, const DistanceFieldPtr& field2, double filletRadius = 0);
+// Joins without blending as a balanced tree, so the bounds skip most of the bodies.
+DistanceFieldPtr Combine(const std::vector<DistanceFieldPtr>& fields);
+
+// Dual contouring on a sparse octree with leaves of cellSize. Cells the field proves
+// empty are never split, and every cell around a crossed edge is made a leaf, so the
+// mesh is closed; vertices are placed by the edge normals, so sharp edges
+// stay sharp. threadCount 0 uses every hardware thread.
+MeshBody ToMesh(const DistanceFieldPtr& field, double cellSize, int threadCount = 0);
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include "DistanceFieldParts.h"
+#include <algorithm>
+#include <thread>
+
+DistanceProfilePtr CreateSquareRingProfile(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel, double thickness)
+{
+    auto profile = CreateSquareProfile(center, size, cornerOuterRadius, rotateAngel);
+    if (size / 2.0 + cornerOuterRadius - thickness <= 0)
+        return profile;
+    return Combine(CutMeshOperation, profile, CreateSquareProfile(center, size, cornerOuterRadius - thickness, rotateAngel));
+}
+
+DistanceProfilePtr CreatePairedSquaresProfile(const BasePartLayout& layout, double size, double cornerOuterRadius, double thickness, double verticalEdgeFilletRadius)
+{
+    auto profileLeft = CreateSquareRingProfile(layout.leftCenterPoint, size, cornerOuterRadius, RAD_45, thickness);
+    auto profileRight = CreateSquareRingProfile(layout.rightCenterPoint, size, cornerOuterRadius, RAD_45, thickness);
+    return Combine(JoinMeshOperation, profileLeft, profileRight, verticalEdgeFilletRadius);
+}
+
+DistanceFieldPtr CreateBasePartField(const BasePartLayout& layout)
+{
+    auto cornerOuterRadius = layout.cornerMiddleRadius + layout.outerWidth;
+    auto width = layout.outerWidth + layout.innerWidth;
+    auto floorThickness = layout.floorThickness;
+    auto verticalEdgeFilletRadius = layout.verticalEdgeFilletRadius;
+
+    auto profile = CreatePairedSquaresProfile(layout, layout.lineLength, cornerOuterRadius, width, verticalEdgeFilletRadius);
+    auto field = Extrude(profile, layout.height, layout.otherEdgeFilletRadius, layout.topEdgeFilletRadius);
+
+    // the rounded edges of the way become the fillets of the way floor and of the walls at the center
+    auto cutWayProfile = CreatePairedSquaresProfile(layout, layout.lineLength, cornerOuterRadius - layout.wallThickness, width - 2.0 * layout.wallThickness, verticalEdgeFilletRadius / 2.0);
+    auto cutWayField = Move(Extrude(cutWayProfile, layout.height, layout.otherEdgeFilletRadius, 0), ZMeshAxis(), floorThickness);
+    field = Combine(CutMeshOperation, field, cutWayField, layout.topEdgeFilletRadius);
+
+    std::vector<DistanceFieldPtr> magnetFields;
+    for (auto& center : GetPairedCirclesOnSquareCenters(layout))
+        magnetFields.push_back(CreateCylinderField({ center.x, center.y, -floorThickness }, layout.circlesOnSquareRadius, floorThickness * 3.0));
+    return Combine(CutMeshOperation, field, Combine(magnetFields), floorThickness / 3.0);
+}
+
+DistanceFieldPtr CreateRoofPartField(const RoofPartLayout& layout)
+{
+    auto cornerOuterRadius = layout.cornerMiddleRadius + layout.outerWidth;
+    auto width = layout.outerWidth + layout.innerWidth;
+    auto separationCornerOuterRadius = layout.cornerMiddleRadius + layout.separationOuterWidth;
+    auto separationWidth = layout.separationOuterWidth + layout.separationInnerWidth;
+    auto height = layout.height;
+    auto verticalEdgeFilletRadius = layout.verticalEdgeFilletRadius;
+    auto otherEdgeFilletRadius = layout.otherEdgeFilletRadius;
+
+    auto profile = CreatePairedSquaresProfile(layout, layout.lineLength, cornerOuterRadius, width, verticalEdgeFilletRadius);
+    profile = Combine(JoinMeshOperation, profile, CreateCircleProfile({ 0, 0, 0 }, width), verticalEdgeFilletRadius);
+    auto field = Extrude(profile, height, otherEdgeFilletRadius, layout.topEdgeFilletRadius);
+
+    // tool bodies start below the part, so the cut rounds their rims on its bottom face
+    auto cutProfile = CreatePairedSquaresProfile(layout, layout.lineLength, cornerOuterRadius - layout.wallThickness, width - 2.0 * layout.wallThickness, verticalEdgeFilletRadius / 2.0);
+    auto cutField = Move(Extrude(cutProfile, height - layout.floorThickness + 1.0, 0, otherEdgeFilletRadius), ZMeshAxis(), -1.0);
+    auto separationCutProfile = CreatePairedSquaresProfile(layout, layout.lineLength, separationCornerOuterRadius, separationWidth, verticalEdgeFilletRadius / 2.0);
+    auto separationCutField = Move(Extrude(separationCutProfile, height + 2.0), ZMeshAxis(), -1.0);
+    cutField = Combine(JoinMeshOperation, cutField, separationCutField);
+    auto substrateCutField = CreateCylinderField({ 0, 0, -1.0 }, 2.0 * (layout.lineLength + cornerOuterRadius * 2.0), layout.downTrimmingThicknes + 1.0);
+    cutField = Combine(JoinMeshOperation, cutField, substrateCutField);
+
+    return Combine(CutMeshOperation, field, cutField, otherEdgeFilletRadius);
+}
+
+DistanceFieldPtr CreateVolfUpPartField(const VolfUpPartLayout& layout, const PlainPoint3D& centerPoint)
+{
+    auto filletRadius = layout.filletRadius;
+    auto field = CreateCylinderField(centerPoint, layout.radius, layout.height, filletRadius, filletRadius);
+
+    if (layout.middleRadius > 0 && layout.middleHeight > 0)
+    {
+        auto middleField = CreateCylinderField(centerPoint, layout.middleRadius, layout.middleHeight, filletRadius / 2.0, 0);
+        field = Move(field, ZMeshAxis(), layout.middleHeight);
+        field = Combine(JoinMeshOperation, field, middleField, filletRadius / 2.0);
+    }
+
+    if (layout.holeRadius > 0 && layout.holeHeight > 0)
+    {
+        auto holeField = CreateCylinderField({ centerPoint.x, centerPoint.y, centerPoint.z - 1.0 }, layout.holeRadius, layout.holeHeight + 1.0);
+        field = Combine(CutMeshOperation, field, holeField, filletRadius / 2.0);
+    }
+
+    if (layout.holeDownRadius > 0 && layout.holeDownHeight > 0)
+    {
+        auto holeField = CreateCylinderField({ centerPoint.x, centerPoint.y, centerPoint.z - 1.0 }, layout.holeDownRadius, layout.holeDownHeight + 1.0);
+        field = Combine(CutMeshOperation, field, holeField, filletRadius / 2.0);
+    }
+
+    if (layout.holeUpRadius > 0 && layout.holeUpHeight > 0)
+    {
+        auto holeField = CreateCylinderField(centerPoint, layout.holeUpRadius, layout.holeUpHeight + 1.0);
+        holeField = Move(holeField, ZMeshAxis(), layout.height + layout.middleHeight - layout.holeUpHeight);
+        field = Combine(CutMeshOperation, field, holeField, filletRadius / 2.0);
+    }
+
+    auto top = centerPoint.z + layout.height + layout.middleHeight;
+    if (layout.form == VolfUpForm::Concave && layout.concaveRadius > 0 && layout.concaveHeight > 0)
+    {
+        auto sphereField = CreateSphereField({ centerPoint.x, centerPoint.y, top + layout.concaveRadius - layout.concaveHeight }, layout.concaveRadius);
+        field = Combine(CutMeshOperation, field, sphereField, filletRadius);
+    }
+    else if (layout.form == VolfUpForm::Convex && layout.convexRadius > 0)
+    {
+        auto sphereField = CreateSphereField({ centerPoint.x, centerPoint.y, top - layout.convexRadius }, layout.convexRadius);
+        field = Combine(IntersectMeshOperation, field, sphereField, filletRadius);
+    }
+
+    return Move(field, ZMeshAxis(), layout.zMoveShift - layout.middleHeight);
+}
+
+DistanceFieldPtr CreateVolfDownPartField(const VolfDownPartLayout& layout, const PlainPoint3D& centerPoint)
+{
+    auto filletRadius = layout.filletRadius;
+    auto isMiddle = layout.middleRadius > 0 && layout.middleHeight > 0;
+    auto field = CreateCylinderField(centerPoint, layout.radius, layout.height, filletRadius, isMiddle ? filletRadius : filletRadius / 2.0);
+
+    if (isMiddle)
+    {
+        auto middleField = CreateCylinderField(centerPoint, layout.middleRadius, layout.middleHeight, 0, filletRadius / 2.0);
+        middleField = Move(middleField, ZMeshAxis(), layout.height);
+        field = Combine(JoinMeshOperation, field, middleField, filletRadius);
+    }
+
+    if (layout.holeRadius > 0 && layout.holeHeight > 0)
+    {
+        auto holeField = CreateCylinderField({ centerPoint.x, centerPoint.y, centerPoint.z - 1.0 }, layout.holeRadius, layout.holeHeight + 1.0);
+        field = Combine(CutMeshOperation, field, holeField, filletRadius / 2.0);
+    }
+
+    if (layout.holeDownRadius > 0 && layout.holeDownHeight > 0)
+    {
+        // the step inside the hole gets the 2/3 fillet, its rim the full one
+        auto holeField = CreateCylinderField({ centerPoint.x, centerPoint.y, centerPoint.z - 1.0 }, layout.holeDownRadius, layout.holeDownHeight + 1.0, 0, filletRadius / 3.0 * 2.0);
+        field = Combine(CutMeshOperation, field, holeField, filletRadius);
+    }
+
+    if (layout.holeUpRadius > 0 && layout.holeUpHeight > 0)
+    {
+        auto holeField = CreateCylinderField(centerPoint, layout.holeUpRadius, layout.holeUpHeight + 1.0);
+        holeField = Move(holeField, ZMeshAxis(), layout.height + layout.middleHeight - layout.holeUpHeight);
+        field = Combine(CutMeshOperation, field, holeField, filletRadius / 2.0);
+    }
+
+    return Move(field, ZMeshAxis(), layout.zMoveShift);
+}
+
+std::vector<MeshBody> CreateRings2D2SquaresFieldBodies(const Rings2D2SquaresLayout& layout, double cellSize, int threadCount)
+{
+    const int partCount = 4;
+    if (threadCount <= 0)
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    // the parts run side by side, each meshes on its share of the threads
+    auto meshThreadCount = std::max(1, threadCount / partCount);
+
+    MeshBody baseBody;
+    std::vector<MeshBody> roofBodies;
+    std::vector<MeshBody> volfBodies;
+    TaskGraph graph;
+    graph.add([&]()
+    {
+        baseBody = ToMesh(CreateBasePartField(layout.basePart), cellSize, meshThreadCount);
+        baseBody.name = "BaseBody";
+    });
+    graph.add([&]()
+    {
+        auto& roofPart = layout.roofPart;
+        roofBodies = SplitComponents(ToMesh(CreateRoofPartField(roofPart), cellSize, meshThreadCount));
+        NameRoofBodies(roofBodies, roofPart, roofPart.cornerMiddleRadius + roofPart.outerWidth, roofPart.outerWidth + roofPart.innerWidth);
+    });
+
+    auto volfBase = layout.basePart;
+    volfBase.circlesOnSquarePeriodRadius = layout.volfRadius;
+    for (auto& center : GetPairedCirclesOnSquareCenters(volfBase))
+    {
+        if (center.x < layout.rightCenterPoint.x + 2.0 * layout.volfRadius || center.y < 0)
+            continue;
+        volfBodies.resize(2);
+        graph.add([&, center]()
+        {
+            volfBodies[0] = ToMesh(CreateVolfDownPartField(layout.volfDownPart, center), cellSize, meshThreadCount);
+            volfBodies[0].name = "VolfDownBody";
+        });
+        graph.add([&, center]()
+        {
+            volfBodies[1] = ToMesh(CreateVolfUpPartField(layout.volfUpPart, center), cellSize, meshThreadCount);
+            volfBodies[1].name = "VolfUpBody";
+        });
+        break;
+    }
+    graph.run(std::min(threadCount, partCount));
+
+    std::vector<MeshBody> bodies;
+    bodies.push_back(baseBody);
+    for (auto& body : roofBodies)
+        bodies.push_back(body);
+    for (auto& body : volfBodies)
+        bodies.push_back(body);
+    return bodies;
+}
\ No newline at end of file
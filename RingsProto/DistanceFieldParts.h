@@ -0,0 +1,20 @@
+#pragma once
+#include "DistanceField.h"
+#include "MeshParts.h"
+
+// Distance field builds of the plain Rings2D2Squares parts. The fillets of the
+// filletBody methods come from the blend radii of the primitives and combines, so
+// there is no separate fillet step that can fail.
+
+DistanceProfilePtr CreateSquareRingProfile(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel, double thickness);
+// Both rings of PariedSquaresPart::createPairedSquares, their joints rounded by verticalEdgeFilletRadius.
+DistanceProfilePtr CreatePairedSquaresProfile(const BasePartLayout& layout, double size, double cornerOuterRadius, double thickness, double verticalEdgeFilletRadius);
+
+DistanceFieldPtr CreateBasePartField(const BasePartLayout& layout);
+// All roof parts in one field, ToMesh and SplitComponents separate them.
+DistanceFieldPtr CreateRoofPartField(const RoofPartLayout& layout);
+DistanceFieldPtr CreateVolfUpPartField(const VolfUpPartLayout& layout, const PlainPoint3D& centerPoint);
+DistanceFieldPtr CreateVolfDownPartField(const VolfDownPartLayout& layout, const PlainPoint3D& centerPoint);
+
+// Same bodies and names as CreateRings2D2SquaresBodies for a plain (not rectangled) layout.
+std::vector<MeshBody> CreateRings2D2SquaresFieldBodies(const Rings2D2SquaresLayout& layout, double cellSize, int threadCount = 0);
\ No newline at end of file
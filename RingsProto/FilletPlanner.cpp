@@ -0,0 +1,117 @@
+#include "FilletPlanner.h"
+#include "Instrumentation.h"
+
+void FilletPlanner::add(EdgeRule isGoodEdge, double radius, EdgeNarrowing narrowing)
+{
+    passes.back().push_back({ isGoodEdge, radius, narrowing });
+}
+
+void FilletPlanner::skip(EdgeRule isSkippedEdge)
+{
+    skipRules.push_back(isSkippedEdge);
+}
+
+void FilletPlanner::nextPass()
+{
+    if (!passes.back().empty())
+        passes.push_back({});
+}
+
+int FilletPlanner::fillet(Ptr<Component> component, Ptr<BRepBody> body)
+{
+    auto count = 0;
+    for (auto& rules : passes)
+        count += filletPass(component, body, rules);
+    return count;
+}
+
+std::vector<char> FilletPlanner::getSkippedEdges(const BodyTopology& topology) const
+{
+    std::vector<char> isSkipped(topology.edgeCount(), false);
+    for (auto& isSkippedEdge : skipRules)
+        for (int i = 0; i < topology.edgeCount(); i++)
+            isSkipped[i] = isSkipped[i] || isSkippedEdge(topology, i);
+    return isSkipped;
+}
+
+std::vector<int> FilletPlanner::match(const BodyTopology& topology, const Rule& rule, const std::vector<char>& isTaken)
+{
+    std::vector<int> matched;
+    for (int i = 0; i < topology.edgeCount(); i++)
+        if (!isTaken[i] && rule.isGoodEdge(topology, i))
+            matched.push_back(i);
+    if (rule.narrowing == nullptr || matched.empty())
+        return matched;
+
+    auto isKept = rule.narrowing(topology, matched);
+    std::vector<int> kept;
+    for (auto i : matched)
+        if (isKept(topology, i))
+            kept.push_back(i);
+    return kept;
+}
+
+int FilletPlanner::filletPass(Ptr<Component> component, Ptr<BRepBody> body, const std::vector<Rule>& rules)
+{
+    if (rules.empty())
+        return 0;
+
+    BodyTopology topology(body);
+    // edge sets by radius, in the order of their first rule
+    std::vector<std::pair<double, Ptr<ObjectCollection>>> edgeSets;
+    auto isTaken = getSkippedEdges(topology);
+    for (auto& rule : rules)
+    {
+        auto matched = match(topology, rule, isTaken);
+        if (matched.empty())
+            continue;
+
+        Ptr<ObjectCollection> edgeSet;
+        for (auto& edgeSetItem : edgeSets)
+            if (Equal(edgeSetItem.first, rule.radius))
+                edgeSet = edgeSetItem.second;
+        if (edgeSet == nullptr)
+        {
+            edgeSet = ObjectCollection::create();
+            edgeSets.push_back({ rule.radius, edgeSet });
+        }
+        for (auto i : matched)
+        {
+            edgeSet->add(topology.getEdge(i));
+            isTaken[i] = true;
+        }
+    }
+
+    if (edgeSets.empty())
+        return 0;
+
+    INSTRUMENT_OPERATION("Fillet");
+    auto filletFeatures = component->features()->filletFeatures();
+    auto filletInput = filletFeatures->createInput();
+    for (auto& edgeSet : edgeSets)
+        filletInput->addConstantRadiusEdgeSet(edgeSet.second, ValueInput::createByReal(edgeSet.first), false);
+    MarkDesignModified();
+    if (filletFeatures->add(filletInput) != nullptr)
+        return 1;
+
+    // the edge sets do not fit together, the rules see each other's fillets then
+    return filletSequentially(component, body, rules);
+}
+
+int FilletPlanner::filletSequentially(Ptr<Component> component, Ptr<BRepBody> body, const std::vector<Rule>& rules)
+{
+    auto count = 0;
+    for (auto& rule : rules)
+    {
+        BodyTopology topology(body);
+        auto matched = match(topology, rule, getSkippedEdges(topology));
+        if (matched.empty())
+            continue;
+        auto edges = ObjectCollection::create();
+        for (auto i : matched)
+            edges->add(topology.getEdge(i));
+        if (Fillet(component, edges, rule.radius) != nullptr)
+            count++;
+    }
+    return count;
+}
\ No newline at end of file
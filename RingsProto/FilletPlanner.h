@@ -0,0 +1,39 @@
+#pragma once
+#include "FusionEnvironment.h"
+#include "BodyTopology.h"
+
+// Collects the fillet rules of a body and applies every pass of them as one fillet
+// feature with an edge set per radius. The edges of a pass are read once and each edge
+// goes to the first rule that takes it, as if the earlier rules had filleted it away.
+// Start a new pass only where a rule has to see the edges made by the previous fillets.
+// When the merged feature fails, the pass is filleted rule by rule.
+class FilletPlanner
+{
+public:
+    typedef BodyTopology::EdgeRule EdgeRule;
+    // narrows the edges the rule matched, the others stay for the next rules
+    typedef std::function<EdgeRule(const BodyTopology& topology, const std::vector<int>& edges)> EdgeNarrowing;
+
+    void add(EdgeRule isGoodEdge, double radius, EdgeNarrowing narrowing = nullptr);
+    // the edges are left sharp, in every pass and before all rules
+    void skip(EdgeRule isSkippedEdge);
+    void nextPass();
+    // returns the count of the created fillet features
+    int fillet(Ptr<Component> component, Ptr<BRepBody> body);
+
+private:
+    struct Rule
+    {
+        EdgeRule isGoodEdge;
+        double radius;
+        EdgeNarrowing narrowing;
+    };
+
+    std::vector<std::vector<Rule>> passes = { {} };
+    std::vector<EdgeRule> skipRules;
+
+    int filletPass(Ptr<Component> component, Ptr<BRepBody> body, const std::vector<Rule>& rules);
+    int filletSequentially(Ptr<Component> component, Ptr<BRepBody> body, const std::vector<Rule>& rules);
+    std::vector<char> getSkippedEdges(const BodyTopology& topology) const;
+    static std::vector<int> match(const BodyTopology& topology, const Rule& rule, const std::vector<char>& isTaken);
+};
\ No newline at end of file
@@ -1,4 +1,12 @@
 #include "FusionEnvironment.h"
+#include "Instrumentation.h"
+#include "StlWriter.h"
+#include "BodyTopology.h"
+#include "TopologyIndex.h"
+#include <deque>
+#include <future>
+#include <memory>
+#include <unordered_map>
 
 
 Ptr<Point3D> GetCenterPoint()
@@ -6,6 +14,11 @@ Ptr<Point3D> GetCenterPoint()
 	return Point3D::create(0, 0, 0);
 }
 
+Ptr<Point3D> ToPoint3D(const PlainPoint3D& point)
+{
+    return Point3D::create(point.x, point.y, point.z);
+}
+
 Ptr<Point3D> GetCirclePoint(double radius, double angel)
 {
 	return Point3D::create(radius * cos(angel), radius * sin(angel), 0);
@@ -54,14 +67,6 @@ bool Equal(Ptr<SketchLine> line, Ptr<BRepEdge> edge, double delta)
         (Equal(startPoint1, endPoint2, delta) && Equal(endPoint1, startPoint2, delta));
 }
 
-bool EqualAny(Ptr<BRepEdge> edge, Ptr<SketchLines> lines, double delta)
-{
-    for (int i = 0; i < lines->count(); i++)
-        if (Equal(lines->item(i), edge, delta))
-            return true;
-    return false;
-}
-
 bool isPointOnFace(Ptr<BRepFace> face, Ptr<Point3D> point, double tolerance)
 {
     Ptr<Point2D> parameter;
@@ -100,24 +105,7 @@ double getTriangleLeg(double legB, double angleBInRadians)
 
 Ptr<BRepFace> getBodyFace(Ptr<BRepBody> body, CubeFaceType faceType)
 {
-    Ptr<Vector3D> normalVector = Vector3D::create(
-        faceType == Right ? 1 : (faceType == Left ? -1 : 0),
-        faceType == Fron ? 1 : (faceType == Back ? -1 : 0),
-        faceType == Top ? 1 : (faceType == Bottom ? -1 : 0));
-
-    auto faces = body->faces();
-    
-    for (int i = 0; i < faces->count(); i++)
-    {
-        auto face = faces->item(i);
-        auto point = face->pointOnFace();
-        Ptr<Vector3D> normal;
-        face->evaluator()->getNormalAtPoint(point, normal);
-        
-        if (normal->angleTo(normalVector) < RAD_90)
-            return face;
-    }
-    return NULL;
+    return BodyTopology(body, BodyTopology::FaceColumns).getFace(faceType);
 }
 
 Ptr<BRepFace> getBodyFace(Ptr<BRepBody> body, Ptr<Point3D> pointOnFace, double tolerance)
@@ -136,20 +124,21 @@ Ptr<BRepFace> getBodyFace(Ptr<BRepBody> body, Ptr<Point3D> pointOnFace, double t
 
 Ptr<BRepEdge> getJoinedEdge(Ptr<BRepFace> face1, Ptr<BRepFace> face2)
 {
+    auto tokens2 = GetEntityTokens(face2->edges());
     auto edges1 = face1->edges();
-    auto edges2 = face2->edges();
     for (int i = 0; i < edges1->count(); i++)
     {
         auto edge1 = edges1->item(i);
-        for (int j = 0; j < edges2->count(); j++)
-            if (edge1 == edges2->item(j))
-                return edge1;
+        if (tokens2.count(edge1->entityToken()) > 0)
+            return edge1;
     }
     return nullptr;
 }
 
 DialogResults MessageBox(std::string message, std::string title, MessageBoxButtonTypes buttonType)
 {
+    // the time the user takes to answer shows up apart from the modeling
+    INSTRUMENT_OPERATION("MessageBox");
     return Application::get()->userInterface()->messageBox(message, title, buttonType);
 }
 
@@ -169,6 +158,7 @@ Ptr<ObjectCollection> createObjectCollection(std::initializer_list<Ptr<Base>> it
 
 Ptr<Sketch> CreateSketch(Ptr<Component> component, Ptr<ConstructionPlane> plane, std::string name)
 {
+    INSTRUMENT_OPERATION("CreateSketch");
     auto sketch = component->sketches()->add(plane);
     sketch->name(name);
     return sketch;
@@ -177,6 +167,7 @@ Ptr<Sketch> CreateSketch(Ptr<Component> component, Ptr<ConstructionPlane> plane,
 
 void Rotate(Ptr<Sketch> sketch, double angel, Ptr<Point3D> point, Ptr<ObjectCollection> items)
 {
+    INSTRUMENT_OPERATION("RotateSketch");
     auto normal = sketch->xDirection()->crossProduct(sketch->yDirection());
     auto matrix = Matrix3D::create();
     matrix->setToRotation(angel, normal, point);
@@ -200,6 +191,7 @@ void Rotate(Ptr<Sketch> sketch, double angel, Ptr<Point3D> point)
 
 void Rotate(Ptr<SectionAnalysis> analysis, double angel, Ptr<Vector3D> axis, Ptr<Point3D> originPointOfAxis)
 {
+    INSTRUMENT_OPERATION("RotateSectionAnalysis");
     Ptr<Plane> plane = analysis->cutPlane();
     auto matrix = Matrix3D::create();
     matrix->setToRotation(angel, axis, originPointOfAxis);
@@ -215,6 +207,7 @@ void Rotate(Ptr<SectionAnalysis> analysis, double angel, Ptr<ConstructionAxis> a
 
 Ptr<ConstructionPoint> AddConstructionPoint(Ptr<Component> component, Ptr<Base> point)
 {
+    INSTRUMENT_OPERATION("AddConstructionPoint");
     auto input = component->constructionPoints()->createInput();
     input->setByPoint(point);
     return component->constructionPoints()->add(input);
@@ -222,6 +215,7 @@ Ptr<ConstructionPoint> AddConstructionPoint(Ptr<Component> component, Ptr<Base>
 
 Ptr<ConstructionAxis> AddConstructionAxis(Ptr<Component> component, Ptr<Point3D> point, Ptr<Vector3D> vector)
 {
+    INSTRUMENT_OPERATION("AddConstructionAxis");
     auto designType = component->parentDesign()->designType();
     component->parentDesign()->designType(DesignTypes::DirectDesignType);
     auto input = component->constructionAxes()->createInput();
@@ -237,24 +231,81 @@ Ptr<ConstructionAxis> AddConstructionAxis(Ptr<Component> component, Ptr<Vector3D
     return AddConstructionAxis(component, component->originConstructionPoint()->geometry(), vector);
 }
 
+static Ptr<Matrix3D> CreateTranslation(Ptr<Vector3D> translation)
+{
+    auto matrix = Matrix3D::create();
+    if (translation != nullptr)
+        matrix->translation(translation);
+    return matrix;
+}
+
+Ptr<Occurrence> AddComponentOccurrence(Ptr<Component> component, std::string name, Ptr<Vector3D> translation)
+{
+    INSTRUMENT_OPERATION("AddComponentOccurrence");
+    auto occurrence = component->occurrences()->addNewComponent(CreateTranslation(translation));
+    occurrence->component()->name(name);
+    MarkDesignModified();
+    return occurrence;
+}
+
+Ptr<Occurrence> AddOccurrence(Ptr<Component> component, Ptr<Component> instancedComponent, Ptr<Vector3D> translation)
+{
+    INSTRUMENT_OPERATION("AddOccurrence");
+    auto occurrence = component->occurrences()->addExistingComponent(instancedComponent, CreateTranslation(translation));
+    MarkDesignModified();
+    return occurrence;
+}
+
+void DeleteOccurrences(Ptr<Component> component, Ptr<Component> instancedComponent)
+{
+    INSTRUMENT_OPERATION("DeleteOccurrences");
+    auto occurrences = component->allOccurrencesByComponent(instancedComponent);
+    for (int i = occurrences->count() - 1; i >= 0; i--)
+        occurrences->item(i)->deleteMe();
+    MarkDesignModified();
+}
+
+Ptr<BRepBody> GetNativeBody(Ptr<BRepBody> body)
+{
+    Ptr<BRepBody> nativeBody = body->nativeObject();
+    return nativeBody != nullptr ? nativeBody : body;
+}
+
+Ptr<BRepBody> CreateInstancedBody(Ptr<Component> component, std::string name, const std::vector<Ptr<Vector3D>>& translations, std::function<Ptr<BRepBody>(Ptr<Component>)> createBody)
+{
+    if (translations.empty())
+        return nullptr;
+    auto occurrence = AddComponentOccurrence(component, name, translations[0]);
+    auto body = createBody(occurrence->component());
+    if (body != nullptr)
+        body->name(name + "Body");
+    for (size_t i = 1; i < translations.size(); i++)
+        AddOccurrence(component, occurrence->component(), translations[i]);
+    return body;
+}
+
 Ptr<SketchCircle> AddCircle(Ptr<Sketch> sketch, Ptr<Point3D> circleCentr, double radius)
 {
+    INSTRUMENT_OPERATION("AddCircle");
     return sketch->sketchCurves()->sketchCircles()->addByCenterRadius(circleCentr, radius);
 }
 
 Ptr<SketchArc> AddArc(Ptr<Sketch> sketch, Ptr<Point3D> circleCentr, double radius, double length, double pivotAngelInRadian, bool pivotAngelIsCenterOfArc)
 {
+	INSTRUMENT_OPERATION("AddArc");
 	double lengthRad = length / radius;
 	return sketch->sketchCurves()->sketchArcs()->addByCenterStartSweep(circleCentr, GetCirclePoint(radius, pivotAngelIsCenterOfArc ? pivotAngelInRadian - lengthRad / 2.0 : pivotAngelInRadian), lengthRad);
 }
 
 Ptr<SketchArc> AddArc(Ptr<Sketch> sketch, Ptr<Point3D> circleCentr, Ptr<Point3D> startPoint, Ptr<Point3D> endPoint)
 {
+    INSTRUMENT_OPERATION("AddArc");
     return sketch->sketchCurves()->sketchArcs()->addByCenterStartEnd(circleCentr, startPoint, endPoint);
 }
 
 Ptr<SketchLine> AddLine(Ptr<Sketch> sketch, Ptr<Base> startPoint, Ptr<Base> endPoint)
 {
+    INSTRUMENT_OPERATION("AddLine");
     return sketch->sketchCurves()->sketchLines()->addByTwoPoints(startPoint, endPoint);
 }
 
@@ -293,6 +344,7 @@ Ptr<ObjectCollection> AddRectangle(Ptr<Sketch> sketch, Ptr<Point3D> center, doub
 
 Ptr<RevolveFeature> Revolve(Ptr<Component> component, Ptr<Profile> profile, Ptr<ConstructionAxis> axis, double angelRad)
 {
+    INSTRUMENT_OPERATION("Revolve");
     auto revInput = component->features()->revolveFeatures()->createInput(profile, axis, FeatureOperations::NewBodyFeatureOperation);
     revInput->setAngleExtent(false, ValueInput::createByReal(angelRad));
     auto feature = component->features()->revolveFeatures()->add(revInput);
@@ -307,6 +359,7 @@ Ptr<RevolveFeature> Revolve(Ptr<Component> component, Ptr<Sketch> sketch, Ptr<Co
 
 Ptr<ExtrudeFeature> Extrude(Ptr<Component> component, Ptr<ObjectCollection> collection, double distance, bool isSymetric)
 {
+    INSTRUMENT_OPERATION("Extrude");
     auto input = component->features()->extrudeFeatures()->createInput(collection, FeatureOperations::NewBodyFeatureOperation);
     input->setDistanceExtent(isSymetric, ValueInput::createByReal(distance));
     auto feature = component->features()->extrudeFeatures()->add(input);
@@ -315,6 +368,7 @@ Ptr<ExtrudeFeature> Extrude(Ptr<Component> component, Ptr<ObjectCollection> coll
 
 Ptr<ExtrudeFeature> Extrude(Ptr<Component> component, Ptr<Profile> profile, double distance, bool isSymetric)
 {
+    INSTRUMENT_OPERATION("Extrude");
     auto input = component->features()->extrudeFeatures()->createInput(profile, FeatureOperations::NewBodyFeatureOperation);
     input->setDistanceExtent(isSymetric, ValueInput::createByReal(distance));
     auto feature = component->features()->extrudeFeatures()->add(input);
@@ -335,74 +389,116 @@ Ptr<ObjectCollection> ExtrudeAll(Ptr<Component> component, Ptr<Sketch> sketch, d
     return collection;
 }
 
-Ptr<BRepBody> Move(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, double distance, bool createCopy)
-{
-    auto moveBody = createCopy ? body->copyToComponent(component) : body;
-    auto moveFeatures = component->features()->moveFeatures();
-
-    auto collection = ObjectCollection::create();
-    collection->add(moveBody);
+static int designRevision = 0;
 
-    auto input = moveFeatures->createInput2(collection);
-    auto res = input->defineAsTranslateAlongEntity(axis, ValueInput::createByReal(distance));
-    moveFeatures->add(input);
-    
-    return moveBody;
+int GetDesignRevision()
+{
+    return designRevision;
 }
 
-Ptr<BRepBody> Rotate(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, double angel, bool createCopy)
+void MarkDesignModified()
 {
-	auto moveBody = createCopy ? body->copyToComponent(component) : body;
-	auto moveFeatures = component->features()->moveFeatures();
-
-	auto collection = ObjectCollection::create();
-	collection->add(moveBody);
-    
-    auto input = moveFeatures->createInput2(collection);
-    input->defineAsRotate(axis, ValueInput::createByReal(angel));
-	moveFeatures->add(input);
-	
-    return moveBody;
+    designRevision++;
 }
 
-Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2)
+Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2)
 {
-    return CreateCombineFeature(component, operation, body1, body2)->bodies()->item(0);
+    return CreateCombineFeature(component, operation, body1, createObjectCollection({ body2 }));
 }
 
-Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2)
+Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body, Ptr<ObjectCollection> toolBodies)
 {
+    INSTRUMENT_OPERATION("Combine");
     auto combineFeatures = component->features()->combineFeatures();
-
-    Ptr<ObjectCollection> collection = ObjectCollection::create();
-    collection->add(body2);
-
-    auto joinInput = combineFeatures->createInput(body1, collection);
+    auto joinInput = combineFeatures->createInput(body, toolBodies);
     joinInput->operation(operation);
+    MarkDesignModified();
     return combineFeatures->add(joinInput);
 }
 
 Ptr<FilletFeature> Fillet(Ptr<Component> component, Ptr<ObjectCollection> edges, double val)
 {
+	INSTRUMENT_OPERATION("Fillet");
 	auto filletFeatures = component->features()->filletFeatures();
 	auto filletInput = filletFeatures->createInput();
 	filletInput->addConstantRadiusEdgeSet(edges, ValueInput::createByReal(val), false);
+	MarkDesignModified();
 	return filletFeatures->add(filletInput);
 }
 
+Ptr<BRepBody> Mirror(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionPlane> plane, bool isJoined)
+{
+    INSTRUMENT_OPERATION("Mirror");
+    body = CommitBody(component, body);
+    auto mirrorFeatures = component->features()->mirrorFeatures();
+    auto input = mirrorFeatures->createInput(createObjectCollection({ body }), plane);
+    auto feature = mirrorFeatures->add(input);
+    MarkDesignModified();
+    auto mirrorBody = feature->bodies()->item(0);
+    return isJoined ? Combine(component, JoinFeatureOperation, body, mirrorBody) : mirrorBody;
+}
+
+Ptr<ObjectCollection> CircularPattern(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, int count, double angleStep, FeatureOperations operation)
+{
+    INSTRUMENT_OPERATION("CircularPattern");
+    if (operation != NewBodyFeatureOperation && operation != JoinFeatureOperation)
+        return nullptr;
+    auto isFullCircle = count > 1 && Equal(count * abs(angleStep), 2.0 * M_PI);
+    if (count > 1 && !isFullCircle && (count - 1) * abs(angleStep) > 2.0 * M_PI - 0.001)
+        return nullptr;
+
+    auto copies = ObjectCollection::create();
+    if (body->isTemporary())
+    {
+        for (int i = 1; i < count; i++)
+            copies->add(Rotate(component, body, axis, i * angleStep, true));
+    }
+    else if (count > 1)
+    {
+        // the instances spread evenly over the total angle, the last one on its end;
+        // over a full turn the last one is a step before the body
+        auto patternFeatures = component->features()->circularPatternFeatures();
+        auto input = patternFeatures->createInput(createObjectCollection({ body }), axis);
+        input->quantity(ValueInput::createByReal(count));
+        input->totalAngle(ValueInput::createByReal((isFullCircle ? count : count - 1) * angleStep));
+        input->isSymmetric(false);
+        auto feature = patternFeatures->add(input);
+        MarkDesignModified();
+        auto token = body->entityToken();
+        for (auto& copy : ToVector<BRepBody>(feature->bodies()))
+            if (copy->entityToken() != token)
+                copies->add(copy);
+    }
+
+    if (operation == JoinFeatureOperation)
+        return createObjectCollection({ Combine(component, JoinFeatureOperation, body, copies) });
+    auto bodies = createObjectCollection({ body });
+    for (int i = 0; i < copies->count(); i++)
+        bodies->add(copies->item(i));
+    return bodies;
+}
+
+bool IsSameShape(Ptr<BRepBody> body1, Ptr<BRepBody> body2, double volumeTolerance)
+{
+    auto volume1 = body1->volume();
+    auto volume2 = body2->volume();
+    if (abs(volume1 - volume2) > volumeTolerance * fmax(volume1, volume2))
+        return false;
+    auto box1 = body1->boundingBox();
+    auto box2 = body2->boundingBox();
+    return Equal(box1->minPoint(), box2->minPoint(), 0.01) && Equal(box1->maxPoint(), box2->maxPoint(), 0.01);
+}
+
 
 bool HasCommonEdge(Ptr<BRepFace> face1, Ptr<BRepFace> face2)
 {
-    for (auto edge1 : face1->edges())
-        for (auto edge2 : face2->edges())
-            if (edge1->entityToken() == edge2->entityToken() )
-                return true;
-    return false;
+    return getJoinedEdge(face1, face2) != nullptr;
 }
 
 
 Ptr<ObjectCollection> GetEdges(Ptr<BRepBody> body, std::function <bool(Ptr<BRepEdge>)> isGoodEdge)
 {
+	INSTRUMENT_OPERATION("GetEdges");
 	auto collection = ObjectCollection::create();
 	auto edges = body->edges();
 	for (int i = 0; i < edges->count(); i++)
@@ -417,6 +513,7 @@ Ptr<ObjectCollection> GetEdges(Ptr<BRepBody> body, std::function <bool(Ptr<BRepE
 
 Ptr<ObjectCollection> GetEdges(Ptr<ObjectCollection> edges, std::function <bool(Ptr<BRepEdge>)> isGoodEdge)
 {
+    INSTRUMENT_OPERATION("GetEdges");
     auto collection = ObjectCollection::create();
     
     for (int i = 0; i < edges->count(); i++)
@@ -431,15 +528,15 @@ Ptr<ObjectCollection> GetEdges(Ptr<ObjectCollection> edges, std::function <bool(
 
 Ptr<ObjectCollection> GetEdges(std::vector<Ptr<BRepFace>> joinedFaces, std::vector<Ptr<BRepFace>> unjoinedFaces)
 {
+    INSTRUMENT_OPERATION("GetEdges");
     auto collection = ObjectCollection::create();
-    auto unjoinedEdges = ObjectCollection::create();
+    // the unjoined edges and the ones taken already
+    EntityTokenSet skippedEdges;
     
     for (int i = 0; i < unjoinedFaces.size(); i++)
     {
-        auto face = unjoinedFaces[i];
-        auto edges = face->edges();
-        for (int j = 0; j < edges->count(); j++)
-            unjoinedEdges->add(edges->item(j));
+        auto tokens = GetEntityTokens(unjoinedFaces[i]->edges());
+        skippedEdges.insert(tokens.begin(), tokens.end());
     }
 
     for (int i = 0; i < joinedFaces.size(); i++)
@@ -449,7 +546,7 @@ Ptr<ObjectCollection> GetEdges(std::vector<Ptr<BRepFace>> joinedFaces, std::vect
         for (int j = 0; j < edges->count(); j++)
         {
             auto edge = edges->item(j);
-            if (unjoinedEdges->find(edge) < 0 && collection->find(edge) < 0)
+            if (skippedEdges.insert(edge->entityToken()).second)
                 collection->add(edge);
         }
     }
@@ -472,6 +569,7 @@ double GetMin(Ptr<ObjectCollection> items, std::function <double(Ptr<Base>)> get
 
 Ptr<ObjectCollection> GetProfiles(Ptr<Sketch> sketch, std::function <bool(Ptr<Profile>)> isGoodProfile)
 {
+    INSTRUMENT_OPERATION("GetProfiles");
     {
         auto collection = ObjectCollection::create();
         auto profiles = sketch->profiles();
@@ -486,6 +584,11 @@ Ptr<ObjectCollection> GetProfiles(Ptr<Sketch> sketch, std::function <bool(Ptr<Pr
     }
 }
 
+Ptr<ObjectCollection> GetProfiles(Ptr<Sketch> sketch)
+{
+    return GetProfiles(sketch, [](Ptr<Profile> profile) { return true; });
+}
+
 
 Ptr<Vector3D> ConstructionAxisToVector3D(Ptr<ConstructionAxis> axis)
 {
@@ -502,87 +605,131 @@ VectorPoint ConstructionAxisToVectorPoint(Ptr<ConstructionAxis> axis)
     return vectorPoint;
 }
 
-Ptr<BRepBody> CreateSphere(Ptr<Component> component, Ptr<Point3D> center, double radius)
+bool EdgeIsHorizontal(Ptr<BRepEdge> edge)
 {
-    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "SphereSketch");
-    auto startPoint = Point3D::create(-radius);
-    auto endPoint = Point3D::create(radius);
-    AddArc(sketch, Point3D::create(), startPoint, endPoint);
-    AddLine(sketch, startPoint, endPoint);
-    auto body = Revolve(component, sketch, component->xConstructionAxis(), RAD_360)->bodies()->item(0);
-    body = Move(component, body, component->xConstructionAxis(), center->x());
-    body = Move(component, body, component->yConstructionAxis(), center->y());
-    body = Move(component, body, component->zConstructionAxis(), center->z());
-    return body;
+    return Equal(abs(edge->startVertex()->geometry()->z() - edge->endVertex()->geometry()->z()), 0, 0.01) && !edge->isDegenerate();
 }
 
-Ptr<BRepBody> CreateCylinder(Ptr<Component> component, Ptr<Point3D> center, double radius, double height)
+bool EdgeIsVerticalLine(Ptr<BRepEdge> edge)
 {
-    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "CilinderSketch");
-    AddCircle(sketch, center, radius);
-    return Extrude(component, sketch->profiles()->item(0), height)->bodies()->item(0);
+    return Equal(abs(edge->startVertex()->geometry()->z() - edge->endVertex()->geometry()->z()), edge->length(), 0.01) && !edge->isDegenerate();
 }
 
-Ptr<BRepBody> CreateBox(Ptr<Component> component, Ptr<Point3D> point1, Ptr<Point3D> point2, double height)
+bool BodyContainPoint(Ptr<BRepBody> body, Ptr<Point3D> point)
 {
-    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "BoxSketch");
-    auto line1 = AddLine(sketch, Point3D::create(point1->x(), point1->y()), Point3D::create(point2->x(), point1->y()));
-    auto line2 = AddLine(sketch, line1->endSketchPoint()->geometry(), Point3D::create(point2->x(), point2->y()));
-    auto line3 = AddLine(sketch, line2->endSketchPoint()->geometry(), Point3D::create(point1->x(), point2->y()));
-    auto line4 = AddLine(sketch, line3->endSketchPoint()->geometry(), line1->startSketchPoint()->geometry());
-    return Extrude(component, sketch->profiles()->item(0), height)->bodies()->item(0);
+    INSTRUMENT_OPERATION("BodyContainPoint");
+    auto pointContainment = body->pointContainment(point);
+    return pointContainment == PointInsidePointContainment || pointContainment == PointOnPointContainment;
 }
 
-Ptr<BRepBody> CreateBox(Ptr<Component> component, Ptr<Point3D> point1, Ptr<Point3D> point2, double height, double verticalCornerFilletRadius)
+Ptr<SectionAnalysis> AddSectionAnalysis(Ptr<Component> component, Ptr<Base> plane, double distance)
 {
-    auto body = CreateBox(component, point1, point2, height);
-    if (verticalCornerFilletRadius > 0)
-    {
-        auto edges = GetEdges(body, EdgeIsVerticalLine);
-        Fillet(component, edges, verticalCornerFilletRadius);
-    }
-    return body;
+    INSTRUMENT_OPERATION("AddSectionAnalysis");
+    auto input = component->parentDesign()->analyses()->sectionAnalyses()->createInput(plane, distance);
+    return component->parentDesign()->analyses()->sectionAnalyses()->add(input);
 }
 
-Ptr<BRepBody> CreateBox(Ptr<Component> component, Ptr<Point3D> point1, Ptr<Point3D> point2, double height, double verticalCornerFilletRadius, double wallThicknness)
+static Ptr<TriangleMesh> CalculateMesh(Ptr<BRepBody> body)
 {
-    auto body = CreateBox(component, point1, point2, height, verticalCornerFilletRadius);
-    if (wallThicknness <= 0)
-        return body;
-    auto xMax = fmax(point1->x(), point2->x()) - wallThicknness;
-    auto xMin = fmin(point1->x(), point2->x()) + wallThicknness;
-    auto yMax = fmax(point1->y(), point2->y()) - wallThicknness;
-    auto yMin = fmin(point1->y(), point2->y()) + wallThicknness;
-    auto cutBody = CreateBox(component, Point3D::create(xMax, yMax), Point3D::create(xMin, yMin), height, verticalCornerFilletRadius - wallThicknness);
-    return Combine(component, CutFeatureOperation, body, cutBody);
+    INSTRUMENT_OPERATION("CalculateMesh");
+    auto calculator = GetNativeBody(body)->meshManager()->createMeshCalculator();
+    calculator->setQuality(TriangleMeshQualityOptions::HighQualityTriangleMesh);
+    return calculator->calculate();
 }
 
-bool EdgeIsHorizontal(Ptr<BRepEdge> edge)
+static bool WriteStl(const std::string& filepath, const std::vector<double>& coordinates, const std::vector<int>& indices)
 {
-    return Equal(abs(edge->startVertex()->geometry()->z() - edge->endVertex()->geometry()->z()), 0, 0.01) && !edge->isDegenerate();
+    INSTRUMENT_OPERATION("WriteStl");
+    StlWriter writer;
+    if (!writer.open(filepath, (uint32_t)(indices.size() / 3)))
+        return false;
+    auto getPoint = [&](int index) { return PlainPoint3D{ coordinates[3 * index], coordinates[3 * index + 1], coordinates[3 * index + 2] }; };
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        writer.addTriangle(getPoint(indices[i]), getPoint(indices[i + 1]), getPoint(indices[i + 2]));
+    return writer.close();
 }
 
-bool EdgeIsVerticalLine(Ptr<BRepEdge> edge)
+void SaveAsStl(Ptr<BRepBody> body, std::string filepath)
 {
-    return Equal(abs(edge->startVertex()->geometry()->z() - edge->endVertex()->geometry()->z()), edge->length(), 0.01) && !edge->isDegenerate();
+    SaveAllAsStl({ { body, filepath } });
 }
 
-bool BodyContainPoint(Ptr<BRepBody> body, Ptr<Point3D> point)
+static MeshBody ToMeshBody(const std::vector<double>& coordinates, const std::vector<int>& indices)
 {
-    auto pointContainment = body->pointContainment(point);
-    return pointContainment == PointInsidePointContainment || pointContainment == PointOnPointContainment;
+    MeshBody meshBody;
+    meshBody.vertices.reserve(coordinates.size() / 3);
+    for (size_t i = 0; i + 2 < coordinates.size(); i += 3)
+        meshBody.addVertex({ coordinates[i], coordinates[i + 1], coordinates[i + 2] });
+    meshBody.triangles.reserve(indices.size() / 3);
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        meshBody.addTriangle(indices[i], indices[i + 1], indices[i + 2]);
+    return meshBody;
 }
 
-Ptr<SectionAnalysis> AddSectionAnalysis(Ptr<Component> component, Ptr<Base> plane, double distance)
+bool SaveAllAsStl(const std::vector<std::pair<Ptr<BRepBody>, std::string>>& bodies, std::vector<MeshBody>* meshBodies)
 {
-    auto input = component->parentDesign()->analyses()->sectionAnalyses()->createInput(plane, distance);
-    return component->parentDesign()->analyses()->sectionAnalyses()->add(input);
+    INSTRUMENT_OPERATION("SaveAllAsStl");
+    // at most this many tessellated meshes are held while their files are written
+    const size_t maxWritingCount = 4;
+
+    struct StlMesh
+    {
+        std::vector<double> coordinates;
+        std::vector<int> indices;
+    };
+    // a mesh of a part placed many times is kept until its last file
+    std::unordered_map<std::string, int> remainingCounts;
+    for (auto& item : bodies)
+        remainingCounts[GetNativeBody(item.first)->entityToken()]++;
+    std::unordered_map<std::string, std::shared_ptr<const StlMesh>> sharedMeshes;
+
+    auto isOk = true;
+    std::deque<std::future<bool>> writings;
+    for (auto& item : bodies)
+    {
+        auto token = GetNativeBody(item.first)->entityToken();
+        auto stlMesh = sharedMeshes[token];
+        if (stlMesh == nullptr)
+        {
+            auto mesh = CalculateMesh(item.first);
+            if (mesh == nullptr)
+            {
+                isOk = false;
+                if (meshBodies != nullptr)
+                    meshBodies->push_back(MeshBody());
+                continue;
+            }
+            stlMesh = std::make_shared<const StlMesh>(StlMesh{ mesh->nodeCoordinatesAsDouble(), mesh->nodeIndices() });
+        }
+        if (meshBodies != nullptr)
+            meshBodies->push_back(ToMeshBody(stlMesh->coordinates, stlMesh->indices));
+        if (--remainingCounts[token] > 0)
+            sharedMeshes[token] = stlMesh;
+        else
+            sharedMeshes.erase(token);
+
+        if (writings.size() == maxWritingCount)
+        {
+            isOk = writings.front().get() && isOk;
+            writings.pop_front();
+        }
+        writings.push_back(std::async(std::launch::async, [filepath = item.second, stlMesh]()
+        {
+            return WriteStl(filepath, stlMesh->coordinates, stlMesh->indices);
+        }));
+    }
+    for (auto& writing : writings)
+        isOk = writing.get() && isOk;
+    return isOk;
 }
 
-void SaveAsStl(Ptr<BRepBody> body, std::string filepath)
+MeshBody GetMeshBody(Ptr<BRepBody> body, const std::string& name)
 {
-    auto exportManager = body->parentComponent()->parentDesign()->exportManager();
-    auto stlOptions = exportManager->createSTLExportOptions(body, filepath);
-    stlOptions->meshRefinement(MeshRefinementSettings::MeshRefinementHigh);
-    exportManager->execute(stlOptions);
+    INSTRUMENT_OPERATION("GetMeshBody");
+    MeshBody meshBody;
+    auto mesh = CalculateMesh(body);
+    if (mesh != nullptr)
+        meshBody = ToMeshBody(mesh->nodeCoordinatesAsDouble(), mesh->nodeIndices());
+    meshBody.name = name;
+    return meshBody;
 }
@@ -8,21 +8,12 @@
 #include <math.h>
 #include <initializer_list>
 #include "Geometry.h"
+#include "MeshBody.h"
 
 using namespace adsk::core;
 using namespace adsk::fusion;
 //using namespace adsk::cam;
 
-#define RAD_45  M_PI * 0.25
-#define RAD_90  M_PI * 0.5
-#define RAD_180 M_PI * 1.0
-#define RAD_360 M_PI * 2.0
-
-#define PLA_MOOVABLE_CLEARNCE 0.04
-#define PLA_UNMOOVABLE_CLEARNCE 0.02
-#define ABS_MOOVABLE_CLEARNCE 0.02
-#define ABS_UNMOOVABLE_CLEARNCE 0.01
-
 enum CubeFaceType {
     Top,
     Bottom,
@@ -39,6 +30,7 @@ struct VectorPoint
 };
 
 Ptr<Point3D> GetCenterPoint();
+Ptr<Point3D> ToPoint3D(const PlainPoint3D& point);
 Ptr<Point3D> GetCirclePoint(double radius, double angel);
 Ptr<Point3D> GetCirclePoint(Ptr<Point3D> circleCenter, double radius, double angel, bool saveZ = false);
 
@@ -48,7 +40,6 @@ Ptr<BoundingBox3D> CutShell(Ptr<BoundingBox3D> box, double shellThickness);
 bool Equal(double a, double b, double delta = 0.001);
 bool Equal(Ptr<Point3D> p1, Ptr<Point3D> p2, double delta = 0.001);
 bool Equal(Ptr<SketchLine> line, Ptr<BRepEdge> edge, double delta = 0.001);
-bool EqualAny(Ptr<BRepEdge> edge, Ptr<SketchLines> lines, double delta = 0.001);
 bool isPointOnFace(Ptr<BRepFace> face, Ptr<Point3D> point, double tolerance = 0.01);
 bool isPointOnEdge(Ptr<BRepEdge> edge, Ptr<Point3D> point, double tolerance = 0.01);
 Ptr<Point3D> getPointOnSphere(Ptr<Point3D> center, double radius, Ptr<Vector3D> vector);
@@ -77,6 +68,18 @@ Ptr<ConstructionPoint> AddConstructionPoint(Ptr<Component> component, Ptr<Base>
 Ptr<ConstructionAxis> AddConstructionAxis(Ptr<Component> component, Ptr<Point3D> point, Ptr<Vector3D> vector);
 Ptr<ConstructionAxis> AddConstructionAxis(Ptr<Component> component, Ptr<Vector3D> vector);
 
+// Instancing: a part is built once in its own component and placed by occurrences that
+// only move it. The bodies of an occurrence are proxies of the bodies of its component.
+Ptr<Occurrence> AddComponentOccurrence(Ptr<Component> component, std::string name, Ptr<Vector3D> translation = nullptr);
+Ptr<Occurrence> AddOccurrence(Ptr<Component> component, Ptr<Component> instancedComponent, Ptr<Vector3D> translation);
+// Removes every occurrence of the instanced component, the component goes with the last one.
+void DeleteOccurrences(Ptr<Component> component, Ptr<Component> instancedComponent);
+// The component body of an occurrence proxy, any other body as it is.
+Ptr<BRepBody> GetNativeBody(Ptr<BRepBody> body);
+// Builds the body once in a new component and places the component at every translation,
+// returns the component body.
+Ptr<BRepBody> CreateInstancedBody(Ptr<Component> component, std::string name, const std::vector<Ptr<Vector3D>>& translations, std::function<Ptr<BRepBody>(Ptr<Component>)> createBody);
+
 Ptr<SketchCircle> AddCircle(Ptr<Sketch> sketch, Ptr<Point3D> circleCentr, double radius);
 Ptr<SketchArc> AddArc(Ptr<Sketch> sketch, Ptr<Point3D> circleCentr, double radius, double length, double pivotAngelInRadian, bool pivotAngelIsCenterOfArc = true);
 Ptr<SketchArc> AddArc(Ptr<Sketch> sketch, Ptr<Point3D> circleCentr, Ptr<Point3D> startPoint, Ptr<Point3D> endPoint);
@@ -91,11 +94,44 @@ Ptr<ExtrudeFeature> Extrude(Ptr<Component> component, Ptr<Profile> profile, doub
 Ptr<ExtrudeFeature> Extrude(Ptr<Component> component, Ptr<Sketch> sketch, double distance, bool isSymetric = false);
 Ptr<ObjectCollection> ExtrudeAll(Ptr<Component> component, Ptr<Sketch> sketch, double distance, bool isSymetric = false);
 
+// Transient primitives: while on, CreateCylinder, CreateBox and CreateSphere make
+// temporary bodies that take no timeline entries, and Move, Rotate and Combine keep
+// temporary bodies temporary. A temporary body gets into the design through CommitBody
+// as one base feature, or through Combine with a design body. Fillets and the other
+// features need design bodies, so commit before taking edges. A temporary boolean that
+// fails is done again as a combine feature of the committed bodies.
+void SetTransientPrimitives(bool isOn);
+bool IsTransientPrimitives();
+// Adds a temporary body to the component, design bodies are returned as they are.
+Ptr<BRepBody> CommitBody(Ptr<Component> component, Ptr<BRepBody> body);
+
+// Counts the changes of the design bodies made through the helpers below, cached body
+// data is stale once it differs. Code that changes design bodies by other means calls
+// MarkDesignModified itself.
+int GetDesignRevision();
+void MarkDesignModified();
+
 Ptr<BRepBody> Move(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, double distance, bool createCopy = false);
 Ptr<BRepBody> Rotate(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, double angel, bool createCopy = false);
 Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2);
+// All tool bodies in one combine feature. Temporary tools are joined to one body first,
+// so they take one commit. An intersect still needs one feature per tool.
+Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body, Ptr<ObjectCollection> toolBodies);
+Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body, Ptr<BRepBodies> toolBodies);
 Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2);
+Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body, Ptr<ObjectCollection> toolBodies);
 Ptr<FilletFeature> Fillet(Ptr<Component> component, Ptr<ObjectCollection> edges, double val);
+// Mirrors a copy of the body over the plane, the copy is joined to the body when isJoined.
+Ptr<BRepBody> Mirror(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionPlane> plane, bool isJoined = true);
+// count - 1 copies of the body turned by angleStep, 2 * angleStep and so on around the axis, by
+// one circular pattern feature. NewBodyFeatureOperation returns the body and its copies,
+// JoinFeatureOperation joins the copies to the body by one combine and returns just it.
+// Temporary bodies are copied and joined as temporary ones. count * angleStep of a full
+// turn spreads the copies evenly over the circle; copies reaching a full turn would land
+// on the body. Those and the other operations, which have no target, return nullptr.
+Ptr<ObjectCollection> CircularPattern(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, int count, double angleStep, FeatureOperations operation);
+// The same volume within the relative tolerance and the same bounds within 0.01.
+bool IsSameShape(Ptr<BRepBody> body1, Ptr<BRepBody> body2, double volumeTolerance = 0.001);
 
 bool HasCommonEdge(Ptr<BRepFace> face1, Ptr<BRepFace> face2);
 
@@ -105,6 +141,7 @@ Ptr<ObjectCollection> GetEdges(std::vector<Ptr<BRepFace>> joinedFaces, std::vect
 double GetMin(Ptr<ObjectCollection> items, std::function <double(Ptr<Base>)> getValue);
 
 Ptr<ObjectCollection> GetProfiles(Ptr<Sketch> sketch, std::function <bool(Ptr<Profile>)> isGoodProfile);
+Ptr<ObjectCollection> GetProfiles(Ptr<Sketch> sketch);
 
 Ptr<Vector3D> ConstructionAxisToVector3D(Ptr<ConstructionAxis> axis);
 VectorPoint ConstructionAxisToVectorPoint(Ptr<ConstructionAxis> axis);
@@ -124,6 +161,14 @@ bool BodyContainPoint(Ptr<BRepBody> body, Ptr<Point3D> point);
 Ptr<SectionAnalysis> AddSectionAnalysis(Ptr<Component> component, Ptr<Base> plane, double distance);
 
 void SaveAsStl(Ptr<BRepBody> body, std::string filepath);
+// Tessellates the bodies one by one on this thread, as the Fusion API requires, and
+// writes the finished meshes to their files on worker threads meanwhile. Occurrence
+// proxies are saved as their component bodies, so the instances of a part are
+// tessellated once. meshBodies, when given, gets the same tessellations as indexed
+// meshes in the order of bodies, empty where one failed.
+bool SaveAllAsStl(const std::vector<std::pair<Ptr<BRepBody>, std::string>>& bodies, std::vector<MeshBody>* meshBodies = nullptr);
+// The tessellation SaveAsStl writes, as an indexed mesh. Empty when it fails.
+MeshBody GetMeshBody(Ptr<BRepBody> body, const std::string& name);
 
 //template <typename T> std::vector<T> Where(std::vector<T> collection, std::function <bool(T)> isGoodItem);
 //template <class T> std::vector<Ptr<T>> ToVector(Ptr<ObjectCollection> collection);
@@ -0,0 +1,236 @@
+#include "FusionEnvironment.h"
+#include "Instrumentation.h"
+
+static bool isTransientPrimitives = false;
+
+void SetTransientPrimitives(bool isOn)
+{
+    isTransientPrimitives = isOn;
+}
+
+bool IsTransientPrimitives()
+{
+    return isTransientPrimitives;
+}
+
+Ptr<BRepBody> CommitBody(Ptr<Component> component, Ptr<BRepBody> body)
+{
+    if (body == nullptr || !body->isTemporary())
+        return body;
+    INSTRUMENT_OPERATION("CommitBody");
+    if (component->parentDesign()->designType() == DirectDesignType)
+    {
+        MarkDesignModified();
+        return component->bRepBodies()->add(body);
+    }
+    auto baseFeature = component->features()->baseFeatures()->add();
+    baseFeature->startEdit();
+    auto result = component->bRepBodies()->add(body, baseFeature);
+    baseFeature->finishEdit();
+    MarkDesignModified();
+    return result;
+}
+
+static Ptr<BRepBody> TransformTemporary(Ptr<BRepBody> body, Ptr<Matrix3D> matrix, bool createCopy)
+{
+    auto manager = TemporaryBRepManager::get();
+    auto moveBody = createCopy ? manager->copy(body) : body;
+    manager->transform(moveBody, matrix);
+    return moveBody;
+}
+
+Ptr<BRepBody> Move(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, double distance, bool createCopy)
+{
+    INSTRUMENT_OPERATION("Move");
+    if (body->isTemporary())
+    {
+        auto vector = ConstructionAxisToVector3D(axis);
+        vector->normalize();
+        vector->scaleBy(distance);
+        auto matrix = Matrix3D::create();
+        matrix->translation(vector);
+        return TransformTemporary(body, matrix, createCopy);
+    }
+
+    auto moveBody = createCopy ? body->copyToComponent(component) : body;
+    auto moveFeatures = component->features()->moveFeatures();
+
+    auto collection = ObjectCollection::create();
+    collection->add(moveBody);
+
+    auto input = moveFeatures->createInput2(collection);
+    input->defineAsTranslateAlongEntity(axis, ValueInput::createByReal(distance));
+    moveFeatures->add(input);
+    MarkDesignModified();
+    
+    return moveBody;
+}
+
+Ptr<BRepBody> Rotate(Ptr<Component> component, Ptr<BRepBody> body, Ptr<ConstructionAxis> axis, double angel, bool createCopy)
+{
+	INSTRUMENT_OPERATION("Rotate");
+    if (body->isTemporary())
+    {
+        auto vectorPoint = ConstructionAxisToVectorPoint(axis);
+        auto matrix = Matrix3D::create();
+        matrix->setToRotation(angel, vectorPoint.vector, vectorPoint.point);
+        return TransformTemporary(body, matrix, createCopy);
+    }
+
+	auto moveBody = createCopy ? body->copyToComponent(component) : body;
+	auto moveFeatures = component->features()->moveFeatures();
+
+	auto collection = ObjectCollection::create();
+	collection->add(moveBody);
+    
+    auto input = moveFeatures->createInput2(collection);
+    input->defineAsRotate(axis, ValueInput::createByReal(angel));
+	moveFeatures->add(input);
+	MarkDesignModified();
+	
+    return moveBody;
+}
+
+Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2)
+{
+    if (body1->isTemporary() && body2->isTemporary())
+    {
+        INSTRUMENT_OPERATION("CombineTemporary");
+        auto booleanType = operation == JoinFeatureOperation ? UnionBooleanType : (operation == CutFeatureOperation ? DifferenceBooleanType : IntersectionBooleanType);
+        if (TemporaryBRepManager::get()->booleanOperation(body1, body2, booleanType))
+            return body1;
+        // a failed boolean leaves the bodies as they were, the combine feature of them may still work
+    }
+    body1 = CommitBody(component, body1);
+    body2 = CommitBody(component, body2);
+    return CreateCombineFeature(component, operation, body1, body2)->bodies()->item(0);
+}
+
+Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body, Ptr<ObjectCollection> toolBodies)
+{
+    // several tools of one intersect keep only what is common to all of them
+    if (operation == IntersectFeatureOperation)
+    {
+        for (size_t i = 0; i < toolBodies->count(); i++)
+            body = Combine(component, operation, body, toolBodies->item(i)->cast<BRepBody>());
+        return body;
+    }
+
+    Ptr<BRepBody> temporaryTool = nullptr;
+    auto tools = ObjectCollection::create();
+    for (size_t i = 0; i < toolBodies->count(); i++)
+    {
+        auto tool = toolBodies->item(i)->cast<BRepBody>();
+        if (!tool->isTemporary())
+            tools->add(tool);
+        else if (temporaryTool == nullptr)
+            temporaryTool = tool;
+        else
+            temporaryTool = Combine(component, JoinFeatureOperation, temporaryTool, tool);
+    }
+    if (tools->count() == 0)
+        return temporaryTool == nullptr ? body : Combine(component, operation, body, temporaryTool);
+    if (temporaryTool != nullptr)
+        tools->add(CommitBody(component, temporaryTool));
+    return CreateCombineFeature(component, operation, CommitBody(component, body), tools)->bodies()->item(0);
+}
+
+Ptr<BRepBody> Combine(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body, Ptr<BRepBodies> toolBodies)
+{
+    auto collection = ObjectCollection::create();
+    for (size_t i = 0; i < toolBodies->count(); i++)
+        collection->add(toolBodies->item(i));
+    return Combine(component, operation, body, collection);
+}
+
+Ptr<BRepBody> CreateSphere(Ptr<Component> component, Ptr<Point3D> center, double radius)
+{
+    INSTRUMENT_OPERATION("CreateSphere");
+    if (isTransientPrimitives)
+        return TemporaryBRepManager::get()->createSphere(center, radius);
+
+    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "SphereSketch");
+    auto startPoint = Point3D::create(-radius);
+    auto endPoint = Point3D::create(radius);
+    AddArc(sketch, Point3D::create(), startPoint, endPoint);
+    AddLine(sketch, startPoint, endPoint);
+    auto body = Revolve(component, sketch, component->xConstructionAxis(), RAD_360)->bodies()->item(0);
+    body = Move(component, body, component->xConstructionAxis(), center->x());
+    body = Move(component, body, component->yConstructionAxis(), center->y());
+    body = Move(component, body, component->zConstructionAxis(), center->z());
+    return body;
+}
+
+Ptr<BRepBody> CreateCylinder(Ptr<Component> component, Ptr<Point3D> center, double radius, double height)
+{
+    INSTRUMENT_OPERATION("CreateCylinder");
+    if (isTransientPrimitives)
+    {
+        // the sketch circle of the feature path is on the XY plane
+        auto bottom = Point3D::create(center->x(), center->y(), 0);
+        auto top = Point3D::create(center->x(), center->y(), height);
+        return TemporaryBRepManager::get()->createCylinderOrCone(bottom, radius, top, radius);
+    }
+
+    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "CilinderSketch");
+    AddCircle(sketch, center, radius);
+    return Extrude(component, sketch->profiles()->item(0), height)->bodies()->item(0);
+}
+
+Ptr<BRepBody> CreateBox(Ptr<Component> component, Ptr<Point3D> point1, Ptr<Point3D> point2, double height)
+{
+    INSTRUMENT_OPERATION("CreateBox");
+    if (isTransientPrimitives)
+    {
+        auto center = Point3D::create((point1->x() + point2->x()) / 2.0, (point1->y() + point2->y()) / 2.0, height / 2.0);
+        auto box = OrientedBoundingBox3D::create(center, Vector3D::create(1, 0, 0), Vector3D::create(0, 1, 0), fabs(point2->x() - point1->x()), fabs(point2->y() - point1->y()), height);
+        return TemporaryBRepManager::get()->createBox(box);
+    }
+
+    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "BoxSketch");
+    auto line1 = AddLine(sketch, Point3D::create(point1->x(), point1->y()), Point3D::create(point2->x(), point1->y()));
+    auto line2 = AddLine(sketch, line1->endSketchPoint()->geometry(), Point3D::create(point2->x(), point2->y()));
+    auto line3 = AddLine(sketch, line2->endSketchPoint()->geometry(), Point3D::create(point1->x(), point2->y()));
+    auto line4 = AddLine(sketch, line3->endSketchPoint()->geometry(), line1->startSketchPoint()->geometry());
+    return Extrude(component, sketch->profiles()->item(0), height)->bodies()->item(0);
+}
+
+Ptr<BRepBody> CreateBox(Ptr<Component> component, Ptr<Point3D> point1, Ptr<Point3D> point2, double height, double verticalCornerFilletRadius)
+{
+    if (isTransientPrimitives && verticalCornerFilletRadius > 0)
+    {
+        // the rounded corners as a cross of two boxes and four cylinders, not a fillet
+        auto xMax = fmax(point1->x(), point2->x());
+        auto xMin = fmin(point1->x(), point2->x());
+        auto yMax = fmax(point1->y(), point2->y());
+        auto yMin = fmin(point1->y(), point2->y());
+        auto radius = verticalCornerFilletRadius;
+        auto body = CreateBox(component, Point3D::create(xMin + radius, yMin), Point3D::create(xMax - radius, yMax), height);
+        body = Combine(component, JoinFeatureOperation, body, CreateBox(component, Point3D::create(xMin, yMin + radius), Point3D::create(xMax, yMax - radius), height));
+        for (auto x : { xMin + radius, xMax - radius })
+            for (auto y : { yMin + radius, yMax - radius })
+                body = Combine(component, JoinFeatureOperation, body, CreateCylinder(component, Point3D::create(x, y), radius, height));
+        return body;
+    }
+
+    auto body = CreateBox(component, point1, point2, height);
+    if (verticalCornerFilletRadius > 0)
+    {
+        auto edges = GetEdges(body, EdgeIsVerticalLine);
+        Fillet(component, edges, verticalCornerFilletRadius);
+    }
+    return body;
+}
+
+Ptr<BRepBody> CreateBox(Ptr<Component> component, Ptr<Point3D> point1, Ptr<Point3D> point2, double height, double verticalCornerFilletRadius, double wallThicknness)
+{
+    auto body = CreateBox(component, point1, point2, height, verticalCornerFilletRadius);
+    if (wallThicknness <= 0)
+        return body;
+    auto xMax = fmax(point1->x(), point2->x()) - wallThicknness;
+    auto xMin = fmin(point1->x(), point2->x()) + wallThicknness;
+    auto yMax = fmax(point1->y(), point2->y()) - wallThicknness;
+    auto yMin = fmin(point1->y(), point2->y()) + wallThicknness;
+    auto cutBody = CreateBox(component, Point3D::create(xMax, yMax), Point3D::create(xMin, yMin), height, verticalCornerFilletRadius - wallThicknness);
+    return Combine(component, CutFeatureOperation, body, cutBody);
+}
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "GearMesh.h"
+#include "StlWriter.h"
+#include <algorithm>
+
+void GetGearOutline(const GearToothProfile& profile, int toothCount, double chordTolerance, std::vector<double>& xs, std::vector<double>& ys)
+{
+    xs.clear();
+    ys.clear();
+    auto flankCount = (int)profile.flankXs.size();
+    if (flankCount == 0 || toothCount < 1)
+        return;
+
+    // one tooth from the lower root up the flank, over the tip and down the mirrored flank
+    std::vector<double> toothXs, toothYs;
+    auto add = [&](double x, double y)
+    {
+        toothXs.push_back(x);
+        toothYs.push_back(y);
+    };
+    if (profile.hasRootLine)
+        add(profile.rootX, profile.rootY);
+    for (int i = 0; i < flankCount; i++)
+        add(profile.flankXs[i], profile.flankYs[i]);
+    for (size_t i = 0; i < profile.tipXs.size(); i++)
+        add(profile.tipXs[i], profile.tipYs[i]);
+    for (int i = (int)profile.tipXs.size() - 2; i >= 0; i--)
+        add(profile.tipXs[i], -profile.tipYs[i]);
+    // a pointed tooth has its flanks meet on the axis
+    for (int i = profile.isPointed() ? flankCount - 2 : flankCount - 1; i >= 0; i--)
+        add(profile.flankXs[i], -profile.flankYs[i]);
+    if (profile.hasRootLine)
+        add(profile.rootX, -profile.rootY);
+
+    // the root arc to the next tooth, without its ends
+    auto rootRadius = profile.dimensions.rootRadius;
+    auto pitchAngle = 2.0 * M_PI / toothCount;
+    auto rootStartAngle = -atan2(toothYs[0], toothXs[0]);
+    auto rootAngle = pitchAngle - 2.0 * rootStartAngle;
+    std::vector<double> rootXs, rootYs;
+    if (rootAngle > 0)
+    {
+        auto rootSegmentCount = GetArcSegmentCount(rootRadius, rootAngle, chordTolerance);
+        for (int i = 1; i < rootSegmentCount; i++)
+        {
+            auto angle = rootStartAngle + rootAngle * i / rootSegmentCount;
+            rootXs.push_back(rootRadius * cos(angle));
+            rootYs.push_back(rootRadius * sin(angle));
+        }
+    }
+
+    auto toothPointCount = toothXs.size() + rootXs.size();
+    xs.reserve(toothPointCount * toothCount);
+    ys.reserve(toothPointCount * toothCount);
+    for (int k = 0; k < toothCount; k++)
+    {
+        auto angleCos = cos(pitchAngle * k);
+        auto angleSin = sin(pitchAngle * k);
+        for (int pass = 0; pass < 2; pass++)
+        {
+            auto& partXs = pass == 0 ? toothXs : rootXs;
+            auto& partYs = pass == 0 ? toothYs : rootYs;
+            for (size_t i = 0; i < partXs.size(); i++)
+            {
+                xs.push_back(partXs[i] * angleCos - partYs[i] * angleSin);
+                ys.push_back(partXs[i] * angleSin + partYs[i] * angleCos);
+            }
+        }
+    }
+}
+
+namespace
+{
+    // Everything the triangles need, with a vertex given as layer * stride + point: the points
+    // are the outline, then the ring of the hole or of the cap middle, then the center.
+    struct GearMeshLayout
+    {
+        std::vector<double> xs;
+        std::vector<double> ys;
+        uint32_t outlineCount = 0;
+        uint32_t ringCount = 0;
+        bool hasHole = false;
+        std::vector<double> layerCoses;
+        std::vector<double> layerSins;
+        std::vector<double> layerZs;
+        // counter-clockwise from above, in points
+        std::vector<MeshTriangle> capTriangles;
+
+        uint32_t stride() const { return outlineCount + ringCount + 1; }
+        uint32_t layerCount() const { return (uint32_t)layerZs.size() - 1; }
+
+        uint32_t triangleCount() const
+        {
+            auto sideCount = outlineCount + (hasHole ? ringCount : 0);
+            return 2 * sideCount * layerCount() + 2 * (uint32_t)capTriangles.size();
+        }
+
+        PlainPoint3D point(uint32_t vertex) const
+        {
+            auto layer = vertex / stride();
+            auto index = vertex % stride();
+            return { xs[index] * layerCoses[layer] - ys[index] * layerSins[layer],
+                xs[index] * layerSins[layer] + ys[index] * layerCoses[layer], layerZs[layer] };
+        }
+    };
+
+    bool CreateGearMeshLayout(const GearMeshParams& params, GearMeshLayout& layout)
+    {
+        auto toothCount = params.gear.toothCount;
+        if (toothCount < 1 || params.thickness <= 0 || params.chordTolerance <= 0)
+            return false;
+        auto profile = GetGearToothProfile(params.gear, params.chordTolerance);
+        GetGearOutline(profile, toothCount, params.chordTolerance, layout.xs, layout.ys);
+        auto outlineCount = (uint32_t)layout.xs.size();
+        if (outlineCount < 3)
+            return false;
+        // the teeth must not overlap at the root
+        auto rootStartAngle = atan2(layout.ys[0], layout.xs[0]);
+        if (2.0 * M_PI / toothCount + 2.0 * rootStartAngle <= 0)
+            return false;
+
+        auto rootRadius = profile.dimensions.rootRadius;
+        auto holeRadius = params.holeDiameter / 2.0;
+        layout.hasHole = holeRadius > 0;
+        if (layout.hasHole && holeRadius >= rootRadius)
+            return false;
+        auto ringRadius = layout.hasHole ? holeRadius : rootRadius / 2.0;
+        // a ring point in the middle of every tooth at least, the radial root lines only face those
+        auto ringCount = (uint32_t)toothCount;
+        if (layout.hasHole)
+        {
+            auto segmentCount = (uint32_t)GetArcSegmentCount(holeRadius, 2.0 * M_PI, params.chordTolerance);
+            ringCount *= (segmentCount + toothCount - 1) / toothCount;
+        }
+        std::vector<double> ringAngles(ringCount + 1);
+        for (uint32_t i = 0; i <= ringCount; i++)
+        {
+            ringAngles[i] = 2.0 * M_PI * i / ringCount;
+            if (i < ringCount)
+            {
+                layout.xs.push_back(ringRadius * cos(ringAngles[i]));
+                layout.ys.push_back(ringRadius * sin(ringAngles[i]));
+            }
+        }
+        layout.xs.push_back(0);
+        layout.ys.push_back(0);
+        layout.outlineCount = outlineCount;
+        layout.ringCount = ringCount;
+
+        // The outline is star shaped around the center, so the cap is zipped between it and the
+        // ring by the polar angles, the smaller next one first, unless its triangle would turn
+        // clockwise where a flank or a root line runs along a ray.
+        std::vector<double> outlineAngles(outlineCount + 1);
+        outlineAngles[0] = rootStartAngle;
+        for (uint32_t j = 1; j <= outlineCount; j++)
+        {
+            auto index = j % outlineCount;
+            auto angle = atan2(layout.ys[index], layout.xs[index]) - outlineAngles[j - 1];
+            angle -= 2.0 * M_PI * floor((angle + M_PI) / (2.0 * M_PI));
+            outlineAngles[j] = outlineAngles[j - 1] + angle;
+        }
+        auto isCounterClockwise = [&](uint32_t a, uint32_t b, uint32_t c)
+        {
+            auto& xs = layout.xs;
+            auto& ys = layout.ys;
+            return (xs[b] - xs[a]) * (ys[c] - ys[a]) - (ys[b] - ys[a]) * (xs[c] - xs[a]) > 0;
+        };
+        auto& caps = layout.capTriangles;
+        caps.clear();
+        uint32_t i = 0, j = 0;
+        while (i < ringCount || j < outlineCount)
+        {
+            auto ring = outlineCount + i % ringCount;
+            auto nextRing = outlineCount + (i + 1) % ringCount;
+            auto outline = j % outlineCount;
+            auto nextOutline = (j + 1) % outlineCount;
+            auto canRing = i < ringCount && isCounterClockwise(ring, outline, nextRing);
+            auto canOutline = j < outlineCount && isCounterClockwise(ring, outline, nextOutline);
+            if (canRing == canOutline)
+                canRing = j == outlineCount || (i < ringCount && ringAngles[i + 1] <= outlineAngles[j + 1]);
+            if (canRing)
+            {
+                caps.push_back({ ring, outline, nextRing });
+                i++;
+            }
+            else
+            {
+                caps.push_back({ ring, outline, nextOutline });
+                j++;
+            }
+        }
+        if (!layout.hasHole)
+        {
+            auto center = outlineCount + ringCount;
+            for (uint32_t k = 0; k < ringCount; k++)
+                caps.push_back({ center, outlineCount + k, outlineCount + (k + 1) % ringCount });
+        }
+
+        // the helix between two layers is a chord of the outside circle
+        auto outsideRadius = std::max(profile.dimensions.outsideRadius, profile.tipRadius());
+        auto layerCount = params.layerCount;
+        if (layerCount <= 0)
+        {
+            layerCount = params.isHerringbone
+                ? 2 * GetArcSegmentCount(outsideRadius, fabs(params.twist) / 2.0, params.chordTolerance)
+                : GetArcSegmentCount(outsideRadius, fabs(params.twist), params.chordTolerance);
+        }
+        if (params.isHerringbone)
+            layerCount += layerCount % 2;
+        layout.layerCoses.resize(layerCount + 1);
+        layout.layerSins.resize(layerCount + 1);
+        layout.layerZs.resize(layerCount + 1);
+        for (int layer = 0; layer <= layerCount; layer++)
+        {
+            auto z = params.thickness * layer / layerCount;
+            auto turn = params.isHerringbone ? std::min(z, params.thickness - z) : z;
+            auto angle = params.twist * turn / params.thickness;
+            layout.layerCoses[layer] = cos(angle);
+            layout.layerSins[layer] = sin(angle);
+            layout.layerZs[layer] = z;
+        }
+        return true;
+    }
+
+    // Calls add with the vertices of every triangle, counter-clockwise from outside.
+    template <typename Add>
+    void AddGearTriangles(const GearMeshLayout& layout, Add add)
+    {
+        auto stride = layout.stride();
+        auto outlineCount = layout.outlineCount;
+        auto ringCount = layout.ringCount;
+        for (uint32_t layer = 0; layer < layout.layerCount(); layer++)
+        {
+            auto bottom = layer * stride;
+            auto top = bottom + stride;
+            for (uint32_t i = 0; i < outlineCount; i++)
+            {
+                auto j = (i + 1) % outlineCount;
+                add(bottom + i, bottom + j, top + j);
+                add(bottom + i, top + j, top + i);
+            }
+            if (!layout.hasHole)
+                continue;
+            for (uint32_t i = outlineCount; i < outlineCount + ringCount; i++)
+            {
+                auto j = outlineCount + (i + 1 - outlineCount) % ringCount;
+                add(bottom + i, top + j, bottom + j);
+                add(bottom + i, top + i, top + j);
+            }
+        }
+        auto top = layout.layerCount() * stride;
+        for (auto& triangle : layout.capTriangles)
+        {
+            add(triangle.a, triangle.c, triangle.b);
+            add(top + triangle.a, top + triangle.b, top + triangle.c);
+        }
+    }
+}
+
+MeshBody CreateGearMesh(const GearMeshParams& params)
+{
+    MeshBody body;
+    GearMeshLayout layout;
+    if (!CreateGearMeshLayout(params, layout))
+        return body;
+
+    // only the vertices the triangles use: the middle layers have no cap ring
+    std::vector<uint32_t> indexes(layout.stride() * (layout.layerCount() + 1), UINT32_MAX);
+    auto index = [&](uint32_t vertex)
+    {
+        if (indexes[vertex] == UINT32_MAX)
+            indexes[vertex] = body.addVertex(layout.point(vertex));
+        return indexes[vertex];
+    };
+    body.triangles.reserve(layout.triangleCount());
+    AddGearTriangles(layout, [&](uint32_t a, uint32_t b, uint32_t c)
+    {
+        auto indexA = index(a);
+        auto indexB = index(b);
+        body.addTriangle(indexA, indexB, index(c));
+    });
+    return body;
+}
+
+uint32_t GetGearMeshTriangleCount(const GearMeshParams& params)
+{
+    GearMeshLayout layout;
+    return CreateGearMeshLayout(params, layout) ? layout.triangleCount() : 0;
+}
+
+bool SaveGearAsStl(const GearMeshParams& params, const std::string& filepath)
+{
+    GearMeshLayout layout;
+    if (!CreateGearMeshLayout(params, layout))
+        return false;
+    StlWriter writer;
+    if (!writer.open(filepath, layout.triangleCount(), "Gear"))
+        return false;
+    AddGearTriangles(layout, [&](uint32_t a, uint32_t b, uint32_t c)
+    {
+        writer.addTriangle(layout.point(a), layout.point(b), layout.point(c));
+    });
+    return writer.close();
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include "GearProfile.h"
+#include "MeshBody.h"
+
+// The gear of drawGear extruded straight into a mesh, no sweep: the outline is turned layer
+// by layer up the thickness. A point of the side turns twist * z / thickness like the
+// twistAngle of the sweep, a herringbone one turns back the same way from the middle up.
+struct GearMeshParams
+{
+    GearParams gear;
+    double thickness = 1;
+    double twist = 0;
+    bool isHerringbone = false;
+    double holeDiameter = 0;
+    // The flanks, arcs and the helix between layers stay within it at the outside circle.
+    double chordTolerance = 0.001;
+    int layerCount = 0; // 0 - from chordTolerance, rounded up to even for a herringbone
+};
+
+// The closed counter-clockwise outline of all teeth on the XY plane, tooth 0 on the x axis.
+void GetGearOutline(const GearToothProfile& profile, int toothCount, double chordTolerance, std::vector<double>& xs, std::vector<double>& ys);
+
+// Watertight with every edge shared by two triangles. Empty for an invalid gear or a hole
+// that does not fit inside the root circle.
+MeshBody CreateGearMesh(const GearMeshParams& params);
+uint32_t GetGearMeshTriangleCount(const GearMeshParams& params);
+// The same triangles as CreateGearMesh streamed to the file, a layer at a time.
+bool SaveGearAsStl(const GearMeshParams& params, const std::string& filepath);
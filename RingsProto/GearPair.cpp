@@ -0,0 +1,254 @@
+#include "GearPair.h"
+#include <algorithm>
+#include <initializer_list>
+
+namespace
+{
+    double GetToothThickness(const GearDimensions& dimensions, double pressureAngle, double radius)
+    {
+        auto radiusPressureAngle = acos(std::min(1.0, dimensions.baseRadius / radius));
+        return 2.0 * radius * (dimensions.pitchHalfAngle + GetInvolute(pressureAngle) - GetInvolute(radiusPressureAngle));
+    }
+
+    // the contact path length the tip gives, up to where it would leave the other involute
+    double GetApproachLength(double tipRadius, double baseRadius, double otherStartRadius, double otherBaseRadius, double lineLength)
+    {
+        auto length = sqrt(std::max(0.0, tipRadius * tipRadius - baseRadius * baseRadius));
+        auto otherStart = sqrt(std::max(0.0, otherStartRadius * otherStartRadius - otherBaseRadius * otherBaseRadius));
+        return std::min(length, lineLength - otherStart);
+    }
+
+    double WrapAngle(double angle)
+    {
+        return angle - FULL_CIRCLE_RAD * floor(angle / FULL_CIRCLE_RAD);
+    }
+
+    // the side of a tooth that faces the other gear, in polar coordinates about its center:
+    // the mirror of the profile's flank, from the root to the tip middle
+    struct ToothSide
+    {
+        std::vector<double> radii;
+        std::vector<double> angles;
+
+        explicit ToothSide(const GearToothProfile& profile)
+        {
+            if (profile.hasRootLine)
+                add(profile.rootX, -profile.rootY);
+            for (size_t i = 0; i < profile.flankXs.size(); i++)
+                add(profile.flankXs[i], -profile.flankYs[i]);
+            for (size_t i = 0; i < profile.tipXs.size(); i++)
+                add(profile.tipXs[i], -profile.tipYs[i]);
+        }
+
+        void add(double x, double y)
+        {
+            radii.push_back(sqrt(x * x + y * y));
+            angles.push_back(atan2(y, x));
+        }
+    };
+
+    // a tooth side placed on the plane
+    struct PlacedSide
+    {
+        std::vector<double> xs;
+        std::vector<double> ys;
+        double minX, minY, maxX, maxY;
+
+        void place(const ToothSide& side, double centerX, double rotation)
+        {
+            auto count = side.radii.size();
+            xs.resize(count);
+            ys.resize(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                xs[i] = centerX + side.radii[i] * cos(side.angles[i] + rotation);
+                ys[i] = side.radii[i] * sin(side.angles[i] + rotation);
+            }
+            minX = *std::min_element(xs.begin(), xs.end());
+            maxX = *std::max_element(xs.begin(), xs.end());
+            minY = *std::min_element(ys.begin(), ys.end());
+            maxY = *std::max_element(ys.begin(), ys.end());
+        }
+    };
+
+    // The smallest counterclockwise turn of gear2 about (centerX, 0) in [0, 2pi) that brings
+    // a point on the circle of radius from pointAngle onto the segment. When isSegmentTurned
+    // the segment is gear2's and turns onto the fixed point, the turn is then pointAngle - hit.
+    double GetContactTurn(double centerX, double radius, double pointAngle, double ax, double ay, double bx, double by, bool isSegmentTurned)
+    {
+        auto dx = bx - ax;
+        auto dy = by - ay;
+        auto fx = ax - centerX;
+        auto a = dx * dx + dy * dy;
+        auto b = 2.0 * (fx * dx + ay * dy);
+        auto c = fx * fx + ay * ay - radius * radius;
+        auto discriminant = b * b - 4.0 * a * c;
+        if (a == 0 || discriminant < 0)
+            return HUGE_VAL;
+
+        auto result = HUGE_VAL;
+        auto root = sqrt(discriminant);
+        for (auto t : { (-b - root) / (2.0 * a), (-b + root) / (2.0 * a) })
+        {
+            if (t < 0 || t > 1)
+                continue;
+            auto hitAngle = atan2(ay + t * dy, fx + t * dx);
+            result = std::min(result, WrapAngle(isSegmentTurned ? pointAngle - hitAngle : hitAngle - pointAngle));
+        }
+        return result;
+    }
+
+    double GetContactTurn(const PlacedSide& points, bool isPointsTurned, const PlacedSide& segments, double centerX, double startTurn)
+    {
+        auto result = HUGE_VAL;
+        for (size_t i = 0; i < points.xs.size(); i++)
+        {
+            auto x = points.xs[i] - centerX;
+            auto y = points.ys[i];
+            auto radius = sqrt(x * x + y * y);
+            // start the turn backed off, so the sides are apart
+            auto angle = atan2(y, x) + (isPointsTurned ? startTurn : -startTurn);
+            for (size_t j = 0; j + 1 < segments.xs.size(); j++)
+            {
+                auto turn = GetContactTurn(centerX, radius, angle, segments.xs[j], segments.ys[j], segments.xs[j + 1], segments.ys[j + 1], !isPointsTurned);
+                result = std::min(result, turn);
+            }
+        }
+        return result + startTurn;
+    }
+
+    // the teeth whose middle is within span of angle 0, numbered from -toothCount / 2 on so
+    // the teeth below the axis count back from tooth 0
+    std::vector<int> GetNearTeeth(int toothCount, double rotation, double span)
+    {
+        std::vector<int> teeth;
+        for (int k = -toothCount / 2; k < toothCount - toothCount / 2; k++)
+        {
+            auto offset = WrapAngle(rotation + FULL_CIRCLE_RAD * k / toothCount + M_PI) - M_PI;
+            if (fabs(offset) <= span)
+                teeth.push_back(k);
+        }
+        return teeth;
+    }
+
+    // the half angle the other gear's outside circle covers, seen from the center
+    double GetMeshSpan(double outsideRadius, double otherOutsideRadius, double centerDistance)
+    {
+        if (centerDistance <= otherOutsideRadius)
+            return M_PI;
+        auto crossing = (centerDistance * centerDistance + outsideRadius * outsideRadius - otherOutsideRadius * otherOutsideRadius) / (2.0 * centerDistance * outsideRadius);
+        auto span = asin(otherOutsideRadius / centerDistance);
+        return crossing >= 1 ? span : std::min(span, acos(std::max(-1.0, crossing)));
+    }
+
+    double GetTransmissionError(const GearPairParams& params, const GearPairAnalysis& analysis, int sampleCount, double chordTolerance)
+    {
+        auto profile1 = GetGearToothProfile(params.gear1, chordTolerance);
+        auto profile2 = GetGearToothProfile(params.gear2, chordTolerance);
+        if (profile1.flankXs.empty() || profile2.flankXs.empty())
+            return NAN;
+        ToothSide side1(profile1);
+        ToothSide side2(profile2);
+
+        auto count1 = params.gear1.toothCount;
+        auto count2 = params.gear2.toothCount;
+        auto centerX = analysis.centerDistance;
+        auto pitchAngle1 = FULL_CIRCLE_RAD / count1;
+        auto pitchAngle2 = FULL_CIRCLE_RAD / count2;
+        auto outsideRadius1 = profile1.dimensions.outsideRadius;
+        auto outsideRadius2 = profile2.dimensions.outsideRadius;
+        auto span = GetMeshSpan(outsideRadius1, outsideRadius2, centerX) + pitchAngle1;
+        // gear2 turns up to half a pitch on the way to the contact
+        auto margin = outsideRadius2 * pitchAngle2 / 2.0;
+        auto startTurn = -pitchAngle2 / 2.0;
+
+        auto minTurn = HUGE_VAL;
+        auto maxTurn = -HUGE_VAL;
+        PlacedSide tooth1;
+        PlacedSide tooth2;
+        for (int sample = 0; sample < sampleCount; sample++)
+        {
+            // At rest gear2 has a space across from gear1's tooth 0, and its tooth -1 above
+            // faces tooth 0's driving side. Only such facing teeth are paired: backed off by
+            // half a pitch, a tooth of gear2 runs into the tooth of gear1 behind it.
+            auto rotation1 = pitchAngle1 * sample / sampleCount;
+            auto rotation2 = M_PI + pitchAngle2 / 2.0 - rotation1 * count1 / count2;
+            auto turn = HUGE_VAL;
+            for (auto k : GetNearTeeth(count1, rotation1, span))
+            {
+                tooth1.place(side1, 0, rotation1 + pitchAngle1 * k);
+                tooth2.place(side2, centerX, rotation2 - pitchAngle2 * (k + 1));
+                if (tooth1.maxX < tooth2.minX - margin || tooth1.minX > tooth2.maxX + margin
+                    || tooth1.maxY < tooth2.minY - margin || tooth1.minY > tooth2.maxY + margin)
+                    continue;
+                turn = std::min(turn, GetContactTurn(tooth2, true, tooth1, centerX, startTurn));
+                turn = std::min(turn, GetContactTurn(tooth1, false, tooth2, centerX, startTurn));
+            }
+            if (turn == HUGE_VAL)
+                return NAN;
+            minTurn = std::min(minTurn, turn);
+            maxTurn = std::max(maxTurn, turn);
+        }
+        return (maxTurn - minTurn) * profile2.dimensions.baseRadius / cos(analysis.operatingPressureAngle);
+    }
+}
+
+bool GearPairAnalysis::isRunning() const
+{
+    return !isMismatched && contactRatio >= 1.0 && !isUndercut1 && !isUndercut2 && !isTipInterference() && !isBinding();
+}
+
+GearPairAnalysis AnalyzeGearPair(const GearPairParams& params, int sampleCount, double chordTolerance)
+{
+    GearPairAnalysis analysis;
+    auto& gear1 = params.gear1;
+    auto& gear2 = params.gear2;
+    if (gear1.toothCount < 1 || gear2.toothCount < 1 || fabs(gear1.diametralPitch - gear2.diametralPitch) > 1e-9
+        || fabs(gear1.pressureAngle - gear2.pressureAngle) > 1e-9)
+    {
+        analysis.isMismatched = true;
+        return analysis;
+    }
+
+    auto profile1 = GetGearToothProfile(gear1, 0.0001);
+    auto profile2 = GetGearToothProfile(gear2, 0.0001);
+    auto& dimensions1 = profile1.dimensions;
+    auto& dimensions2 = profile2.dimensions;
+    auto delta = params.printerHorizontalDelta;
+
+    auto standardDistance = dimensions1.pitchRadius + dimensions2.pitchRadius;
+    auto centerDistance = params.centerDistance > 0 ? params.centerDistance : standardDistance;
+    auto pressureAngle = acos(std::min(1.0, standardDistance * cos(gear1.pressureAngle) / centerDistance));
+    analysis.centerDistance = centerDistance;
+    analysis.operatingPressureAngle = pressureAngle;
+    analysis.isPointed1 = profile1.isPointed();
+    analysis.isPointed2 = profile2.isPointed();
+
+    // the line of action runs between the points it touches the base circles
+    auto tipRadius1 = profile1.tipRadius();
+    auto tipRadius2 = profile2.tipRadius();
+    auto lineLength = centerDistance * sin(pressureAngle);
+    auto startRadius1 = std::max(dimensions1.baseRadius, dimensions1.rootRadius);
+    auto startRadius2 = std::max(dimensions2.baseRadius, dimensions2.rootRadius);
+    auto recessLength = GetApproachLength(tipRadius1, dimensions1.baseRadius, startRadius2, dimensions2.baseRadius, lineLength);
+    auto approachLength = GetApproachLength(tipRadius2, dimensions2.baseRadius, startRadius1, dimensions1.baseRadius, lineLength);
+    auto basePitch = FULL_CIRCLE_RAD * dimensions1.baseRadius / gear1.toothCount;
+    analysis.contactRatio = std::max(0.0, recessLength + approachLength - lineLength) / basePitch;
+    analysis.isUndercut1 = sqrt(std::max(0.0, tipRadius2 * tipRadius2 - dimensions2.baseRadius * dimensions2.baseRadius)) > lineLength;
+    analysis.isUndercut2 = sqrt(std::max(0.0, tipRadius1 * tipRadius1 - dimensions1.baseRadius * dimensions1.baseRadius)) > lineLength;
+
+    // the printed tips grow out and the printed roots grow in by delta
+    analysis.tipClearance = std::min(centerDistance - tipRadius1 - dimensions2.rootRadius, centerDistance - tipRadius2 - dimensions1.rootRadius) - 2.0 * delta;
+
+    // the space of one gear less the tooth of the other on the operating pitch circles, every
+    // printed flank takes delta / cos off it
+    auto operatingRadius1 = dimensions1.baseRadius / cos(pressureAngle);
+    auto operatingRadius2 = dimensions2.baseRadius / cos(pressureAngle);
+    analysis.backlash = FULL_CIRCLE_RAD * operatingRadius1 / gear1.toothCount - GetToothThickness(dimensions1, gear1.pressureAngle, operatingRadius1)
+        - GetToothThickness(dimensions2, gear2.pressureAngle, operatingRadius2);
+    analysis.effectiveBacklash = analysis.backlash - 4.0 * delta / cos(pressureAngle);
+
+    if (sampleCount > 0)
+        analysis.transmissionError = GetTransmissionError(params, analysis, sampleCount, chordTolerance);
+    return analysis;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include "GearProfile.h"
+
+// below it a backlash is round-off, the backlash of a gear drawn with none comes out as -3e-17
+#define GEAR_BACKLASH_TOLERANCE 1e-9
+
+// Two gears of drawGear running together, gear1 driving. The printed contours grow by
+// printerHorizontalDelta on every side, like the holes of DexpSpurGear make up for.
+struct GearPairParams
+{
+    GearParams gear1;
+    GearParams gear2;
+    double printerHorizontalDelta = 0;
+    double centerDistance = 0; // 0 - the sum of the pitch radii
+};
+
+// Lengths in cm, backlash and transmission error along the operating pitch circle.
+struct GearPairAnalysis
+{
+    bool isMismatched = false;   // different modules or pressure angles, nothing else is set
+    double centerDistance = 0;
+    double operatingPressureAngle = 0;
+    double contactRatio = 0;     // mean teeth in contact, below 1 the gears jump
+    bool isUndercut1 = false;    // gear2's tips run below gear1's base circle, off the involute
+    bool isUndercut2 = false;
+    double tipClearance = 0;     // smallest gap between a printed tip and the other root circle
+    double backlash = 0;         // as drawn
+    double effectiveBacklash = 0; // as printed, negative binds
+    double transmissionError = 0; // peak to peak lag of gear2 over a mesh cycle
+    bool isPointed1 = false;
+    bool isPointed2 = false;
+
+    bool isTipInterference() const { return tipClearance < 0; }
+    bool isBinding() const { return effectiveBacklash < -GEAR_BACKLASH_TOLERANCE; }
+    bool isRunning() const;
+};
+
+// The transmission error turns gear1 through one tooth in sampleCount steps and finds for each
+// how far gear2 turns until one of its flanks touches one of gear1's driving flanks, on the
+// sampled profiles of chordTolerance. sampleCount 0 skips it, everything else is closed form.
+GearPairAnalysis AnalyzeGearPair(const GearPairParams& params, int sampleCount = 32, double chordTolerance = 0.0001);
\ No newline at end of file
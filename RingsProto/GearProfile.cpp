@@ -0,0 +1,136 @@
+#include "GearProfile.h"
+#include <algorithm>
+
+GearDimensions GetGearDimensions(const GearParams& params)
+{
+    // drawGear works in centimeters
+    auto diametralPitch = params.diametralPitch / 2.54;
+
+    double dedendum;
+    if (diametralPitch < (20 * (M_PI / 180.0)) - 0.000001)
+        dedendum = 1.557 / diametralPitch;
+    else if (M_PI / diametralPitch >= 20.0)
+        dedendum = 1.65 / diametralPitch;
+    else
+        dedendum = (1.70 / diametralPitch) + (.002 * 2.54);
+
+    GearDimensions dimensions;
+    dimensions.module = 1.0 / diametralPitch;
+    dimensions.pitchRadius = params.toothCount / diametralPitch / 2.0;
+    dimensions.baseRadius = dimensions.pitchRadius * cos(params.pressureAngle);
+    dimensions.outsideRadius = dimensions.pitchRadius + dimensions.module;
+    dimensions.rootRadius = dimensions.pitchRadius - dedendum;
+    dimensions.pitchHalfAngle = M_PI / (2.0 * params.toothCount) - params.backlash / dimensions.pitchRadius * 0.25;
+    return dimensions;
+}
+
+double GetInvolute(double pressureAngle)
+{
+    return tan(pressureAngle) - pressureAngle;
+}
+
+double GetInvoluteRoll(double baseRadius, double radius)
+{
+    return radius <= baseRadius ? 0 : sqrt(radius * radius - baseRadius * baseRadius) / baseRadius;
+}
+
+void EvaluateInvolute(double baseRadius, double rotation, const double* rolls, int count, double* xs, double* ys)
+{
+    auto rotationCos = cos(rotation);
+    auto rotationSin = sin(rotation);
+    for (int i = 0; i < count; i++)
+    {
+        auto roll = rolls[i];
+        auto rollCos = cos(roll);
+        auto rollSin = sin(roll);
+        auto x = baseRadius * (rollCos + roll * rollSin);
+        auto y = baseRadius * (rollSin - roll * rollCos);
+        xs[i] = x * rotationCos - y * rotationSin;
+        ys[i] = x * rotationSin + y * rotationCos;
+    }
+}
+
+int GetArcSegmentCount(double radius, double angle, double chordTolerance)
+{
+    if (radius <= chordTolerance || chordTolerance <= 0)
+        return 1;
+    auto segmentAngle = 2.0 * acos(1.0 - chordTolerance / radius);
+    return std::max(1, (int)ceil(fabs(angle) / segmentAngle));
+}
+
+double GearToothProfile::tipRadius() const
+{
+    if (flankXs.empty())
+        return 0;
+    return sqrt(flankXs.back() * flankXs.back() + flankYs.back() * flankYs.back());
+}
+
+GearToothProfile GetGearToothProfile(const GearParams& params, double chordTolerance)
+{
+    GearToothProfile profile;
+    auto& dimensions = profile.dimensions = GetGearDimensions(params);
+    auto baseRadius = dimensions.baseRadius;
+    if (params.toothCount < 1 || baseRadius <= 0 || chordTolerance <= 0)
+        return profile;
+
+    // the involute point of roll t lies at polar angle t - atan(t), the flank is turned so
+    // its pitch point is pitchHalfAngle below the axis
+    auto rotation = -(GetInvolute(params.pressureAngle) + dimensions.pitchHalfAngle);
+    auto startRoll = GetInvoluteRoll(baseRadius, dimensions.rootRadius);
+    auto endRoll = GetInvoluteRoll(baseRadius, dimensions.outsideRadius);
+
+    // the flanks meet on the axis before the outside circle: end at the meeting point
+    auto isPointed = endRoll - atan(endRoll) + rotation > 0;
+    if (isPointed)
+    {
+        auto roll = endRoll;
+        for (int i = 0; i < 50; i++)
+        {
+            // d(t - atan t)/dt = t^2 / (1 + t^2)
+            auto step = (roll - atan(roll) + rotation) * (1.0 + roll * roll) / std::max(roll * roll, 1e-12);
+            roll = std::max(startRoll, roll - step);
+            if (fabs(step) < 1e-15)
+                break;
+        }
+        endRoll = roll;
+    }
+
+    // The sagitta of a chord of roll step dt is about baseRadius * t * dt^2 / 8 with the
+    // curvature radius baseRadius * t, so steps even in u = 2/3 t^(3/2) keep it constant.
+    auto startU = 2.0 / 3.0 * pow(startRoll, 1.5);
+    auto endU = 2.0 / 3.0 * pow(endRoll, 1.5);
+    auto uStep = sqrt(8.0 * chordTolerance / baseRadius);
+    auto segmentCount = std::max(4, (int)ceil((endU - startU) / uStep));
+
+    std::vector<double> rolls(segmentCount + 1);
+    for (int i = 0; i <= segmentCount; i++)
+        rolls[i] = pow(1.5 * (startU + (endU - startU) * i / segmentCount), 2.0 / 3.0);
+    rolls[0] = startRoll;
+    rolls[segmentCount] = endRoll;
+    profile.flankXs.resize(segmentCount + 1);
+    profile.flankYs.resize(segmentCount + 1);
+    EvaluateInvolute(baseRadius, rotation, rolls.data(), segmentCount + 1, profile.flankXs.data(), profile.flankYs.data());
+
+    if (isPointed)
+        profile.flankYs.back() = 0;
+    else
+    {
+        auto tipAngle = endRoll - atan(endRoll) + rotation;
+        auto tipSegmentCount = GetArcSegmentCount(dimensions.outsideRadius, tipAngle, chordTolerance);
+        for (int i = 1; i <= tipSegmentCount; i++)
+        {
+            auto angle = tipAngle * (tipSegmentCount - i) / tipSegmentCount;
+            profile.tipXs.push_back(dimensions.outsideRadius * cos(angle));
+            profile.tipYs.push_back(dimensions.outsideRadius * sin(angle));
+        }
+    }
+
+    if (baseRadius > dimensions.rootRadius)
+    {
+        auto startAngle = rotation;
+        profile.hasRootLine = true;
+        profile.rootX = dimensions.rootRadius * cos(startAngle);
+        profile.rootY = dimensions.rootRadius * sin(startAngle);
+    }
+    return profile;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include "Geometry.h"
+#include <vector>
+
+// The spur gear of drawGear as plain numbers. diametralPitch is teeth per inch of pitch
+// diameter (25.4 / module in mm), the angles are radians and the lengths centimeters.
+struct GearParams
+{
+    double diametralPitch = 2.0;
+    int toothCount = 24;
+    double pressureAngle = 20.0 * M_PI / 180.0;
+    double backlash = 0;
+};
+
+struct GearDimensions
+{
+    double module = 0; // pitch diameter per tooth, cm
+    double pitchRadius = 0;
+    double baseRadius = 0;
+    double outsideRadius = 0;
+    double rootRadius = 0;
+    // half the angle the tooth spans on the pitch circle, backlash taken off
+    double pitchHalfAngle = 0;
+};
+
+GearDimensions GetGearDimensions(const GearParams& params);
+
+// tan(angle) - angle, the polar angle of the involute point with this pressure angle
+double GetInvolute(double pressureAngle);
+// the roll angle of the involute point at radius, 0 on the base circle
+double GetInvoluteRoll(double baseRadius, double radius);
+// The involute of the base circle at every roll angle, turned by rotation. A plain loop over
+// the arrays with no branches, so the compilers vectorize it.
+void EvaluateInvolute(double baseRadius, double rotation, const double* rolls, int count, double* xs, double* ys);
+
+// One tooth with its middle on the x axis, sampled so no chord is further than chordTolerance
+// from the curve. The tooth is symmetric: only the flank below the axis and the half of the
+// tip arc are given, the other half is (x, -y).
+struct GearToothProfile
+{
+    GearDimensions dimensions;
+    // from the root end, on the base circle or the root one whichever is outer, to the tip
+    std::vector<double> flankXs;
+    std::vector<double> flankYs;
+    // from the flank end to the x axis, empty when the flanks meet below the outside circle
+    std::vector<double> tipXs;
+    std::vector<double> tipYs;
+    // the root circle point the flank starts a radial line from when the base circle is above it
+    bool hasRootLine = false;
+    double rootX = 0;
+    double rootY = 0;
+
+    bool isPointed() const { return tipXs.empty(); }
+    double tipRadius() const;
+};
+
+GearToothProfile GetGearToothProfile(const GearParams& params, double chordTolerance);
+
+// the chords an arc of radius and angle needs to stay within chordTolerance, at least 1
+int GetArcSegmentCount(double radius, double angle, double chordTolerance);
\ No newline at end of file
@@ -5,6 +5,23 @@
 constexpr auto FULL_CIRCLE_DEG = 360.0;
 constexpr auto FULL_CIRCLE_RAD = 2 * M_PI;
 
+#define RAD_45  M_PI * 0.25
+#define RAD_90  M_PI * 0.5
+#define RAD_180 M_PI * 1.0
+#define RAD_360 M_PI * 2.0
+
+#define PLA_MOOVABLE_CLEARNCE 0.04
+#define PLA_UNMOOVABLE_CLEARNCE 0.02
+#define ABS_MOOVABLE_CLEARNCE 0.02
+#define ABS_UNMOOVABLE_CLEARNCE 0.01
+
+struct PlainPoint3D
+{
+    double x = 0;
+    double y = 0;
+    double z = 0;
+};
+
 double DegreesToRadians(double degrees);
 double GetAngleOfRegularPolygon(int n);
 double GetTriangleSideLength(double side1, double side2, double angleInRadians);
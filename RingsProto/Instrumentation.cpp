@@ -0,0 +1,199 @@
+#include "Instrumentation.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const int histogramSize = 8;
+    // upper bounds in seconds, the last bucket takes the rest
+    const double histogramLimits[histogramSize - 1] = { 0.001, 0.004, 0.016, 0.064, 0.256, 1.0, 4.0 };
+    const char* histogramNames[histogramSize] = { "<1ms", "<4ms", "<16ms", "<64ms", "<256ms", "<1s", "<4s", ">=4s" };
+    const char* noPart = "-";
+    // part scopes are listed as this operation of the part
+    const char* partTotal = "(part total)";
+
+    struct OperationStats
+    {
+        int count = 0;
+        double totalTime = 0;
+        double maxTime = 0;
+        long long memoryDelta = 0;
+        int histogram[histogramSize] = {};
+    };
+
+    struct TraceEvent
+    {
+        const char* name;
+        const char* part;
+        double startTime;
+        double duration;
+        long long memoryDelta;
+        int threadIndex;
+    };
+
+    // by part and operation
+    typedef std::map<std::pair<std::string, std::string>, OperationStats> StatsMap;
+
+    std::mutex recordMutex;
+    StatsMap operationStats;
+    std::vector<TraceEvent> traceEvents;
+    std::atomic<int> threadCount(0);
+    thread_local const char* currentPart = nullptr;
+    thread_local int threadIndex = threadCount++;
+
+    double GetTime()
+    {
+        static auto startTime = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    size_t GetResidentMemory()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.WorkingSetSize;
+        return 0;
+#else
+        long totalPages = 0;
+        long residentPages = 0;
+        auto file = fopen("/proc/self/statm", "r");
+        if (file == nullptr)
+            return 0;
+        if (fscanf(file, "%ld %ld", &totalPages, &residentPages) != 2)
+            residentPages = 0;
+        fclose(file);
+        return (size_t)residentPages * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    void Record(const char* name, const char* part, double startTime, double duration, long long memoryDelta)
+    {
+        std::lock_guard<std::mutex> lock(recordMutex);
+        auto& stats = operationStats[{ part, name }];
+        stats.count++;
+        stats.totalTime += duration;
+        stats.maxTime = std::max(stats.maxTime, duration);
+        stats.memoryDelta += memoryDelta;
+        auto bucket = 0;
+        while (bucket < histogramSize - 1 && duration >= histogramLimits[bucket])
+            bucket++;
+        stats.histogram[bucket]++;
+        traceEvents.push_back({ name, part, startTime, duration, memoryDelta, threadIndex });
+    }
+
+    void WriteJsonString(FILE* file, const char* text)
+    {
+        fputc('"', file);
+        for (; *text != 0; text++)
+        {
+            if (*text == '"' || *text == '\\')
+                fputc('\\', file);
+            fputc(*text, file);
+        }
+        fputc('"', file);
+    }
+
+    bool WriteTable(const std::string& filepath, const StatsMap& stats)
+    {
+        auto file = fopen(filepath.c_str(), "w");
+        if (file == nullptr)
+            return false;
+
+        // the most expensive first, that is what to optimize
+        std::vector<const StatsMap::value_type*> rows;
+        for (auto& item : stats)
+            rows.push_back(&item);
+        std::stable_sort(rows.begin(), rows.end(), [](const StatsMap::value_type* a, const StatsMap::value_type* b) { return a->second.totalTime > b->second.totalTime; });
+
+        fprintf(file, "%-24s %-24s %8s %10s %10s %10s %10s", "part", "operation", "count", "total s", "mean ms", "max ms", "rss MB");
+        for (auto name : histogramNames)
+            fprintf(file, " %7s", name);
+        fprintf(file, "\n");
+        for (auto row : rows)
+        {
+            auto& item = row->second;
+            fprintf(file, "%-24s %-24s %8d %10.3f %10.3f %10.3f %10.2f", row->first.first.c_str(), row->first.second.c_str(), item.count,
+                item.totalTime, 1000.0 * item.totalTime / item.count, 1000.0 * item.maxTime, item.memoryDelta / 1048576.0);
+            for (auto count : item.histogram)
+                fprintf(file, " %7d", count);
+            fprintf(file, "\n");
+        }
+        return fclose(file) == 0;
+    }
+
+    bool WriteTrace(const std::string& filepath, const std::vector<TraceEvent>& events)
+    {
+        auto file = fopen(filepath.c_str(), "w");
+        if (file == nullptr)
+            return false;
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            auto& event = events[i];
+            auto isPart = event.name == partTotal;
+            fprintf(file, "{\"name\":");
+            WriteJsonString(file, isPart ? event.part : event.name);
+            fprintf(file, ",\"cat\":");
+            WriteJsonString(file, isPart ? "part" : event.part);
+            fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.1f,\"dur\":%.1f,\"args\":{\"rssDeltaKB\":%lld}}%s\n",
+                event.threadIndex, 1e6 * event.startTime, 1e6 * event.duration, event.memoryDelta / 1024, i + 1 < events.size() ? "," : "");
+        }
+        fprintf(file, "]}\n");
+        return fclose(file) == 0;
+    }
+}
+
+InstrumentationScope::InstrumentationScope(const char* name, bool isPart) : name(name), parentPart(currentPart), isPart(isPart)
+{
+    if (isPart)
+        currentPart = name;
+    startMemory = GetResidentMemory();
+    startTime = GetTime();
+}
+
+InstrumentationScope::~InstrumentationScope()
+{
+    auto duration = GetTime() - startTime;
+    auto memoryDelta = (long long)GetResidentMemory() - (long long)startMemory;
+    if (isPart)
+    {
+        currentPart = parentPart;
+        Record(partTotal, name, startTime, duration, memoryDelta);
+    }
+    else
+        Record(name, currentPart != nullptr ? currentPart : noPart, startTime, duration, memoryDelta);
+}
+
+bool WriteInstrumentationReport(const std::string& path)
+{
+    StatsMap stats;
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(recordMutex);
+        stats.swap(operationStats);
+        events.swap(traceEvents);
+    }
+    // parents before their children when they start together
+    std::stable_sort(events.begin(), events.end(), [](const TraceEvent& a, const TraceEvent& b)
+    {
+        return a.startTime < b.startTime || (a.startTime == b.startTime && a.duration > b.duration);
+    });
+    auto isOk = WriteTable(path + ".txt", stats);
+    return WriteTrace(path + ".json", events) && isOk;
+}
\ No newline at end of file
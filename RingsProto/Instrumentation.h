@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+
+// Timing and memory instrumentation of the Fusion helpers. It is compiled in only when
+// RINGS_INSTRUMENTATION is defined (add it to the preprocessor definitions of the
+// project), otherwise the macros are empty and cost nothing.
+//
+// INSTRUMENT_OPERATION marks one helper call, INSTRUMENT_PART marks the part builder
+// the calls below it belong to. Every operation records its time and the change of
+// the process resident memory; times of nested operations are inclusive.
+// INSTRUMENT_REPORT(path) writes path.txt with a table per part and operation and
+// path.json with every call for chrome://tracing or https://ui.perfetto.dev.
+
+#ifdef RINGS_INSTRUMENTATION
+
+#define INSTRUMENT_CONCAT_INNER(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_INNER(a, b)
+#define INSTRUMENT_OPERATION(name) InstrumentationScope INSTRUMENT_CONCAT(instrumentationScope, __LINE__)(name, false)
+#define INSTRUMENT_PART(name) InstrumentationScope INSTRUMENT_CONCAT(instrumentationScope, __LINE__)(name, true)
+#define INSTRUMENT_REPORT(path) WriteInstrumentationReport(path)
+
+#else
+
+#define INSTRUMENT_OPERATION(name)
+#define INSTRUMENT_PART(name)
+#define INSTRUMENT_REPORT(path) (true)
+
+#endif
+
+class InstrumentationScope
+{
+public:
+    // name must be a literal, only the pointer is kept
+    InstrumentationScope(const char* name, bool isPart);
+    ~InstrumentationScope();
+
+private:
+    const char* name;
+    const char* parentPart;
+    bool isPart;
+    double startTime;
+    size_t startMemory;
+
+    InstrumentationScope(const InstrumentationScope&) = delete;
+    InstrumentationScope& operator=(const InstrumentationScope&) = delete;
+};
+
+// Writes the report of everything recorded so far and starts recording anew.
+bool WriteInstrumentationReport(const std::string& path);
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include "FusionEnvironment.h"
+#include "Instrumentation.h"
+#include "PartLayouts.h"
 
 class LinkingPart
 {
@@ -16,23 +18,53 @@ public:
     FloorStates floorState = Top;
     bool isReverse = false;
     Ptr<BRepBody> joinedBody = nullptr;
+
+    void setLayout(const LinkingPartLayout& layout)
+    {
+        radius = layout.radius;
+        height = layout.height;
+        z = layout.z;
+        wallThickness = layout.wallThickness;
+        floorThickness = layout.floorThickness;
+        floorHoleRadius = layout.floorHoleRadius;
+        floorState = layout.isFloorOnTop ? Top : Down;
+        isReverse = layout.isReverse;
+    }
   
     Ptr<BRepBody> createBody(Ptr<Component> component)
     {
+        return createBodies(component, { center });
+    }
+
+    // Linkers at all the centers, joined to joinedBody when it is set. All cylinders go
+    // in one join and all holes in one cut, so the linkers must not overlap. Without
+    // centers joinedBody is returned as it is, nullptr when it is not set.
+    Ptr<BRepBody> createBodies(Ptr<Component> component, const std::vector<Ptr<Point3D>>& centers)
+    {
+        INSTRUMENT_PART("LinkingPart");
+        if (centers.empty())
+            return joinedBody;
         auto direction = isReverse ? -1 : 1;
-        
-        auto body = createCylinder(component, center, radius, height, z);
-        if (joinedBody != nullptr)
-            body = Combine(component, JoinFeatureOperation, body, joinedBody);
-        auto cutBody = createCylinder(component, center, radius - wallThickness, height - floorThickness, z + direction * (floorState == Top ? 0 : floorThickness));
-        body = Combine(component, CutFeatureOperation, body, cutBody);
-        if (floorHoleRadius > 0 && floorThickness > 0)
+
+        auto bodies = ObjectCollection::create();
+        auto cutBodies = ObjectCollection::create();
+        for (auto& linkerCenter : centers)
         {
-            
-            auto cutFloorBody = createCylinder(component, center, floorHoleRadius, floorThickness, z + direction * (floorState == Top ? height - floorThickness : 0));
-            body = Combine(component, CutFeatureOperation, body, cutFloorBody);
+            bodies->add(createCylinder(component, linkerCenter, radius, height, z));
+            cutBodies->add(createCylinder(component, linkerCenter, radius - wallThickness, height - floorThickness, z + direction * (floorState == Top ? 0 : floorThickness)));
+            if (floorHoleRadius > 0 && floorThickness > 0)
+                cutBodies->add(createCylinder(component, linkerCenter, floorHoleRadius, floorThickness, z + direction * (floorState == Top ? height - floorThickness : 0)));
         }
-        return body;
+
+        auto body = joinedBody;
+        if (body == nullptr)
+        {
+            body = bodies->item(0)->cast<BRepBody>();
+            bodies->removeByIndex(0);
+        }
+        body = Combine(component, JoinFeatureOperation, body, bodies);
+        body = Combine(component, CutFeatureOperation, body, cutBodies);
+        return CommitBody(component, body);
     }
 private:
     Ptr<BRepBody> createCylinder(Ptr<Component> component, Ptr<Point3D> center, double radius, double height, double z)
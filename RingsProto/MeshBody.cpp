@@ -0,0 +1,244 @@
+#include "MeshBody.h"
+#include "StlWriter.h"
+#include <unordered_map>
+
+uint32_t MeshBody::addVertex(const PlainPoint3D& point)
+{
+    vertices.push_back(point);
+    return (uint32_t)vertices.size() - 1;
+}
+
+void MeshBody::addTriangle(uint32_t a, uint32_t b, uint32_t c)
+{
+    triangles.push_back({ a, b, c });
+}
+
+void MeshBody::append(const MeshBody& other)
+{
+    auto shift = (uint32_t)vertices.size();
+    vertices.insert(vertices.end(), other.vertices.begin(), other.vertices.end());
+    for (auto& triangle : other.triangles)
+        triangles.push_back({ triangle.a + shift, triangle.b + shift, triangle.c + shift });
+}
+
+bool MeshBody::isEmpty() const
+{
+    return triangles.empty();
+}
+
+MeshBox MeshBody::boundingBox() const
+{
+    MeshBox box;
+    if (vertices.empty())
+        return box;
+    box.minPoint = vertices[0];
+    box.maxPoint = vertices[0];
+    for (auto& vertex : vertices)
+    {
+        box.minPoint = { fmin(box.minPoint.x, vertex.x), fmin(box.minPoint.y, vertex.y), fmin(box.minPoint.z, vertex.z) };
+        box.maxPoint = { fmax(box.maxPoint.x, vertex.x), fmax(box.maxPoint.y, vertex.y), fmax(box.maxPoint.z, vertex.z) };
+    }
+    return box;
+}
+
+double MeshBody::volume() const
+{
+    auto result = 0.0;
+    for (auto& triangle : triangles)
+    {
+        auto& p1 = vertices[triangle.a];
+        auto& p2 = vertices[triangle.b];
+        auto& p3 = vertices[triangle.c];
+        result += p1.x * (p2.y * p3.z - p3.y * p2.z) - p2.x * (p1.y * p3.z - p3.y * p1.z) + p3.x * (p1.y * p2.z - p2.y * p1.z);
+    }
+    return result / 6.0;
+}
+
+bool MeshBody::containsPoint(const PlainPoint3D& point) const
+{
+    // Parity of ray crossings. The direction is skewed so the ray does not run along
+    // the axis-aligned edges and seams the primitives are built from.
+    const double dx = 0.8017837, dy = 0.5345225, dz = 0.2672612;
+    auto crossings = 0;
+    for (auto& triangle : triangles)
+    {
+        auto& p1 = vertices[triangle.a];
+        auto& p2 = vertices[triangle.b];
+        auto& p3 = vertices[triangle.c];
+        double e1x = p2.x - p1.x, e1y = p2.y - p1.y, e1z = p2.z - p1.z;
+        double e2x = p3.x - p1.x, e2y = p3.y - p1.y, e2z = p3.z - p1.z;
+        double hx = dy * e2z - dz * e2y, hy = dz * e2x - dx * e2z, hz = dx * e2y - dy * e2x;
+        auto det = e1x * hx + e1y * hy + e1z * hz;
+        if (fabs(det) < 1e-15)
+            continue;
+        auto inv = 1.0 / det;
+        double sx = point.x - p1.x, sy = point.y - p1.y, sz = point.z - p1.z;
+        auto u = (sx * hx + sy * hy + sz * hz) * inv;
+        if (u < 0 || u > 1)
+            continue;
+        double qx = sy * e1z - sz * e1y, qy = sz * e1x - sx * e1z, qz = sx * e1y - sy * e1x;
+        auto v = (dx * qx + dy * qy + dz * qz) * inv;
+        if (v < 0 || u + v > 1)
+            continue;
+        if ((e2x * qx + e2y * qy + e2z * qz) * inv > 0)
+            crossings++;
+    }
+    return crossings % 2 == 1;
+}
+
+namespace
+{
+    struct GridKey
+    {
+        int64_t x;
+        int64_t y;
+        int64_t z;
+        bool operator==(const GridKey& other) const { return x == other.x && y == other.y && z == other.z; }
+    };
+
+    struct GridKeyHash
+    {
+        size_t operator()(const GridKey& key) const
+        {
+            return (size_t)(key.x * 73856093) ^ (size_t)(key.y * 19349663) ^ (size_t)(key.z * 83492791);
+        }
+    };
+}
+
+std::vector<uint32_t> MeshBody::weld(double tolerance)
+{
+    std::unordered_map<GridKey, uint32_t, GridKeyHash> grid;
+    grid.reserve(vertices.size());
+    std::vector<PlainPoint3D> welded;
+    std::vector<uint32_t> remap(vertices.size());
+
+    // a vertex next to a cell border is merged with the vertex of the neighbour cell too
+    auto findNear = [&](const GridKey& key, const PlainPoint3D& vertex)
+    {
+        auto found = grid.find(key);
+        if (found != grid.end())
+            return (int64_t)found->second;
+        for (int64_t dx = -1; dx <= 1; dx++)
+            for (int64_t dy = -1; dy <= 1; dy++)
+                for (int64_t dz = -1; dz <= 1; dz++)
+                {
+                    found = grid.find({ key.x + dx, key.y + dy, key.z + dz });
+                    if (found == grid.end())
+                        continue;
+                    auto& near = welded[found->second];
+                    if (fabs(near.x - vertex.x) <= tolerance && fabs(near.y - vertex.y) <= tolerance && fabs(near.z - vertex.z) <= tolerance)
+                        return (int64_t)found->second;
+                }
+        return (int64_t)-1;
+    };
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        auto& vertex = vertices[i];
+        GridKey key = { (int64_t)llround(vertex.x / tolerance), (int64_t)llround(vertex.y / tolerance), (int64_t)llround(vertex.z / tolerance) };
+        auto near = findNear(key, vertex);
+        if (near >= 0)
+        {
+            remap[i] = (uint32_t)near;
+            continue;
+        }
+        remap[i] = (uint32_t)welded.size();
+        grid.emplace(key, remap[i]);
+        welded.push_back(vertex);
+    }
+
+    std::vector<MeshTriangle> kept;
+    kept.reserve(triangles.size());
+    for (auto& triangle : triangles)
+    {
+        MeshTriangle mapped = { remap[triangle.a], remap[triangle.b], remap[triangle.c] };
+        if (mapped.a != mapped.b && mapped.b != mapped.c && mapped.a != mapped.c)
+            kept.push_back(mapped);
+    }
+    vertices.swap(welded);
+    triangles.swap(kept);
+    return remap;
+}
+
+size_t MeshBody::countOpenEdges() const
+{
+    std::unordered_map<uint64_t, int> edges;
+    edges.reserve(triangles.size() * 3);
+    for (auto& triangle : triangles)
+    {
+        uint32_t indexes[3] = { triangle.a, triangle.b, triangle.c };
+        for (int i = 0; i < 3; i++)
+            edges[(uint64_t)indexes[i] << 32 | indexes[(i + 1) % 3]]++;
+    }
+    size_t count = 0;
+    for (auto& edge : edges)
+    {
+        auto reverse = edges.find(edge.first << 32 | edge.first >> 32);
+        if (edge.second != 1 || reverse == edges.end() || reverse->second != 1)
+            count += edge.second;
+    }
+    return count;
+}
+
+std::vector<MeshBody> SplitComponents(const MeshBody& body)
+{
+    std::vector<uint32_t> parents(body.vertices.size());
+    for (uint32_t i = 0; i < parents.size(); i++)
+        parents[i] = i;
+    auto find = [&](uint32_t i)
+    {
+        while (parents[i] != i)
+        {
+            parents[i] = parents[parents[i]];
+            i = parents[i];
+        }
+        return i;
+    };
+    auto unite = [&](uint32_t a, uint32_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a != b)
+            parents[a] = b;
+    };
+    for (auto& triangle : body.triangles)
+    {
+        unite(triangle.a, triangle.b);
+        unite(triangle.a, triangle.c);
+    }
+
+    std::unordered_map<uint32_t, size_t> componentIndexes;
+    std::vector<MeshBody> components;
+    std::vector<uint32_t> remap(body.vertices.size(), UINT32_MAX);
+    for (auto& triangle : body.triangles)
+    {
+        auto root = find(triangle.a);
+        auto found = componentIndexes.find(root);
+        if (found == componentIndexes.end())
+        {
+            found = componentIndexes.emplace(root, components.size()).first;
+            components.push_back(MeshBody());
+            components.back().name = body.name;
+        }
+        auto& component = components[found->second];
+        uint32_t indexes[3] = { triangle.a, triangle.b, triangle.c };
+        for (auto& index : indexes)
+        {
+            if (remap[index] == UINT32_MAX)
+                remap[index] = component.addVertex(body.vertices[index]);
+            index = remap[index];
+        }
+        component.addTriangle(indexes[0], indexes[1], indexes[2]);
+    }
+    return components;
+}
+
+bool SaveAsStl(const MeshBody& body, const std::string& filepath)
+{
+    StlWriter writer;
+    if (!writer.open(filepath, (uint32_t)body.triangles.size(), body.name))
+        return false;
+    for (auto& triangle : body.triangles)
+        writer.addTriangle(body.vertices[triangle.a], body.vertices[triangle.b], body.vertices[triangle.c]);
+    return writer.close();
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include "Geometry.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct MeshTriangle
+{
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+struct MeshBox
+{
+    PlainPoint3D minPoint;
+    PlainPoint3D maxPoint;
+};
+
+// Indexed triangle mesh, the headless counterpart of BRepBody. Triangles are
+// counter-clockwise when looking at the body from outside.
+class MeshBody
+{
+public:
+    std::string name;
+    std::vector<PlainPoint3D> vertices;
+    std::vector<MeshTriangle> triangles;
+
+    uint32_t addVertex(const PlainPoint3D& point);
+    void addTriangle(uint32_t a, uint32_t b, uint32_t c);
+    void append(const MeshBody& other);
+    bool isEmpty() const;
+    MeshBox boundingBox() const;
+    double volume() const;
+    bool containsPoint(const PlainPoint3D& point) const;
+    // Merges vertices closer than tolerance and drops triangles that collapse. Returns
+    // the new index of each old vertex.
+    std::vector<uint32_t> weld(double tolerance = 1e-6);
+    // The directed edges without exactly one reverse edge, 0 for a closed manifold mesh.
+    // Vertices are compared by index, weld first.
+    size_t countOpenEdges() const;
+};
+
+std::vector<MeshBody> SplitComponents(const MeshBody& body);
+bool SaveAsStl(const MeshBody& body, const std::string& filepath);
\ No newline at end of file
@@ -0,0 +1,770 @@
+#include "MeshCsg.h"
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace
+{
+    const double CSG_EPSILON = 1e-7;
+    // how far a vertex may be from an edge it splits, above the CSG_EPSILON of the splits
+    const double T_JUNCTION_TOLERANCE = 1e-5;
+    // how far apart the ends of the edges left open may be merged
+    const double GAP_TOLERANCE = 1e-4;
+
+    enum PointSide
+    {
+        CoplanarSide = 0,
+        FrontSide = 1,
+        BackSide = 2,
+        SpanningSide = 3
+    };
+
+    struct CsgPlane
+    {
+        double nx = 0;
+        double ny = 0;
+        double nz = 0;
+        double w = 0;
+
+        double distance(const PlainPoint3D& point) const
+        {
+            return nx * point.x + ny * point.y + nz * point.z - w;
+        }
+
+        void flip()
+        {
+            nx = -nx;
+            ny = -ny;
+            nz = -nz;
+            w = -w;
+        }
+    };
+
+    struct CsgPolygon
+    {
+        std::vector<PlainPoint3D> vertices;
+        CsgPlane plane;
+        size_t source = 0; // index of the input polygon the polygon was split from
+        bool isFar = false; // away from the other body, it is not split
+
+        void flip()
+        {
+            std::reverse(vertices.begin(), vertices.end());
+            plane.flip();
+        }
+    };
+
+    // Newell normal, stable for the thin slivers splitting leaves behind.
+    bool MakePlane(const std::vector<PlainPoint3D>& vertices, CsgPlane& plane)
+    {
+        double nx = 0, ny = 0, nz = 0, cx = 0, cy = 0, cz = 0;
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            auto& current = vertices[i];
+            auto& next = vertices[(i + 1) % vertices.size()];
+            nx += (current.y - next.y) * (current.z + next.z);
+            ny += (current.z - next.z) * (current.x + next.x);
+            nz += (current.x - next.x) * (current.y + next.y);
+            cx += current.x;
+            cy += current.y;
+            cz += current.z;
+        }
+        auto length = sqrt(nx * nx + ny * ny + nz * nz);
+        if (length < 1e-14)
+            return false;
+        plane.nx = nx / length;
+        plane.ny = ny / length;
+        plane.nz = nz / length;
+        plane.w = (plane.nx * cx + plane.ny * cy + plane.nz * cz) / vertices.size();
+        return true;
+    }
+
+    void SplitPolygon(const CsgPlane& plane, const CsgPolygon& polygon, std::vector<CsgPolygon>& coplanarFront, std::vector<CsgPolygon>& coplanarBack, std::vector<CsgPolygon>& front, std::vector<CsgPolygon>& back)
+    {
+        auto count = polygon.vertices.size();
+        int polygonSide = CoplanarSide;
+        double distances[64];
+        std::vector<double> heapDistances;
+        auto pointDistances = distances;
+        if (count > 64)
+        {
+            heapDistances.resize(count);
+            pointDistances = heapDistances.data();
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            auto distance = plane.distance(polygon.vertices[i]);
+            pointDistances[i] = distance;
+            polygonSide |= distance < -CSG_EPSILON ? BackSide : (distance > CSG_EPSILON ? FrontSide : CoplanarSide);
+        }
+
+        switch (polygonSide)
+        {
+        case CoplanarSide:
+        {
+            auto dot = plane.nx * polygon.plane.nx + plane.ny * polygon.plane.ny + plane.nz * polygon.plane.nz;
+            (dot > 0 ? coplanarFront : coplanarBack).push_back(polygon);
+            break;
+        }
+        case FrontSide:
+            front.push_back(polygon);
+            break;
+        case BackSide:
+            back.push_back(polygon);
+            break;
+        default:
+        {
+            CsgPolygon frontPart;
+            CsgPolygon backPart;
+            frontPart.plane = polygon.plane;
+            backPart.plane = polygon.plane;
+            frontPart.source = polygon.source;
+            backPart.source = polygon.source;
+            for (size_t i = 0; i < count; i++)
+            {
+                auto j = (i + 1) % count;
+                auto& vi = polygon.vertices[i];
+                auto& vj = polygon.vertices[j];
+                auto di = pointDistances[i];
+                auto dj = pointDistances[j];
+                auto si = di < -CSG_EPSILON ? BackSide : (di > CSG_EPSILON ? FrontSide : CoplanarSide);
+                auto sj = dj < -CSG_EPSILON ? BackSide : (dj > CSG_EPSILON ? FrontSide : CoplanarSide);
+                if (si != BackSide)
+                    frontPart.vertices.push_back(vi);
+                if (si != FrontSide)
+                    backPart.vertices.push_back(vi);
+                if ((si | sj) == SpanningSide)
+                {
+                    auto t = di / (di - dj);
+                    PlainPoint3D point = { vi.x + (vj.x - vi.x) * t, vi.y + (vj.y - vi.y) * t, vi.z + (vj.z - vi.z) * t };
+                    frontPart.vertices.push_back(point);
+                    backPart.vertices.push_back(point);
+                }
+            }
+            if (frontPart.vertices.size() >= 3)
+                front.push_back(std::move(frontPart));
+            if (backPart.vertices.size() >= 3)
+                back.push_back(std::move(backPart));
+            break;
+        }
+        }
+    }
+
+    class BspTree
+    {
+    public:
+        struct Node
+        {
+            CsgPlane plane;
+            int front = -1;
+            int back = -1;
+        };
+
+        std::vector<Node> nodes;
+
+        explicit BspTree(const std::vector<CsgPolygon>& polygons)
+        {
+            if (polygons.empty())
+                return;
+            struct Task
+            {
+                int node;
+                std::vector<CsgPolygon> polygons;
+            };
+            std::vector<Task> tasks;
+            nodes.push_back(Node());
+            tasks.push_back({ 0, polygons });
+            while (!tasks.empty())
+            {
+                auto task = std::move(tasks.back());
+                tasks.pop_back();
+                auto nodeIndex = task.node;
+                nodes[nodeIndex].plane = task.polygons[0].plane;
+                auto plane = nodes[nodeIndex].plane;
+
+                std::vector<CsgPolygon> coplanar, front, back;
+                for (auto& polygon : task.polygons)
+                    SplitPolygon(plane, polygon, coplanar, coplanar, front, back);
+
+                if (!front.empty())
+                {
+                    auto child = (int)nodes.size();
+                    nodes.push_back(Node());
+                    nodes[nodeIndex].front = child;
+                    tasks.push_back({ child, std::move(front) });
+                }
+                if (!back.empty())
+                {
+                    auto child = (int)nodes.size();
+                    nodes.push_back(Node());
+                    nodes[nodeIndex].back = child;
+                    tasks.push_back({ child, std::move(back) });
+                }
+            }
+        }
+
+        void invert()
+        {
+            for (auto& node : nodes)
+            {
+                node.plane.flip();
+                std::swap(node.front, node.back);
+            }
+        }
+
+        // Removes the parts of the polygons inside the solid of the tree.
+        std::vector<CsgPolygon> clip(std::vector<CsgPolygon> polygons) const
+        {
+            if (nodes.empty())
+                return polygons;
+            std::vector<CsgPolygon> result;
+            struct Task
+            {
+                int node;
+                std::vector<CsgPolygon> polygons;
+            };
+            std::vector<Task> tasks;
+            tasks.push_back({ 0, std::move(polygons) });
+            while (!tasks.empty())
+            {
+                auto task = std::move(tasks.back());
+                tasks.pop_back();
+                auto& node = nodes[task.node];
+
+                std::vector<CsgPolygon> front, back;
+                for (auto& polygon : task.polygons)
+                    SplitPolygon(node.plane, polygon, front, back, front, back);
+
+                if (node.front >= 0)
+                {
+                    if (!front.empty())
+                        tasks.push_back({ node.front, std::move(front) });
+                }
+                else
+                    for (auto& polygon : front)
+                        result.push_back(std::move(polygon));
+
+                if (node.back >= 0 && !back.empty())
+                    tasks.push_back({ node.back, std::move(back) });
+            }
+            return result;
+        }
+    };
+
+    std::vector<CsgPolygon> ToPolygons(const MeshBody& body, size_t sourceShift)
+    {
+        std::vector<CsgPolygon> polygons;
+        polygons.reserve(body.triangles.size());
+        for (size_t i = 0; i < body.triangles.size(); i++)
+        {
+            auto& triangle = body.triangles[i];
+            CsgPolygon polygon;
+            polygon.vertices = { body.vertices[triangle.a], body.vertices[triangle.b], body.vertices[triangle.c] };
+            polygon.source = sourceShift + polygons.size();
+            if (MakePlane(polygon.vertices, polygon.plane))
+                polygons.push_back(std::move(polygon));
+        }
+        return polygons;
+    }
+
+    double Area(const std::vector<PlainPoint3D>& vertices)
+    {
+        double nx = 0, ny = 0, nz = 0;
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            auto& current = vertices[i];
+            auto& next = vertices[(i + 1) % vertices.size()];
+            nx += (current.y - next.y) * (current.z + next.z);
+            ny += (current.z - next.z) * (current.x + next.x);
+            nz += (current.x - next.x) * (current.y + next.y);
+        }
+        return sqrt(nx * nx + ny * ny + nz * nz) / 2.0;
+    }
+
+    void Flip(std::vector<CsgPolygon>& polygons)
+    {
+        for (auto& polygon : polygons)
+            polygon.flip();
+    }
+
+    bool Overlaps(const PlainPoint3D& minPoint, const PlainPoint3D& maxPoint, const MeshBox& box)
+    {
+        const double margin = 1e-5;
+        return minPoint.x <= box.maxPoint.x + margin && maxPoint.x >= box.minPoint.x - margin
+            && minPoint.y <= box.maxPoint.y + margin && maxPoint.y >= box.minPoint.y - margin
+            && minPoint.z <= box.maxPoint.z + margin && maxPoint.z >= box.minPoint.z - margin;
+    }
+
+    // Splits polygons into the ones touching the box and the ones far from it.
+    void Partition(std::vector<CsgPolygon>& polygons, const MeshBox& box, std::vector<CsgPolygon>& nearPolygons, std::vector<CsgPolygon>& farPolygons)
+    {
+        for (auto& polygon : polygons)
+        {
+            auto minPoint = polygon.vertices[0];
+            auto maxPoint = polygon.vertices[0];
+            for (auto& vertex : polygon.vertices)
+            {
+                minPoint = { fmin(minPoint.x, vertex.x), fmin(minPoint.y, vertex.y), fmin(minPoint.z, vertex.z) };
+                maxPoint = { fmax(maxPoint.x, vertex.x), fmax(maxPoint.y, vertex.y), fmax(maxPoint.z, vertex.z) };
+            }
+            polygon.isFar = !Overlaps(minPoint, maxPoint, box);
+            (polygon.isFar ? farPolygons : nearPolygons).push_back(std::move(polygon));
+        }
+    }
+
+    void AddPolygon(MeshBody& body, const std::vector<PlainPoint3D>& vertices, bool isFlipped)
+    {
+        auto first = body.addVertex(vertices[0]);
+        auto previous = body.addVertex(vertices[1]);
+        for (size_t i = 2; i < vertices.size(); i++)
+        {
+            auto current = body.addVertex(vertices[i]);
+            if (isFlipped)
+                body.addTriangle(first, current, previous);
+            else
+                body.addTriangle(first, previous, current);
+            previous = current;
+        }
+    }
+
+    // Splitting by the planes of the other body cuts triangles far from its surface too.
+    // When every fragment of an input triangle survived, the triangle itself is written.
+    // The vertices of the polygons near the other body are marked in isNearVertex.
+    void AddPolygons(MeshBody& body, const std::vector<CsgPolygon>& polygons, const std::vector<CsgPolygon>& sources, size_t sourceShift, std::vector<bool>& isNearVertex)
+    {
+        std::vector<double> areas(sources.size(), 0.0);
+        for (auto& polygon : polygons)
+            areas[polygon.source - sourceShift] += Area(polygon.vertices);
+
+        std::vector<bool> isWritten(sources.size(), false);
+        for (auto& polygon : polygons)
+        {
+            auto index = polygon.source - sourceShift;
+            auto& source = sources[index];
+            auto sourceArea = Area(source.vertices);
+            if (fabs(areas[index] - sourceArea) > 1e-9 * fmax(1.0, sourceArea))
+            {
+                AddPolygon(body, polygon.vertices, false);
+                isNearVertex.resize(body.vertices.size(), !polygon.isFar);
+                continue;
+            }
+            if (isWritten[index])
+                continue;
+            isWritten[index] = true;
+            auto dot = polygon.plane.nx * source.plane.nx + polygon.plane.ny * source.plane.ny + polygon.plane.nz * source.plane.nz;
+            AddPolygon(body, source.vertices, dot < 0);
+            isNearVertex.resize(body.vertices.size(), !polygon.isFar);
+        }
+    }
+
+    // True when the point lies on the segment between its ends, within T_JUNCTION_TOLERANCE.
+    bool IsOnSegment(const PlainPoint3D& point, const PlainPoint3D& p1, const PlainPoint3D& p2)
+    {
+        double dx = p2.x - p1.x, dy = p2.y - p1.y, dz = p2.z - p1.z;
+        auto lengthSquared = dx * dx + dy * dy + dz * dz;
+        if (lengthSquared < 1e-24)
+            return false;
+        auto t = ((point.x - p1.x) * dx + (point.y - p1.y) * dy + (point.z - p1.z) * dz) / lengthSquared;
+        if (t <= 0 || t >= 1)
+            return false;
+        double ex = p1.x + dx * t - point.x, ey = p1.y + dy * t - point.y, ez = p1.z + dz * t - point.z;
+        return ex * ex + ey * ey + ez * ez <= T_JUNCTION_TOLERANCE * T_JUNCTION_TOLERANCE;
+    }
+
+    uint64_t EdgeKey(uint32_t from, uint32_t to)
+    {
+        return (uint64_t)from << 32 | to;
+    }
+
+    // The polygons of a split keep whole the neighbours on one side of the plane, so the
+    // split vertices sit in the middle of their edges. Each edge without a reverse one is
+    // split at the ends of the other open edges lying on it, by a fan from the opposite
+    // vertex, until every edge has its reverse or no open edge has a vertex on it.
+    void ResolveTJunctions(MeshBody& body, const std::vector<bool>& isNear)
+    {
+        // each near edge with a triangle using it, updated as the triangles are split
+        std::unordered_map<uint64_t, uint32_t> edges;
+        auto addEdge = [&](uint32_t from, uint32_t to, uint32_t index)
+        {
+            if (isNear[from] && isNear[to])
+                edges[EdgeKey(from, to)] = index;
+        };
+        auto addEdges = [&](uint32_t index)
+        {
+            auto& triangle = body.triangles[index];
+            addEdge(triangle.a, triangle.b, index);
+            addEdge(triangle.b, triangle.c, index);
+            addEdge(triangle.c, triangle.a, index);
+        };
+        for (uint32_t i = 0; i < body.triangles.size(); i++)
+            addEdges(i);
+        std::vector<uint64_t> checked;
+        for (auto& edge : edges)
+            checked.push_back(edge.first);
+
+        // a split only opens the edges of its pieces, the next pass checks them and the
+        // edges left open
+        for (int pass = 0; pass < 8; pass++)
+        {
+            std::vector<std::pair<uint64_t, uint32_t>> openEdges;
+            std::vector<uint32_t> openVertices;
+            auto openLength = 0.0;
+            std::sort(checked.begin(), checked.end());
+            checked.erase(std::unique(checked.begin(), checked.end()), checked.end());
+            for (auto key : checked)
+            {
+                auto from = (uint32_t)(key >> 32);
+                auto to = (uint32_t)key;
+                auto edge = edges.find(key);
+                if (edge == edges.end() || edges.count(EdgeKey(to, from)) != 0)
+                    continue;
+                openEdges.push_back(*edge);
+                openVertices.push_back(from);
+                openVertices.push_back(to);
+                auto& p1 = body.vertices[from];
+                auto& p2 = body.vertices[to];
+                openLength += sqrt((p2.x - p1.x) * (p2.x - p1.x) + (p2.y - p1.y) * (p2.y - p1.y) + (p2.z - p1.z) * (p2.z - p1.z));
+            }
+            if (openEdges.empty())
+                return;
+            std::sort(openVertices.begin(), openVertices.end());
+            openVertices.erase(std::unique(openVertices.begin(), openVertices.end()), openVertices.end());
+
+            // the open vertices by cells about as big as an open edge
+            auto cellSize = fmax(openLength / openEdges.size(), 1e-4);
+            auto cellKey = [](int64_t x, int64_t y, int64_t z)
+            {
+                return (uint64_t)(x * 73856093) ^ (uint64_t)(y * 19349663) ^ (uint64_t)(z * 83492791);
+            };
+            std::unordered_multimap<uint64_t, uint32_t> cells;
+            cells.reserve(openVertices.size());
+            for (auto vertex : openVertices)
+            {
+                auto& point = body.vertices[vertex];
+                cells.emplace(cellKey((int64_t)floor(point.x / cellSize), (int64_t)floor(point.y / cellSize), (int64_t)floor(point.z / cellSize)), vertex);
+            }
+
+            checked.clear();
+            auto isAnySplit = false;
+            std::vector<bool> isSplit(body.triangles.size(), false);
+            std::vector<std::pair<double, uint32_t>> splits;
+            std::vector<uint32_t> candidates;
+            for (auto& openEdge : openEdges)
+            {
+                checked.push_back(openEdge.first);
+                auto triangleIndex = openEdge.second;
+                if (isSplit[triangleIndex])
+                    continue;
+                auto from = (uint32_t)(openEdge.first >> 32);
+                auto to = (uint32_t)openEdge.first;
+                auto& p1 = body.vertices[from];
+                auto& p2 = body.vertices[to];
+                double dx = p2.x - p1.x, dy = p2.y - p1.y, dz = p2.z - p1.z;
+                auto lengthSquared = dx * dx + dy * dy + dz * dz;
+                if (lengthSquared < 1e-24)
+                    continue;
+
+                candidates.clear();
+                auto stepCount = (int)ceil(sqrt(lengthSquared) / cellSize);
+                for (int step = 0; step <= stepCount; step++)
+                {
+                    auto t = (double)step / stepCount;
+                    auto x = (int64_t)floor((p1.x + dx * t) / cellSize);
+                    auto y = (int64_t)floor((p1.y + dy * t) / cellSize);
+                    auto z = (int64_t)floor((p1.z + dz * t) / cellSize);
+                    for (int64_t cx = -1; cx <= 1; cx++)
+                        for (int64_t cy = -1; cy <= 1; cy++)
+                            for (int64_t cz = -1; cz <= 1; cz++)
+                            {
+                                // other cells of the same key only add candidates, each is tested below
+                                auto range = cells.equal_range(cellKey(x + cx, y + cy, z + cz));
+                                for (auto item = range.first; item != range.second; item++)
+                                    candidates.push_back(item->second);
+                            }
+                }
+                std::sort(candidates.begin(), candidates.end());
+                candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+                splits.clear();
+                for (auto vertex : candidates)
+                {
+                    auto& point = body.vertices[vertex];
+                    if (vertex != from && vertex != to && IsOnSegment(point, p1, p2))
+                        splits.push_back({ ((point.x - p1.x) * dx + (point.y - p1.y) * dy + (point.z - p1.z) * dz) / lengthSquared, vertex });
+                }
+                auto triangle = body.triangles[triangleIndex];
+                auto opposite = triangle.a != from && triangle.a != to ? triangle.a : (triangle.b != from && triangle.b != to ? triangle.b : triangle.c);
+                // a sliver with its own vertex on the edge is left to RemoveOpenSlivers
+                splits.erase(std::remove_if(splits.begin(), splits.end(), [&](const std::pair<double, uint32_t>& split) { return split.second == opposite; }), splits.end());
+                if (splits.empty())
+                    continue;
+                std::sort(splits.begin(), splits.end());
+                splits.push_back({ 1.0, to });
+
+                // the first piece takes the place of the triangle, the others are added
+                auto edge = edges.find(openEdge.first);
+                if (edge != edges.end() && edge->second == triangleIndex)
+                    edges.erase(edge);
+                auto previous = from;
+                for (size_t i = 0; i < splits.size(); i++)
+                {
+                    MeshTriangle piece = { previous, splits[i].second, opposite };
+                    auto index = triangleIndex;
+                    if (i == 0)
+                        body.triangles[index] = piece;
+                    else
+                    {
+                        index = (uint32_t)body.triangles.size();
+                        body.triangles.push_back(piece);
+                        isSplit.push_back(true);
+                    }
+                    addEdges(index);
+                    checked.push_back(EdgeKey(piece.a, piece.b));
+                    previous = splits[i].second;
+                }
+                isSplit[triangleIndex] = true;
+                isAnySplit = true;
+            }
+            if (!isAnySplit)
+                return;
+        }
+    }
+
+    // The edges between near vertices with their use counts. The others are edges of the
+    // far polygons, closed as the input bodies are.
+    struct NearEdges
+    {
+        std::unordered_map<uint64_t, int> counts;
+        const std::vector<bool>& isNear;
+
+        NearEdges(const MeshBody& body, const std::vector<bool>& isNear) : isNear(isNear)
+        {
+            for (auto& triangle : body.triangles)
+            {
+                add(triangle.a, triangle.b);
+                add(triangle.b, triangle.c);
+                add(triangle.c, triangle.a);
+            }
+        }
+
+        void add(uint32_t from, uint32_t to)
+        {
+            if (isNear[from] && isNear[to])
+                counts[EdgeKey(from, to)]++;
+        }
+
+        // An edge is closed when it and its reverse are used once each.
+        bool isOpen(uint32_t from, uint32_t to) const
+        {
+            if (!isNear[from] || !isNear[to])
+                return false;
+            auto edge = counts.find(EdgeKey(from, to));
+            auto reverse = counts.find(EdgeKey(to, from));
+            return edge == counts.end() || edge->second != 1 || reverse == counts.end() || reverse->second != 1;
+        }
+
+        bool isOpen(const MeshTriangle& triangle) const
+        {
+            return isOpen(triangle.a, triangle.b) || isOpen(triangle.b, triangle.c) || isOpen(triangle.c, triangle.a);
+        }
+
+        bool isClosed() const
+        {
+            for (auto& edge : counts)
+                if (isOpen((uint32_t)(edge.first >> 32), (uint32_t)edge.first))
+                    return false;
+            return true;
+        }
+    };
+
+    // Two planes of the bodies meeting at a grazing angle place the same corner a few
+    // T_JUNCTION_TOLERANCE apart on either side of the cut. Only the vertices of the edges
+    // still open are merged, at GAP_TOLERANCE, the closed surface keeps its small features.
+    void WeldOpenVertices(MeshBody& body, const std::vector<bool>& isNear)
+    {
+        NearEdges edges(body, isNear);
+        std::vector<uint32_t> openVertices;
+        for (auto& edge : edges.counts)
+        {
+            auto from = (uint32_t)(edge.first >> 32);
+            auto to = (uint32_t)edge.first;
+            if (!edges.isOpen(from, to))
+                continue;
+            openVertices.push_back(from);
+            openVertices.push_back(to);
+        }
+        if (openVertices.empty())
+            return;
+        std::sort(openVertices.begin(), openVertices.end());
+        openVertices.erase(std::unique(openVertices.begin(), openVertices.end()), openVertices.end());
+
+        // each open vertex goes to the first open vertex near it
+        std::vector<uint32_t> remap(body.vertices.size());
+        for (uint32_t i = 0; i < remap.size(); i++)
+            remap[i] = i;
+        for (size_t i = 0; i < openVertices.size(); i++)
+        {
+            auto& point = body.vertices[openVertices[i]];
+            for (size_t j = 0; j < i; j++)
+            {
+                auto& near = body.vertices[openVertices[j]];
+                if (remap[openVertices[j]] == openVertices[j] && fabs(near.x - point.x) <= GAP_TOLERANCE && fabs(near.y - point.y) <= GAP_TOLERANCE && fabs(near.z - point.z) <= GAP_TOLERANCE)
+                {
+                    remap[openVertices[i]] = openVertices[j];
+                    break;
+                }
+            }
+        }
+
+        std::vector<MeshTriangle> kept;
+        kept.reserve(body.triangles.size());
+        for (auto& triangle : body.triangles)
+        {
+            MeshTriangle mapped = { remap[triangle.a], remap[triangle.b], remap[triangle.c] };
+            if (mapped.a != mapped.b && mapped.b != mapped.c && mapped.a != mapped.c)
+                kept.push_back(mapped);
+        }
+        body.triangles.swap(kept);
+    }
+
+    // A sliver with a vertex on its opposite edge covers no area but can pair that edge
+    // next to the split neighbour it overlaps. The open ones are dropped, their edges
+    // then pair the neighbour or get split by ResolveTJunctions.
+    void RemoveOpenSlivers(MeshBody& body, const std::vector<bool>& isNear)
+    {
+        NearEdges edges(body, isNear);
+        auto& vertices = body.vertices;
+        body.triangles.erase(std::remove_if(body.triangles.begin(), body.triangles.end(), [&](const MeshTriangle& triangle)
+        {
+            if (!edges.isOpen(triangle))
+                return false;
+            auto& a = vertices[triangle.a];
+            auto& b = vertices[triangle.b];
+            auto& c = vertices[triangle.c];
+            return IsOnSegment(c, a, b) || IsOnSegment(a, b, c) || IsOnSegment(b, c, a);
+        }), body.triangles.end());
+    }
+
+    // Coplanar faces of both bodies can both survive: a triangle and its reverse cancel,
+    // a second copy of a triangle is dropped.
+    void RemoveDuplicates(MeshBody& body, const std::vector<bool>& isNear)
+    {
+        auto key = [](const MeshTriangle& triangle)
+        {
+            // rotated to start at the least index, the orientation stays
+            auto least = std::min(triangle.a, std::min(triangle.b, triangle.c));
+            if (least == triangle.a)
+                return std::make_tuple(triangle.a, triangle.b, triangle.c);
+            if (least == triangle.b)
+                return std::make_tuple(triangle.b, triangle.c, triangle.a);
+            return std::make_tuple(triangle.c, triangle.a, triangle.b);
+        };
+        // a duplicate uses its edges twice, only the triangles on open edges are looked at
+        NearEdges edges(body, isNear);
+        std::map<std::tuple<uint32_t, uint32_t, uint32_t>, int> counts;
+        for (auto& triangle : body.triangles)
+            if (edges.isOpen(triangle))
+                counts[key(triangle)]++;
+
+        std::vector<MeshTriangle> kept;
+        kept.reserve(body.triangles.size());
+        for (auto& triangle : body.triangles)
+        {
+            auto found = counts.find(key(triangle));
+            if (found == counts.end())
+            {
+                kept.push_back(triangle);
+                continue;
+            }
+            if (found->second == 0)
+                continue;
+            auto reverse = counts.find(key({ triangle.a, triangle.c, triangle.b }));
+            if (reverse != counts.end() && reverse->second > 0)
+            {
+                found->second--;
+                reverse->second--;
+                continue;
+            }
+            found->second = 0;
+            kept.push_back(triangle);
+        }
+        body.triangles.swap(kept);
+    }
+}
+
+MeshBody CsgCombine(MeshOperation operation, const MeshBody& body1, const MeshBody& body2)
+{
+    auto sources1 = ToPolygons(body1, 0);
+    auto sources2 = ToPolygons(body2, sources1.size());
+    BspTree tree1(sources1);
+    BspTree tree2(sources2);
+    auto polygons1 = sources1;
+    auto polygons2 = sources2;
+
+    std::vector<CsgPolygon> near1, far1, near2, far2;
+    Partition(polygons1, body2.boundingBox(), near1, far1);
+    Partition(polygons2, body1.boundingBox(), near2, far2);
+
+    std::vector<CsgPolygon> result1, result2;
+    switch (operation)
+    {
+    case JoinMeshOperation:
+        // far polygons are outside the other body and stay as they are
+        result1 = tree2.clip(std::move(near1));
+        result2 = tree1.clip(std::move(near2));
+        Flip(result2);
+        result2 = tree1.clip(std::move(result2));
+        Flip(result2);
+        result1.insert(result1.end(), far1.begin(), far1.end());
+        result2.insert(result2.end(), far2.begin(), far2.end());
+        break;
+    case CutMeshOperation:
+        // far polygons of the first body stay, far polygons of the tool are dropped
+        Flip(near1);
+        result1 = tree2.clip(std::move(near1));
+        Flip(result1);
+        tree1.invert();
+        result2 = tree1.clip(std::move(near2));
+        Flip(result2);
+        result2 = tree1.clip(std::move(result2));
+        result1.insert(result1.end(), far1.begin(), far1.end());
+        break;
+    case IntersectMeshOperation:
+        // far polygons of both bodies are dropped
+        tree1.invert();
+        result2 = tree1.clip(std::move(near2));
+        Flip(result2);
+        tree2.invert();
+        Flip(near1);
+        result1 = tree2.clip(std::move(near1));
+        result2 = tree1.clip(std::move(result2));
+        Flip(result1);
+        Flip(result2);
+        break;
+    }
+
+    MeshBody result;
+    result.name = body1.name;
+    std::vector<bool> isNearVertex;
+    AddPolygons(result, result1, sources1, 0, isNearVertex);
+    AddPolygons(result, result2, sources2, sources1.size(), isNearVertex);
+    auto remap = result.weld(T_JUNCTION_TOLERANCE);
+
+    // the far polygons are written as they were, every open edge is between near vertices
+    std::vector<bool> isNear(result.vertices.size(), false);
+    for (size_t i = 0; i < remap.size(); i++)
+        if (isNearVertex[i])
+            isNear[remap[i]] = true;
+
+    ResolveTJunctions(result, isNear);
+    if (!NearEdges(result, isNear).isClosed())
+    {
+        RemoveDuplicates(result, isNear);
+        WeldOpenVertices(result, isNear);
+        RemoveOpenSlivers(result, isNear);
+        ResolveTJunctions(result, isNear);
+        RemoveDuplicates(result, isNear);
+    }
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include "MeshBody.h"
+
+enum MeshOperation
+{
+    JoinMeshOperation,
+    CutMeshOperation,
+    IntersectMeshOperation
+};
+
+// Boolean of two closed meshes with BSP trees. Triangles of one body lying outside
+// the bounding box of the other are passed through without being classified, so
+// cutting a small hole into a big body only splits the triangles around the hole.
+MeshBody CsgCombine(MeshOperation operation, const MeshBody& body1, const MeshBody& body2);
\ No newline at end of file
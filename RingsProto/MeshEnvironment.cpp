@@ -0,0 +1,412 @@
+#include "MeshEnvironment.h"
+#include <algorithm>
+
+namespace
+{
+    PlainPoint3D Add(const PlainPoint3D& a, const PlainPoint3D& b)
+    {
+        return { a.x + b.x, a.y + b.y, a.z + b.z };
+    }
+
+    PlainPoint3D Subtract(const PlainPoint3D& a, const PlainPoint3D& b)
+    {
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    PlainPoint3D Scale(const PlainPoint3D& a, double k)
+    {
+        return { a.x * k, a.y * k, a.z * k };
+    }
+
+    double Dot(const PlainPoint3D& a, const PlainPoint3D& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    PlainPoint3D Cross(const PlainPoint3D& a, const PlainPoint3D& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    PlainPoint3D Normalize(const PlainPoint3D& a)
+    {
+        auto length = sqrt(Dot(a, a));
+        return length > 0 ? Scale(a, 1.0 / length) : a;
+    }
+
+    // Rodrigues rotation of the point around the axis through origin along unit direction.
+    PlainPoint3D RotatePoint(const PlainPoint3D& point, const PlainPoint3D& origin, const PlainPoint3D& direction, double cosA, double sinA)
+    {
+        auto p = Subtract(point, origin);
+        auto rotated = Add(Add(Scale(p, cosA), Scale(Cross(direction, p), sinA)), Scale(direction, Dot(direction, p) * (1.0 - cosA)));
+        return Add(rotated, origin);
+    }
+
+    double SignedArea(const std::vector<double>& xs, const std::vector<double>& ys)
+    {
+        auto area = 0.0;
+        for (size_t i = 0; i < xs.size(); i++)
+        {
+            auto j = (i + 1) % xs.size();
+            area += xs[i] * ys[j] - xs[j] * ys[i];
+        }
+        return area / 2.0;
+    }
+
+    // Ear clipping of a simple counter-clockwise polygon; returns index triples.
+    std::vector<MeshTriangle> Triangulate(const std::vector<double>& xs, const std::vector<double>& ys)
+    {
+        std::vector<MeshTriangle> result;
+        std::vector<uint32_t> indexes(xs.size());
+        for (uint32_t i = 0; i < indexes.size(); i++)
+            indexes[i] = i;
+
+        auto cross = [&](uint32_t a, uint32_t b, uint32_t c)
+        {
+            return (xs[b] - xs[a]) * (ys[c] - ys[a]) - (ys[b] - ys[a]) * (xs[c] - xs[a]);
+        };
+
+        size_t guard = 0;
+        while (indexes.size() > 3 && guard < indexes.size())
+        {
+            auto count = indexes.size();
+            auto isClipped = false;
+            for (size_t i = 0; i < count; i++)
+            {
+                auto a = indexes[(i + count - 1) % count];
+                auto b = indexes[i];
+                auto c = indexes[(i + 1) % count];
+                if (cross(a, b, c) <= 1e-14)
+                    continue;
+                auto isEar = true;
+                for (auto p : indexes)
+                {
+                    if (p == a || p == b || p == c)
+                        continue;
+                    if (cross(a, b, p) >= 0 && cross(b, c, p) >= 0 && cross(c, a, p) >= 0)
+                    {
+                        isEar = false;
+                        break;
+                    }
+                }
+                if (!isEar)
+                    continue;
+                result.push_back({ a, b, c });
+                indexes.erase(indexes.begin() + i);
+                isClipped = true;
+                break;
+            }
+            guard = isClipped ? 0 : guard + 1;
+            if (!isClipped)
+            {
+                // only collinear leftovers remain
+                break;
+            }
+        }
+        if (indexes.size() == 3 && cross(indexes[0], indexes[1], indexes[2]) > 1e-14)
+            result.push_back({ indexes[0], indexes[1], indexes[2] });
+        return result;
+    }
+}
+
+MeshAxis XMeshAxis()
+{
+    return { { 0, 0, 0 }, { 1, 0, 0 } };
+}
+
+MeshAxis YMeshAxis()
+{
+    return { { 0, 0, 0 }, { 0, 1, 0 } };
+}
+
+MeshAxis ZMeshAxis()
+{
+    return { { 0, 0, 0 }, { 0, 0, 1 } };
+}
+
+MeshAxis CreateMeshAxis(const PlainPoint3D& point, const PlainPoint3D& direction)
+{
+    return { point, Normalize(direction) };
+}
+
+int GetCircleSegmentCount(double radius)
+{
+    if (radius <= MESH_CHORD_TOLERANCE)
+        return 8;
+    auto count = (int)ceil(M_PI / acos(1.0 - MESH_CHORD_TOLERANCE / radius));
+    count = (count + 7) / 8 * 8;
+    return std::min(std::max(count, 16), 512);
+}
+
+std::vector<PlainPoint3D> GetCirclePoints(const PlainPoint3D& center, double radius, int segmentCount)
+{
+    if (segmentCount <= 0)
+        segmentCount = GetCircleSegmentCount(radius);
+    std::vector<PlainPoint3D> points(segmentCount);
+    for (int i = 0; i < segmentCount; i++)
+    {
+        auto angel = FULL_CIRCLE_RAD * i / segmentCount;
+        points[i] = { center.x + radius * cos(angel), center.y + radius * sin(angel), center.z };
+    }
+    return points;
+}
+
+std::vector<PlainPoint3D> GetRoundedRectanglePoints(const PlainPoint3D& point1, const PlainPoint3D& point2, double cornerRadius)
+{
+    auto xMin = fmin(point1.x, point2.x);
+    auto xMax = fmax(point1.x, point2.x);
+    auto yMin = fmin(point1.y, point2.y);
+    auto yMax = fmax(point1.y, point2.y);
+    auto z = point1.z;
+    cornerRadius = fmin(cornerRadius, fmin(xMax - xMin, yMax - yMin) / 2.0);
+    if (cornerRadius <= 0)
+        return { { xMin, yMin, z }, { xMax, yMin, z }, { xMax, yMax, z }, { xMin, yMax, z } };
+
+    std::vector<PlainPoint3D> points;
+    auto quarterCount = GetCircleSegmentCount(cornerRadius) / 4;
+    PlainPoint3D centers[4] = {
+        { xMax - cornerRadius, yMin + cornerRadius, z },
+        { xMax - cornerRadius, yMax - cornerRadius, z },
+        { xMin + cornerRadius, yMax - cornerRadius, z },
+        { xMin + cornerRadius, yMin + cornerRadius, z },
+    };
+    for (int corner = 0; corner < 4; corner++)
+    {
+        auto startAngel = -M_PI / 2.0 + corner * M_PI / 2.0;
+        for (int i = 0; i <= quarterCount; i++)
+        {
+            auto angel = startAngel + M_PI / 2.0 * i / quarterCount;
+            points.push_back({ centers[corner].x + cornerRadius * cos(angel), centers[corner].y + cornerRadius * sin(angel), z });
+        }
+    }
+    return points;
+}
+
+MeshBody Extrude(const std::vector<PlainPoint3D>& outline, double distance)
+{
+    MeshBody body;
+    if (outline.size() < 3 || distance == 0)
+        return body;
+
+    std::vector<double> xs(outline.size()), ys(outline.size());
+    for (size_t i = 0; i < outline.size(); i++)
+    {
+        xs[i] = outline[i].x;
+        ys[i] = outline[i].y;
+    }
+    std::vector<uint32_t> order(outline.size());
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    if (SignedArea(xs, ys) < 0)
+    {
+        std::reverse(order.begin(), order.end());
+        std::reverse(xs.begin(), xs.end());
+        std::reverse(ys.begin(), ys.end());
+    }
+
+    auto z = outline[0].z;
+    auto bottom = fmin(z, z + distance);
+    auto top = fmax(z, z + distance);
+    auto count = (uint32_t)outline.size();
+    for (uint32_t i = 0; i < count; i++)
+        body.addVertex({ xs[i], ys[i], bottom });
+    for (uint32_t i = 0; i < count; i++)
+        body.addVertex({ xs[i], ys[i], top });
+
+    for (auto& triangle : Triangulate(xs, ys))
+    {
+        body.addTriangle(triangle.a, triangle.c, triangle.b);
+        body.addTriangle(triangle.a + count, triangle.b + count, triangle.c + count);
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto j = (i + 1) % count;
+        body.addTriangle(i, j, j + count);
+        body.addTriangle(i, j + count, i + count);
+    }
+    return body;
+}
+
+MeshBody Revolve(const std::vector<PlainPoint3D>& profile, const MeshAxis& axis, double angelRad)
+{
+    MeshBody body;
+    if (profile.size() < 3 || angelRad == 0)
+        return body;
+
+    auto u = Normalize(axis.direction);
+    auto maxRadius = 0.0;
+    PlainPoint3D v = { 0, 0, 0 };
+    for (auto& point : profile)
+    {
+        auto p = Subtract(point, axis.point);
+        auto radial = Subtract(p, Scale(u, Dot(p, u)));
+        auto radius = sqrt(Dot(radial, radial));
+        if (radius > maxRadius)
+        {
+            maxRadius = radius;
+            v = Scale(radial, 1.0 / radius);
+        }
+    }
+    if (maxRadius <= 0)
+        return body;
+
+    if (angelRad < 0)
+    {
+        u = Scale(u, -1.0);
+        angelRad = -angelRad;
+    }
+    auto isFull = angelRad >= FULL_CIRCLE_RAD - 1e-9;
+    if (isFull)
+        angelRad = FULL_CIRCLE_RAD;
+
+    std::vector<double> as(profile.size()), rs(profile.size());
+    std::vector<PlainPoint3D> points(profile);
+    for (size_t i = 0; i < profile.size(); i++)
+    {
+        auto p = Subtract(profile[i], axis.point);
+        as[i] = Dot(p, u);
+        rs[i] = Dot(p, v);
+    }
+    if (SignedArea(as, rs) < 0)
+    {
+        std::reverse(as.begin(), as.end());
+        std::reverse(rs.begin(), rs.end());
+        std::reverse(points.begin(), points.end());
+    }
+
+    auto stepCount = std::max(1, (int)ceil(GetCircleSegmentCount(maxRadius) * angelRad / FULL_CIRCLE_RAD));
+    auto ringCount = isFull ? stepCount : stepCount + 1;
+    auto count = (uint32_t)points.size();
+    for (int s = 0; s < ringCount; s++)
+    {
+        auto angel = angelRad * s / stepCount;
+        auto cosA = cos(angel);
+        auto sinA = sin(angel);
+        for (auto& point : points)
+            body.addVertex(RotatePoint(point, axis.point, u, cosA, sinA));
+    }
+
+    for (int s = 0; s < stepCount; s++)
+    {
+        auto ring = (uint32_t)(s * count);
+        auto nextRing = (uint32_t)(((s + 1) % ringCount) * count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto j = (i + 1) % count;
+            body.addTriangle(ring + i, ring + j, nextRing + j);
+            body.addTriangle(ring + i, nextRing + j, nextRing + i);
+        }
+    }
+
+    if (!isFull)
+    {
+        auto lastRing = (uint32_t)(stepCount * count);
+        for (auto& triangle : Triangulate(as, rs))
+        {
+            body.addTriangle(triangle.a, triangle.c, triangle.b);
+            body.addTriangle(lastRing + triangle.a, lastRing + triangle.b, lastRing + triangle.c);
+        }
+    }
+
+    // points on the axis leave zero area triangles behind
+    body.weld();
+    return body;
+}
+
+MeshBody Move(const MeshBody& body, const MeshAxis& axis, double distance)
+{
+    auto result = body;
+    auto shift = Scale(Normalize(axis.direction), distance);
+    for (auto& vertex : result.vertices)
+        vertex = Add(vertex, shift);
+    return result;
+}
+
+MeshBody Rotate(const MeshBody& body, const MeshAxis& axis, double angel)
+{
+    auto result = body;
+    auto direction = Normalize(axis.direction);
+    auto cosA = cos(angel);
+    auto sinA = sin(angel);
+    for (auto& vertex : result.vertices)
+        vertex = RotatePoint(vertex, axis.point, direction, cosA, sinA);
+    return result;
+}
+
+MeshBody Combine(MeshOperation operation, const MeshBody& body1, const MeshBody& body2)
+{
+    return CsgCombine(operation, body1, body2);
+}
+
+MeshBody CreateSphere(const PlainPoint3D& center, double radius)
+{
+    MeshBody body;
+    auto segmentCount = GetCircleSegmentCount(radius);
+    auto ringCount = segmentCount / 2;
+
+    auto north = body.addVertex({ center.x, center.y, center.z + radius });
+    for (int ring = 1; ring < ringCount; ring++)
+    {
+        auto polar = M_PI * ring / ringCount;
+        for (int i = 0; i < segmentCount; i++)
+        {
+            auto angel = FULL_CIRCLE_RAD * i / segmentCount;
+            body.addVertex({ center.x + radius * sin(polar) * cos(angel), center.y + radius * sin(polar) * sin(angel), center.z + radius * cos(polar) });
+        }
+    }
+    auto south = body.addVertex({ center.x, center.y, center.z - radius });
+
+    auto vertexIndex = [&](int ring, int i) { return (uint32_t)(1 + (ring - 1) * segmentCount + i % segmentCount); };
+    for (int i = 0; i < segmentCount; i++)
+    {
+        body.addTriangle(north, vertexIndex(1, i), vertexIndex(1, i + 1));
+        body.addTriangle(south, vertexIndex(ringCount - 1, i + 1), vertexIndex(ringCount - 1, i));
+    }
+    for (int ring = 1; ring < ringCount - 1; ring++)
+    {
+        for (int i = 0; i < segmentCount; i++)
+        {
+            body.addTriangle(vertexIndex(ring, i), vertexIndex(ring + 1, i), vertexIndex(ring + 1, i + 1));
+            body.addTriangle(vertexIndex(ring, i), vertexIndex(ring + 1, i + 1), vertexIndex(ring, i + 1));
+        }
+    }
+    return body;
+}
+
+MeshBody CreateCylinder(const PlainPoint3D& center, double radius, double height)
+{
+    return Extrude(GetCirclePoints(center, radius), height);
+}
+
+MeshBody CreateBox(const PlainPoint3D& point1, const PlainPoint3D& point2, double height)
+{
+    return CreateBox(point1, point2, height, 0);
+}
+
+MeshBody CreateBox(const PlainPoint3D& point1, const PlainPoint3D& point2, double height, double verticalCornerFilletRadius)
+{
+    PlainPoint3D start = { point1.x, point1.y, 0 };
+    PlainPoint3D end = { point2.x, point2.y, 0 };
+    return Extrude(GetRoundedRectanglePoints(start, end, verticalCornerFilletRadius), height);
+}
+
+MeshBody CreateBox(const PlainPoint3D& point1, const PlainPoint3D& point2, double height, double verticalCornerFilletRadius, double wallThicknness)
+{
+    auto body = CreateBox(point1, point2, height, verticalCornerFilletRadius);
+    if (wallThicknness <= 0)
+        return body;
+    auto xMax = fmax(point1.x, point2.x) - wallThicknness;
+    auto xMin = fmin(point1.x, point2.x) + wallThicknness;
+    auto yMax = fmax(point1.y, point2.y) - wallThicknness;
+    auto yMin = fmin(point1.y, point2.y) + wallThicknness;
+    auto cutBody = CreateBox({ xMax, yMax, 0 }, { xMin, yMin, 0 }, height, verticalCornerFilletRadius - wallThicknness);
+    return Combine(CutMeshOperation, body, cutBody);
+}
+
+MeshBox CutShell(const MeshBox& box, double shellThickness)
+{
+    MeshBox result;
+    result.minPoint = { box.minPoint.x + shellThickness, box.minPoint.y + shellThickness, 0 };
+    result.maxPoint = { box.maxPoint.x - shellThickness, box.maxPoint.y - shellThickness, 0 };
+    return result;
+}
\ No newline at end of file
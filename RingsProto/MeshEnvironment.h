@@ -0,0 +1,42 @@
+#pragma once
+#include "MeshBody.h"
+#include "MeshCsg.h"
+
+// Headless counterparts of the FusionEnvironment body helpers. Sketch based
+// primitives are built on the XY plane like their Fusion versions; curved faces are
+// tessellated with MESH_CHORD_TOLERANCE.
+
+#define MESH_CHORD_TOLERANCE 0.001
+
+struct MeshAxis
+{
+    PlainPoint3D point;
+    PlainPoint3D direction;
+};
+
+MeshAxis XMeshAxis();
+MeshAxis YMeshAxis();
+MeshAxis ZMeshAxis();
+MeshAxis CreateMeshAxis(const PlainPoint3D& point, const PlainPoint3D& direction);
+
+int GetCircleSegmentCount(double radius);
+std::vector<PlainPoint3D> GetCirclePoints(const PlainPoint3D& center, double radius, int segmentCount = 0);
+std::vector<PlainPoint3D> GetRoundedRectanglePoints(const PlainPoint3D& point1, const PlainPoint3D& point2, double cornerRadius);
+
+// outline is a simple closed polygon on the XY plane, either orientation.
+MeshBody Extrude(const std::vector<PlainPoint3D>& outline, double distance);
+// profile is a simple closed polygon lying in a plane that contains the axis.
+MeshBody Revolve(const std::vector<PlainPoint3D>& profile, const MeshAxis& axis, double angelRad);
+
+MeshBody Move(const MeshBody& body, const MeshAxis& axis, double distance);
+MeshBody Rotate(const MeshBody& body, const MeshAxis& axis, double angel);
+MeshBody Combine(MeshOperation operation, const MeshBody& body1, const MeshBody& body2);
+
+MeshBody CreateSphere(const PlainPoint3D& center, double radius);
+MeshBody CreateCylinder(const PlainPoint3D& center, double radius, double height);
+MeshBody CreateBox(const PlainPoint3D& point1, const PlainPoint3D& point2, double height);
+// Vertical corners are rounded exactly instead of by a fillet feature.
+MeshBody CreateBox(const PlainPoint3D& point1, const PlainPoint3D& point2, double height, double verticalCornerFilletRadius);
+MeshBody CreateBox(const PlainPoint3D& point1, const PlainPoint3D& point2, double height, double verticalCornerFilletRadius, double wallThicknness);
+
+MeshBox CutShell(const MeshBox& box, double shellThickness);
\ No newline at end of file
@@ -0,0 +1,442 @@
+#include "MeshParts.h"
+#include <memory>
+
+namespace
+{
+    PlainPoint3D RotateAround(const PlainPoint3D& point, const PlainPoint3D& center, double angel)
+    {
+        auto x = point.x - center.x;
+        auto y = point.y - center.y;
+        return { center.x + x * cos(angel) - y * sin(angel), center.y + x * sin(angel) + y * cos(angel), point.z };
+    }
+
+    MeshBody CutCircles(MeshBody body, const std::vector<PlainPoint3D>& centers, double radius, double height)
+    {
+        for (auto& center : centers)
+            body = Combine(CutMeshOperation, body, CreateCylinder({ center.x, center.y, 0 }, radius, height));
+        return body;
+    }
+
+    // PariedSquaresPart profiles as solids: the inner wall is the part of both rings
+    // inside the overlap of the squares, the center is the overlap of the holes.
+    MeshBody CreatePariedSquaresInnerWallBody(const BasePartLayout& layout, double cornerOuterRadius, double thickness, double height)
+    {
+        auto leftSquare = Extrude(GetSquareOutline(layout.leftCenterPoint, layout.lineLength, cornerOuterRadius, RAD_45), height);
+        auto rightSquare = Extrude(GetSquareOutline(layout.rightCenterPoint, layout.lineLength, cornerOuterRadius, RAD_45), height);
+        auto rings = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius, RAD_45, thickness, height);
+        return Combine(IntersectMeshOperation, Combine(IntersectMeshOperation, rings, leftSquare), rightSquare);
+    }
+
+    MeshBody CreatePariedSquaresCenterBody(const BasePartLayout& layout, double cornerOuterRadius, double thickness, double height)
+    {
+        auto leftHole = Extrude(GetSquareOutline(layout.leftCenterPoint, layout.lineLength, cornerOuterRadius - thickness, RAD_45), height);
+        auto rightHole = Extrude(GetSquareOutline(layout.rightCenterPoint, layout.lineLength, cornerOuterRadius - thickness, RAD_45), height);
+        return Combine(IntersectMeshOperation, leftHole, rightHole);
+    }
+
+    MeshBody CreateLinkingCylinder(const LinkingPartLayout& layout, const PlainPoint3D& center, double radius, double height, double z)
+    {
+        auto body = CreateCylinder({ center.x, center.y, 0 }, radius, height);
+        if (!layout.isReverse && z != 0)
+            body = Move(body, ZMeshAxis(), z);
+        else if (layout.isReverse && z - height != 0)
+            body = Move(body, ZMeshAxis(), z - height);
+        return body;
+    }
+}
+
+std::vector<PlainPoint3D> GetSquareOutline(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel)
+{
+    auto halfSize = size / 2.0 + cornerOuterRadius;
+    auto points = GetRoundedRectanglePoints({ center.x - halfSize, center.y - halfSize, 0 }, { center.x + halfSize, center.y + halfSize, 0 }, cornerOuterRadius);
+    for (auto& point : points)
+        point = RotateAround(point, center, rotateAngel);
+    return points;
+}
+
+std::vector<PlainPoint3D> GetCirclesOnSquareCenters(const PlainPoint3D& center, double lineLength, double cornerMiddleRadius, double circlesOnSquarePeriodRadius, double rotateAngel)
+{
+    // Sketcher::AddCirclesOnSquare places one line circle and two corner circles, then
+    // turns the sketch by -90 degrees four times.
+    PlainPoint3D p1 = { center.x - lineLength / 2.0, center.y + cornerMiddleRadius + lineLength / 2.0, 0 };
+    PlainPoint3D p2 = { p1.x + lineLength, p1.y, 0 };
+    PlainPoint3D cornerCenter = { p2.x, p2.y - cornerMiddleRadius, 0 };
+
+    std::vector<PlainPoint3D> points;
+    for (int i = 0; i < 4; i++)
+    {
+        auto turn = -RAD_90 * (4 - i) + rotateAngel;
+        PlainPoint3D onLine = { p1.x + circlesOnSquarePeriodRadius, p1.y, 0 };
+        auto onCorner1 = RotateAround(p2, cornerCenter, -RAD_45 - RAD_45 / 2.0);
+        auto onCorner2 = RotateAround(p2, cornerCenter, -RAD_45 / 2.0);
+        points.push_back(RotateAround(onLine, center, turn));
+        points.push_back(RotateAround(onCorner1, center, turn));
+        points.push_back(RotateAround(onCorner2, center, turn));
+    }
+    return points;
+}
+
+std::vector<PlainPoint3D> GetPairedCirclesOnSquareCenters(const BasePartLayout& layout)
+{
+    auto points = GetCirclesOnSquareCenters(layout.leftCenterPoint, layout.lineLength, layout.cornerMiddleRadius, layout.circlesOnSquarePeriodRadius, RAD_45);
+    for (auto& point : GetCirclesOnSquareCenters(layout.rightCenterPoint, layout.lineLength, layout.cornerMiddleRadius, layout.circlesOnSquarePeriodRadius, RAD_45))
+        if (fabs(point.y) > 1e-9)
+            points.push_back(point);
+    return points;
+}
+
+void NameRoofBodies(std::vector<MeshBody>& bodies, const BasePartLayout& layout, double cornerOuterRadius, double width)
+{
+    auto smallShift = 0.1;
+    auto outerDistance = layout.lineLength / 2.0 + cornerOuterRadius;
+    auto innerDistance = layout.lineLength / 2.0 + cornerOuterRadius - width;
+    auto z = layout.height - smallShift;
+    auto left = layout.leftCenterPoint;
+    auto right = layout.rightCenterPoint;
+    auto angel = RAD_45 * 3.0;
+    PlainPoint3D mainPoint = { left.x + (outerDistance - smallShift) * cos(angel), left.y + (outerDistance - smallShift) * sin(angel), z };
+    PlainPoint3D leftPoint = { left.x + (innerDistance + smallShift) * cos(angel), left.y + (innerDistance + smallShift) * sin(angel), z };
+    PlainPoint3D rightPoint = { right.x + (innerDistance + smallShift) * cos(RAD_45), right.y + (innerDistance + smallShift) * sin(RAD_45), z };
+
+    for (auto& body : bodies)
+    {
+        if (body.containsPoint({ 0, 0, z }))
+            body.name = "CenterRoofBody";
+        else if (body.containsPoint(mainPoint))
+            body.name = "MainRoofBody";
+        else if (body.containsPoint(leftPoint))
+            body.name = "LeftSideRoofBody";
+        else if (body.containsPoint(rightPoint))
+            body.name = "RightSideRoofBody";
+    }
+}
+
+MeshBody CreateSquareBody(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel, double thickness, double height)
+{
+    auto body = Extrude(GetSquareOutline(center, size, cornerOuterRadius, rotateAngel), height);
+    if (size / 2.0 + cornerOuterRadius - thickness <= 0)
+        return body;
+    auto cutBody = Extrude(GetSquareOutline(center, size, cornerOuterRadius - thickness, rotateAngel), height);
+    return Combine(CutMeshOperation, body, cutBody);
+}
+
+MeshBody CreatePairedSquares(const BasePartLayout& layout, double size, double cornerOuterRadius, double rotateAngel, double thickness, double height)
+{
+    auto bodyLeft = CreateSquareBody(layout.leftCenterPoint, size, cornerOuterRadius, rotateAngel, thickness, height);
+    auto bodyRight = CreateSquareBody(layout.rightCenterPoint, size, cornerOuterRadius, rotateAngel, thickness, height);
+    return Combine(JoinMeshOperation, bodyLeft, bodyRight);
+}
+
+MeshBody CreateLinkingPartBody(const LinkingPartLayout& layout, const PlainPoint3D& center, const MeshBody* joinedBody)
+{
+    auto direction = layout.isReverse ? -1 : 1;
+
+    auto body = CreateLinkingCylinder(layout, center, layout.radius, layout.height, layout.z);
+    if (joinedBody != nullptr)
+        body = Combine(JoinMeshOperation, body, *joinedBody);
+    auto cutBody = CreateLinkingCylinder(layout, center, layout.radius - layout.wallThickness, layout.height - layout.floorThickness,
+        layout.z + direction * (layout.isFloorOnTop ? 0 : layout.floorThickness));
+    body = Combine(CutMeshOperation, body, cutBody);
+    if (layout.floorHoleRadius > 0 && layout.floorThickness > 0)
+    {
+        auto cutFloorBody = CreateLinkingCylinder(layout, center, layout.floorHoleRadius, layout.floorThickness,
+            layout.z + direction * (layout.isFloorOnTop ? layout.height - layout.floorThickness : 0));
+        body = Combine(CutMeshOperation, body, cutFloorBody);
+    }
+    return body;
+}
+
+MeshBody CreateBasePartBody(const BasePartLayout& layout)
+{
+    auto cornerOuterRadius = layout.cornerMiddleRadius + layout.outerWidth;
+    auto width = layout.outerWidth + layout.innerWidth;
+
+    auto body = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius, RAD_45, width, layout.height);
+    auto cutWayBody = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius - layout.wallThickness, RAD_45, width - 2.0 * layout.wallThickness, layout.height);
+    cutWayBody = Move(cutWayBody, ZMeshAxis(), layout.floorThickness);
+    body = Combine(CutMeshOperation, body, cutWayBody);
+
+    body = CutCircles(body, GetPairedCirclesOnSquareCenters(layout), layout.circlesOnSquareRadius, layout.floorThickness * 3.0);
+    body.name = "BaseBody";
+    return body;
+}
+
+MeshBody CreateRectangledBasePartBody(const RectangledBasePartLayout& layout, bool isPapaCenterPart)
+{
+    auto cornerOuterRadius = layout.cornerMiddleRadius + layout.outerWidth;
+    auto width = layout.outerWidth + layout.innerWidth;
+    auto height = layout.height;
+    auto wallThickness = layout.wallThickness;
+    auto floorThickness = layout.floorThickness;
+
+    auto body = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius, RAD_45, width, height);
+
+    auto outerBox = body.boundingBox();
+    auto box = CutShell(outerBox, layout.cuttingShellThickness);
+
+    auto cutWayBody = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius - wallThickness, RAD_45, width - 2.0 * wallThickness, height);
+    cutWayBody = Move(cutWayBody, ZMeshAxis(), floorThickness);
+    auto cutShellBody = CreateBox(outerBox.minPoint, outerBox.maxPoint, height, 0, width - wallThickness);
+    cutWayBody = Combine(JoinMeshOperation, cutWayBody, cutShellBody);
+    body = Combine(CutMeshOperation, body, cutWayBody);
+
+    auto floorBody = CreateBox(box.minPoint, box.maxPoint, floorThickness, layout.cornerFilletRadius);
+    body = Combine(JoinMeshOperation, body, floorBody);
+
+    auto intersectBody = CreateBox(box.minPoint, box.maxPoint, height);
+    body = Combine(IntersectMeshOperation, body, intersectBody);
+
+    body = CutCircles(body, GetPairedCirclesOnSquareCenters(layout), layout.circlesOnSquareRadius, floorThickness * 3.0);
+
+    if (!isPapaCenterPart)
+    {
+        auto centerJoinBody = CreatePariedSquaresInnerWallBody(layout, cornerOuterRadius - width + wallThickness * 2.0, wallThickness, height);
+        auto centerBox = centerJoinBody.boundingBox();
+        auto centerCutBody = CreateBox(centerBox.minPoint, centerBox.maxPoint, height);
+        centerCutBody = Move(centerCutBody, ZMeshAxis(), floorThickness);
+        body = Combine(CutMeshOperation, body, centerCutBody);
+        body = Combine(JoinMeshOperation, body, centerJoinBody);
+    }
+
+    auto top = box.maxPoint.y;
+    auto down = box.minPoint.y;
+    for (auto& point : layout.linkerPoints)
+        body = CreateLinkingPartBody(layout.linkingPart, point, &body);
+
+    auto centralLinkerRadius = layout.centralLinkerRadius;
+    auto upCentralLinkerBody = CreateCylinder({ 0, top - centralLinkerRadius - wallThickness / 3.0, 0 }, centralLinkerRadius, height);
+    body = Combine(JoinMeshOperation, body, upCentralLinkerBody);
+    auto downCentralLinkerBody = CreateCylinder({ 0, down + centralLinkerRadius + wallThickness / 3.0, 0 }, centralLinkerRadius, height);
+    body = Combine(JoinMeshOperation, body, downCentralLinkerBody);
+
+    body.name = "BaseBody";
+    return body;
+}
+
+std::vector<MeshBody> CreateRoofPartBodies(const RoofPartLayout& layout)
+{
+    auto cornerOuterRadius = layout.cornerMiddleRadius + layout.outerWidth;
+    auto width = layout.outerWidth + layout.innerWidth;
+    auto separationCornerOuterRadius = layout.cornerMiddleRadius + layout.separationOuterWidth;
+    auto separationWidth = layout.separationOuterWidth + layout.separationInnerWidth;
+    auto height = layout.height;
+
+    auto body = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius, RAD_45, width, height);
+    auto centerBody = CreateCylinder({ 0, 0, 0 }, width, height);
+    body = Combine(JoinMeshOperation, body, centerBody);
+
+    auto cutBody = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius - layout.wallThickness, RAD_45, width - 2.0 * layout.wallThickness, height - layout.floorThickness);
+    auto separationCutBody = CreatePairedSquares(layout, layout.lineLength, separationCornerOuterRadius, RAD_45, separationWidth, height);
+    cutBody = Combine(JoinMeshOperation, cutBody, separationCutBody);
+    auto substrateCutBody = CreateCylinder({ 0, 0, 0 }, 2.0 * (layout.lineLength + cornerOuterRadius * 2.0), layout.downTrimmingThicknes);
+    cutBody = Combine(JoinMeshOperation, cutBody, substrateCutBody);
+
+    auto bodies = SplitComponents(Combine(CutMeshOperation, body, cutBody));
+    NameRoofBodies(bodies, layout, cornerOuterRadius, width);
+    return bodies;
+}
+
+std::vector<MeshBody> CreateRectangledRoofPartBodies(const RectangledRoofPartLayout& layout, const PlainPoint3D* linkerPoints, int linkerPointCount, bool isPapaCenterPart)
+{
+    auto cornerOuterRadius = layout.cornerMiddleRadius + layout.outerWidth;
+    auto width = layout.outerWidth + layout.innerWidth;
+    auto separationCornerOuterRadius = layout.cornerMiddleRadius + layout.separationOuterWidth;
+    auto separationWidth = layout.separationOuterWidth + layout.separationInnerWidth;
+    auto height = layout.height;
+    auto wallThickness = layout.wallThickness;
+    auto floorThickness = layout.floorThickness;
+    auto cornerFilletRadius = layout.cornerFilletRadius;
+
+    auto body = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius, RAD_45, width, height);
+    auto box = body.boundingBox();
+    auto boundWallBody = CreateBox(box.minPoint, box.maxPoint, height, cornerFilletRadius, wallThickness);
+    auto roofBody = CreateBox(box.minPoint, box.maxPoint, floorThickness, cornerFilletRadius);
+    roofBody = Move(roofBody, ZMeshAxis(), height - floorThickness);
+    body = Combine(JoinMeshOperation, body, boundWallBody);
+    body = Combine(JoinMeshOperation, body, roofBody);
+    auto left = layout.leftCenterPoint.x;
+    auto right = layout.rightCenterPoint.x;
+    auto centerUpBody = CreateBox({ left, box.maxPoint.y - width, 0 }, { right, box.maxPoint.y, 0 }, height);
+    auto centerDownBody = CreateBox({ left, box.minPoint.y, 0 }, { right, box.minPoint.y + width, 0 }, height);
+    body = Combine(JoinMeshOperation, body, centerUpBody);
+    body = Combine(JoinMeshOperation, body, centerDownBody);
+
+    auto cutBody = CreatePairedSquares(layout, layout.lineLength, cornerOuterRadius - wallThickness, RAD_45, width - 2.0 * wallThickness, height - floorThickness);
+    auto separationCutBody = CreatePairedSquares(layout, layout.lineLength, separationCornerOuterRadius, RAD_45, separationWidth, height);
+    cutBody = Combine(JoinMeshOperation, cutBody, separationCutBody);
+    auto substrateCutBody = CreateCylinder({ 0, 0, 0 }, 2.0 * (layout.lineLength + cornerOuterRadius * 2.0), layout.downTrimmingThicknes);
+    cutBody = Combine(JoinMeshOperation, cutBody, substrateCutBody);
+    auto deepBox = CutShell(box, wallThickness);
+    auto deepCutBody = CreateBox(deepBox.minPoint, deepBox.maxPoint, layout.deepThickness, cornerFilletRadius - wallThickness);
+    cutBody = Combine(JoinMeshOperation, cutBody, deepCutBody);
+
+    auto bodies = SplitComponents(Combine(CutMeshOperation, body, cutBody));
+    NameRoofBodies(bodies, layout, cornerOuterRadius, width);
+
+    std::vector<MeshBody> result;
+    MeshBody mainBody;
+    MeshBody centerBody;
+    for (auto& part : bodies)
+    {
+        if (part.name == "CenterRoofBody")
+            centerBody = part;
+        else if (part.name == "MainRoofBody")
+            mainBody = part;
+        else if (part.name == "LeftSideRoofBody" || part.name == "RightSideRoofBody")
+            result.push_back(part);
+    }
+
+    if (isPapaCenterPart && !centerBody.isEmpty())
+    {
+        auto innerCornerOuterRadius = cornerOuterRadius - width + wallThickness;
+        auto centerBox = centerBody.boundingBox();
+        auto centerCutBody = CreateBox(centerBox.minPoint, centerBox.maxPoint, height - layout.deepThickness);
+        centerBody = Combine(CutMeshOperation, centerBody, centerCutBody);
+        auto centerJoinBody = CreatePariedSquaresCenterBody(layout, innerCornerOuterRadius, wallThickness, height - layout.deepThickness);
+        centerJoinBody = Move(centerJoinBody, ZMeshAxis(), layout.deepThickness);
+        centerBody = Combine(JoinMeshOperation, centerBody, centerJoinBody);
+        centerBody.name = "CenterRoofBody";
+    }
+
+    // RectangledRoofPart::addLinkersToMainBody
+    auto mainBox = mainBody.boundingBox();
+    for (int i = 0; i < linkerPointCount; i++)
+        mainBody = CreateLinkingPartBody(layout.linkingPart, linkerPoints[i], &mainBody);
+    auto centralLinkerRadius = layout.centralLinkerRadius;
+    auto centralLinkerShift = centralLinkerRadius + wallThickness + wallThickness / 3.0 - 0.01;
+    auto upCentralLinkerBody = CreateCylinder({ 0, mainBox.maxPoint.y - centralLinkerShift, 0 }, centralLinkerRadius, height - floorThickness);
+    mainBody = Combine(CutMeshOperation, mainBody, upCentralLinkerBody);
+    auto downCentralLinkerBody = CreateCylinder({ 0, mainBox.minPoint.y + centralLinkerShift, 0 }, centralLinkerRadius, height - floorThickness);
+    mainBody = Combine(CutMeshOperation, mainBody, downCentralLinkerBody);
+    mainBody.name = "MainRoofBody";
+    result.push_back(mainBody);
+
+    result.push_back(centerBody);
+    return result;
+}
+
+MeshBody CreateVolfUpPartBody(const VolfUpPartLayout& layout, const PlainPoint3D& centerPoint)
+{
+    auto body = CreateCylinder(centerPoint, layout.radius, layout.height);
+
+    if (layout.middleRadius > 0 && layout.middleHeight > 0)
+    {
+        auto middleBody = CreateCylinder(centerPoint, layout.middleRadius, layout.middleHeight);
+        body = Move(body, ZMeshAxis(), layout.middleHeight);
+        body = Combine(JoinMeshOperation, body, middleBody);
+    }
+
+    if (layout.holeRadius > 0 && layout.holeHeight > 0)
+        body = Combine(CutMeshOperation, body, CreateCylinder(centerPoint, layout.holeRadius, layout.holeHeight));
+
+    if (layout.holeDownRadius > 0 && layout.holeDownHeight > 0)
+        body = Combine(CutMeshOperation, body, CreateCylinder(centerPoint, layout.holeDownRadius, layout.holeDownHeight));
+
+    if (layout.holeUpRadius > 0 && layout.holeUpHeight > 0)
+    {
+        auto holeBody = CreateCylinder(centerPoint, layout.holeUpRadius, layout.holeUpHeight);
+        holeBody = Move(holeBody, ZMeshAxis(), layout.height + layout.middleHeight - layout.holeUpHeight);
+        body = Combine(CutMeshOperation, body, holeBody);
+    }
+
+    auto top = centerPoint.z + layout.height + layout.middleHeight;
+    if (layout.form == VolfUpForm::Concave && layout.concaveRadius > 0 && layout.concaveHeight > 0)
+    {
+        auto sphereBody = CreateSphere({ centerPoint.x, centerPoint.y, top + layout.concaveRadius - layout.concaveHeight }, layout.concaveRadius);
+        body = Combine(CutMeshOperation, body, sphereBody);
+    }
+    else if (layout.form == VolfUpForm::Convex && layout.convexRadius > 0)
+    {
+        auto sphereBody = CreateSphere({ centerPoint.x, centerPoint.y, top - layout.convexRadius }, layout.convexRadius);
+        body = Combine(IntersectMeshOperation, body, sphereBody);
+    }
+
+    body = Move(body, ZMeshAxis(), layout.zMoveShift - layout.middleHeight);
+    body.name = "VolfUpBody";
+    return body;
+}
+
+MeshBody CreateVolfDownPartBody(const VolfDownPartLayout& layout, const PlainPoint3D& centerPoint)
+{
+    auto body = CreateCylinder(centerPoint, layout.radius, layout.height);
+
+    if (layout.middleRadius > 0 && layout.middleHeight > 0)
+    {
+        auto middleBody = CreateCylinder(centerPoint, layout.middleRadius, layout.middleHeight);
+        middleBody = Move(middleBody, ZMeshAxis(), layout.height);
+        body = Combine(JoinMeshOperation, body, middleBody);
+    }
+
+    if (layout.holeRadius > 0 && layout.holeHeight > 0)
+        body = Combine(CutMeshOperation, body, CreateCylinder(centerPoint, layout.holeRadius, layout.holeHeight));
+
+    if (layout.holeDownRadius > 0 && layout.holeDownHeight > 0)
+        body = Combine(CutMeshOperation, body, CreateCylinder(centerPoint, layout.holeDownRadius, layout.holeDownHeight));
+
+    if (layout.holeUpRadius > 0 && layout.holeUpHeight > 0)
+    {
+        auto holeBody = CreateCylinder(centerPoint, layout.holeUpRadius, layout.holeUpHeight);
+        holeBody = Move(holeBody, ZMeshAxis(), layout.height + layout.middleHeight - layout.holeUpHeight);
+        body = Combine(CutMeshOperation, body, holeBody);
+    }
+
+    body = Move(body, ZMeshAxis(), layout.zMoveShift);
+    body.name = "VolfDownBody";
+    return body;
+}
+
+void AddRings2D2SquaresTasks(TaskGraph& graph, const Rings2D2SquaresLayout& layout, bool isRectangled, std::vector<MeshBody>& bodies)
+{
+    // every part has its slot, the join after run keeps their order
+    struct PartSlots
+    {
+        MeshBody baseBody;
+        std::vector<MeshBody> roofBodies;
+        std::vector<MeshBody> volfBodies;
+    };
+    auto slots = std::make_shared<PartSlots>();
+
+    auto baseTask = graph.add([slots, &layout, isRectangled]()
+    {
+        slots->baseBody = isRectangled ? CreateRectangledBasePartBody(layout.basePart) : CreateBasePartBody(layout.basePart);
+    });
+    auto roofTask = graph.add([slots, &layout, isRectangled]()
+    {
+        slots->roofBodies = isRectangled ? CreateRectangledRoofPartBodies(layout.roofPart, layout.basePart.linkerPoints, 4) : CreateRoofPartBodies(layout.roofPart);
+    });
+
+    // the first volf place right of the right square center, as createBodies picks it
+    auto volfBase = layout.basePart;
+    volfBase.circlesOnSquarePeriodRadius = layout.volfRadius;
+    std::vector<int> volfTasks;
+    for (auto& center : GetPairedCirclesOnSquareCenters(volfBase))
+    {
+        if (center.x < layout.rightCenterPoint.x + 2.0 * layout.volfRadius || center.y < 0)
+            continue;
+        slots->volfBodies.resize(2);
+        volfTasks.push_back(graph.add([slots, &layout, center]() { slots->volfBodies[0] = CreateVolfDownPartBody(layout.volfDownPart, center); }));
+        volfTasks.push_back(graph.add([slots, &layout, center]() { slots->volfBodies[1] = CreateVolfUpPartBody(layout.volfUpPart, center); }));
+        break;
+    }
+
+    auto joinDependencies = volfTasks;
+    joinDependencies.insert(joinDependencies.begin(), { baseTask, roofTask });
+    graph.add([slots, &bodies]()
+    {
+        bodies.clear();
+        bodies.push_back(std::move(slots->baseBody));
+        for (auto& body : slots->roofBodies)
+            bodies.push_back(std::move(body));
+        for (auto& body : slots->volfBodies)
+            bodies.push_back(std::move(body));
+    }, joinDependencies);
+}
+
+std::vector<MeshBody> CreateRings2D2SquaresBodies(const Rings2D2SquaresLayout& layout, bool isRectangled, int threadCount)
+{
+    std::vector<MeshBody> bodies;
+    TaskGraph graph;
+    AddRings2D2SquaresTasks(graph, layout, isRectangled, bodies);
+    graph.run(threadCount);
+    return bodies;
+}
\ No newline at end of file
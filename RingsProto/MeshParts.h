@@ -0,0 +1,35 @@
+#pragma once
+#include "MeshEnvironment.h"
+#include "PartLayouts.h"
+#include "Rings2D2SquaresLayout.h"
+#include "TaskGraph.h"
+
+// Mesh builds of the parts from their layouts. They follow the createBody/createBodies
+// methods of the part classes step by step, except that fillets are not applied.
+
+std::vector<PlainPoint3D> GetSquareOutline(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel);
+std::vector<PlainPoint3D> GetCirclesOnSquareCenters(const PlainPoint3D& center, double lineLength, double cornerMiddleRadius, double circlesOnSquarePeriodRadius, double rotateAngel);
+// Circle centers of BasePart::createCirclesSketch: both squares, the shared ones once.
+std::vector<PlainPoint3D> GetPairedCirclesOnSquareCenters(const BasePartLayout& layout);
+
+// Names roof components by points only the main, center, left or right part contains.
+void NameRoofBodies(std::vector<MeshBody>& bodies, const BasePartLayout& layout, double cornerOuterRadius, double width);
+
+MeshBody CreateSquareBody(const PlainPoint3D& center, double size, double cornerOuterRadius, double rotateAngel, double thickness, double height);
+MeshBody CreatePairedSquares(const BasePartLayout& layout, double size, double cornerOuterRadius, double rotateAngel, double thickness, double height);
+
+MeshBody CreateLinkingPartBody(const LinkingPartLayout& layout, const PlainPoint3D& center, const MeshBody* joinedBody = nullptr);
+MeshBody CreateBasePartBody(const BasePartLayout& layout);
+MeshBody CreateRectangledBasePartBody(const RectangledBasePartLayout& layout, bool isPapaCenterPart = false);
+std::vector<MeshBody> CreateRoofPartBodies(const RoofPartLayout& layout);
+std::vector<MeshBody> CreateRectangledRoofPartBodies(const RectangledRoofPartLayout& layout, const PlainPoint3D* linkerPoints, int linkerPointCount, bool isPapaCenterPart = true);
+MeshBody CreateVolfUpPartBody(const VolfUpPartLayout& layout, const PlainPoint3D& centerPoint);
+MeshBody CreateVolfDownPartBody(const VolfDownPartLayout& layout, const PlainPoint3D& centerPoint);
+
+// Everything Rings2D2Squares::createBodies builds, plus one volf pair. The parts are
+// built as independent tasks on threadCount threads (0 for all cores), the bodies come
+// in the same order for any count.
+std::vector<MeshBody> CreateRings2D2SquaresBodies(const Rings2D2SquaresLayout& layout, bool isRectangled = true, int threadCount = 1);
+// Adds the part builds of CreateRings2D2SquaresBodies to the graph, they fill bodies when
+// it runs. The layout and the bodies must outlive the run.
+void AddRings2D2SquaresTasks(TaskGraph& graph, const Rings2D2SquaresLayout& layout, bool isRectangled, std::vector<MeshBody>& bodies);
\ No newline at end of file
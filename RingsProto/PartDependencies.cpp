@@ -0,0 +1,187 @@
+#include "PartDependencies.h"
+
+void AddValues(PartValues& values, const PlainPoint3D& point)
+{
+    values.insert(values.end(), { point.x, point.y, point.z });
+}
+
+void AddValues(PartValues& values, const LinkingPartLayout& layout)
+{
+    values.insert(values.end(), {
+        layout.radius,
+        layout.height,
+        layout.z,
+        layout.wallThickness,
+        layout.floorThickness,
+        layout.floorHoleRadius,
+        layout.isFloorOnTop ? 1.0 : 0.0,
+        layout.isReverse ? 1.0 : 0.0 });
+}
+
+void AddValues(PartValues& values, const BasePartLayout& layout)
+{
+    values.insert(values.end(), {
+        layout.lineLength,
+        layout.cornerMiddleRadius,
+        layout.outerWidth,
+        layout.innerWidth,
+        layout.height,
+        layout.wallThickness,
+        layout.floorThickness,
+        layout.circlesOnSquareRadius,
+        layout.circlesOnSquarePeriodRadius });
+    AddValues(values, layout.leftCenterPoint);
+    AddValues(values, layout.rightCenterPoint);
+    values.insert(values.end(), {
+        layout.zMoveShift,
+        layout.topEdgeFilletRadius,
+        layout.verticalEdgeFilletRadius,
+        layout.otherEdgeFilletRadius });
+}
+
+void AddValues(PartValues& values, const RectangledBasePartLayout& layout)
+{
+    AddValues(values, static_cast<const BasePartLayout&>(layout));
+    values.insert(values.end(), {
+        layout.cornerFilletRadius,
+        layout.cuttingShellThickness,
+        layout.centralLinkerRadius });
+    AddValues(values, layout.linkingPart);
+    for (auto& point : layout.linkerPoints)
+        AddValues(values, point);
+}
+
+void AddValues(PartValues& values, const RoofPartLayout& layout)
+{
+    AddValues(values, static_cast<const BasePartLayout&>(layout));
+    values.insert(values.end(), {
+        layout.separationInnerWidth,
+        layout.separationOuterWidth,
+        layout.downTrimmingThicknes });
+}
+
+void AddValues(PartValues& values, const RectangledRoofPartLayout& layout)
+{
+    AddValues(values, static_cast<const RoofPartLayout&>(layout));
+    values.insert(values.end(), {
+        layout.deepThickness,
+        layout.cornerFilletRadius,
+        layout.centralLinkerRadius });
+    AddValues(values, layout.linkingPart);
+}
+
+void AddValues(PartValues& values, const VolfUpPartLayout& layout)
+{
+    values.insert(values.end(), {
+        layout.radius,
+        layout.height,
+        layout.middleRadius,
+        layout.middleHeight,
+        layout.holeRadius,
+        layout.holeHeight,
+        layout.holeUpRadius,
+        layout.holeUpHeight,
+        layout.holeDownRadius,
+        layout.holeDownHeight,
+        layout.zMoveShift,
+        layout.filletRadius,
+        (double)layout.form,
+        layout.concaveHeight,
+        layout.concaveRadius,
+        layout.convexRadius });
+}
+
+void AddValues(PartValues& values, const VolfDownPartLayout& layout)
+{
+    values.insert(values.end(), {
+        layout.radius,
+        layout.height,
+        layout.middleRadius,
+        layout.middleHeight,
+        layout.holeRadius,
+        layout.holeHeight,
+        layout.holeUpRadius,
+        layout.holeUpHeight,
+        layout.holeDownRadius,
+        layout.holeDownHeight,
+        layout.zMoveShift,
+        layout.filletRadius });
+}
+
+const PartDependencyGraph::Node* PartDependencyGraph::findNode(const std::string& name) const
+{
+    for (auto& node : nodes)
+        if (node.name == name)
+            return &node;
+    return nullptr;
+}
+
+void PartDependencyGraph::setNode(const std::string& name, const PartValues& values, const std::vector<std::string>& dependencies)
+{
+    for (auto& node : nodes)
+    {
+        if (node.name != name)
+            continue;
+        node.values = values;
+        node.dependencies = dependencies;
+        return;
+    }
+    Node node;
+    node.name = name;
+    node.values = values;
+    node.dependencies = dependencies;
+    nodes.push_back(node);
+}
+
+bool PartDependencyGraph::isDirty(const std::string& name) const
+{
+    auto node = findNode(name);
+    if (node == nullptr || !node->isBuilt || node->values != node->builtValues)
+        return true;
+    for (auto& dependency : node->dependencies)
+        if (isDirty(dependency))
+            return true;
+    return false;
+}
+
+std::vector<std::string> PartDependencyGraph::getDirtyDependencies(const std::string& name) const
+{
+    std::vector<std::string> result;
+    auto node = findNode(name);
+    if (node == nullptr)
+        return result;
+    for (auto& dependency : node->dependencies)
+        if (isDirty(dependency))
+            result.push_back(dependency);
+    return result;
+}
+
+const PartValues* PartDependencyGraph::getBuiltValues(const std::string& name) const
+{
+    auto node = findNode(name);
+    return node != nullptr && node->isBuilt ? &node->builtValues : nullptr;
+}
+
+void PartDependencyGraph::markBuilt()
+{
+    for (auto& node : nodes)
+    {
+        node.builtValues = node.values;
+        node.isBuilt = true;
+    }
+}
+
+void PartDependencyGraph::invalidate()
+{
+    for (auto& node : nodes)
+        node.isBuilt = false;
+}
+
+std::vector<std::string> PartDependencyGraph::getNodes(bool isDirty) const
+{
+    std::vector<std::string> result;
+    for (auto& node : nodes)
+        if (this->isDirty(node.name) == isDirty)
+            result.push_back(node.name);
+    return result;
+}
\ No newline at end of file
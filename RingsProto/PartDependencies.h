@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "PartLayouts.h"
+
+// The field values a layout gives its part, in a fixed order. Equal values build the
+// same body, so they stand for the part in the dependency graph.
+typedef std::vector<double> PartValues;
+
+void AddValues(PartValues& values, const PlainPoint3D& point);
+void AddValues(PartValues& values, const LinkingPartLayout& layout);
+void AddValues(PartValues& values, const BasePartLayout& layout);
+void AddValues(PartValues& values, const RectangledBasePartLayout& layout);
+void AddValues(PartValues& values, const RoofPartLayout& layout);
+void AddValues(PartValues& values, const RectangledRoofPartLayout& layout);
+void AddValues(PartValues& values, const VolfUpPartLayout& layout);
+void AddValues(PartValues& values, const VolfDownPartLayout& layout);
+
+// Inputs of a puzzle, the parts and the shared values they use, with the values they were
+// last built with. A part node holds its solved fields, so an input change reaches exactly
+// the parts whose fields it moved; the puzzle links an input to those parts to tell which
+// input drove a rebuild. A node is dirty when it was never built, its values changed since
+// or one of its dependencies is dirty.
+class PartDependencyGraph
+{
+public:
+    // sets the current values of the node, a new node is dirty
+    void setNode(const std::string& name, const PartValues& values, const std::vector<std::string>& dependencies = {});
+    bool isDirty(const std::string& name) const;
+    // the dependencies of the node that are dirty
+    std::vector<std::string> getDirtyDependencies(const std::string& name) const;
+    // the values the node was last built with, nullptr when it was never built
+    const PartValues* getBuiltValues(const std::string& name) const;
+    // the current values of every node are built
+    void markBuilt();
+    // every node is dirty until the next markBuilt
+    void invalidate();
+    // the nodes in the order they were set first
+    std::vector<std::string> getNodes(bool isDirty) const;
+
+private:
+    struct Node
+    {
+        std::string name;
+        PartValues values;
+        PartValues builtValues;
+        bool isBuilt = false;
+        std::vector<std::string> dependencies;
+    };
+
+    std::vector<Node> nodes;
+
+    const Node* findNode(const std::string& name) const;
+};
\ No newline at end of file
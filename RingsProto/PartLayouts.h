@@ -0,0 +1,107 @@
+#pragma once
+#include "Geometry.h"
+
+// Plain-value mirrors of the part fields. They carry no Fusion objects, so a layout
+// can be solved and compared without the Fusion runtime; the parts copy from them.
+
+struct LinkingPartLayout
+{
+    double radius = 0;
+    double height = 0;
+    double z = 0;
+    double wallThickness = 0;
+    double floorThickness = 0;
+    double floorHoleRadius = 0;
+    bool isFloorOnTop = true;
+    bool isReverse = false;
+};
+
+struct BasePartLayout
+{
+    double lineLength = 0;
+    double cornerMiddleRadius = 0;
+    double outerWidth = 0;
+    double innerWidth = 0;
+    double height = 0;
+    double wallThickness = 0;
+    double floorThickness = 0;
+    double circlesOnSquareRadius = 0;
+    double circlesOnSquarePeriodRadius = 0;
+
+    PlainPoint3D leftCenterPoint;
+    PlainPoint3D rightCenterPoint;
+    double zMoveShift = 0;
+    double topEdgeFilletRadius = 0;
+    double verticalEdgeFilletRadius = 0;
+    double otherEdgeFilletRadius = 0;
+};
+
+struct RectangledBasePartLayout : BasePartLayout
+{
+    double cornerFilletRadius = 0;
+    double cuttingShellThickness = 0;
+    double centralLinkerRadius = 0;
+    LinkingPartLayout linkingPart;
+    PlainPoint3D linkerPoints[4];
+};
+
+struct RoofPartLayout : BasePartLayout
+{
+    double separationInnerWidth = 0;
+    double separationOuterWidth = 0;
+    double downTrimmingThicknes = 0;
+};
+
+struct RectangledRoofPartLayout : RoofPartLayout
+{
+    double deepThickness = 0;
+    double cornerFilletRadius = 0;
+    double centralLinkerRadius = 0;
+    LinkingPartLayout linkingPart;
+};
+
+enum class VolfUpForm { Convex, Concave, Straight };
+
+struct VolfUpPartLayout
+{
+    double radius = 0;
+    double height = 0;
+    double middleRadius = 0;
+    double middleHeight = 0;
+    double holeRadius = 0;
+    double holeHeight = 0;
+    double holeUpRadius = 0;
+    double holeUpHeight = 0;
+    double holeDownRadius = 0;
+    double holeDownHeight = 0;
+    double zMoveShift = 0;
+    double filletRadius = 0;
+    VolfUpForm form = VolfUpForm::Straight;
+    double concaveHeight = 0;
+    double concaveRadius = 0;
+    double convexRadius = 0;
+};
+
+struct VolfDownPartLayout
+{
+    double radius = 0;
+    double height = 0;
+    double middleRadius = 0;
+    double middleHeight = 0;
+    double holeRadius = 0;
+    double holeHeight = 0;
+    double holeUpRadius = 0;
+    double holeUpHeight = 0;
+    double holeDownRadius = 0;
+    double holeDownHeight = 0;
+    double zMoveShift = 0;
+    double filletRadius = 0;
+};
+
+struct MetizLayout
+{
+    double hatRadius = 0;
+    double hatHeight = 0;
+    double legRadius = 0;
+    double legHeight = 0;
+};
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "PuzzlePlates.h"
+#include "MeshParts.h"
+#include <cstdio>
+
+namespace
+{
+    std::string ToMillimeters(double value)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%g mm", value * THREE_MF_SCALE);
+        return text;
+    }
+
+    int AddPart(ThreeMfWriter& writer, const MeshBody& body)
+    {
+        return writer.addObject(body, { { "rings:Part", body.name } });
+    }
+}
+
+ThreeMfMetadata GetClearanceMetadata(const Rings2D2SquaresParams& params)
+{
+    return
+    {
+        { "rings:MoovableClearence", ToMillimeters(params.moovableClearence) },
+        { "rings:UnmoovableClearence", ToMillimeters(params.unmoovableClearence) },
+    };
+}
+
+ThreeMfMetadata GetClearanceMetadata(const RingsProtoCreatorParams& params)
+{
+    return
+    {
+        { "rings:MoovableClearence", ToMillimeters(params.clearanceMovable) },
+        { "rings:UnmoovableClearence", ToMillimeters(params.clearanceUnmovable) },
+        { "rings:BaseWallToVolfLegClearence", ToMillimeters(params.clearanceBetweenBaseWallAndVolfLeg) },
+    };
+}
+
+bool SaveRings2D2SquaresAs3mf(const std::vector<MeshBody>& bodies, const Rings2D2SquaresParams& params, const Rings2D2SquaresLayout& layout, const std::string& filepath)
+{
+    auto volfBase = layout.basePart;
+    volfBase.circlesOnSquarePeriodRadius = layout.volfRadius;
+    auto volfCount = GetPairedCirclesOnSquareCenters(volfBase).size();
+
+    ThreeMfWriter writer;
+    writer.addMetadata("Title", "Rings2D2Squares");
+    for (auto& item : GetClearanceMetadata(params))
+        writer.addMetadata(item.first, item.second);
+
+    for (auto& body : bodies)
+    {
+        auto id = AddPart(writer, body);
+        auto count = body.name.compare(0, 4, "Volf") == 0 ? volfCount : 1;
+        for (size_t i = 0; i < count; i++)
+            writer.addItem(id);
+    }
+    writer.arrange();
+    return writer.save(filepath);
+}
+
+bool SaveRingsProtoAs3mf(const MeshBody& baseBody, const MeshBody& volfBody, const RingsProtoCreatorParams& params, const std::string& filepath)
+{
+    ThreeMfWriter writer;
+    writer.addMetadata("Title", "RingsProto");
+    for (auto& item : GetClearanceMetadata(params))
+        writer.addMetadata(item.first, item.second);
+
+    // createBaseBody leaves the base and its copy turned by 90 degrees
+    auto baseId = AddPart(writer, baseBody);
+    writer.addItem(baseId);
+    writer.addItem(baseId);
+    auto volfId = AddPart(writer, volfBody);
+    for (int i = 0; i < params.volfCount; i++)
+        writer.addItem(volfId);
+    writer.arrange();
+    return writer.save(filepath);
+}
\ No newline at end of file
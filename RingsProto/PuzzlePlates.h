@@ -0,0 +1,15 @@
+#pragma once
+#include "MeshBody.h"
+#include "Rings2D2SquaresLayout.h"
+#include "RingsProtoCreatorLayout.h"
+#include "ThreeMfWriter.h"
+
+// Clearances of the puzzle as 3MF metadata, in millimeters as the printed model.
+ThreeMfMetadata GetClearanceMetadata(const Rings2D2SquaresParams& params);
+ThreeMfMetadata GetClearanceMetadata(const RingsProtoCreatorParams& params);
+
+// One build plate of the Rings2D2Squares bodies. The volf bodies are stored once and
+// placed once per volf place of the layout, every other body once.
+bool SaveRings2D2SquaresAs3mf(const std::vector<MeshBody>& bodies, const Rings2D2SquaresParams& params, const Rings2D2SquaresLayout& layout, const std::string& filepath);
+// One build plate of the two RingsProtoCreator bases with volfCount volfs.
+bool SaveRingsProtoAs3mf(const MeshBody& baseBody, const MeshBody& volfBody, const RingsProtoCreatorParams& params, const std::string& filepath);
\ No newline at end of file
@@ -1,4 +1,14 @@
 #include "RectangledBasePart.h"
+#include "Instrumentation.h"
+
+void RectangledBasePart::setLayout(const RectangledBasePartLayout& layout)
+{
+    BasePart::setLayout(layout);
+    cornerFilletRadius = layout.cornerFilletRadius;
+    cuttingShellThickness = layout.cuttingShellThickness;
+    centralLinkerRadius = layout.centralLinkerRadius;
+    linkingPart.setLayout(layout.linkingPart);
+}
 
 std::vector<Ptr<Point3D>> RectangledBasePart::getLinkerPoints()
 {
@@ -21,6 +31,19 @@ std::vector<Ptr<Point3D>> RectangledBasePart::getLinkerPoints()
 }
 
 Ptr<BRepBody> RectangledBasePart::createBody(Ptr<Component> component)
+{
+    INSTRUMENT_PART("RectangledBasePart");
+    auto body = createBody(component, isSymmetricBuild);
+    if (isSymmetricBuildChecked())
+    {
+        auto isMatching = true;
+        body = ChooseVerifiedBody(body, createBody(component, false), isMatching);
+        isSymmetricBuildTrusted = isMatching;
+    }
+    return body;
+}
+
+Ptr<BRepBody> RectangledBasePart::createBody(Ptr<Component> component, bool isSymmetric)
 {
     auto cornerOuterRadius = cornerMiddleRadius + outerWidth;
     auto width = outerWidth + innerWidth;
@@ -39,7 +62,8 @@ Ptr<BRepBody> RectangledBasePart::createBody(Ptr<Component> component)
     auto floorBody = CreateBox(component, box->minPoint(), box->maxPoint(), floorThickness, cornerFilletRadius);
     body = Combine(component, JoinFeatureOperation, body, floorBody);
 
-    auto intersectBody = CreateBox(component, box->minPoint(), box->maxPoint(), height);
+    // the symmetric build goes on with the quarter
+    auto intersectBody = CreateBox(component, isSymmetric ? Point3D::create(0, 0) : box->minPoint(), box->maxPoint(), height);
     body = Combine(component, IntersectFeatureOperation, body, intersectBody);
 
     auto createHalForMagnet = true;
@@ -47,11 +71,10 @@ Ptr<BRepBody> RectangledBasePart::createBody(Ptr<Component> component)
     {
         auto magnetSketch = createCirclesSketch(component, circlesOnSquareRadius, 0);
 
-        for (int i = 0; i < magnetSketch->profiles()->count(); i++)
-        {
-            auto magnetBody = Extrude(component, magnetSketch->profiles()->item(i), floorThickness * 3.0, false);
-            body = Combine(component, CutFeatureOperation, body, magnetBody->bodies()->item(0));
-        }
+        // the symmetric build extrudes only the magnets reaching the quarter
+        auto magnetProfiles = isSymmetric ? GetProfiles(magnetSketch, IsInQuarter) : GetProfiles(magnetSketch);
+        auto magnetExtrude = Extrude(component, magnetProfiles, floorThickness * 3.0, false);
+        body = Combine(component, CutFeatureOperation, body, magnetExtrude->bodies());
     }
 
     if (!isPapaCenterPart)
@@ -69,51 +92,45 @@ Ptr<BRepBody> RectangledBasePart::createBody(Ptr<Component> component)
 
         auto centerJoinBody = innerWallPart.createInnerWallBody();
         auto centerBox = centerJoinBody->boundingBox();
-        auto centerCutBody = CreateBox(component, centerBox->minPoint(), centerBox->maxPoint(), height);
+        auto centerCutBody = CreateBox(component, isSymmetric ? Point3D::create(0, 0) : centerBox->minPoint(), centerBox->maxPoint(), height);
         centerCutBody = Move(component, centerCutBody, component->zConstructionAxis(), floorThickness);
+        if (isSymmetric)
+            centerJoinBody = cutToSymmetryDomain(component, centerJoinBody, true);
         body = Combine(component, CutFeatureOperation, body, centerCutBody);
         body = Combine(component, JoinFeatureOperation, body, centerJoinBody);
     }
 
     auto top = box->maxPoint()->y();
     auto down = box->minPoint()->y();
-    auto points = getLinkerPoints();
-    for (auto point : points)
-    {
-        linkingPart.center = point;
-        linkingPart.joinedBody = body;
-        body = linkingPart.createBody(component);
-    }
+    linkingPart.joinedBody = body;
+    body = linkingPart.createBodies(component, isSymmetric ? GetQuarterPoints(getLinkerPoints()) : getLinkerPoints());
 
     auto upCentralLinkerBody = CreateCylinder(component, Point3D::create(0, top - centralLinkerRadius - wallThickness / 3.0), centralLinkerRadius, height);
-    body = Combine(component, JoinFeatureOperation, body, upCentralLinkerBody);
     auto downCentralLinkerBody = CreateCylinder(component, Point3D::create(0, down + centralLinkerRadius + wallThickness / 3.0), centralLinkerRadius, height);
-    body = Combine(component, JoinFeatureOperation, body, downCentralLinkerBody);
+    body = Combine(component, JoinFeatureOperation, body, createObjectCollection({ upCentralLinkerBody, downCentralLinkerBody }));
+
+    if (isSymmetric)
+    {
+        // the joins above reach over the quarter
+        body = cutToSymmetryDomain(component, body, true);
+        body = Mirror(component, body, component->yZConstructionPlane());
+    }
+
+    filletBody(component, body, isSymmetric);
 
-    filletBody(component, body);
+    if (isSymmetric)
+        body = Mirror(component, body, component->xZConstructionPlane());
 
     return body;
 }
 
-void RectangledBasePart::filletBody(Ptr<Component> component, Ptr<BRepBody> body)
+void RectangledBasePart::filletBody(Ptr<Component> component, Ptr<BRepBody> body, bool isHalf)
 {
-    auto edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsVerticalLine(edge) && abs(edge->endVertex()->geometry()->x()) <= 0.01 && abs(edge->endVertex()->geometry()->y()) < innerWidth + outerWidth; });
-    auto minY = GetMin(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()); });
-    edges = GetEdges(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()) < minY + 0.01; });
-    Fillet(component, edges, verticalEdgeFilletRadius / 2.0);
-
-    edges = GetEdges(body, EdgeIsVerticalLine);
-    Fillet(component, edges, verticalEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && Equal(edge->length(), GetCircleLength(linkingPart.radius), 0.02) && edge->endVertex()->geometry()->z() > floorThickness * 1.1; });
-    Fillet(component, edges, topEdgeFilletRadius * 2.0);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && edge->endVertex()->geometry()->z() > floorThickness * 1.1; });
-    Fillet(component, edges, topEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && Equal(edge->length(), GetCircleLength(circlesOnSquareRadius), 0.1); });
-    Fillet(component, edges, floorThickness / 3.0);
-
-    edges = GetEdges(body, EdgeIsHorizontal);
-    Fillet(component, edges, otherEdgeFilletRadius);
+    FilletPlanner planner;
+    addVerticalFilletRules(planner, isHalf);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && Equal(topology.length[edge], GetCircleLength(linkingPart.radius), 0.02) && topology.endZ[edge] > floorThickness * 1.1; }, topEdgeFilletRadius * 2.0);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && topology.endZ[edge] > floorThickness * 1.1; }, topEdgeFilletRadius);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && edgeIsCircle(topology, edge, circlesOnSquareRadius, 0.1); }, floorThickness / 3.0);
+    planner.add(IsHorizontalEdge, otherEdgeFilletRadius);
+    planner.fillet(component, body);
 }
\ No newline at end of file
@@ -12,8 +12,10 @@ public:
     bool isPapaCenterPart = false;
     LinkingPart linkingPart;
 
+    void setLayout(const RectangledBasePartLayout& layout);
     Ptr<BRepBody> createBody(Ptr<Component> component);
     std::vector<Ptr<Point3D>> getLinkerPoints();
 protected:
-    void filletBody(Ptr<Component> component, Ptr<BRepBody> body);
+    Ptr<BRepBody> createBody(Ptr<Component> component, bool isSymmetric);
+    void filletBody(Ptr<Component> component, Ptr<BRepBody> body, bool isHalf = false);
 };
\ No newline at end of file
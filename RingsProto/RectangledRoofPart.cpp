@@ -1,6 +1,41 @@
 #include "RectangledRoofPart.h"
+#include "Instrumentation.h"
+
+void RectangledRoofPart::setLayout(const RectangledRoofPartLayout& layout)
+{
+    RoofPart::setLayout(layout);
+    deepThickness = layout.deepThickness;
+    cornerFilletRadius = layout.cornerFilletRadius;
+    centralLinkerRadius = layout.centralLinkerRadius;
+    linkingPart.setLayout(layout.linkingPart);
+}
 
 Ptr<ObjectCollection> RectangledRoofPart::createBodies(Ptr<Component> component, std::vector<Ptr<Point3D>> linkerPoints)
+{
+    INSTRUMENT_PART("RectangledRoofPart");
+    auto bodies = createBodies(component, linkerPoints, isSymmetricBuild);
+    if (!isSymmetricBuildChecked())
+        return bodies;
+
+    auto wholeBodies = createBodies(component, linkerPoints, false);
+    if (wholeBodies->count() != bodies->count())
+    {
+        for (int i = 0; i < bodies->count(); i++)
+            bodies->item(i)->cast<BRepBody>()->deleteMe();
+        isSymmetricBuildTrusted = false;
+        return wholeBodies;
+    }
+    auto isMatching = true;
+    auto result = ObjectCollection::create();
+    for (int i = 0; i < bodies->count(); i++)
+        result->add(ChooseVerifiedBody(bodies->item(i)->cast<BRepBody>(), wholeBodies->item(i)->cast<BRepBody>(), isMatching));
+    isSymmetricBuildTrusted = isMatching;
+    return result;
+}
+
+// The side bodies are mirrored over the yz plane into each other, so only the main and
+// the center bodies take the symmetric build.
+Ptr<ObjectCollection> RectangledRoofPart::createBodies(Ptr<Component> component, std::vector<Ptr<Point3D>> linkerPoints, bool isSymmetric)
 {
     auto cornerOuterRadius = cornerMiddleRadius + outerWidth;
     auto width = outerWidth + innerWidth;
@@ -12,14 +47,15 @@ Ptr<ObjectCollection> RectangledRoofPart::createBodies(Ptr<Component> component,
     auto boundWallBody = CreateBox(component, box->minPoint(), box->maxPoint(), height, cornerFilletRadius, wallThickness);
     auto roofBody = CreateBox(component, box->minPoint(), box->maxPoint(), floorThickness, cornerFilletRadius);
     roofBody = Move(component, roofBody, component->zConstructionAxis(), height - floorThickness);
-    body = Combine(component, JoinFeatureOperation, body, boundWallBody);
-    body = Combine(component, JoinFeatureOperation, body, roofBody);
     auto centerUpBound = CreateBound(box->maxPoint()->y(), box->maxPoint()->y() - width, leftCenterPoint->x(), rightCenterPoint->x());
     auto centerDownBound = CreateBound(box->minPoint()->y(), box->minPoint()->y() + width, leftCenterPoint->x(), rightCenterPoint->x());
     auto centerUpBody = CreateBox(component, centerUpBound->minPoint(), centerUpBound->maxPoint(), height);
     auto centerDownBody = CreateBox(component, centerDownBound->minPoint(), centerDownBound->maxPoint(), height);
-    body = Combine(component, JoinFeatureOperation, body, centerUpBody);
-    body = Combine(component, JoinFeatureOperation, body, centerDownBody);
+    // the primitives are joined together first, so transient ones reach the design as one body
+    auto joinBody = Combine(component, JoinFeatureOperation, boundWallBody, roofBody);
+    joinBody = Combine(component, JoinFeatureOperation, joinBody, centerUpBody);
+    joinBody = Combine(component, JoinFeatureOperation, joinBody, centerDownBody);
+    body = Combine(component, JoinFeatureOperation, body, joinBody);
 
     auto cutBody = createPairedSquares(component, lineLength, cornerOuterRadius - wallThickness, RAD_45, width - 2.0 * wallThickness, height - floorThickness);
     auto separationCutBody = createPairedSquares(component, lineLength, separationCornerOuterRadius, RAD_45, separationWidth, height);
@@ -65,6 +101,9 @@ Ptr<ObjectCollection> RectangledRoofPart::createBodies(Ptr<Component> component,
         }
     }
 
+    // the center part is symmetric on the half, its inner wall is built there too
+    if (isSymmetric)
+        centerBody = cutToSymmetryDomain(component, centerBody, false);
     if (isPapaCenterPart)
     {
         PariedSquaresPart innerWallPart;
@@ -83,37 +122,49 @@ Ptr<ObjectCollection> RectangledRoofPart::createBodies(Ptr<Component> component,
         centerBody = Combine(component, CutFeatureOperation, centerBody, centerCutBody);
         auto centerJoinBody = innerWallPart.createCenterBody();
         centerJoinBody = Move(component, centerJoinBody, component->zConstructionAxis(), deepThickness);
+        if (isSymmetric)
+            centerJoinBody = cutToSymmetryDomain(component, centerJoinBody, false);
         centerBody = Combine(component, JoinFeatureOperation, centerBody, centerJoinBody);
     }
 
-    mainBody = addLinkersToMainBody(component, mainBody, linkerPoints);
+    for (auto b : result)
+        filletBody(component, b);
+
+    auto mainBox = mainBody->boundingBox();
+    if (isSymmetric)
+    {
+        mainBody = cutToSymmetryDomain(component, mainBody, true);
+        linkerPoints = GetQuarterPoints(linkerPoints);
+    }
+    mainBody = addLinkersToMainBody(component, mainBody, linkerPoints, mainBox);
+    if (isSymmetric)
+        mainBody = Mirror(component, mainBody, component->yZConstructionPlane());
+
+    filletBody(component, mainBody, isSymmetric);
+    filletBody(component, centerBody, isSymmetric);
+    if (isSymmetric)
+    {
+        mainBody = Mirror(component, mainBody, component->xZConstructionPlane());
+        centerBody = Mirror(component, centerBody, component->xZConstructionPlane());
+    }
     mainBody->name("MainRoofBody");
+    centerBody->name("CenterRoofBody");
     result->add(mainBody);
-    
     result->add(centerBody);
 
-    for (auto b : result)
-        filletBody(component, b);
-
     return result;
 }
 
-Ptr<BRepBody> RectangledRoofPart::addLinkersToMainBody(Ptr<Component> component, Ptr<BRepBody>& body, std::vector<Ptr<Point3D>> linkerPoints)
+Ptr<BRepBody> RectangledRoofPart::addLinkersToMainBody(Ptr<Component> component, Ptr<BRepBody>& body, std::vector<Ptr<Point3D>> linkerPoints, Ptr<BoundingBox3D> box)
 {
-    auto box = body->boundingBox();
     auto top = box->maxPoint()->y();
     auto down = box->minPoint()->y();
-    for (auto point : linkerPoints)
-    {
-        linkingPart.center = point;
-        linkingPart.joinedBody = body;
-        body = linkingPart.createBody(component);
-    }
+    linkingPart.joinedBody = body;
+    body = linkingPart.createBodies(component, linkerPoints);
     auto centralLinkerShift = centralLinkerRadius + wallThickness + wallThickness / 3.0 - 0.01;
     auto upCentralLinkerBody = CreateCylinder(component, Point3D::create(0, top - centralLinkerShift), centralLinkerRadius, height - floorThickness);
-    body = Combine(component, CutFeatureOperation, body, upCentralLinkerBody);
     auto downCentralLinkerBody = CreateCylinder(component, Point3D::create(0, down + centralLinkerShift), centralLinkerRadius, height - floorThickness);
-    body = Combine(component, CutFeatureOperation, body, downCentralLinkerBody);
+    body = Combine(component, CutFeatureOperation, body, createObjectCollection({ upCentralLinkerBody, downCentralLinkerBody }));
 
     return body;
 }
@@ -129,38 +180,22 @@ double RectangledRoofPart::getRight()
     return rightCenterPoint->x() + getTop();
 }
 
-bool RectangledRoofPart::isEedgeOnOuterRectangle(Ptr<BRepEdge> edge)
+bool RectangledRoofPart::isEedgeOnOuterRectangle(const BodyTopology& topology, int edge)
 {
-    auto point1 = edge->endVertex()->geometry();
-    auto point2 = edge->startVertex()->geometry();
     auto delta = 0.02;
-    return EdgeIsHorizontal(edge) &&
-        (Equal(abs(point1->x()), getRight(), delta) || Equal(abs(point1->y()), getTop(), delta)) &&
-        (Equal(abs(point2->x()), getRight(), delta) || Equal(abs(point2->y()), getTop(), delta));
+    return IsHorizontalEdge(topology, edge) &&
+        (Equal(abs(topology.endX[edge]), getRight(), delta) || Equal(abs(topology.endY[edge]), getTop(), delta)) &&
+        (Equal(abs(topology.startX[edge]), getRight(), delta) || Equal(abs(topology.startY[edge]), getTop(), delta));
 }
 
-void RectangledRoofPart::filletBody(Ptr<Component> component, Ptr<BRepBody> body)
+void RectangledRoofPart::filletBody(Ptr<Component> component, Ptr<BRepBody> body, bool isHalf)
 {
-    auto edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsVerticalLine(edge) && abs(edge->endVertex()->geometry()->x()) <= 0.01 && abs(edge->endVertex()->geometry()->y()) < innerWidth + outerWidth; });
-    auto minY = GetMin(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()); });
-    edges = GetEdges(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()) < minY + 0.01; });
-    Fillet(component, edges, verticalEdgeFilletRadius / 2.0);
-
-    edges = GetEdges(body, EdgeIsVerticalLine);
-    Fillet(component, edges, verticalEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return edgeOnInnerCorner(edge); });
-    Fillet(component, edges, otherEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && Equal(edge->length(), GetCircleLength(circlesOnSquareRadius), 0.1); });
-    Fillet(component, edges, floorThickness / 3.0);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return isEedgeOnOuterRectangle(edge) && edge->endVertex()->geometry()->z() > floorThickness * 1.1; });
-    Fillet(component, edges, topEdgeFilletRadius * 2.5);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && edge->endVertex()->geometry()->z() > floorThickness * 1.1; });
-    Fillet(component, edges, topEdgeFilletRadius);
-
-    edges = GetEdges(body, EdgeIsHorizontal);
-    Fillet(component, edges, otherEdgeFilletRadius);
+    FilletPlanner planner;
+    addVerticalFilletRules(planner, isHalf);
+    planner.add([=](const BodyTopology& topology, int edge) {return edgeOnInnerCorner(topology, edge); }, otherEdgeFilletRadius);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && edgeIsCircle(topology, edge, circlesOnSquareRadius, 0.1); }, floorThickness / 3.0);
+    planner.add([=](const BodyTopology& topology, int edge) {return isEedgeOnOuterRectangle(topology, edge) && topology.endZ[edge] > floorThickness * 1.1; }, topEdgeFilletRadius * 2.5);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && topology.endZ[edge] > floorThickness * 1.1; }, topEdgeFilletRadius);
+    planner.add(IsHorizontalEdge, otherEdgeFilletRadius);
+    planner.fillet(component, body);
 }
\ No newline at end of file
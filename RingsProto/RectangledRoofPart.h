@@ -11,12 +11,14 @@ public:
     double centralLinkerRadius;
     bool isPapaCenterPart = true;
     LinkingPart linkingPart;
+    void setLayout(const RectangledRoofPartLayout& layout);
     Ptr<ObjectCollection> createBodies(Ptr<Component> component, std::vector<Ptr<Point3D>> linkerPoints);
 protected:
     Ptr<BRepBody> createBody(Ptr<Component> component);
-    Ptr<BRepBody> addLinkersToMainBody(Ptr<Component> component, Ptr<BRepBody>& body, std::vector<Ptr<Point3D>> linkerPoints);
-    void filletBody(Ptr<Component> component, Ptr<BRepBody> body);
-    bool isEedgeOnOuterRectangle(Ptr<BRepEdge> edge);
+    Ptr<ObjectCollection> createBodies(Ptr<Component> component, std::vector<Ptr<Point3D>> linkerPoints, bool isSymmetric);
+    Ptr<BRepBody> addLinkersToMainBody(Ptr<Component> component, Ptr<BRepBody>& body, std::vector<Ptr<Point3D>> linkerPoints, Ptr<BoundingBox3D> box);
+    void filletBody(Ptr<Component> component, Ptr<BRepBody> body, bool isHalf = false);
+    bool isEedgeOnOuterRectangle(const BodyTopology& topology, int edge);
     double getTop();
     double getRight();
 };
\ No newline at end of file
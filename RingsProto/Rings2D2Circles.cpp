@@ -1,4 +1,5 @@
 #include "Rings2D2Circles.h"
+#include "Instrumentation.h"
 #include "Geometry.h"
 #include "FusionEnvironment.h"
 
@@ -15,11 +16,30 @@ Rings2D2Circles::Rings2D2Circles()
 
 void Rings2D2Circles::Recount()
 {
-    volfRadiusWithoutClearance = getVolfRadius();
-    volfRadius = volfRadiusWithoutClearance - moovableClearence / volfCount;
+    SolveRings2D2CirclesLayout(getParams(), layout);
+    volfRadiusWithoutClearance = layout.volfRadiusWithoutClearance;
+    volfRadius = layout.volfRadius;
     leftAxis = nullptr;
 }
 
+Rings2D2CirclesParams Rings2D2Circles::getParams()
+{
+    Rings2D2CirclesParams params;
+    params.volfCount = volfCount;
+    params.crossVolfCount = crossVolfCount;
+    params.volfLegRadius = volfLegRadius;
+    params.volfLegThickness = volfLegThickness;
+    params.volfLegHoleRadius = volfLegHoleRadius;
+    params.volfHeadThickness = volfHeadThickness;
+    params.circleRadius = circleRadius;
+    params.wallThickness = wallThickness;
+    params.magnetRadius = magnetRadius;
+    params.floorThickness = floorThickness;
+    params.moovableClearence = moovableClearence;
+    params.unmoovableClearence = unmoovableClearence;
+    return params;
+}
+
 void Rings2D2Circles::setVolfCount(int count)
 {
     volfCount = count;
@@ -34,18 +54,17 @@ void Rings2D2Circles::setCrossVolfCount(int count)
 
 double Rings2D2Circles::getVolfSegmentAngelRad()
 {
-    return FULL_CIRCLE_RAD / volfCount;
+    return GetCirclesVolfSegmentAngelRad(volfCount);
 }
 
 double Rings2D2Circles::getVolfRadius()
 {
-    return GetTriangleSideLength(circleRadius, circleRadius, getVolfSegmentAngelRad()) / 2.0;
+    return GetCirclesVolfRadius(circleRadius, volfCount);
 }
 
 double Rings2D2Circles::getCircleShift()
 {
-    auto angel = (crossVolfCount - 1) * getVolfSegmentAngelRad() / 2.0;
-    return GetRightTriangleLegByHypotenuseAndAdjacentAngle(circleRadius, angel);
+    return GetCirclesShift(circleRadius, volfCount, crossVolfCount);
 }
 
 Ptr<Point3D> Rings2D2Circles::getLeftCenterPoint()
@@ -58,11 +77,11 @@ Ptr<Point3D> Rings2D2Circles::getRightCenterPoint()
     return Point3D::create(getCircleShift());
 }
 
-Ptr<Sketch> Rings2D2Circles::createSketchRings(Ptr<Component> component, double volfRadius, int count)
+std::vector<Ptr<Point3D>> Rings2D2Circles::getVolfCenters(int count)
 {
     if (count < 0 || count > 2 * volfCount)
         count = 2 * volfCount;
-    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "RingsSketch");
+    std::vector<Ptr<Point3D>> centers;
 
     auto leftRotate = crossVolfCount % 2 == 0 ? getVolfSegmentAngelRad() / 2.0 : 0;
     auto rightRotate = crossVolfCount % 2 == volfCount % 2 ? getVolfSegmentAngelRad() / 2.0 : 0;
@@ -70,14 +89,22 @@ Ptr<Sketch> Rings2D2Circles::createSketchRings(Ptr<Component> component, double
     {
         if (k == count)
             break;
-        AddCircle(sketch, GetCirclePoint(getLeftCenterPoint(), circleRadius, getVolfSegmentAngelRad() * i + leftRotate), volfRadius);
+        centers.push_back(GetCirclePoint(getLeftCenterPoint(), circleRadius, getVolfSegmentAngelRad() * i + leftRotate));
         k++;
         if (k == count)
             break;
-        AddCircle(sketch, GetCirclePoint(getRightCenterPoint(), circleRadius, getVolfSegmentAngelRad() * i + rightRotate), volfRadius);
+        centers.push_back(GetCirclePoint(getRightCenterPoint(), circleRadius, getVolfSegmentAngelRad() * i + rightRotate));
         k++;
     }
 
+    return centers;
+}
+
+Ptr<Sketch> Rings2D2Circles::createSketchRings(Ptr<Component> component, double volfRadius, int count)
+{
+    auto sketch = CreateSketch(component, component->xYConstructionPlane(), "RingsSketch");
+    for (auto& center : getVolfCenters(count))
+        AddCircle(sketch, center, volfRadius);
     return sketch;
 }
 
@@ -136,6 +163,7 @@ Ptr<BRepBody> Rings2D2Circles::createVolfCilinderPart(Ptr<Component> component,
 
 void Rings2D2Circles::createBodies(Ptr<Component> component)
 {
+    INSTRUMENT_PART("Rings2D2Circles");
     if (leftAxis == nullptr)
         leftAxis = AddConstructionAxis(component, getLeftCenterPoint(), Vector3D::create(0, 0, 1));
     if (rightAxis == nullptr)
@@ -146,10 +174,10 @@ void Rings2D2Circles::createBodies(Ptr<Component> component)
 
     Params params;
 
-    params.baseOuterRadius = circleRadius + volfRadius + wallThickness + moovableClearence * 0.25;
-    params.baseInnerRadius = circleRadius - volfRadius - wallThickness - moovableClearence * 0.75;
-    params.baseWayHeight = floorThickness * 1.0;
-    params.baseWallHeight = params.baseWayHeight + volfLegThickness + 2.0 * moovableClearence;
+    params.baseOuterRadius = layout.baseOuterRadius;
+    params.baseInnerRadius = layout.baseInnerRadius;
+    params.baseWayHeight = layout.baseWayHeight;
+    params.baseWallHeight = layout.baseWallHeight;
 
     auto baseBody = createPairedCircles(component, params.baseInnerRadius, params.baseOuterRadius - params.baseInnerRadius, floorThickness);
     auto baseOuterWallBody = createPairedCircles(component, params.baseOuterRadius - wallThickness, wallThickness, params.baseWallHeight);
@@ -172,17 +200,15 @@ void Rings2D2Circles::createBodies(Ptr<Component> component)
     Extrude(component, sketch2, params.baseWallHeight);
     //-------------------
 
-    for (int i = 0; i < magnetSketch->profiles()->count(); i++)
-    {
-        auto magnetBody = Extrude(component, magnetSketch->profiles()->item(i), floorThickness * 3.0, false);
-        baseBody = Combine(component, CutFeatureOperation, baseBody, magnetBody->bodies()->item(0));
-    }
+    auto magnetProfiles = GetProfiles(magnetSketch);
+    auto magnetExtrude = Extrude(component, magnetProfiles, floorThickness * 3.0, false);
+    baseBody = Combine(component, CutFeatureOperation, baseBody, magnetExtrude->bodies());
 
 
-    auto roofOuterInnerRadius = circleRadius + volfLegRadius + moovableClearence * 0.25;
-    auto roofOuterOuterRadius = params.baseOuterRadius + wallThickness + unmoovableClearence;
-    auto roofInnerInnerRadius = params.baseInnerRadius - wallThickness - unmoovableClearence;
-    auto roofInnerOuterRadius = circleRadius - volfLegRadius - moovableClearence * 0.75;
+    auto roofOuterInnerRadius = layout.roofOuterInnerRadius;
+    auto roofOuterOuterRadius = layout.roofOuterOuterRadius;
+    auto roofInnerInnerRadius = layout.roofInnerInnerRadius;
+    auto roofInnerOuterRadius = layout.roofInnerOuterRadius;
 
     auto roofBody = createPairedCircles(component, roofInnerInnerRadius, roofOuterOuterRadius - roofInnerInnerRadius, params.baseWallHeight + floorThickness + unmoovableClearence);
 
@@ -194,32 +220,38 @@ void Rings2D2Circles::createBodies(Ptr<Component> component)
 
 
     
-    auto sectorAngel = (circleRadius * RAD_360 / volfCount - 2.0 * volfLegRadius - unmoovableClearence) / RAD_360;
+    auto sectorAngel = layout.sectorAngel;
     auto sectorBody = createSector(component, getLeftCenterPoint(), roofOuterInnerRadius, sectorAngel, RAD_90, params.baseWallHeight + unmoovableClearence + floorThickness);
     auto sectorItersectBody = createPairedCircles(component, roofInnerOuterRadius, roofOuterInnerRadius - roofInnerOuterRadius, params.baseWallHeight + unmoovableClearence + floorThickness);
     sectorBody = Combine(component, IntersectFeatureOperation, sectorBody, sectorItersectBody);
 
 
-    auto volfDownBody = createVolfCilinderPart(component, volfRadius, volfLegThickness);
-    volfDownBody = Move(component, volfDownBody, leftAxis, params.baseWayHeight + moovableClearence);
+    // the volfs are built once on the first volf place and moved to the others by occurrences
+    auto volfCenters = getVolfCenters();
+    std::vector<Ptr<Vector3D>> volfShifts;
+    for (auto& center : volfCenters)
+        volfShifts.push_back(Vector3D::create(center->x() - volfCenters[0]->x(), center->y() - volfCenters[0]->y(), 0));
 
-    auto volfLegBody = createVolfCilinderPart(component, volfLegRadius, floorThickness + 2.0 * moovableClearence);
-    volfLegBody = Move(component, volfLegBody, leftAxis, params.baseWayHeight + moovableClearence + volfLegThickness);
-    volfDownBody = Combine(component, JoinFeatureOperation, volfDownBody, volfLegBody);
-    
-    auto volfLegHoleBody = createVolfCilinderPart(component, volfLegHoleRadius, volfLegThickness + floorThickness + 2.0 * moovableClearence);
-    volfLegHoleBody = Move(component, volfLegHoleBody, leftAxis, params.baseWayHeight + moovableClearence);
-    volfDownBody = Combine(component, CutFeatureOperation, volfDownBody, volfLegHoleBody);
+    auto volfDownBody = CreateInstancedBody(component, "VolfDown", volfShifts, [&](Ptr<Component> volfComponent)
+    {
+        auto zAxis = volfComponent->zConstructionAxis();
+        auto body = createVolfCilinderPart(volfComponent, volfRadius, volfLegThickness);
+        body = Move(volfComponent, body, zAxis, params.baseWayHeight + moovableClearence);
 
+        auto volfLegBody = createVolfCilinderPart(volfComponent, volfLegRadius, floorThickness + 2.0 * moovableClearence);
+        volfLegBody = Move(volfComponent, volfLegBody, zAxis, params.baseWayHeight + moovableClearence + volfLegThickness);
+        body = Combine(volfComponent, JoinFeatureOperation, body, volfLegBody);
 
-    auto volfUpBody = createVolfCilinderPart(component, volfRadius, volfHeadThickness);
-    auto volfUpHoleBody = createVolfCilinderPart(component, volfLegHoleRadius + moovableClearence, volfHeadThickness);
-    volfUpBody = Combine(component, CutFeatureOperation, volfUpBody, volfUpHoleBody);
-    volfUpBody = Move(component, volfUpBody, leftAxis, params.baseWallHeight + unmoovableClearence + floorThickness + moovableClearence);
-    
-    
-    auto head2 = Rotate(component, volfUpBody, leftAxis, getVolfSegmentAngelRad(), true);
-    auto head3 = Rotate(component, head2, leftAxis, getVolfSegmentAngelRad(), true);
-    auto head4 = Rotate(component, head2, rightAxis, getVolfSegmentAngelRad(), true);
-    auto head5 = Rotate(component, head2, rightAxis, -getVolfSegmentAngelRad(), true);
+        auto volfLegHoleBody = createVolfCilinderPart(volfComponent, volfLegHoleRadius, volfLegThickness + floorThickness + 2.0 * moovableClearence);
+        volfLegHoleBody = Move(volfComponent, volfLegHoleBody, zAxis, params.baseWayHeight + moovableClearence);
+        return Combine(volfComponent, CutFeatureOperation, body, volfLegHoleBody);
+    });
+
+    auto volfUpBody = CreateInstancedBody(component, "VolfUp", volfShifts, [&](Ptr<Component> volfComponent)
+    {
+        auto body = createVolfCilinderPart(volfComponent, volfRadius, volfHeadThickness);
+        auto volfUpHoleBody = createVolfCilinderPart(volfComponent, volfLegHoleRadius + moovableClearence, volfHeadThickness);
+        body = Combine(volfComponent, CutFeatureOperation, body, volfUpHoleBody);
+        return Move(volfComponent, body, volfComponent->zConstructionAxis(), params.baseWallHeight + unmoovableClearence + floorThickness + moovableClearence);
+    });
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <Core/CoreAll.h>
 #include <Fusion/FusionAll.h>
+#include "Rings2D2CirclesLayout.h"
 
 using namespace adsk::core;
 using namespace adsk::fusion;
@@ -35,12 +36,14 @@ public:
 private:
     double volfRadiusWithoutClearance;
     double volfRadius;
+    Rings2D2CirclesLayout layout;
     Ptr<ConstructionAxis> leftAxis = nullptr;
     Ptr<ConstructionAxis> rightAxis = nullptr;
     
 public:
     Rings2D2Circles();
     void Recount();
+    Rings2D2CirclesParams getParams();
 private:
     void setVolfCount(int count);
     void setCrossVolfCount(int count);
@@ -49,6 +52,8 @@ private:
     double getCircleShift();
     Ptr<Point3D> getLeftCenterPoint();
     Ptr<Point3D> getRightCenterPoint();
+    // the first count places of the volfs, all of them when count is negative
+    std::vector<Ptr<Point3D>> getVolfCenters(int count = -1);
     Ptr<Sketch> createSketchRings(Ptr<Component> component, double volfRadius, int count = -1);
     Ptr<Sketch> createSketchBase(Ptr<Component> component);
     Ptr<BRepBody> createSector(Ptr<Component> component, Ptr<Point3D> centerPoint, double radius, double angel, double startAngel, double height);
@@ -0,0 +1,64 @@
+#include "Rings2D2CirclesLayout.h"
+
+double GetCirclesVolfSegmentAngelRad(int volfCount)
+{
+    return FULL_CIRCLE_RAD / volfCount;
+}
+
+double GetCirclesVolfRadius(double circleRadius, int volfCount)
+{
+    return GetTriangleSideLength(circleRadius, circleRadius, GetCirclesVolfSegmentAngelRad(volfCount)) / 2.0;
+}
+
+double GetCirclesShift(double circleRadius, int volfCount, int crossVolfCount)
+{
+    auto angel = (crossVolfCount - 1) * GetCirclesVolfSegmentAngelRad(volfCount) / 2.0;
+    return GetRightTriangleLegByHypotenuseAndAdjacentAngle(circleRadius, angel);
+}
+
+void SolveRings2D2CirclesLayout(const Rings2D2CirclesParams& params, Rings2D2CirclesLayout& layout)
+{
+    auto circleRadius = params.circleRadius;
+    auto wallThickness = params.wallThickness;
+    auto floorThickness = params.floorThickness;
+    auto moovableClearence = params.moovableClearence;
+    auto unmoovableClearence = params.unmoovableClearence;
+
+    layout.volfSegmentAngelRad = GetCirclesVolfSegmentAngelRad(params.volfCount);
+    layout.volfRadiusWithoutClearance = GetCirclesVolfRadius(circleRadius, params.volfCount);
+    layout.volfRadius = layout.volfRadiusWithoutClearance - moovableClearence / params.volfCount;
+    layout.circleShift = GetCirclesShift(circleRadius, params.volfCount, params.crossVolfCount);
+
+    layout.baseOuterRadius = circleRadius + layout.volfRadius + wallThickness + moovableClearence * 0.25;
+    layout.baseInnerRadius = circleRadius - layout.volfRadius - wallThickness - moovableClearence * 0.75;
+    layout.baseWayHeight = floorThickness * 1.0;
+    layout.baseWallHeight = layout.baseWayHeight + params.volfLegThickness + 2.0 * moovableClearence;
+
+    layout.roofOuterInnerRadius = circleRadius + params.volfLegRadius + moovableClearence * 0.25;
+    layout.roofOuterOuterRadius = layout.baseOuterRadius + wallThickness + unmoovableClearence;
+    layout.roofInnerInnerRadius = layout.baseInnerRadius - wallThickness - unmoovableClearence;
+    layout.roofInnerOuterRadius = circleRadius - params.volfLegRadius - moovableClearence * 0.75;
+    layout.sectorAngel = (circleRadius * FULL_CIRCLE_RAD / params.volfCount - 2.0 * params.volfLegRadius - unmoovableClearence) / FULL_CIRCLE_RAD;
+}
+
+Rings2D2CirclesLayout SolveRings2D2CirclesLayout(const Rings2D2CirclesParams& params)
+{
+    Rings2D2CirclesLayout layout;
+    SolveRings2D2CirclesLayout(params, layout);
+    return layout;
+}
+
+std::vector<PlainPoint3D> GetCirclesVolfPlaces(const Rings2D2CirclesParams& params, const Rings2D2CirclesLayout& layout, bool isRight)
+{
+    auto segment = layout.volfSegmentAngelRad;
+    auto rotate = isRight ? (params.crossVolfCount % 2 == params.volfCount % 2 ? segment / 2.0 : 0) : (params.crossVolfCount % 2 == 0 ? segment / 2.0 : 0);
+    auto centerX = isRight ? layout.circleShift : -layout.circleShift;
+
+    std::vector<PlainPoint3D> places;
+    for (int i = 0; i < params.volfCount; i++)
+    {
+        auto angle = segment * i + rotate;
+        places.push_back({ centerX + params.circleRadius * cos(angle), params.circleRadius * sin(angle), 0 });
+    }
+    return places;
+}
\ No newline at end of file
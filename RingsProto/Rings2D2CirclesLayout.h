@@ -0,0 +1,49 @@
+#pragma once
+#include "Geometry.h"
+#include <vector>
+
+struct Rings2D2CirclesParams
+{
+    int volfCount = 12;
+    int crossVolfCount = 4;
+    double volfLegRadius = 0.3;
+    double volfLegThickness = 0.2;
+    double volfLegHoleRadius = 0.14;
+    double volfHeadThickness = 0.2;
+    double circleRadius = 3.6;
+    double wallThickness = 0.12;
+    double magnetRadius = 0.3;
+    double floorThickness = 0.2;
+    double moovableClearence = 0.04;
+    double unmoovableClearence = 0.02;
+};
+
+struct Rings2D2CirclesLayout
+{
+    double volfSegmentAngelRad = 0;
+    double volfRadiusWithoutClearance = 0;
+    double volfRadius = 0;
+    double circleShift = 0;
+
+    double baseOuterRadius = 0;
+    double baseInnerRadius = 0;
+    double baseWayHeight = 0;
+    double baseWallHeight = 0;
+
+    double roofOuterInnerRadius = 0;
+    double roofOuterOuterRadius = 0;
+    double roofInnerInnerRadius = 0;
+    double roofInnerOuterRadius = 0;
+    double sectorAngel = 0;
+};
+
+double GetCirclesVolfSegmentAngelRad(int volfCount);
+double GetCirclesVolfRadius(double circleRadius, int volfCount);
+double GetCirclesShift(double circleRadius, int volfCount, int crossVolfCount);
+
+void SolveRings2D2CirclesLayout(const Rings2D2CirclesParams& params, Rings2D2CirclesLayout& layout);
+Rings2D2CirclesLayout SolveRings2D2CirclesLayout(const Rings2D2CirclesParams& params);
+
+// The volf places of Rings2D2Circles::getVolfCenters on one circle, counterclockwise: the
+// order a counterclockwise turn of the circle moves the volfs.
+std::vector<PlainPoint3D> GetCirclesVolfPlaces(const Rings2D2CirclesParams& params, const Rings2D2CirclesLayout& layout, bool isRight);
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "Rings2D2Squares.h"
+#include "Instrumentation.h"
 #include "Geometry.h"
+#include "Rings2D2SquaresLayout.h"
 #include "FusionEnvironment.h"
+#include "PuzzlePlates.h"
+#include "SquaresClearance.h"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -12,37 +16,37 @@ Rings2D2Squares::Rings2D2Squares()
 {
 }
 
+Rings2D2SquaresParams Rings2D2Squares::getParams()
+{
+    Rings2D2SquaresParams params;
+    params.lineVolfCount = lineVolfCount;
+    params.cornerVolfCount = cornerVolfCount;
+    params.squareMiddleSize = squareMiddleSize;
+    params.moovableClearence = moovableClearence;
+    params.unmoovableClearence = unmoovableClearence;
+    params.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
+    params.horizontalEdgeFilletRadius = horizontalEdgeFilletRadius;
+    return params;
+}
+
 double Rings2D2Squares::getVolfRadius()
 {
-    // innerCornerRadius + volfRadius = middleCornerRadius
-    // volfDiametr = 2 * volfRadius;
-    // volfDiametr^2 = middleCornerRadius^2 + middleCornerRadius^2 - 2 * middleCornerRadius * middleCornerRadius * cos(2*pi / 4*cornerVolfCount) // 
-    // volfDiametr = middleCornerRadius * sqrt(2)*sqrt(1 - cos(2*pi / 4*cornerVolfCount))
-    // rate = sqrt(2)*sqrt(1 - cos(2*pi / 4*cornerVolfCount))
-    // volfDiametr = middleCornerRadius * rate
-    // middleCornerRadius = (squareMiddleSize - lineVolfCount * volfDiametr)/2
-    // volfDiametr = (squareMiddleSize - lineVolfCount * volfDiametr) * rate / 2
-    // volfDiametr = (squareMiddleSize * rate / 2) / (1 + lineVolfCount * rate / 2)
-    
-    auto rate = sqrt(2.0) * sqrt(1 - cos(RAD_360 / (4.0 * cornerVolfCount)));
-    auto volfDiametr = (squareMiddleSize * rate / 2.0) / (1.0 + lineVolfCount * rate / 2.0);
-    return volfDiametr / 2.0;
+    return GetSquaresVolfRadius(lineVolfCount, cornerVolfCount, squareMiddleSize);
 }
 
 double Rings2D2Squares::getLineLength()
 {
-    return lineVolfCount * getVolfRadius() * 2.0;
+    return GetSquaresLineLength(lineVolfCount, getVolfRadius());
 }
 
 double Rings2D2Squares::getCornerOuterRadius()
 {
-    return (squareMiddleSize - getLineLength()) / 2.0 + getVolfRadius();
+    return GetSquaresCornerOuterRadius(squareMiddleSize, getLineLength(), getVolfRadius());
 }
 
 double Rings2D2Squares::getSquareShift()
 {
-    auto sizeByVolfCenter = squareMiddleSize;
-    return sizeByVolfCenter / (2.0 * sqrt(2.0));
+    return GetSquaresShift(squareMiddleSize);
 }
 
 Ptr<Point3D> Rings2D2Squares::getLeftCenterPoint()
@@ -58,168 +62,120 @@ Ptr<Point3D> Rings2D2Squares::getRightCenterPoint()
 void Rings2D2Squares::SetParams(MetizParams& linkMetizParams)
 {
     linkMetizParams.hatForm = MetizParams::HatForms::Hided;
-    linkMetizParams.hatRadius = 0.24;
-    linkMetizParams.hatHeight = 0.16;
-    linkMetizParams.legRadius = 0.12;
-    linkMetizParams.legHeight = 0.68;
+    linkMetizParams.hatRadius = layout.linkMetiz.hatRadius;
+    linkMetizParams.hatHeight = layout.linkMetiz.hatHeight;
+    linkMetizParams.legRadius = layout.linkMetiz.legRadius;
+    linkMetizParams.legHeight = layout.linkMetiz.legHeight;
 }
 
 void Rings2D2Squares::SetParams(BasePart& basePart, RoofPart& roofPart, VolfUpPart& volfUpPart, VolfDownPart& volfDownPart)
 {
-    auto volfRadius = getVolfRadius() - moovableClearence / (cornerVolfCount * 4.0 + lineVolfCount * 4.0);
+    SolveRings2D2SquaresLayout(getParams(), false, layout);
 
     SetParams(linkMetizParams);
-
-    basePart.floorThickness = 0.3;
-    basePart.wallThickness = 0.16;
-    basePart.circlesOnSquareRadius = 0.25;
-
-    roofPart.floorThickness = 0.3;
-    roofPart.wallThickness = 0.16;
-
-    volfDownPart.radius = volfRadius;
-    volfDownPart.height = 0.54;
-    volfDownPart.holeDownRadius = 0.28;
-    volfDownPart.holeDownHeight = 0.3;
-    volfDownPart.holeRadius = 0.15;
-
-    volfUpPart.height = 0.5;
-    volfUpPart.middleRadius = 0.3;
-    volfUpPart.holeRadius = 0.14;
-    volfUpPart.form = VolfUpPart::convex;
-    volfUpPart.concaveHeight = 0.15;
-
-    volfDownPart.holeHeight = volfDownPart.height;
-    volfDownPart.zMoveShift = basePart.floorThickness + moovableClearence;
-    volfDownPart.filletRadius = horizontalEdgeFilletRadius;
-
-    volfUpPart.radius = volfRadius;
-    volfUpPart.middleHeight = roofPart.floorThickness;
-    volfUpPart.holeHeight = volfUpPart.middleHeight + volfUpPart.height;
-    volfUpPart.concaveRadius = volfRadius * 3.0;
-    volfUpPart.convexRadius = volfRadius * 1.5;
-    volfUpPart.filletRadius = horizontalEdgeFilletRadius;
-
-    basePart.lineLength = getLineLength();
-    basePart.cornerMiddleRadius = getCornerOuterRadius() - getVolfRadius();
-    basePart.innerWidth = getVolfRadius() + basePart.wallThickness + moovableClearence * 1.5;
-    basePart.outerWidth = getVolfRadius() + basePart.wallThickness + moovableClearence * 0.5;
-    basePart.height = basePart.floorThickness + volfDownPart.height + 2.0 * moovableClearence;
-    basePart.leftCenterPoint = getLeftCenterPoint();
-    basePart.rightCenterPoint = getRightCenterPoint();
-    basePart.circlesOnSquarePeriodRadius = getVolfRadius();
-    basePart.topEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
-    basePart.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
-    basePart.otherEdgeFilletRadius = horizontalEdgeFilletRadius;
-
-    roofPart.lineLength = getLineLength();
-    roofPart.cornerMiddleRadius = getCornerOuterRadius() - getVolfRadius();
-    roofPart.innerWidth = basePart.innerWidth + roofPart.wallThickness;
-    roofPart.outerWidth = basePart.outerWidth + roofPart.wallThickness;
-    roofPart.height = basePart.height + roofPart.floorThickness + unmoovableClearence;
-    roofPart.leftCenterPoint = basePart.leftCenterPoint;
-    roofPart.rightCenterPoint = basePart.rightCenterPoint;
-    roofPart.separationInnerWidth = volfUpPart.middleRadius + moovableClearence * 1.5;
-    roofPart.separationOuterWidth = volfUpPart.middleRadius + moovableClearence * 0.5;
-    roofPart.downTrimmingThicknes = moovableClearence * 2.0;
-    //roofPart.circlesOnSquarePeriodRadius = getVolfRadius();
-    roofPart.topEdgeFilletRadius = horizontalEdgeFilletRadius;
-    roofPart.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
-    roofPart.otherEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
-
-    volfUpPart.zMoveShift = basePart.height + unmoovableClearence + roofPart.floorThickness + moovableClearence;
+    basePart.setLayout(layout.basePart);
+    roofPart.setLayout(layout.roofPart);
+    volfUpPart.setLayout(layout.volfUpPart);
+    volfDownPart.setLayout(layout.volfDownPart);
 }
 
-
 void Rings2D2Squares::SetParams(RectangledBasePart& basePart, RectangledRoofPart& roofPart, VolfUpPart& volfUpPart, VolfDownPart& volfDownPart)
 {
-    auto volfRadius = getVolfRadius() - moovableClearence / (cornerVolfCount * 4.0 + lineVolfCount * 4.0);
+    SolveRings2D2SquaresLayout(getParams(), true, layout);
 
     SetParams(linkMetizParams);
+    basePart.setLayout(layout.basePart);
+    roofPart.setLayout(layout.roofPart);
+    // switching the symmetric build on checks it again
+    if (isSymmetricBuild && !basePart.isSymmetricBuild)
+        basePart.isSymmetricBuildTrusted = roofPart.isSymmetricBuildTrusted = false;
+    basePart.isSymmetricBuild = roofPart.isSymmetricBuild = isSymmetricBuild;
+    volfUpPart.setLayout(layout.volfUpPart);
+    volfDownPart.setLayout(layout.volfDownPart);
+}
 
-    basePart.floorThickness = 0.3;
-    basePart.wallThickness = 0.16;
-    basePart.circlesOnSquareRadius = 0.25;
-
-    roofPart.floorThickness = 0.3;
-    roofPart.wallThickness = 0.16;
-    roofPart.cornerFilletRadius = getVolfRadius() * 2.0;
-
-    volfDownPart.radius = volfRadius;
-    volfDownPart.height = 0.44;
-    volfDownPart.holeDownRadius = 0.28;
-    volfDownPart.holeDownHeight = 0.3;
-    volfDownPart.holeRadius = 0.15;
-
-    volfUpPart.height = 0.5;
-    volfUpPart.middleRadius = 0.3;
-    volfUpPart.holeRadius = 0.14;
-    volfUpPart.form = VolfUpPart::convex;
-    volfUpPart.concaveHeight = 0.15;
-
-    volfDownPart.holeHeight = volfDownPart.height;
-    volfDownPart.zMoveShift = basePart.floorThickness + moovableClearence;
-    volfDownPart.filletRadius = horizontalEdgeFilletRadius;
-
-    volfUpPart.radius = volfRadius;
-    volfUpPart.middleHeight = roofPart.floorThickness;
-    volfUpPart.holeHeight = volfUpPart.middleHeight + volfUpPart.height;
-    volfUpPart.concaveRadius = volfRadius * 3.0;
-    volfUpPart.convexRadius = volfRadius * 1.5;
-    volfUpPart.filletRadius = horizontalEdgeFilletRadius;
-
-    basePart.lineLength = getLineLength();
-    basePart.cornerMiddleRadius = getCornerOuterRadius() - getVolfRadius();
-    basePart.innerWidth = getVolfRadius() + basePart.wallThickness + roofPart.wallThickness + moovableClearence * 1.5;
-    basePart.outerWidth = getVolfRadius() + basePart.wallThickness + roofPart.wallThickness + moovableClearence * 0.5;
-    basePart.height = basePart.floorThickness + volfDownPart.height + 2.0 * moovableClearence;
-    basePart.leftCenterPoint = getLeftCenterPoint();
-    basePart.rightCenterPoint = getRightCenterPoint();
-    basePart.circlesOnSquarePeriodRadius = getVolfRadius();
-    basePart.topEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
-    basePart.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
-    basePart.otherEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
-    basePart.cuttingShellThickness = basePart.wallThickness + roofPart.wallThickness;
-    basePart.cornerFilletRadius = roofPart.cornerFilletRadius - roofPart.wallThickness;
-    basePart.centralLinkerRadius = 0.2;
-    
-    basePart.linkingPart.floorState = LinkingPart::FloorStates::Top;
-    basePart.linkingPart.isReverse = false;
-    basePart.linkingPart.floorHoleRadius = linkMetizParams.legRadius + moovableClearence;
-    basePart.linkingPart.floorThickness = 0.12;
-    basePart.linkingPart.wallThickness = 0.16;
-    basePart.linkingPart.radius = basePart.linkingPart.wallThickness + linkMetizParams.hatRadius + moovableClearence;
-    basePart.linkingPart.height = basePart.floorThickness;
-    basePart.linkingPart.z = 0;
-
-    roofPart.lineLength = getLineLength();
-    roofPart.cornerMiddleRadius = getCornerOuterRadius() - getVolfRadius();
-    roofPart.innerWidth = basePart.innerWidth - roofPart.wallThickness;
-    roofPart.outerWidth = basePart.outerWidth - roofPart.wallThickness;
-    roofPart.height = basePart.height + roofPart.floorThickness + unmoovableClearence;
-    roofPart.leftCenterPoint = basePart.leftCenterPoint;
-    roofPart.rightCenterPoint = basePart.rightCenterPoint;
-    roofPart.separationInnerWidth = volfUpPart.middleRadius + moovableClearence * 1.5;
-    roofPart.separationOuterWidth = volfUpPart.middleRadius + moovableClearence * 0.5;
-    roofPart.downTrimmingThicknes = moovableClearence * 2.0;
-    //roofPart.circlesOnSquarePeriodRadius = getVolfRadius();
-    roofPart.topEdgeFilletRadius = horizontalEdgeFilletRadius;
-    roofPart.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
-    roofPart.otherEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
-    roofPart.deepThickness = basePart.floorThickness;
-    roofPart.centralLinkerRadius = basePart.centralLinkerRadius + unmoovableClearence;
-    
-    roofPart.linkingPart.floorState = LinkingPart::FloorStates::Top;
-    roofPart.linkingPart.isReverse = true;
-    roofPart.linkingPart.floorThickness = 0.0;
-    roofPart.linkingPart.radius = linkMetizParams.legRadius + 0.2;
-    roofPart.linkingPart.floorHoleRadius = 0.0;
-    roofPart.linkingPart.wallThickness = roofPart.linkingPart.radius - linkMetizParams.legRadius;
-    roofPart.linkingPart.z = roofPart.height - roofPart.wallThickness;
-    roofPart.linkingPart.height = roofPart.linkingPart.z - basePart.linkingPart.height - unmoovableClearence;
-    
+struct InputField
+{
+    const char* name;
+    double Rings2D2SquaresParams::* value;
+};
+
+static const InputField INPUT_FIELDS[] = {
+    { "lineVolfCount", &Rings2D2SquaresParams::lineVolfCount },
+    { "cornerVolfCount", &Rings2D2SquaresParams::cornerVolfCount },
+    { "squareMiddleSize", &Rings2D2SquaresParams::squareMiddleSize },
+    { "moovableClearence", &Rings2D2SquaresParams::moovableClearence },
+    { "unmoovableClearence", &Rings2D2SquaresParams::unmoovableClearence },
+    { "verticalEdgeFilletRadius", &Rings2D2SquaresParams::verticalEdgeFilletRadius },
+    { "horizontalEdgeFilletRadius", &Rings2D2SquaresParams::horizontalEdgeFilletRadius } };
+
+struct LayoutNode
+{
+    std::string name;
+    PartValues values;
+    std::vector<std::string> dependencies;
+};
+
+// The nodes of the solved fields, the ones a part is built from and the shared ones.
+static std::vector<LayoutNode> GetLayoutNodes(const Rings2D2SquaresLayout& layout)
+{
+    std::vector<LayoutNode> nodes(7);
+    // the square axes and the section analysis rotated about the right one
+    nodes[0] = { "SquareAxes", { layout.squareShift }, {} };
+
+    nodes[1] = { "VolfPlaces", { layout.volfRadius }, {} };
+    AddValues(nodes[1].values, static_cast<const BasePartLayout&>(layout.basePart));
 
-    volfUpPart.zMoveShift = basePart.height + unmoovableClearence + roofPart.floorThickness + moovableClearence;
+    nodes[2] = { "LinkerPoints", {}, {} };
+    for (auto& point : layout.basePart.linkerPoints)
+        AddValues(nodes[2].values, point);
+
+    nodes[3] = { "BasePart", {}, { "SymmetricBuild" } };
+    AddValues(nodes[3].values, layout.basePart);
+
+    nodes[4] = { "RoofPart", {}, { "SymmetricBuild", "LinkerPoints" } };
+    AddValues(nodes[4].values, layout.roofPart);
+
+    nodes[5] = { "VolfDownPart", {}, { "VolfPlaces" } };
+    AddValues(nodes[5].values, layout.volfDownPart);
+
+    nodes[6] = { "VolfUpPart", {}, { "VolfPlaces" } };
+    AddValues(nodes[6].values, layout.volfUpPart);
+    return nodes;
+}
+
+void Rings2D2Squares::setDependencies()
+{
+    auto params = getParams();
+    for (auto& input : INPUT_FIELDS)
+        dependencies.setNode(input.name, { params.*input.value });
+    dependencies.setNode("SymmetricBuild", { isSymmetricBuild ? 1.0 : 0.0 });
+
+    // An input that changed since the last build is linked to the nodes its built value
+    // solves differently, the layout is solved again with only that input set back.
+    auto nodes = GetLayoutNodes(layout);
+    for (auto& input : INPUT_FIELDS)
+    {
+        auto builtValues = dependencies.getBuiltValues(input.name);
+        if (builtValues == nullptr || (*builtValues)[0] == params.*input.value)
+            continue;
+        auto builtParams = params;
+        builtParams.*input.value = (*builtValues)[0];
+        auto builtNodes = GetLayoutNodes(SolveRings2D2SquaresLayout(builtParams, true));
+        for (size_t i = 0; i < nodes.size(); i++)
+            if (builtNodes[i].values != nodes[i].values)
+                nodes[i].dependencies.push_back(input.name);
+    }
+    for (auto& node : nodes)
+        dependencies.setNode(node.name, node.values, node.dependencies);
+}
+
+std::vector<Ptr<Point3D>> Rings2D2Squares::getLinkerPoints()
+{
+    std::vector<Ptr<Point3D>> points;
+    for (auto& point : layout.basePart.linkerPoints)
+        points.push_back(ToPoint3D(point));
+    return points;
 }
 
 void saveBodyAssStl(Ptr<Component> component)
@@ -232,60 +188,177 @@ void saveBodyAssStl(Ptr<Component> component)
 
 void Rings2D2Squares::createBodies(Ptr<Component> component)
 {
+    INSTRUMENT_PART("Rings2D2Squares");
     SetParams(basePart, roofPart, volfUpPart, volfDownPart);
+    setDependencies();
 
-    if (leftAxis == nullptr)
+    auto clearance = VerifySquaresClearance(getParams(), layout, true);
+    if (!clearance.isClear())
+    {
+        auto gapsMessage = "Inner wall: " + std::to_string(clearance.innerWallGap) + "\nOuter wall: " + std::to_string(clearance.outerWallGap) +
+            "\nVolfs: " + std::to_string(clearance.volfGap) + "\nCrossing: " + std::to_string(clearance.crossingGap);
+        if (MessageBox("A volf jams on its way, the smallest gaps are\n" + gapsMessage + "\n\nBuild anyway?", "", YesNoButtonType) == DialogNo)
+            return;
+    }
+
+    // a build in another design shares nothing with this one
+    if (builtComponent == nullptr || !builtComponent->isValid() || builtComponent->id() != component->id())
+    {
+        dependencies.invalidate();
+        leftAxis = rightAxis = nullptr;
+        volfsSketch = nullptr;
+        baseBody = volfDownBody = volfUpBody = nullptr;
+        roofBodies = nullptr;
+        analysis = nullptr;
+        builtComponent = component;
+    }
+
+    auto isAxesDirty = dependencies.isDirty("SquareAxes") || leftAxis == nullptr || !leftAxis->isValid() || rightAxis == nullptr || !rightAxis->isValid();
+    if (isAxesDirty)
+    {
+        if (analysis != nullptr && analysis->isValid())
+            analysis->deleteMe();
+        analysis = nullptr;
+        if (leftAxis != nullptr && leftAxis->isValid())
+            leftAxis->deleteMe();
+        if (rightAxis != nullptr && rightAxis->isValid())
+            rightAxis->deleteMe();
         leftAxis = AddConstructionAxis(component, getLeftCenterPoint(), Vector3D::create(0, 0, 1));
-    if (rightAxis == nullptr)
         rightAxis = AddConstructionAxis(component, getRightCenterPoint(), Vector3D::create(0, 0, 1));
+    }
 
-    auto volfsSketch = basePart.createCirclesSketch(component, getVolfRadius(), 0);
-    volfsSketch->isLightBulbOn(false);
+    // the dirty parts are found before any of them is rebuilt
+    auto isVolfPlacesDirty = dependencies.isDirty("VolfPlaces") || volfsSketch == nullptr || !volfsSketch->isValid();
+    auto isBaseDirty = dependencies.isDirty("BasePart") || baseBody == nullptr || !baseBody->isValid();
+    auto isRoofDirty = dependencies.isDirty("RoofPart") || roofBodies == nullptr;
+    for (int i = 0; !isRoofDirty && i < roofBodies->count(); i++)
+        isRoofDirty = !roofBodies->item(i)->isValid();
+    auto isVolfDownDirty = isVolfPlacesDirty || dependencies.isDirty("VolfDownPart") || volfDownBody == nullptr || !volfDownBody->isValid();
+    auto isVolfUpDirty = isVolfPlacesDirty || dependencies.isDirty("VolfUpPart") || volfUpBody == nullptr || !volfUpBody->isValid();
+    skippedParts.clear();
+    std::string rebuiltParts;
+    // a rebuilt part is followed by the inputs and shared nodes that drove it
+    auto report = [&](const std::string& name, bool isDirty)
+    {
+        if (!isDirty)
+        {
+            skippedParts.push_back(name);
+            return;
+        }
+        std::string causes;
+        for (auto& dependency : dependencies.getDirtyDependencies(name))
+            causes += (causes.empty() ? "" : ", ") + dependency;
+        rebuiltParts += (rebuiltParts.empty() ? "" : ", ") + name + (causes.empty() ? "" : " (" + causes + ")");
+    };
+
+    if (isVolfPlacesDirty)
+    {
+        if (volfsSketch != nullptr && volfsSketch->isValid())
+            volfsSketch->deleteMe();
+        volfsSketch = basePart.createCirclesSketch(component, getVolfRadius(), 0);
+        volfsSketch->isLightBulbOn(false);
+    }
 
-    auto baseBody = basePart.createBody(component);
-    auto roofBodies = roofPart.createBodies(component, basePart.getLinkerPoints());
-    
-    Ptr<BRepBody> volfDownBody;
-    Ptr<BRepBody> volfUpBody;
-    int k = 2;
-    for (int i = 0; i < volfsSketch->sketchCurves()->sketchCircles()->count() && k < 2; i++)
+    report("BasePart", isBaseDirty);
+    if (isBaseDirty)
     {
-        auto volfCenter = volfsSketch->sketchCurves()->sketchCircles()->item(i)->centerSketchPoint()->geometry();
-        if (volfCenter->x() < getRightCenterPoint()->x() + 2.0 * getVolfRadius() || volfCenter->y() < 0)
-            continue;
-        k++;
+        if (baseBody != nullptr && baseBody->isValid())
+            baseBody->deleteMe();
+        baseBody = basePart.createBody(component);
+    }
+
+    report("RoofPart", isRoofDirty);
+    if (isRoofDirty)
+    {
+        for (int i = 0; roofBodies != nullptr && i < roofBodies->count(); i++)
+        {
+            Ptr<BRepBody> roofBody = roofBodies->item(i);
+            if (roofBody->isValid())
+                roofBody->deleteMe();
+        }
+        roofBodies = roofPart.createBodies(component, getLinkerPoints());
+    }
 
-        volfDownPart.centerPoint = volfCenter;
-        volfDownBody = volfDownPart.createBody(component);
+    // the volfs are built once at the origin and placed at the circles of the sketch
+    std::vector<Ptr<Vector3D>> volfShifts;
+    auto volfCircles = volfsSketch->sketchCurves()->sketchCircles();
+    for (int i = 0; i < volfCircles->count(); i++)
+        volfShifts.push_back(volfCircles->item(i)->centerSketchPoint()->geometry()->asVector());
 
-        //if (i > 0)
-        //    continue;
-        volfUpPart.centerPoint = volfCenter;
-        volfUpBody = volfUpPart.createBody(component);
-        //volfUpBody->isLightBulbOn(false);
+    auto volfCacheHits = volfDownPart.bodyCache.getHitCount() + volfUpPart.bodyCache.getHitCount();
+    auto volfCacheMisses = volfDownPart.bodyCache.getMissCount() + volfUpPart.bodyCache.getMissCount();
+    report("VolfDownPart", isVolfDownDirty);
+    if (isVolfDownDirty)
+    {
+        if (volfDownBody != nullptr && volfDownBody->isValid())
+            DeleteOccurrences(component, volfDownBody->parentComponent());
+        volfDownBody = CreateInstancedBody(component, "VolfDown", volfShifts, [&](Ptr<Component> volfComponent)
+        {
+            volfDownPart.centerPoint = GetCenterPoint();
+            return volfDownPart.createBody(volfComponent);
+        });
+    }
+
+    report("VolfUpPart", isVolfUpDirty);
+    if (isVolfUpDirty)
+    {
+        if (volfUpBody != nullptr && volfUpBody->isValid())
+            DeleteOccurrences(component, volfUpBody->parentComponent());
+        volfUpBody = CreateInstancedBody(component, "VolfUp", volfShifts, [&](Ptr<Component> volfComponent)
+        {
+            volfUpPart.centerPoint = GetCenterPoint();
+            return volfUpPart.createBody(volfComponent);
+        });
+    }
+    dependencies.markBuilt();
+    volfCacheHits = volfDownPart.bodyCache.getHitCount() + volfUpPart.bodyCache.getHitCount() - volfCacheHits;
+    volfCacheMisses = volfDownPart.bodyCache.getMissCount() + volfUpPart.bodyCache.getMissCount() - volfCacheMisses;
+
+    if (analysis == nullptr || !analysis->isValid())
+    {
+        analysis = AddSectionAnalysis(component, component->xZConstructionPlane(), 0);
+        analysis->flip();
+        Rotate(analysis, RAD_45, rightAxis);
     }
-    
-    auto analysis = AddSectionAnalysis(component, component->xZConstructionPlane(), 0);
-    analysis->flip();
-    Rotate(analysis, RAD_45, rightAxis);
     
     component->parentDesign()->namedViews()->homeNamedView()->apply();
 
-    if (MessageBox("Save bodies as STL?", "", YesNoButtonType) == DialogNo)
+    std::string skipped;
+    for (auto& name : skippedParts)
+        skipped += (skipped.empty() ? "" : ", ") + name;
+    auto rebuildMessage = "Rebuilt: " + (rebuiltParts.empty() ? std::string("none") : rebuiltParts) + "\nSkipped: " + (skipped.empty() ? std::string("none") : skipped) +
+        "\nVolf body cache: " + std::to_string(volfCacheHits) + " hits, " + std::to_string(volfCacheMisses) + " misses";
+    if (MessageBox(rebuildMessage + "\n\nSave bodies as STL?", "", YesNoButtonType) == DialogNo)
         return;
 
     std::string modelsFolderPath = "D:\\ServerTechnology\\RingsModels\\2D2S12v3\\";
     
-    SaveAsStl(baseBody, modelsFolderPath + "BaseBody.stl");
+    std::vector<std::pair<Ptr<BRepBody>, std::string>> namedBodies;
+    namedBodies.push_back({ baseBody, "BaseBody" });
     for (int i = 0; i < roofBodies->count(); i++)
     {
         Ptr<BRepBody> roofBody = roofBodies->item(i);
-        SaveAsStl(roofBody, modelsFolderPath + roofBody->name() + ".stl");
+        namedBodies.push_back({ roofBody, roofBody->name() });
     }
     if (volfUpBody != nullptr && volfDownBody != nullptr)
     {
-        SaveAsStl(volfUpBody, modelsFolderPath + "VolfUpBody.stl");
-        SaveAsStl(volfDownBody, modelsFolderPath + "VolfDownBody.stl");
+        namedBodies.push_back({ volfUpBody, "VolfUpBody" });
+        namedBodies.push_back({ volfDownBody, "VolfDownBody" });
+    }
+
+    // the plate takes the meshes the STL files are written from
+    std::vector<std::pair<Ptr<BRepBody>, std::string>> stlBodies;
+    for (auto& item : namedBodies)
+        stlBodies.push_back({ item.first, modelsFolderPath + item.second + ".stl" });
+    std::vector<MeshBody> plateBodies;
+    auto isSaved = SaveAllAsStl(stlBodies, &plateBodies);
+    for (size_t i = 0; i < plateBodies.size(); i++)
+        plateBodies[i].name = namedBodies[i].second;
+    isSaved = SaveRings2D2SquaresAs3mf(plateBodies, getParams(), layout, modelsFolderPath + "Rings2D2Squares.3mf") && isSaved;
+    if (!isSaved)
+    {
+        MessageBox("Some bodies were not saved :(");
+        return;
     }
     MessageBox("All Done :)");
 }
\ No newline at end of file
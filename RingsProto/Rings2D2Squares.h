@@ -9,6 +9,8 @@
 #include "VolfUpPart.h"
 #include "PariedSquaresPart.h"
 #include "PariedSquaresWithOuterRectanglePart.h"
+#include "Rings2D2SquaresLayout.h"
+#include "PartDependencies.h"
 
 using namespace adsk::core;
 using namespace adsk::fusion;
@@ -40,12 +42,27 @@ public:
     double unmoovableClearence = ABS_UNMOOVABLE_CLEARNCE;
     double verticalEdgeFilletRadius = 0.24;
     double horizontalEdgeFilletRadius = 0.12;
+    bool isSymmetricBuild = true; //booleans on a quarter and fillets on a half of the rectangled parts, checked on the first build
 private:
+    Rings2D2SquaresLayout layout;
     Ptr<ConstructionAxis> leftAxis = nullptr;
     Ptr<ConstructionAxis> rightAxis = nullptr;
+    // what the last createBodies built, a next call on the same component rebuilds only the dirty parts
+    Ptr<Component> builtComponent;
+    PartDependencyGraph dependencies;
+    std::vector<std::string> skippedParts;
+    Ptr<Sketch> volfsSketch;
+    Ptr<BRepBody> baseBody;
+    Ptr<ObjectCollection> roofBodies;
+    Ptr<BRepBody> volfDownBody;
+    Ptr<BRepBody> volfUpBody;
+    Ptr<SectionAnalysis> analysis;
 
 public:
     Rings2D2Squares();
+    Rings2D2SquaresParams getParams();
+    // the parts the last createBodies kept from the call before
+    const std::vector<std::string>& getSkippedParts() const { return skippedParts; }
 private:
     double getVolfRadius();
     double getLineLength();
@@ -54,10 +71,12 @@ private:
     
     Ptr<Point3D> getLeftCenterPoint();
     Ptr<Point3D> getRightCenterPoint();
+    std::vector<Ptr<Point3D>> getLinkerPoints();
 
     void SetParams(RectangledBasePart& basePart, RectangledRoofPart& roofPart, VolfUpPart& volfUpPart, VolfDownPart& volfDownPart);
     void SetParams(BasePart& basePart, RoofPart& roofPart, VolfUpPart& volfUpPart, VolfDownPart& volfDownPart);
     void SetParams(MetizParams& linkMetizParams);
+    void setDependencies();
 public:
     void createBodies(Ptr<Component> component);
 };
@@ -0,0 +1,202 @@
+#include "Rings2D2SquaresLayout.h"
+
+double GetSquaresVolfRadius(double lineVolfCount, double cornerVolfCount, double squareMiddleSize)
+{
+    // innerCornerRadius + volfRadius = middleCornerRadius
+    // volfDiametr = 2 * volfRadius;
+    // volfDiametr^2 = middleCornerRadius^2 + middleCornerRadius^2 - 2 * middleCornerRadius * middleCornerRadius * cos(2*pi / 4*cornerVolfCount) //law of cosines
+    // volfDiametr = middleCornerRadius * sqrt(2)*sqrt(1 - cos(2*pi / 4*cornerVolfCount))
+    // rate = sqrt(2)*sqrt(1 - cos(2*pi / 4*cornerVolfCount))
+    // volfDiametr = middleCornerRadius * rate
+    // middleCornerRadius = (squareMiddleSize - lineVolfCount * volfDiametr)/2
+    // volfDiametr = (squareMiddleSize - lineVolfCount * volfDiametr) * rate / 2
+    // volfDiametr = (squareMiddleSize * rate / 2) / (1 + lineVolfCount * rate / 2)
+
+    auto rate = sqrt(2.0) * sqrt(1 - cos(FULL_CIRCLE_RAD / (4.0 * cornerVolfCount)));
+    auto volfDiametr = (squareMiddleSize * rate / 2.0) / (1.0 + lineVolfCount * rate / 2.0);
+    return volfDiametr / 2.0;
+}
+
+double GetSquaresLineLength(double lineVolfCount, double volfRadius)
+{
+    return lineVolfCount * volfRadius * 2.0;
+}
+
+double GetSquaresCornerOuterRadius(double squareMiddleSize, double lineLength, double volfRadius)
+{
+    return (squareMiddleSize - lineLength) / 2.0 + volfRadius;
+}
+
+double GetSquaresShift(double squareMiddleSize)
+{
+    auto sizeByVolfCenter = squareMiddleSize;
+    return sizeByVolfCenter / (2.0 * sqrt(2.0));
+}
+
+static void SolveLinkerPoints(RectangledBasePartLayout& basePart)
+{
+    auto shift = basePart.cornerFilletRadius - basePart.cornerFilletRadius / sqrt(2.0) + basePart.linkingPart.radius / sqrt(2.0) + basePart.wallThickness / sqrt(2.0);
+    auto cornerOuterRadius = basePart.cornerMiddleRadius + basePart.outerWidth;
+    auto size = basePart.lineLength / sqrt(2.0) + cornerOuterRadius - basePart.cuttingShellThickness;
+    auto top = basePart.rightCenterPoint.y + size;
+    auto right = basePart.rightCenterPoint.x + size;
+    auto left = basePart.leftCenterPoint.x - size;
+    auto down = basePart.leftCenterPoint.y - size;
+
+    basePart.linkerPoints[0] = { right - shift, top - shift, 0 };
+    basePart.linkerPoints[1] = { right - shift, down + shift, 0 };
+    basePart.linkerPoints[2] = { left + shift, top - shift, 0 };
+    basePart.linkerPoints[3] = { left + shift, down + shift, 0 };
+}
+
+void SolveRings2D2SquaresLayout(const Rings2D2SquaresParams& params, bool isRectangled, Rings2D2SquaresLayout& layout)
+{
+    auto moovableClearence = params.moovableClearence;
+    auto unmoovableClearence = params.unmoovableClearence;
+    auto horizontalEdgeFilletRadius = params.horizontalEdgeFilletRadius;
+    auto verticalEdgeFilletRadius = params.verticalEdgeFilletRadius;
+
+    layout = Rings2D2SquaresLayout();
+    layout.volfRadius = GetSquaresVolfRadius(params.lineVolfCount, params.cornerVolfCount, params.squareMiddleSize);
+    layout.clearedVolfRadius = layout.volfRadius - moovableClearence / (params.cornerVolfCount * 4.0 + params.lineVolfCount * 4.0);
+    layout.lineLength = GetSquaresLineLength(params.lineVolfCount, layout.volfRadius);
+    layout.cornerOuterRadius = GetSquaresCornerOuterRadius(params.squareMiddleSize, layout.lineLength, layout.volfRadius);
+    layout.squareShift = GetSquaresShift(params.squareMiddleSize);
+    layout.leftCenterPoint = { -layout.squareShift, 0, 0 };
+    layout.rightCenterPoint = { layout.squareShift, 0, 0 };
+
+    auto volfRadius = layout.clearedVolfRadius;
+    auto& linkMetiz = layout.linkMetiz;
+    auto& basePart = layout.basePart;
+    auto& roofPart = layout.roofPart;
+    auto& volfUpPart = layout.volfUpPart;
+    auto& volfDownPart = layout.volfDownPart;
+
+    linkMetiz.hatRadius = 0.24;
+    linkMetiz.hatHeight = 0.16;
+    linkMetiz.legRadius = 0.12;
+    linkMetiz.legHeight = 0.68;
+
+    basePart.floorThickness = 0.3;
+    basePart.wallThickness = 0.16;
+    basePart.circlesOnSquareRadius = 0.25;
+
+    roofPart.floorThickness = 0.3;
+    roofPart.wallThickness = 0.16;
+    if (isRectangled)
+        roofPart.cornerFilletRadius = layout.volfRadius * 2.0;
+
+    volfDownPart.radius = volfRadius;
+    volfDownPart.height = isRectangled ? 0.44 : 0.54;
+    volfDownPart.holeDownRadius = 0.28;
+    volfDownPart.holeDownHeight = 0.3;
+    volfDownPart.holeRadius = 0.15;
+
+    volfUpPart.height = 0.5;
+    volfUpPart.middleRadius = 0.3;
+    volfUpPart.holeRadius = 0.14;
+    volfUpPart.form = VolfUpForm::Convex;
+    volfUpPart.concaveHeight = 0.15;
+
+    volfDownPart.holeHeight = volfDownPart.height;
+    volfDownPart.zMoveShift = basePart.floorThickness + moovableClearence;
+    volfDownPart.filletRadius = horizontalEdgeFilletRadius;
+
+    volfUpPart.radius = volfRadius;
+    volfUpPart.middleHeight = roofPart.floorThickness;
+    volfUpPart.holeHeight = volfUpPart.middleHeight + volfUpPart.height;
+    volfUpPart.concaveRadius = volfRadius * 3.0;
+    volfUpPart.convexRadius = volfRadius * 1.5;
+    volfUpPart.filletRadius = horizontalEdgeFilletRadius;
+
+    auto wallsThickness = isRectangled ? basePart.wallThickness + roofPart.wallThickness : basePart.wallThickness;
+    basePart.lineLength = layout.lineLength;
+    basePart.cornerMiddleRadius = layout.cornerOuterRadius - layout.volfRadius;
+    basePart.innerWidth = layout.volfRadius + wallsThickness + moovableClearence * 1.5;
+    basePart.outerWidth = layout.volfRadius + wallsThickness + moovableClearence * 0.5;
+    basePart.height = basePart.floorThickness + volfDownPart.height + 2.0 * moovableClearence;
+    basePart.leftCenterPoint = layout.leftCenterPoint;
+    basePart.rightCenterPoint = layout.rightCenterPoint;
+    basePart.circlesOnSquarePeriodRadius = layout.volfRadius;
+    basePart.topEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
+    basePart.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
+    basePart.otherEdgeFilletRadius = isRectangled ? horizontalEdgeFilletRadius / 2.0 : horizontalEdgeFilletRadius;
+
+    auto roofWallShift = isRectangled ? -roofPart.wallThickness : roofPart.wallThickness;
+    roofPart.lineLength = layout.lineLength;
+    roofPart.cornerMiddleRadius = layout.cornerOuterRadius - layout.volfRadius;
+    roofPart.innerWidth = basePart.innerWidth + roofWallShift;
+    roofPart.outerWidth = basePart.outerWidth + roofWallShift;
+    roofPart.height = basePart.height + roofPart.floorThickness + unmoovableClearence;
+    roofPart.leftCenterPoint = basePart.leftCenterPoint;
+    roofPart.rightCenterPoint = basePart.rightCenterPoint;
+    roofPart.separationInnerWidth = volfUpPart.middleRadius + moovableClearence * 1.5;
+    roofPart.separationOuterWidth = volfUpPart.middleRadius + moovableClearence * 0.5;
+    roofPart.downTrimmingThicknes = moovableClearence * 2.0;
+    roofPart.topEdgeFilletRadius = horizontalEdgeFilletRadius;
+    roofPart.verticalEdgeFilletRadius = verticalEdgeFilletRadius;
+    roofPart.otherEdgeFilletRadius = horizontalEdgeFilletRadius / 2.0;
+
+    volfUpPart.zMoveShift = basePart.height + unmoovableClearence + roofPart.floorThickness + moovableClearence;
+
+    if (!isRectangled)
+        return;
+
+    basePart.cuttingShellThickness = basePart.wallThickness + roofPart.wallThickness;
+    basePart.cornerFilletRadius = roofPart.cornerFilletRadius - roofPart.wallThickness;
+    basePart.centralLinkerRadius = 0.2;
+
+    basePart.linkingPart.isFloorOnTop = true;
+    basePart.linkingPart.isReverse = false;
+    basePart.linkingPart.floorHoleRadius = linkMetiz.legRadius + moovableClearence;
+    basePart.linkingPart.floorThickness = 0.12;
+    basePart.linkingPart.wallThickness = 0.16;
+    basePart.linkingPart.radius = basePart.linkingPart.wallThickness + linkMetiz.hatRadius + moovableClearence;
+    basePart.linkingPart.height = basePart.floorThickness;
+    basePart.linkingPart.z = 0;
+
+    roofPart.deepThickness = basePart.floorThickness;
+    roofPart.centralLinkerRadius = basePart.centralLinkerRadius + unmoovableClearence;
+
+    roofPart.linkingPart.isFloorOnTop = true;
+    roofPart.linkingPart.isReverse = true;
+    roofPart.linkingPart.floorThickness = 0.0;
+    roofPart.linkingPart.radius = linkMetiz.legRadius + 0.2;
+    roofPart.linkingPart.floorHoleRadius = 0.0;
+    roofPart.linkingPart.wallThickness = roofPart.linkingPart.radius - linkMetiz.legRadius;
+    roofPart.linkingPart.z = roofPart.height - roofPart.wallThickness;
+    roofPart.linkingPart.height = roofPart.linkingPart.z - basePart.linkingPart.height - unmoovableClearence;
+
+    SolveLinkerPoints(basePart);
+}
+
+Rings2D2SquaresLayout SolveRings2D2SquaresLayout(const Rings2D2SquaresParams& params, bool isRectangled)
+{
+    Rings2D2SquaresLayout layout;
+    SolveRings2D2SquaresLayout(params, isRectangled, layout);
+    return layout;
+}
+
+std::vector<PlainPoint3D> GetSquaresVolfPlaces(const Rings2D2SquaresParams& params, const Rings2D2SquaresLayout& layout, const PlainPoint3D& center)
+{
+    // the top line and the corner after it, the next quarters are turned clockwise
+    auto halfLine = layout.lineLength / 2.0;
+    auto cornerRadius = layout.basePart.cornerMiddleRadius;
+    std::vector<PlainPoint3D> quarterPlaces;
+    for (int i = 0; i < (int)params.lineVolfCount; i++)
+        quarterPlaces.push_back({ -halfLine + layout.volfRadius * (2.0 * i + 1.0), halfLine + cornerRadius, 0 });
+    for (int i = 0; i < (int)params.cornerVolfCount; i++)
+    {
+        auto angle = RAD_90 * (i + 0.5) / (int)params.cornerVolfCount;
+        quarterPlaces.push_back({ halfLine + cornerRadius * sin(angle), halfLine + cornerRadius * cos(angle), 0 });
+    }
+
+    std::vector<PlainPoint3D> places;
+    for (int quarter = 0; quarter < 4; quarter++)
+    {
+        auto angle = RAD_45 - RAD_90 * quarter;
+        for (auto& place : quarterPlaces)
+            places.push_back({ center.x + place.x * cos(angle) - place.y * sin(angle), center.y + place.x * sin(angle) + place.y * cos(angle), 0 });
+    }
+    return places;
+}
\ No newline at end of file
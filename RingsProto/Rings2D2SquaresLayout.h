@@ -0,0 +1,47 @@
+#pragma once
+#include "Geometry.h"
+#include "PartLayouts.h"
+#include <vector>
+
+struct Rings2D2SquaresParams
+{
+    double lineVolfCount = 1;
+    double cornerVolfCount = 2;
+    double squareMiddleSize = 5; //length bitween centers of paralel line ways
+    double moovableClearence = ABS_MOOVABLE_CLEARNCE;
+    double unmoovableClearence = ABS_UNMOOVABLE_CLEARNCE;
+    double verticalEdgeFilletRadius = 0.24;
+    double horizontalEdgeFilletRadius = 0.12;
+};
+
+struct Rings2D2SquaresLayout
+{
+    double volfRadius = 0;           // radius of a volf slot, without clearance
+    double clearedVolfRadius = 0;    // radius of a printed volf
+    double lineLength = 0;
+    double cornerOuterRadius = 0;
+    double squareShift = 0;
+    PlainPoint3D leftCenterPoint;
+    PlainPoint3D rightCenterPoint;
+
+    MetizLayout linkMetiz;
+    RectangledBasePartLayout basePart;
+    RectangledRoofPartLayout roofPart;
+    VolfUpPartLayout volfUpPart;
+    VolfDownPartLayout volfDownPart;
+};
+
+double GetSquaresVolfRadius(double lineVolfCount, double cornerVolfCount, double squareMiddleSize);
+double GetSquaresLineLength(double lineVolfCount, double volfRadius);
+double GetSquaresCornerOuterRadius(double squareMiddleSize, double lineLength, double volfRadius);
+double GetSquaresShift(double squareMiddleSize);
+
+// Computes every derived dimension of the puzzle. isRectangled selects the dimensions of
+// RectangledBasePart/RectangledRoofPart, otherwise the plain BasePart/RoofPart ones are filled.
+// Works on the stack only, so it is cheap enough to call for every evaluated variant.
+void SolveRings2D2SquaresLayout(const Rings2D2SquaresParams& params, bool isRectangled, Rings2D2SquaresLayout& layout);
+Rings2D2SquaresLayout SolveRings2D2SquaresLayout(const Rings2D2SquaresParams& params, bool isRectangled = true);
+
+// The volf places of Sketcher::AddCirclesOnSquare around center, in the order a clockwise
+// turn of the square moves the volfs: 4 * (lineVolfCount + cornerVolfCount) of them.
+std::vector<PlainPoint3D> GetSquaresVolfPlaces(const Rings2D2SquaresParams& params, const Rings2D2SquaresLayout& layout, const PlainPoint3D& center);
\ No newline at end of file
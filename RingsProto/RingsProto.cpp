@@ -1,10 +1,13 @@
 
 #include <Core/CoreAll.h>
 #include <Fusion/FusionAll.h>
+#include <memory>
 
 #include "RingsProtoCreator.h"
 #include "Rings2D2Circles.h"
 #include "Rings2D2Squares.h"
+#include "FusionEnvironment.h"
+#include "Instrumentation.h"
 
 using namespace adsk::core;
 using namespace adsk::fusion;
@@ -14,6 +17,8 @@ Ptr<UserInterface> ui;
 Ptr<Document> doc;
 Ptr<Design> des;
 Ptr<Component> rootComp;
+// lives from run to stop, so a next run rebuilds only the parts whose fields changed
+std::unique_ptr<Rings2D2Squares> rings2D2Squares;
 
 bool Init();
 
@@ -35,8 +40,12 @@ extern "C" XI_EXPORT bool run(const char* context)
 	
 	//ui->messageBox("Start");
     
-    Rings2D2Squares rings2D2Squares;
-    rings2D2Squares.createBodies(rootComp);
+    // primitives and their booleans stay out of the timeline until a part body is done
+    SetTransientPrimitives(true);
+
+    if (!rings2D2Squares)
+        rings2D2Squares.reset(new Rings2D2Squares());
+    rings2D2Squares->createBodies(rootComp);
 
     /*Rings2D2Circles rings2D2Circles;
     rings2D2Circles.circleRadius = 2.5;
@@ -62,10 +71,20 @@ extern "C" XI_EXPORT bool run(const char* context)
 
 	//ui->messageBox("Ok");
 	
+    if (!INSTRUMENT_REPORT("D:\\ServerTechnology\\RingsModels\\Instrumentation"))
+        ui->messageBox("Instrumentation report was not saved");
 
 	return true;
 }
 
+extern "C" XI_EXPORT bool stop(const char* context)
+{
+    rings2D2Squares.reset();
+    ui = nullptr;
+    app = nullptr;
+    return true;
+}
+
 bool Init()
 {
 	doc = app->activeDocument();
@@ -1,5 +1,8 @@
 #include "RingsProtoCreator.h"
+#include "Instrumentation.h"
 #include "FusionEnvironment.h"
+#include "PuzzlePlates.h"
+#include "TopologyIndex.h"
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -30,13 +33,32 @@ RingsProtoCreator::RingsProtoCreator(
 
 void RingsProtoCreator::Initialize()
 {
-    baseCuttingParams.outerRadius = outerRadius;
-    baseCuttingParams.outerLength = getVolfLegAngel() * baseCuttingParams.outerRadius + 2.0 * clearanceMovable;
-    baseCuttingParams.innerRadius = innerRadius + floorBottomThickness;
-    baseCuttingParams.innerLength = getVolfAngel() * baseCuttingParams.innerRadius + 2.0 * clearanceBetweenBaseWallAndVolfLeg;
-    baseCuttingParams.middleRadius = outerRadius - floorTopThickness;
-    baseCuttingParams.miidleLegLength = getVolfLegAngel() * baseCuttingParams.middleRadius + 2.0 * clearanceBetweenBaseWallAndVolfLeg;
-    baseCuttingParams.miidleLength = (getVolfAngel() * baseCuttingParams.middleRadius - baseCuttingParams.miidleLegLength + 2.0 * clearanceBetweenBaseWallAndVolfLeg) / 2.0;
+    SolveRingsProtoCreatorLayout(getParams(), layout);
+    baseCuttingParams.outerRadius = layout.cuttingOuterRadius;
+    baseCuttingParams.outerLength = layout.cuttingOuterLength;
+    baseCuttingParams.innerRadius = layout.cuttingInnerRadius;
+    baseCuttingParams.innerLength = layout.cuttingInnerLength;
+    baseCuttingParams.middleRadius = layout.cuttingMiddleRadius;
+    baseCuttingParams.miidleLegLength = layout.cuttingMiidleLegLength;
+    baseCuttingParams.miidleLength = layout.cuttingMiidleLength;
+}
+
+RingsProtoCreatorParams RingsProtoCreator::getParams()
+{
+    RingsProtoCreatorParams params;
+    params.outerRadius = outerRadius;
+    params.innerRadius = innerRadius;
+    params.volfCount = volfCount;
+    params.wallThickness = wallThickness;
+    params.floorTopThickness = floorTopThickness;
+    params.floorBottomThickness = floorBottomThickness;
+    params.volfLegRate = volfLegRate;
+    params.clearanceMovable = clearanceMovable;
+    params.clearanceUnmovable = clearanceUnmovable;
+    params.clearanceBetweenBaseWallAndVolfLeg = clearanceBetweenBaseWallAndVolfLeg;
+    params.baseInternalCornerFilletRadius = baseInternalCornerFilletRadius;
+    params.volfHeigntOverBaseInCenter = volfHeigntOverBaseInCenter;
+    return params;
 }
 
 bool RingsProtoCreator::createBodies(Ptr<Component> component)
@@ -48,6 +70,7 @@ bool RingsProtoCreator::createBodies(Ptr<Component> component)
 
 bool RingsProtoCreator::createBaseBody(Ptr<Component> component)
 {
+    INSTRUMENT_PART("RingsProtoCreatorBase");
     xy45Axis = AddConstructionAxis(component, Vector3D::create(1, 1, 0));
     xy135Axis = AddConstructionAxis(component, Vector3D::create(-1, 1, 0));
     yz135Axis = AddConstructionAxis(component, Vector3D::create(0, -1, 1));
@@ -56,27 +79,21 @@ bool RingsProtoCreator::createBaseBody(Ptr<Component> component)
     	
     auto baseRevolve = Revolve(component, baseSketch, component->xConstructionAxis(), RAD_144);
     
-    auto baseLeftFace = getBodyFace(baseRevolve->bodies()->item(0), Left);
-    auto baseRightFace = getBodyFace(baseRevolve->bodies()->item(0), Right);
-    auto baseTopFace = getBodyFace(baseRevolve->bodies()->item(0), Top);
-    auto baseBottomFace = getBodyFace(baseRevolve->bodies()->item(0), Bottom);
-    auto baseTopLeftEdge = getJoinedEdge(baseTopFace, baseLeftFace);
-    auto baseTopRightEdge = getJoinedEdge(baseTopFace, baseRightFace);
-    auto baseBottomLeftEdge = getJoinedEdge(baseBottomFace, baseLeftFace);
-    auto baseBottomRightEdge = getJoinedEdge(baseBottomFace, baseRightFace);
-
-	auto baseBody = Rotate(component, baseRevolve->bodies()->item(0), component->zConstructionAxis(), RAD_90, true);
-	baseBody = Combine(component, FeatureOperations::JoinFeatureOperation, baseRevolve->bodies()->item(0), baseBody);
+    BodyTopology baseFaces(baseRevolve->bodies()->item(0), BodyTopology::FaceColumns);
+    auto baseLeftFace = baseFaces.getFace(Left);
+    auto baseRightFace = baseFaces.getFace(Right);
+
+	auto baseBody = CircularPattern(component, baseRevolve->bodies()->item(0), component->zConstructionAxis(), 2, RAD_90, FeatureOperations::JoinFeatureOperation)->item(0)->cast<BRepBody>();
     
 	auto cuttingSketch = createSketchCutting(component);
 	auto cuttingRevolve = Revolve(component, cuttingSketch, component->xConstructionAxis(), RAD_180);
-	auto cuttingBody = Rotate(component, cuttingRevolve->bodies()->item(0), component->zConstructionAxis(), RAD_90, true);
-	cuttingBody = Combine(component, FeatureOperations::JoinFeatureOperation, cuttingRevolve->bodies()->item(0), cuttingBody);
+	auto cuttingBody = CircularPattern(component, cuttingRevolve->bodies()->item(0), component->zConstructionAxis(), 2, RAD_90, FeatureOperations::JoinFeatureOperation)->item(0)->cast<BRepBody>();
 
 	baseBody = Combine(component, FeatureOperations::CutFeatureOperation, baseBody, cuttingBody);
 
-	auto internalEdges = GetEdges(baseBody, [=](Ptr<BRepEdge> edge) {return isBaseIntearnalCornerEdge(edge); });
-	auto externalEdges = GetEdges(baseBody, [=](Ptr<BRepEdge> edge) {return isBaseExternalCornerEdge(edge); });
+	BodyTopology baseTopology(baseBody);
+	auto internalEdges = baseTopology.getEdges([=](const BodyTopology& topology, int edge) {return isBaseIntearnalCornerEdge(topology, edge); });
+	auto externalEdges = baseTopology.getEdges([=](const BodyTopology& topology, int edge) {return isBaseExternalCornerEdge(topology, edge); });
 
 	Fillet(component, internalEdges, baseInternalCornerFilletRadius);
 	Fillet(component, externalEdges, baseExternalCornerFilletRadius);
@@ -86,53 +103,48 @@ bool RingsProtoCreator::createBaseBody(Ptr<Component> component)
 
 	baseBody = Combine(component, FeatureOperations::CutFeatureOperation, baseBody, cuttingFinalExtrude->bodies()->item(0));
 
-    auto baseArcEdges = GetEdges(baseBody, [=](Ptr<BRepEdge> edge)
-    {
-        if (edge->tangentiallyConnectedEdges()->count() <= 1)
-            return false;
-        auto tedges = edge->tangentiallyConnectedEdges();
-        for (int i = 0; i < tedges->count(); i++)
-        {
-            auto e = tedges->item(i)->cast<BRepEdge>();
-            for (int j = 0; j < e->faces()->count(); j++)
-            {
-                auto f = e->faces()->item(j);
-                if (f == baseLeftFace || f == baseRightFace)
-                    return true;
-            }
-        }
-        return false;
-    });
-
-    auto baseArcInsideEdges = GetEdges(baseBody, [=](Ptr<BRepEdge> edge)
+    // arc chains touching the side faces go to the outer fillet, the others inside;
+    // a chain is walked once, its other edges are found by their tokens then
+    auto baseArcEdges = ObjectCollection::create();
+    auto baseArcInsideEdges = ObjectCollection::create();
+    EntityTokenSet sideFaces = { baseLeftFace->entityToken(), baseRightFace->entityToken() };
+    std::unordered_map<std::string, bool> chainTouchesSide;
+    auto baseEdges = baseBody->edges();
+    for (int i = 0; i < baseEdges->count(); i++)
     {
-        if (edge->tangentiallyConnectedEdges()->count() <= 1)
-            return false;
-        auto tedges = edge->tangentiallyConnectedEdges();
-        for (int i = 0; i < tedges->count(); i++)
+        auto edge = baseEdges->item(i);
+        auto token = edge->entityToken();
+        auto chainItem = chainTouchesSide.find(token);
+        auto touchesSide = false;
+        if (chainItem != chainTouchesSide.end())
+            touchesSide = chainItem->second;
+        else
         {
-            auto e = tedges->item(i)->cast<BRepEdge>();
-            for (int j = 0; j < e->faces()->count(); j++)
+            auto tedges = edge->tangentiallyConnectedEdges();
+            if (tedges->count() <= 1)
+                continue;
+            for (int j = 0; j < tedges->count() && !touchesSide; j++)
             {
-                auto f = e->faces()->item(j);
-                if (f == baseLeftFace || f == baseRightFace)
-                    return false;
+                auto faces = tedges->item(j)->cast<BRepEdge>()->faces();
+                for (int k = 0; k < faces->count() && !touchesSide; k++)
+                    touchesSide = sideFaces.count(faces->item(k)->entityToken()) > 0;
             }
+            for (int j = 0; j < tedges->count(); j++)
+                chainTouchesSide[tedges->item(j)->cast<BRepEdge>()->entityToken()] = touchesSide;
         }
-        return true;
-    });
+        (touchesSide ? baseArcEdges : baseArcInsideEdges)->add(edge);
+    }
     
     Fillet(component, baseArcEdges, floorTopThickness * baseArcEdgesFilletRate);
     Fillet(component, baseArcInsideEdges, wallThickness * baseArcEdgesFilletRate);
 
-    auto baseFilletShift = baseInternalCornerFilletRadius * (sqrt(2.0) - 1.0);
-    auto baseTopFloorToothRadius = outerRadius - floorTopThickness / 2.0;
-    auto baseTopFloorToothSize = (getBaseOuterLength() - getVolfLegAngel() * outerRadius) / 2.0 - wallThickness;
-    auto baseTopFloorToothRotateAngel = ((((getBaseOuterLength() - getVolfLegAngel() * outerRadius) / 2.0 + getVolfLegAngel() * outerRadius) / 2.0 + clearanceBetweenBaseWallAndVolfLeg) * sqrt(2.0) + baseFilletShift) / outerRadius;
+    auto baseTopFloorToothRadius = layout.baseTopFloorToothRadius;
+    auto baseTopFloorToothSize = layout.baseTopFloorToothSize;
+    auto baseTopFloorToothRotateAngel = layout.baseTopFloorToothRotateAngel;
     
-    auto baseBottomFloorToothRadius = innerRadius + floorBottomThickness / 2.0;
-    auto baseBottomFloorToothSize = getBaseInnerLength() / 2.0 / innerRadius * baseBottomFloorToothRadius;
-    auto baseBottomFloorToothRotateAngel = (getBaseInnerLength() / 4.0 * sqrt(2.0) + baseFilletShift / 2.0) / innerRadius;
+    auto baseBottomFloorToothRadius = layout.baseBottomFloorToothRadius;
+    auto baseBottomFloorToothSize = layout.baseBottomFloorToothSize;
+    auto baseBottomFloorToothRotateAngel = layout.baseBottomFloorToothRotateAngel;
 
     baseBody = joinFloorToothToBase(component, baseBody, baseTopFloorToothRadius, baseToothThickness, baseTopFloorToothSize, baseTopFloorToothRotateAngel);
     baseBody = joinFloorToothToBase(component, baseBody, baseBottomFloorToothRadius, baseToothThickness, baseBottomFloorToothSize, baseBottomFloorToothRotateAngel, true);
@@ -141,15 +153,17 @@ bool RingsProtoCreator::createBaseBody(Ptr<Component> component)
 
     baseBody = Combine(component, FeatureOperations::JoinFeatureOperation, baseBody, baseReflectionBody);
 
-    Rotate(component, baseBody, component->zConstructionAxis(), RAD_90, true);
+    CircularPattern(component, baseBody, component->zConstructionAxis(), 2, RAD_90, FeatureOperations::NewBodyFeatureOperation);
+    createdBaseBody = baseBody;
 
 	return true;
 }
 
 bool RingsProtoCreator::createVolfBody(Ptr<Component> component)
 {
-    auto volfTop = outerRadius + volfHeigntOverBaseInCenter;
-    auto volfHeadSize = 2.0 * getTriangleLeg(volfTop, getVolfAngel() / 2.0);
+    INSTRUMENT_PART("RingsProtoCreatorVolf");
+    auto volfTop = layout.volfTop;
+    auto volfHeadSize = layout.volfHeadSize;
     auto squareScketch = createSketchSquare(component, volfHeadSize);
 
     auto body = Extrude(component, squareScketch, volfTop)->bodies()->item(0);
@@ -158,10 +172,7 @@ bool RingsProtoCreator::createVolfBody(Ptr<Component> component)
     Move(component, cuttingBody, component->yConstructionAxis(), volfHeadSize / 2.0);
     Rotate(component, cuttingBody, component->xConstructionAxis(), -getVolfAngel() / 2.0);
 
-    auto cuttingBodyCopy = Rotate(component, cuttingBody, component->zConstructionAxis(), RAD_90, true);
-    cuttingBody = Combine(component, FeatureOperations::JoinFeatureOperation, cuttingBodyCopy, cuttingBody);
-    cuttingBodyCopy = Rotate(component, cuttingBody, component->zConstructionAxis(), RAD_180, true);
-    cuttingBody = Combine(component, FeatureOperations::JoinFeatureOperation, cuttingBodyCopy, cuttingBody);
+    cuttingBody = CircularPattern(component, cuttingBody, component->zConstructionAxis(), 4, RAD_90, FeatureOperations::JoinFeatureOperation)->item(0)->cast<BRepBody>();
     body = Combine(component, FeatureOperations::CutFeatureOperation, body, cuttingBody);
 
     Move(component, body, component->zConstructionAxis(), clearanceMovable);
@@ -169,18 +180,26 @@ bool RingsProtoCreator::createVolfBody(Ptr<Component> component)
     auto intersectBody = createArcBody(component, baseCuttingParams.innerRadius + clearanceMovable + volfTop / 2.0, volfTop, 2.0 * volfHeadSize);
     body = Combine(component, FeatureOperations::IntersectFeatureOperation, body, intersectBody);
 
-    auto legThickness = floorTopThickness + 2.0 * clearanceMovable;
-    auto legRadius = outerRadius - legThickness / 2.0 + clearanceMovable;
+    auto legThickness = layout.volfLegThickness;
+    auto legRadius = layout.volfLegRadius;
     auto legCuttingBody = createArcBody(component, legRadius, legThickness, 2.0 * volfHeadSize);
     auto legBody = createArcBody(component, legRadius, legThickness, legRadius * getVolfLegAngel(), 0.3);
     legCuttingBody = Combine(component, FeatureOperations::CutFeatureOperation, legCuttingBody, legBody);
     body = Combine(component, FeatureOperations::CutFeatureOperation, body, legCuttingBody);
     
     Rotate(component, body, component->xConstructionAxis(), RAD_90 / 2.0, true);
+    createdVolfBody = body;
 
     return body;
 }
 
+bool RingsProtoCreator::saveAs3mf(const std::string& filepath)
+{
+    if (createdBaseBody == nullptr || createdVolfBody == nullptr)
+        return false;
+    return SaveRingsProtoAs3mf(GetMeshBody(createdBaseBody, "BaseBody"), GetMeshBody(createdVolfBody, "VolfBody"), getParams(), filepath);
+}
+
 Ptr<Sketch> RingsProtoCreator::createSketchBase(Ptr<Component> component)
 {
 	Ptr<Sketch> sketch = CreateSketch(component, component->xYConstructionPlane(), "BaseSketch");
@@ -197,14 +216,14 @@ Ptr<Sketch> RingsProtoCreator::createSketchBase(Ptr<Component> component)
 	return sketch;
 }
 
-bool RingsProtoCreator::isBaseExternalCornerEdge(Ptr<BRepEdge> edge)
+bool RingsProtoCreator::isBaseExternalCornerEdge(const BodyTopology& topology, int edge)
 {
-	return (edge->startVertex()->geometry()->z() > innerRadius) && (edge->endVertex()->geometry()->z() > innerRadius);
+	return (topology.startZ[edge] > innerRadius) && (topology.endZ[edge] > innerRadius);
 }
 
-bool RingsProtoCreator::isBaseIntearnalCornerEdge(Ptr<BRepEdge> edge)
+bool RingsProtoCreator::isBaseIntearnalCornerEdge(const BodyTopology& topology, int edge)
 {
-	return  (abs(edge->length() - outerRadius + innerRadius) < 0.02) && ((edge->startVertex()->geometry()->z() > innerRadius) || (edge->endVertex()->geometry()->z() > innerRadius));
+	return  (abs(topology.length[edge] - outerRadius + innerRadius) < 0.02) && ((topology.startZ[edge] > innerRadius) || (topology.endZ[edge] > innerRadius));
 }
 
 bool RingsProtoCreator::isBaseWallXFloorsOuterEdge(Ptr<BRepEdge> edge)
@@ -279,13 +298,14 @@ Ptr<BRepBody> RingsProtoCreator::createArcBody(Ptr<Component> component, double
 
     if (sideCrossSideFilletRate > 0)
     {
-        auto cornerEdges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return Equal(edge->length(), thickness); });
+        auto cornerEdges = BodyTopology(body).getEdges([=](const BodyTopology& topology, int edge) {return Equal(topology.length[edge], thickness); });
         Fillet(component, cornerEdges, size * sideCrossSideFilletRate);
     }
 
     if (sideCrossSideFilletRate > 0)
     {
-        auto allEdges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return edge->tangentiallyConnectedEdges()->count() == 8; });
+        BodyTopology bodyTopology(body, BodyTopology::EdgeColumns | BodyTopology::TangentChainColumn);
+        auto allEdges = bodyTopology.getEdges([=](const BodyTopology& topology, int edge) {return topology.tangentChainSize[edge] == 8; });
         Fillet(component, allEdges, thickness * sideCrossFoolrFilletRate);
     }
 
@@ -310,21 +330,21 @@ Ptr<BRepBody> RingsProtoCreator::joinFloorToothToBase(Ptr<Component> component,
 
 double RingsProtoCreator::getVolfAngel()
 {
-	return RAD_360 / volfCount;
+	return layout.volfAngel;
 }
 
 double RingsProtoCreator::getVolfLegAngel()
 {
-	return getVolfAngel() * volfLegRate;
+	return layout.volfLegAngel;
 }
 
 double RingsProtoCreator::getBaseOuterLength()
 {
-	return getVolfAngel() * outerRadius + 2.0 * clearanceMovable + 2.0 * wallThickness;
+	return layout.baseOuterLength;
 }
 
 double RingsProtoCreator::getBaseInnerLength()
 {
-	return getVolfAngel() * innerRadius + 2.0 * clearanceMovable + 2.0 * wallThickness;
+	return layout.baseInnerLength;
 }
 
@@ -2,6 +2,8 @@
 
 #include <Core/CoreAll.h>
 #include <Fusion/FusionAll.h>
+#include "RingsProtoCreatorLayout.h"
+#include "BodyTopology.h"
 //#include <CAM/CAMAll.h>
 
 using namespace adsk::core;
@@ -43,10 +45,13 @@ private:
     double volfHeigntOverBaseInCenter = 0.3;
 
     BaseCuttingParams baseCuttingParams;
+    RingsProtoCreatorLayout layout;
 
     Ptr<ConstructionAxis> xy45Axis;
     Ptr<ConstructionAxis> xy135Axis;
     Ptr<ConstructionAxis> yz135Axis;
+    Ptr<BRepBody> createdBaseBody;
+    Ptr<BRepBody> createdVolfBody;
 
     void Initialize();
 	Ptr<Sketch> createSketchBase(Ptr<Component> component);
@@ -55,8 +60,8 @@ private:
     Ptr<Sketch> createSketchSquare(Ptr<Component> component, double size);
     static Ptr<BRepBody> createArcBody(Ptr<Component> component, double radius, double thickness, double size, double sideCrossSideFilletRate = 0, double sideCrossFoolrFilletRate = 0);
     Ptr<BRepBody> joinFloorToothToBase(Ptr<Component> component, Ptr<BRepBody> baseBody, double radius, double thickness, double size, double rotateAngel, bool inverse = false);
-	bool isBaseExternalCornerEdge(Ptr<BRepEdge> edge);
-	bool isBaseIntearnalCornerEdge(Ptr<BRepEdge> edge);
+	bool isBaseExternalCornerEdge(const BodyTopology& topology, int edge);
+	bool isBaseIntearnalCornerEdge(const BodyTopology& topology, int edge);
     /// O######   ######O
     /// #######   #######
     /// ###           ###
@@ -77,8 +82,11 @@ public:
     bool createBodies(Ptr<Component> component);
 	bool createBaseBody(Ptr<Component> component);
     bool createVolfBody(Ptr<Component> component);
+    // One 3MF build plate of the bodies createBodies made.
+    bool saveAs3mf(const std::string& filepath);
 	double getVolfAngel();
 	double getVolfLegAngel();
 	double getBaseOuterLength();
 	double getBaseInnerLength();
+    RingsProtoCreatorParams getParams();
 };
\ No newline at end of file
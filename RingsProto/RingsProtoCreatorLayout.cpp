@@ -0,0 +1,45 @@
+#include "RingsProtoCreatorLayout.h"
+
+void SolveRingsProtoCreatorLayout(const RingsProtoCreatorParams& params, RingsProtoCreatorLayout& layout)
+{
+    auto outerRadius = params.outerRadius;
+    auto innerRadius = params.innerRadius;
+    auto wallThickness = params.wallThickness;
+    auto clearanceMovable = params.clearanceMovable;
+    auto clearanceBetweenBaseWallAndVolfLeg = params.clearanceBetweenBaseWallAndVolfLeg;
+
+    layout.volfAngel = FULL_CIRCLE_RAD / params.volfCount;
+    layout.volfLegAngel = layout.volfAngel * params.volfLegRate;
+    layout.baseOuterLength = layout.volfAngel * outerRadius + 2.0 * clearanceMovable + 2.0 * wallThickness;
+    layout.baseInnerLength = layout.volfAngel * innerRadius + 2.0 * clearanceMovable + 2.0 * wallThickness;
+
+    layout.cuttingOuterRadius = outerRadius;
+    layout.cuttingOuterLength = layout.volfLegAngel * layout.cuttingOuterRadius + 2.0 * clearanceMovable;
+    layout.cuttingInnerRadius = innerRadius + params.floorBottomThickness;
+    layout.cuttingInnerLength = layout.volfAngel * layout.cuttingInnerRadius + 2.0 * clearanceBetweenBaseWallAndVolfLeg;
+    layout.cuttingMiddleRadius = outerRadius - params.floorTopThickness;
+    layout.cuttingMiidleLegLength = layout.volfLegAngel * layout.cuttingMiddleRadius + 2.0 * clearanceBetweenBaseWallAndVolfLeg;
+    layout.cuttingMiidleLength = (layout.volfAngel * layout.cuttingMiddleRadius - layout.cuttingMiidleLegLength + 2.0 * clearanceBetweenBaseWallAndVolfLeg) / 2.0;
+
+    auto baseFilletShift = params.baseInternalCornerFilletRadius * (sqrt(2.0) - 1.0);
+    auto volfLegOuterLength = layout.volfLegAngel * outerRadius;
+    layout.baseTopFloorToothRadius = outerRadius - params.floorTopThickness / 2.0;
+    layout.baseTopFloorToothSize = (layout.baseOuterLength - volfLegOuterLength) / 2.0 - wallThickness;
+    layout.baseTopFloorToothRotateAngel = ((((layout.baseOuterLength - volfLegOuterLength) / 2.0 + volfLegOuterLength) / 2.0 + clearanceBetweenBaseWallAndVolfLeg) * sqrt(2.0) + baseFilletShift) / outerRadius;
+
+    layout.baseBottomFloorToothRadius = innerRadius + params.floorBottomThickness / 2.0;
+    layout.baseBottomFloorToothSize = layout.baseInnerLength / 2.0 / innerRadius * layout.baseBottomFloorToothRadius;
+    layout.baseBottomFloorToothRotateAngel = (layout.baseInnerLength / 4.0 * sqrt(2.0) + baseFilletShift / 2.0) / innerRadius;
+
+    layout.volfTop = outerRadius + params.volfHeigntOverBaseInCenter;
+    layout.volfHeadSize = 2.0 * GetRightTriangleLeg(layout.volfTop, layout.volfAngel / 2.0);
+    layout.volfLegThickness = params.floorTopThickness + 2.0 * clearanceMovable;
+    layout.volfLegRadius = outerRadius - layout.volfLegThickness / 2.0 + clearanceMovable;
+}
+
+RingsProtoCreatorLayout SolveRingsProtoCreatorLayout(const RingsProtoCreatorParams& params)
+{
+    RingsProtoCreatorLayout layout;
+    SolveRingsProtoCreatorLayout(params, layout);
+    return layout;
+}
\ No newline at end of file
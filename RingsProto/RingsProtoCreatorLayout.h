@@ -0,0 +1,49 @@
+#pragma once
+#include "Geometry.h"
+
+struct RingsProtoCreatorParams
+{
+    double outerRadius = 0;
+    double innerRadius = 0;
+    int volfCount = 0;
+    double wallThickness = 0;
+    double floorTopThickness = 0;
+    double floorBottomThickness = 0;
+    double volfLegRate = 0;
+    double clearanceMovable = 0.04;
+    double clearanceUnmovable = 0.02;
+    double clearanceBetweenBaseWallAndVolfLeg = 0.03;
+    double baseInternalCornerFilletRadius = 0.5;
+    double volfHeigntOverBaseInCenter = 0.3;
+};
+
+struct RingsProtoCreatorLayout
+{
+    double volfAngel = 0;
+    double volfLegAngel = 0;
+    double baseOuterLength = 0;
+    double baseInnerLength = 0;
+
+    double cuttingOuterRadius = 0;
+    double cuttingOuterLength = 0;
+    double cuttingInnerRadius = 0;
+    double cuttingInnerLength = 0;
+    double cuttingMiddleRadius = 0;
+    double cuttingMiidleLength = 0;
+    double cuttingMiidleLegLength = 0;
+
+    double baseTopFloorToothRadius = 0;
+    double baseTopFloorToothSize = 0;
+    double baseTopFloorToothRotateAngel = 0;
+    double baseBottomFloorToothRadius = 0;
+    double baseBottomFloorToothSize = 0;
+    double baseBottomFloorToothRotateAngel = 0;
+
+    double volfTop = 0;
+    double volfHeadSize = 0;
+    double volfLegThickness = 0;
+    double volfLegRadius = 0;
+};
+
+void SolveRingsProtoCreatorLayout(const RingsProtoCreatorParams& params, RingsProtoCreatorLayout& layout);
+RingsProtoCreatorLayout SolveRingsProtoCreatorLayout(const RingsProtoCreatorParams& params);
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "RingsPuzzle.h"
+#include <algorithm>
+
+namespace
+{
+    // the bits of value at the set bits of mask, packed to the low bits
+    uint64_t CompressBits(uint64_t value, uint64_t mask)
+    {
+        uint64_t result = 0;
+        for (int bit = 0; mask != 0; mask &= mask - 1, bit++)
+            if (value & mask & (~mask + 1))
+                result |= 1ull << bit;
+        return result;
+    }
+
+    // the low bits of value spread to the set bits of mask
+    uint64_t ExpandBits(uint64_t value, uint64_t mask)
+    {
+        uint64_t result = 0;
+        for (int bit = 0; mask != 0; mask &= mask - 1, bit++)
+            if (value & (1ull << bit))
+                result |= mask & (~mask + 1);
+        return result;
+    }
+}
+
+RingsPuzzle::RingsPuzzle(const std::vector<PlainPoint3D>& leftPlaces, const std::vector<PlainPoint3D>& rightPlaces)
+{
+    if (leftPlaces.size() < 2 || rightPlaces.size() < 2)
+        return;
+
+    for (size_t i = 0; i < leftPlaces.size(); i++)
+        leftRing.push_back((int)i);
+    placeCount = (int)leftPlaces.size();
+    for (auto& place : rightPlaces)
+    {
+        auto shared = -1;
+        for (size_t i = 0; i < leftPlaces.size(); i++)
+            if (fabs(place.x - leftPlaces[i].x) < 1e-6 && fabs(place.y - leftPlaces[i].y) < 1e-6)
+                shared = (int)i;
+        rightRing.push_back(shared >= 0 ? shared : placeCount++);
+    }
+    if (!isValid())
+        return;
+
+    solvedColors.assign(placeCount, 1);
+    for (auto place : leftRing)
+        solvedColors[place] = 0;
+    for (auto place : rightRing)
+        if (place < (int)leftRing.size())
+            solvedColors[place] = 2;
+
+    // a forward turn moves every volf to the next place of the ring
+    for (int move = 0; move < MoveCount; move++)
+    {
+        auto& ring = move < RightForward ? leftRing : rightRing;
+        auto step = move % 2 == 0 ? -1 : 1;
+        auto count = (int)ring.size();
+        for (int i = 0; i < count; i++)
+            moveSources[move].push_back(ring[(i + step + count) % count]);
+    }
+}
+
+RingsPuzzle CreateRings2D2SquaresPuzzle(const Rings2D2SquaresParams& params)
+{
+    auto layout = SolveRings2D2SquaresLayout(params);
+    return RingsPuzzle(GetSquaresVolfPlaces(params, layout, layout.leftCenterPoint), GetSquaresVolfPlaces(params, layout, layout.rightCenterPoint));
+}
+
+RingsPuzzle CreateRings2D2CirclesPuzzle(const Rings2D2CirclesParams& params)
+{
+    auto layout = SolveRings2D2CirclesLayout(params);
+    return RingsPuzzle(GetCirclesVolfPlaces(params, layout, false), GetCirclesVolfPlaces(params, layout, true));
+}
+
+template <int WordCount>
+RingsStateIndex<WordCount>::RingsStateIndex(const RingsPuzzle& puzzle)
+{
+    placeCount = puzzle.getPlaceCount();
+    for (int n = 0; n <= 64; n++)
+        for (int k = 0; k <= 64; k++)
+            binomials[n][k] = k == 0 ? 1 : n == 0 ? 0 : binomials[n - 1][k - 1] + (k <= n - 1 ? binomials[n - 1][k] : 0);
+
+    for (auto& count : colorCounts)
+        count = 0;
+    for (auto color : puzzle.getSolvedColors())
+        colorCounts[color]++;
+
+    auto firstCount = getBinomial(placeCount, colorCounts[0]);
+    auto secondCount = getBinomial(placeCount - colorCounts[0], colorCounts[1]);
+    stateCount = firstCount != 0 && secondCount > UINT64_MAX / firstCount ? 0 : firstCount * secondCount;
+}
+
+// colexicographic: the i-th place p from the lowest adds binomial(p, i)
+template <int WordCount>
+uint64_t RingsStateIndex<WordCount>::rankPlaces(uint64_t mask) const
+{
+    uint64_t result = 0;
+    for (int i = 1, place = 0; mask != 0; mask >>= 1, place++)
+        if (mask & 1)
+            result += binomials[place][i++];
+    return result;
+}
+
+template <int WordCount>
+uint64_t RingsStateIndex<WordCount>::unrankPlaces(uint64_t index, int count, int placeCount) const
+{
+    uint64_t mask = 0;
+    auto place = placeCount - 1;
+    for (int i = count; i > 0; i--)
+    {
+        while (binomials[place][i] > index)
+            place--;
+        index -= binomials[place][i];
+        mask |= 1ull << place;
+        place--;
+    }
+    return mask;
+}
+
+template <int WordCount>
+uint64_t RingsStateIndex<WordCount>::rank(const State& state) const
+{
+    auto allMask = placeCount >= 64 ? ~0ull : (1ull << placeCount) - 1;
+    auto firstMask = state.getMask(0, placeCount);
+    auto secondMask = CompressBits(state.getMask(1, placeCount), allMask & ~firstMask);
+    return rankPlaces(firstMask) * getBinomial(placeCount - colorCounts[0], colorCounts[1]) + rankPlaces(secondMask);
+}
+
+template <int WordCount>
+typename RingsStateIndex<WordCount>::State RingsStateIndex<WordCount>::unrank(uint64_t index) const
+{
+    auto secondCount = getBinomial(placeCount - colorCounts[0], colorCounts[1]);
+    auto allMask = placeCount >= 64 ? ~0ull : (1ull << placeCount) - 1;
+    auto firstMask = unrankPlaces(index / secondCount, colorCounts[0], placeCount);
+    auto secondMask = ExpandBits(unrankPlaces(index % secondCount, colorCounts[1], placeCount - colorCounts[0]), allMask & ~firstMask);
+
+    State state;
+    for (int place = 0; place < placeCount; place++)
+        state.set(place, (firstMask >> place) & 1 ? 0 : (secondMask >> place) & 1 ? 1 : 2);
+    return state;
+}
+
+template <int WordCount>
+RingsPuzzleSolver<WordCount>::RingsPuzzleSolver(const RingsPuzzle& puzzle, uint64_t maxTableSize) : puzzle(puzzle), index(puzzle)
+{
+    placeCount = puzzle.getPlaceCount();
+    solvedState = GetSolvedState<WordCount>(puzzle);
+
+    for (int color = 0; color < RingsPuzzle::ColorCount; color++)
+    {
+        auto solvedMask = solvedState.getMask(color, placeCount);
+        auto count = 0;
+        for (auto mask = solvedMask; mask != 0; mask &= mask - 1)
+            count++;
+        if (count == 0 || index.getBinomial(placeCount, count) > maxTableSize)
+            continue;
+        tables.push_back({ color, std::vector<uint8_t>(index.getBinomial(placeCount, count), 255) });
+        fillTable(tables.back(), solvedMask);
+    }
+}
+
+template <int WordCount>
+uint64_t RingsPuzzleSolver<WordCount>::applyMove(uint64_t mask, int move) const
+{
+    auto& ring = puzzle.getRing(move >= RingsPuzzle::RightForward);
+    auto& sources = puzzle.getMoveSources(move);
+    auto result = mask;
+    for (size_t i = 0; i < ring.size(); i++)
+        result = (result & ~(1ull << ring[i])) | (((mask >> sources[i]) & 1) << ring[i]);
+    return result;
+}
+
+template <int WordCount>
+void RingsPuzzleSolver<WordCount>::fillTable(Table& table, uint64_t solvedMask)
+{
+    std::vector<uint64_t> layer = { solvedMask };
+    table.distances[index.rankPlaces(solvedMask)] = 0;
+    for (int distance = 1; !layer.empty() && distance < 255; distance++)
+    {
+        std::vector<uint64_t> nextLayer;
+        for (auto mask : layer)
+            for (int move = 0; move < RingsPuzzle::MoveCount; move++)
+            {
+                auto nextMask = applyMove(mask, move);
+                auto& entry = table.distances[index.rankPlaces(nextMask)];
+                if (entry != 255)
+                    continue;
+                entry = (uint8_t)distance;
+                nextLayer.push_back(nextMask);
+            }
+        layer.swap(nextLayer);
+    }
+}
+
+template <int WordCount>
+int RingsPuzzleSolver<WordCount>::getHeuristic(const State& state) const
+{
+    auto result = 0;
+    for (auto& table : tables)
+        result = std::max(result, (int)table.distances[index.rankPlaces(state.getMask(table.color, placeCount))]);
+    return result;
+}
+
+template <int WordCount>
+uint64_t RingsPuzzleSolver<WordCount>::getTableSize() const
+{
+    uint64_t size = 0;
+    for (auto& table : tables)
+        size += table.distances.size();
+    return size;
+}
+
+template <int WordCount>
+bool RingsPuzzleSolver<WordCount>::solve(const State& state, std::vector<int>& solution, int maxLength)
+{
+    solution.clear();
+    auto bound = getHeuristic(state);
+    while (bound <= maxLength)
+    {
+        auto nextBound = maxLength + 1;
+        if (search(state, 0, bound, -1, 0, solution, nextBound))
+            return true;
+        bound = nextBound;
+    }
+    return false;
+}
+
+template <int WordCount>
+bool RingsPuzzleSolver<WordCount>::search(const State& state, int length, int bound, int lastMove, int run, std::vector<int>& path, int& nextBound)
+{
+    nodeCount++;
+    auto estimate = length + getHeuristic(state);
+    if (estimate > bound)
+    {
+        nextBound = std::min(nextBound, estimate);
+        return false;
+    }
+    if (state == solvedState)
+        return true;
+
+    for (int move = 0; move < RingsPuzzle::MoveCount; move++)
+    {
+        // no turning back, and no turn by more than half the ring one way that is shorter
+        // the other way: forward up to half the ring, backward less
+        if (lastMove >= 0 && move == (lastMove ^ 1))
+            continue;
+        auto ringLength = (int)puzzle.getRing(move >= RingsPuzzle::RightForward).size();
+        auto nextRun = move == lastMove ? run + 1 : 1;
+        if (nextRun > (move % 2 == 0 ? ringLength / 2 : (ringLength - 1) / 2))
+            continue;
+
+        auto next = applyMove(state, move);
+        path.push_back(move);
+        if (search(next, length + 1, bound, move, nextRun, path, nextBound))
+            return true;
+        path.pop_back();
+    }
+    return false;
+}
+
+template class RingsStateIndex<1>;
+template class RingsStateIndex<2>;
+template class RingsPuzzleSolver<1>;
+template class RingsPuzzleSolver<2>;
\ No newline at end of file
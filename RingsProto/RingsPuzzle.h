@@ -0,0 +1,176 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Rings2D2SquaresLayout.h"
+#include "Rings2D2CirclesLayout.h"
+
+// A printed two rings puzzle as a permutation puzzle. The places are the left ring ones in
+// turn order, then the right ring ones the left ring does not share. The shared places are
+// found by position, so the volf counts of a design decide the crossings. A move turns one
+// ring by one place, move ^ 1 turns it back.
+class RingsPuzzle
+{
+public:
+    enum Moves { LeftForward, LeftBackward, RightForward, RightBackward, MoveCount };
+    static const int MaxPlaceCount = 64;
+    static const int ColorCount = 3;
+
+    RingsPuzzle(const std::vector<PlainPoint3D>& leftPlaces, const std::vector<PlainPoint3D>& rightPlaces);
+
+    bool isValid() const { return placeCount > 0 && placeCount <= MaxPlaceCount; }
+    int getPlaceCount() const { return placeCount; }
+    int getSharedCount() const { return (int)(leftRing.size() + rightRing.size()) - placeCount; }
+    // the places of a ring in turn order
+    const std::vector<int>& getRing(bool isRight) const { return isRight ? rightRing : leftRing; }
+    // the place every place of the ring gets its volf from
+    const std::vector<int>& getMoveSources(int move) const { return moveSources[move]; }
+    // 0 on the left ring only, 1 on the right one only, 2 shared
+    const std::vector<uint8_t>& getSolvedColors() const { return solvedColors; }
+
+private:
+    int placeCount = 0;
+    std::vector<int> leftRing;
+    std::vector<int> rightRing;
+    std::vector<int> moveSources[MoveCount];
+    std::vector<uint8_t> solvedColors;
+};
+
+// forward turns the squares clockwise
+RingsPuzzle CreateRings2D2SquaresPuzzle(const Rings2D2SquaresParams& params);
+// forward turns the circles counterclockwise
+RingsPuzzle CreateRings2D2CirclesPuzzle(const Rings2D2CirclesParams& params);
+
+// The colors of all places, 2 bits a place: one word holds 32 places, two hold 64.
+template <int WordCount>
+struct PackedPuzzleState
+{
+    uint64_t words[WordCount] = {};
+
+    int get(int place) const
+    {
+        return (int)(words[place >> 5] >> ((place & 31) * 2)) & 3;
+    }
+
+    void set(int place, int color)
+    {
+        auto shift = (place & 31) * 2;
+        auto& word = words[place >> 5];
+        word = (word & ~(3ull << shift)) | ((uint64_t)color << shift);
+    }
+
+    // a bit for every place of color, the places past placeCount are 0
+    uint64_t getMask(int color, int placeCount) const
+    {
+        uint64_t mask = 0;
+        for (int i = 0; i < WordCount; i++)
+        {
+            auto same = ~(words[i] ^ (0x5555555555555555ull * color));
+            auto bits = same & (same >> 1) & 0x5555555555555555ull;
+            bits = (bits | (bits >> 1)) & 0x3333333333333333ull;
+            bits = (bits | (bits >> 2)) & 0x0f0f0f0f0f0f0f0full;
+            bits = (bits | (bits >> 4)) & 0x00ff00ff00ff00ffull;
+            bits = (bits | (bits >> 8)) & 0x0000ffff0000ffffull;
+            bits = (bits | (bits >> 16)) & 0x00000000ffffffffull;
+            mask |= bits << (32 * i);
+        }
+        return placeCount >= 64 ? mask : mask & ((1ull << placeCount) - 1);
+    }
+
+    bool operator==(const PackedPuzzleState& other) const
+    {
+        for (int i = 0; i < WordCount; i++)
+            if (words[i] != other.words[i])
+                return false;
+        return true;
+    }
+};
+
+template <int WordCount>
+PackedPuzzleState<WordCount> GetSolvedState(const RingsPuzzle& puzzle)
+{
+    PackedPuzzleState<WordCount> state;
+    auto& colors = puzzle.getSolvedColors();
+    for (int place = 0; place < puzzle.getPlaceCount(); place++)
+        state.set(place, colors[place]);
+    return state;
+}
+
+template <int WordCount>
+PackedPuzzleState<WordCount> ApplyMove(const RingsPuzzle& puzzle, const PackedPuzzleState<WordCount>& state, int move)
+{
+    auto result = state;
+    auto& ring = puzzle.getRing(move >= RingsPuzzle::RightForward);
+    auto& sources = puzzle.getMoveSources(move);
+    for (size_t i = 0; i < ring.size(); i++)
+        result.set(ring[i], state.get(sources[i]));
+    return result;
+}
+
+// Numbers the states with the solved color counts densely, from 0 to getStateCount() - 1:
+// the places of color 0 among all places, then the places of color 1 among the rest, each
+// ranked colexicographically. getStateCount() is 0 when the count does not fit 64 bits.
+template <int WordCount>
+class RingsStateIndex
+{
+public:
+    typedef PackedPuzzleState<WordCount> State;
+
+    explicit RingsStateIndex(const RingsPuzzle& puzzle);
+
+    uint64_t getStateCount() const { return stateCount; }
+    uint64_t rank(const State& state) const;
+    State unrank(uint64_t index) const;
+
+    uint64_t getBinomial(int n, int k) const { return k < 0 || k > n ? 0 : binomials[n][k]; }
+    // the index of a set of places among all sets of as many places
+    uint64_t rankPlaces(uint64_t mask) const;
+    uint64_t unrankPlaces(uint64_t index, int count, int placeCount) const;
+
+private:
+    int placeCount;
+    int colorCounts[RingsPuzzle::ColorCount];
+    uint64_t stateCount;
+    uint64_t binomials[65][65];
+};
+
+// Optimal solutions by IDA*. The heuristic is the largest of the pattern databases of the
+// colors. A table holds the fewest moves that bring only the volfs of its color home, for
+// every set of places they can take, and is filled by a breadth-first search from the solved
+// places. A color with more than maxTableSize place sets gets no table.
+template <int WordCount>
+class RingsPuzzleSolver
+{
+public:
+    typedef PackedPuzzleState<WordCount> State;
+
+    RingsPuzzleSolver(const RingsPuzzle& puzzle, uint64_t maxTableSize = 1ull << 24);
+
+    State getSolvedState() const { return solvedState; }
+    State applyMove(const State& state, int move) const { return ApplyMove(puzzle, state, move); }
+    int getHeuristic(const State& state) const;
+    // total entries of the pattern databases
+    uint64_t getTableSize() const;
+
+    // the moves from state to the solved one, false when it needs more than maxLength
+    bool solve(const State& state, std::vector<int>& solution, int maxLength = 64);
+    // nodes of all solves so far
+    uint64_t getNodeCount() const { return nodeCount; }
+
+private:
+    struct Table
+    {
+        int color;
+        std::vector<uint8_t> distances;
+    };
+
+    const RingsPuzzle& puzzle;
+    RingsStateIndex<WordCount> index;
+    int placeCount;
+    State solvedState;
+    std::vector<Table> tables;
+    uint64_t nodeCount = 0;
+
+    uint64_t applyMove(uint64_t mask, int move) const;
+    void fillTable(Table& table, uint64_t solvedMask);
+    bool search(const State& state, int length, int bound, int lastMove, int run, std::vector<int>& path, int& nextBound);
+};
\ No newline at end of file
@@ -1,7 +1,17 @@
 #include "RoofPart.h"
+#include "Instrumentation.h"
+
+void RoofPart::setLayout(const RoofPartLayout& layout)
+{
+    BasePart::setLayout(layout);
+    separationInnerWidth = layout.separationInnerWidth;
+    separationOuterWidth = layout.separationOuterWidth;
+    downTrimmingThicknes = layout.downTrimmingThicknes;
+}
 
 Ptr<ObjectCollection> RoofPart::createBodies(Ptr<Component> component)
 {
+    INSTRUMENT_PART("RoofPart");
     auto cornerOuterRadius = cornerMiddleRadius + outerWidth;
     auto width = outerWidth + innerWidth;
     auto separationCornerOuterRadius = cornerMiddleRadius + separationOuterWidth;
@@ -51,34 +61,25 @@ Ptr<ObjectCollection> RoofPart::createBodies(Ptr<Component> component)
 
     return result;
 }
-bool RoofPart::edgeOnInnerCorner(Ptr<BRepEdge> edge)
+bool RoofPart::edgeOnInnerCorner(const BodyTopology& topology, int edge)
 {
-    auto body = edge->body();
-    auto point = edge->endVertex()->geometry();
-    auto upPoint = Point3D::create(point->x(), point->y(), point->z() + floorThickness / 2.0);
-    auto downPoint = Point3D::create(point->x(), point->y(), point->z() - (height - floorThickness) / 2.0);
-    return EdgeIsHorizontal(edge) && Equal(point->z(), height - floorThickness, 0.01) && BodyContainPoint(body, upPoint) && BodyContainPoint(body, downPoint);
+    auto x = topology.endX[edge];
+    auto y = topology.endY[edge];
+    auto z = topology.endZ[edge];
+    if (!IsHorizontalEdge(topology, edge) || !Equal(z, height - floorThickness, 0.01))
+        return false;
+    auto upPoint = Point3D::create(x, y, z + floorThickness / 2.0);
+    auto downPoint = Point3D::create(x, y, z - (height - floorThickness) / 2.0);
+    return BodyContainPoint(topology.getBody(), upPoint) && BodyContainPoint(topology.getBody(), downPoint);
 }
 
 void RoofPart::filletBody(Ptr<Component> component, Ptr<BRepBody> body)
 {
-    auto edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsVerticalLine(edge) && abs(edge->endVertex()->geometry()->x()) <= 0.01 && abs(edge->endVertex()->geometry()->y()) < innerWidth + outerWidth; });
-    auto minY = GetMin(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()); });
-    edges = GetEdges(edges, [=](Ptr<BRepEdge> edge) {return abs(edge->endVertex()->geometry()->y()) < minY + 0.01; });
-    Fillet(component, edges, verticalEdgeFilletRadius / 2.0);
-
-    edges = GetEdges(body, EdgeIsVerticalLine);
-    Fillet(component, edges, verticalEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return edgeOnInnerCorner(edge); });
-    Fillet(component, edges, otherEdgeFilletRadius);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && Equal(edge->length(), GetCircleLength(circlesOnSquareRadius), 0.1); });
-    Fillet(component, edges, floorThickness / 3.0);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && edge->endVertex()->geometry()->z() > floorThickness * 1.1; });
-    Fillet(component, edges, topEdgeFilletRadius);
-
-    edges = GetEdges(body, EdgeIsHorizontal);
-    Fillet(component, edges, otherEdgeFilletRadius);
+    FilletPlanner planner;
+    addVerticalFilletRules(planner);
+    planner.add([=](const BodyTopology& topology, int edge) {return edgeOnInnerCorner(topology, edge); }, otherEdgeFilletRadius);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && Equal(topology.length[edge], GetCircleLength(circlesOnSquareRadius), 0.1); }, floorThickness / 3.0);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && topology.endZ[edge] > floorThickness * 1.1; }, topEdgeFilletRadius);
+    planner.add(IsHorizontalEdge, otherEdgeFilletRadius);
+    planner.fillet(component, body);
 }
\ No newline at end of file
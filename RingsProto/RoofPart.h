@@ -7,9 +7,10 @@ public:
     double separationInnerWidth;
     double separationOuterWidth;
     double downTrimmingThicknes;
+    void setLayout(const RoofPartLayout& layout);
     Ptr<ObjectCollection> createBodies(Ptr<Component> component);
 protected:
-    bool edgeOnInnerCorner(Ptr<BRepEdge> edge);
+    bool edgeOnInnerCorner(const BodyTopology& topology, int edge);
     void filletBody(Ptr<Component> component, Ptr<BRepBody> body);
     Ptr<BRepBody> createBody(Ptr<Component> component);
     
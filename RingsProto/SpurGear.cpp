@@ -100,7 +100,13 @@
 #include <Fusion/Features/SweepFeatures.h>
 #include <Fusion/Features/SweepFeatureInput.h>
 #include <Fusion/Features/SweepFeature.h>
+#include <Fusion/Graphics/CustomGraphicsGroups.h>
+#include <Fusion/Graphics/CustomGraphicsGroup.h>
+#include <Fusion/Graphics/CustomGraphicsCoordinates.h>
+#include <Fusion/Graphics/CustomGraphicsMesh.h>
 #include "FusionEnvironment.h"
+#include "GearMesh.h"
+#include "GearProfile.h"
 #include "SpurGear.hpp"
 
 #include <sstream>
@@ -241,6 +247,89 @@ public:
     }
 } _gearCommandExecute;
 
+// Reads the inputs as they are while being edited, false when one does not evaluate.
+bool getGearMeshParams(GearMeshParams& params)
+{
+    double value;
+    if (_standard->selectedItem()->name() == "English")
+    {
+        if (!getCommandInputValue(_diaPitch, "", &value))
+            return false;
+        params.gear.diametralPitch = value;
+    }
+    else if (_standard->selectedItem()->name() == "Metric")
+    {
+        if (!getCommandInputValue(_module, "", &value) || value <= 0)
+            return false;
+        params.gear.diametralPitch = 25.4 / value;
+    }
+
+    if (_numTeeth->value().empty() || _numTeeth->value().size() > 6 || !is_digits(_numTeeth->value()))
+        return false;
+    params.gear.toothCount = std::stoi(_numTeeth->value());
+
+    if (_pressureAngle->selectedItem()->name() == "Custom")
+        params.gear.pressureAngle = _pressureAngleCustom->value();
+    else if (_pressureAngle->selectedItem()->name() == "14.5 deg")
+        params.gear.pressureAngle = 14.5 * (M_PI / 180.0);
+    else if (_pressureAngle->selectedItem()->name() == "20 deg")
+        params.gear.pressureAngle = 20.0 * (M_PI / 180.0);
+    else if (_pressureAngle->selectedItem()->name() == "25 deg")
+        params.gear.pressureAngle = 25.0 * (M_PI / 180.0);
+
+    if (!getCommandInputValue(_backlash, _units, &params.gear.backlash) ||
+        !getCommandInputValue(_thickness, _units, &params.thickness) ||
+        !getCommandInputValue(_holeDiam, _units, &params.holeDiameter))
+        return false;
+    return params.gear.toothCount >= 4 && params.gear.diametralPitch > 0 && params.thickness > 0;
+}
+
+// Event handler for the executePreview event. The gear is shown as custom graphics meshed
+// from the tooth profile in memory, the features are only built by execute on OK.
+class GearCommandExecutePreviewEventHandler : public adsk::core::CommandEventHandler
+{
+public:
+    void notify(const Ptr<CommandEventArgs>& eventArgs) override
+    {
+        // the graphics are not the result, execute still runs on OK
+        eventArgs->isValidResult(false);
+
+        GearMeshParams params;
+        if (!getGearMeshParams(params))
+            return;
+        // a hundredth of the module, finer than the screen shows at any gear size
+        params.chordTolerance = 2.54 / params.gear.diametralPitch / 100.0;
+        auto mesh = CreateGearMesh(params);
+        if (mesh.isEmpty())
+            return;
+
+        Ptr<Design> des = _app->activeProduct();
+        if (!des)
+            return;
+        Ptr<CustomGraphicsGroup> group = des->rootComponent()->customGraphicsGroups()->add();
+        if (!group)
+            return;
+
+        std::vector<double> coordinates;
+        coordinates.reserve(3 * mesh.vertices.size());
+        for (auto& vertex : mesh.vertices)
+        {
+            coordinates.push_back(vertex.x);
+            coordinates.push_back(vertex.y);
+            coordinates.push_back(vertex.z);
+        }
+        std::vector<int> indexes;
+        indexes.reserve(3 * mesh.triangles.size());
+        for (auto& triangle : mesh.triangles)
+        {
+            indexes.push_back((int)triangle.a);
+            indexes.push_back((int)triangle.b);
+            indexes.push_back((int)triangle.c);
+        }
+        group->addMesh(CustomGraphicsCoordinates::create(coordinates), indexes, std::vector<double>(), std::vector<int>());
+    }
+} _gearCommandExecutePreview;
+
 class GearCommandInputChangedHandler : public adsk::core::InputChangedEventHandler
 {
 public:
@@ -712,6 +801,13 @@ public:
         if (!isOk)
             return;
 
+        Ptr<CommandEvent> executePreviewEvent = cmd->executePreview();
+        if (!executePreviewEvent)
+            return;
+        isOk = executePreviewEvent->add(&_gearCommandExecutePreview);
+        if (!isOk)
+            return;
+
         Ptr<CommandEvent> executeEvent = cmd->execute();
         if (!executeEvent)
             return;
@@ -806,27 +902,6 @@ bool getCommandInputValue(Ptr<CommandInput> commandInput, std::string unitType,
     }
 }
 
-// Calculate points along an involute curve.
-Ptr<Point3D> involutePoint(double baseCircleRadius, double distFromCenterToInvolutePoint)
-{
-    // Calculate the other side of the right-angle triangle defined by the base circle and the current distance radius.
-    // This is also the length of the involute chord as it comes off of the base circle.
-    double triangleSide = sqrt(pow(distFromCenterToInvolutePoint, 2.0) - pow(baseCircleRadius, 2.0));
-
-    // Calculate the angle of the involute.
-    double alpha = triangleSide / baseCircleRadius;
-
-    // Calculate the angle where the current involute point is.
-    double theta = alpha - acos(baseCircleRadius / distFromCenterToInvolutePoint);
-
-    // Calculate the coordinates of the involute point.
-    double x = distFromCenterToInvolutePoint * cos(theta);
-    double y = distFromCenterToInvolutePoint * sin(theta);
-
-    // Create a point to return.
-    return (adsk::core::Point3D::create(x, y, 0));
-}
-
 // Builds a spur gear.
 Ptr<Component> drawGear(
     Ptr<Design> design,
@@ -847,37 +922,20 @@ Ptr<Component> drawGear(
     _ui = _app->userInterface();
     if (!_ui)
         return false;
-    // The diametral pitch is specified in inches but everthing
-    // here expects all distances to be in centimeters, so convert
-    // for the gear creation.
-    diametralPitch = diametralPitch / 2.54;
-
-    // Compute the various values for a gear.
-    double pitchDia = (double)numTeeth / diametralPitch;
-
-    // addendum = 1.0 / diametralPitch
-    double dedendum;
-    if (diametralPitch < (20 * (M_PI / 180.0)) - 0.000001)
-    {
-        dedendum = 1.557 / diametralPitch;
-    }
-    else
-    {
-        double circularPitch = M_PI / diametralPitch;
-        if (circularPitch >= 20.0)
-        {
-            dedendum = 1.65 / diametralPitch;
-        }
-        else
-        {
-            dedendum = (1.70 / diametralPitch) + (.002 * 2.54);
-        }
-    }
-
-    double rootDia = pitchDia - (2.0 * dedendum);
+    // The tooth profile and the circles of the gear, in centimeters like everything here.
+    GearParams gearParams;
+    gearParams.diametralPitch = diametralPitch;
+    gearParams.toothCount = numTeeth;
+    gearParams.pressureAngle = pressureAngle;
+    gearParams.backlash = backlash;
+    auto profile = GetGearToothProfile(gearParams, 0.0001);
+    auto flankCount = (int)profile.flankXs.size();
+    if (flankCount == 0)
+        return nullptr;
 
-    double baseCircleDia = pitchDia * cos(pressureAngle);
-    double outsideDia = (double)(numTeeth + 2) / diametralPitch;
+    double pitchDia = 2.0 * profile.dimensions.pitchRadius;
+    double rootDia = 2.0 * profile.dimensions.rootRadius;
+    double outsideDia = 2.0 * profile.dimensions.outsideRadius;
 
     // Create a new component by creating an occurrence.
     Ptr<Occurrences> occs = design->rootComponent()->occurrences();
@@ -973,74 +1031,13 @@ Ptr<Component> drawGear(
     if (!checkReturn(toothSketch))
         return nullptr;
 
-    // Calculate points along the involute curve.
-    int involutePointCount = 15;
-    double involuteIntersectionRadius = baseCircleDia / 2.0;
-    Ptr<Point3D>* involutePoints = new Ptr<Point3D>[involutePointCount];
-    std::unique_ptr<Ptr<Point3D>[]> involutePointsDeleter(involutePoints);
-    double involuteSize = (outsideDia - baseCircleDia) / 2.0;
-    for (int i = 0; i < involutePointCount; ++i)
-    {
-        involuteIntersectionRadius = (baseCircleDia / 2.0) + ((involuteSize / (involutePointCount - 1)) * i);
-        Ptr<Point3D> newPoint = involutePoint(baseCircleDia / 2.0, involuteIntersectionRadius);
-        involutePoints[i] = newPoint;
-    }
-
-    // Get the point along the tooth that's at the pictch diameter and then
-    // calculate the angle to that point.
-    Ptr<Point3D> pitchInvolutePoint = involutePoint(baseCircleDia / 2.0, pitchDia / 2.0);
-    double pitchPointAngle = atan(pitchInvolutePoint->y() / pitchInvolutePoint->x());
-
-    // Determine the angle defined by the tooth thickness as measured at
-    // the pitch diameter circle.
-    double toothThicknessAngle = (2.0 * M_PI) / (2.0 * (double)numTeeth);
-
-    // Determine the angle needed for the specified backlash.
-    double backlashAngle = (backlash / (pitchDia / 2.0)) * 0.25;
-
-    // Determine the angle to rotate the curve.
-    double rotateAngle = -((toothThicknessAngle / 2.0) + pitchPointAngle - backlashAngle);
-
-    // Rotate the involute so the middle of the tooth lies on the x axis.
-    double cosAngle = cos(rotateAngle);
-    double sinAngle = sin(rotateAngle);
-    for (int i = 0; i < involutePointCount; ++i)
-    {
-        double newX = involutePoints[i]->x() * cosAngle - involutePoints[i]->y() * sinAngle;
-        double newY = involutePoints[i]->x() * sinAngle + involutePoints[i]->y() * cosAngle;
-        involutePoints[i] = adsk::core::Point3D::create(newX, newY, 0);
-    }
-
-    // Create a new set of points with a negated y.  This effectively mirrors the original
-    // points about the X axis.
-    Ptr<Point3D>* involute2Points = new Ptr<Point3D>[involutePointCount];
-    std::unique_ptr<Ptr<Point3D>[]> involute2PointsDeleter(involute2Points);
-    for (int i = 0; i < involutePointCount; ++i)
-    {
-        involute2Points[i] = adsk::core::Point3D::create(involutePoints[i]->x(), -involutePoints[i]->y(), 0);
-    }
-
-    double* curve1Angle = new double[involutePointCount];
-    std::unique_ptr<double[]> curve1AngleDeleter(curve1Angle);
-    for (int i = 0; i < involutePointCount; ++i)
-    {
-        curve1Angle[i] = atan(involutePoints[i]->y() / involutePoints[i]->x());
-    }
-
-    double* curve2Angle = new double[involutePointCount];
-    std::unique_ptr<double[]> curve2AngleDeleter(curve2Angle);
-    for (int i = 0; i < involutePointCount; ++i)
-    {
-        curve2Angle[i] = atan(involute2Points[i]->y() / involute2Points[i]->x());
-    }
-
     toothSketch->isComputeDeferred(true);
 
-    // Create and load an object collection with the points.
+    // Create and load an object collection with the points of the flank below the x axis.
     Ptr<ObjectCollection> pointSet = adsk::core::ObjectCollection::create();
-    for (int i = 0; i < involutePointCount; ++i)
+    for (int i = 0; i < flankCount; ++i)
     {
-        pointSet->add(involutePoints[i]);
+        pointSet->add(adsk::core::Point3D::create(profile.flankXs[i], profile.flankYs[i], 0));
     }
 
     // Create the first spline.
@@ -1048,11 +1045,11 @@ Ptr<Component> drawGear(
     if (!checkReturn(spline1))
         return nullptr;
 
-    // Add the involute points for the second spline to an ObjectCollection.
+    // Mirror the points about the X axis for the second spline.
     pointSet = adsk::core::ObjectCollection::create();
-    for (int i = 0; i < involutePointCount; ++i)
+    for (int i = 0; i < flankCount; ++i)
     {
-        pointSet->add(involute2Points[i]);
+        pointSet->add(adsk::core::Point3D::create(profile.flankXs[i], -profile.flankYs[i], 0));
     }
 
     // Create the second spline.
@@ -1060,16 +1057,19 @@ Ptr<Component> drawGear(
     if (!checkReturn(spline2))
         return nullptr;
 
-    // Draw the arc for the top of the tooth.
-    Ptr<Point3D> midPoint = adsk::core::Point3D::create((outsideDia / 2.0), 0, 0);
-    Ptr<SketchArc> topArc = toothSketch->sketchCurves()->sketchArcs()->addByThreePoints(
-        spline1->endSketchPoint(), midPoint, spline2->endSketchPoint());
-    if (!checkReturn(topArc))
-        return nullptr;
+    // Draw the arc for the top of the tooth, a pointed tooth has its flanks meet instead.
+    if (!profile.isPointed())
+    {
+        Ptr<Point3D> midPoint = adsk::core::Point3D::create((outsideDia / 2.0), 0, 0);
+        Ptr<SketchArc> topArc = toothSketch->sketchCurves()->sketchArcs()->addByThreePoints(
+            spline1->endSketchPoint(), midPoint, spline2->endSketchPoint());
+        if (!checkReturn(topArc))
+            return nullptr;
+    }
 
     // Check to see if involute goes down to the root or not.  If not, then
     // create lines to connect the involute to the root.
-    if (baseCircleDia < rootDia)
+    if (!profile.hasRootLine)
     {
         Ptr<SketchLine> bottomLine = toothSketch->sketchCurves()->sketchLines()->addByTwoPoints(
             spline2->startSketchPoint(), spline1->startSketchPoint());
@@ -1078,15 +1078,16 @@ Ptr<Component> drawGear(
     }
     else
     {
+        double rootAngle = atan(profile.rootY / profile.rootX);
         Ptr<Point3D> rootPoint1 = adsk::core::Point3D::create(
-            (rootDia / 2 - 0.001) * cos(curve1Angle[0]), (rootDia / 2) * sin(curve1Angle[0]), 0);
+            (rootDia / 2 - 0.001) * cos(rootAngle), (rootDia / 2) * sin(rootAngle), 0);
         Ptr<SketchLine> line1 =
             toothSketch->sketchCurves()->sketchLines()->addByTwoPoints(rootPoint1, spline1->startSketchPoint());
         if (!checkReturn(line1))
             return nullptr;
 
         Ptr<Point3D> rootPoint2 = adsk::core::Point3D::create(
-            (rootDia / 2 - 0.001) * cos(curve2Angle[0]), (rootDia / 2) * sin(curve2Angle[0]), 0);
+            (rootDia / 2 - 0.001) * cos(-rootAngle), (rootDia / 2) * sin(-rootAngle), 0);
         Ptr<SketchLine> line2 =
             toothSketch->sketchCurves()->sketchLines()->addByTwoPoints(rootPoint2, spline2->startSketchPoint());
         if (!checkReturn(line2))
@@ -1273,7 +1274,7 @@ Ptr<Component> drawGear(
     gearValues += "'holeDiam': '" + std::to_string(holeDiam) + "',";
     gearValues += "'thickness': '" + std::to_string(thickness) + "',";
     gearValues += "'rootFilletRad': '" + std::to_string(rootFilletRad) + "',";
-    gearValues += "'diametralPitch': '" + std::to_string(diametralPitch * 2.54) + "'}";
+    gearValues += "'diametralPitch': '" + std::to_string(diametralPitch) + "'}";
     Ptr<Attribute> attrib = newComp->attributes()->add("SpurGear", "Values", gearValues);
     if (!checkReturn(attrib))
         return nullptr;
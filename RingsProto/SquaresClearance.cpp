@@ -0,0 +1,264 @@
+#include "SquaresClearance.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    const double SQRT_HALF = sqrt(0.5);
+
+    // The middle path of one square in its own frame: centered at 0 and not turned by 45
+    // degrees. A quarter is the top line from left to right and the corner after it, the
+    // next quarters are turned clockwise, as the volfs go.
+    class SquarePath
+    {
+    public:
+        SquarePath(double lineLength, double cornerRadius) : halfLine(lineLength / 2.0), radius(cornerRadius), quarterLength(lineLength + cornerRadius * RAD_90) {}
+
+        double length() const { return 4.0 * quarterLength; }
+
+        void point(double s, double& x, double& y) const
+        {
+            s = fmod(s, length());
+            auto quarter = std::min(3, (int)(s / quarterLength));
+            auto t = s - quarter * quarterLength;
+            if (t < 2.0 * halfLine)
+            {
+                x = -halfLine + t;
+                y = halfLine + radius;
+            }
+            else
+            {
+                auto angle = (t - 2.0 * halfLine) / radius;
+                x = halfLine + radius * sin(angle);
+                y = halfLine + radius * cos(angle);
+            }
+            for (int i = 0; i < quarter; i++)
+                TurnClockwise(x, y);
+        }
+
+        // the first position after s whose point is distance away from x, y,
+        // -1 when there is none within one lap
+        double next(double s, double x, double y, double distance) const
+        {
+            auto firstQuarter = (int)floor(s / quarterLength);
+            for (int quarter = firstQuarter; quarter <= firstQuarter + 4; quarter++)
+            {
+                // the point in the frame of the quarter, where it is the first one
+                auto localX = x;
+                auto localY = y;
+                for (int i = 0; i < quarter % 4; i++)
+                    TurnCounterclockwise(localX, localY);
+
+                auto start = quarter * quarterLength;
+                auto result = -1.0;
+                auto take = [&](double candidate)
+                {
+                    if (candidate > s + 1e-12 && candidate <= s + length() && (result < 0 || candidate < result))
+                        result = candidate;
+                };
+
+                // line: |(-halfLine + u, halfLine + radius) - point| = distance
+                auto wx = -halfLine - localX;
+                auto wy = halfLine + radius - localY;
+                auto discriminant = wx * wx - (wx * wx + wy * wy - distance * distance);
+                if (discriminant >= 0)
+                    for (auto u : { -wx - sqrt(discriminant), -wx + sqrt(discriminant) })
+                        if (u >= 0 && u <= 2.0 * halfLine)
+                            take(start + u);
+                if (result >= 0)
+                    return result;
+
+                // corner: |cornerCenter + radius * (sin a, cos a) - point| = distance
+                auto cx = localX - halfLine;
+                auto cy = localY - halfLine;
+                auto centerDistance = sqrt(cx * cx + cy * cy);
+                if (centerDistance > 1e-12)
+                {
+                    auto rate = (radius * radius + centerDistance * centerDistance - distance * distance) / (2.0 * radius * centerDistance);
+                    if (fabs(rate) <= 1.0)
+                    {
+                        auto pointAngle = atan2(cx, cy);
+                        for (auto angle : { pointAngle - acos(rate), pointAngle + acos(rate) })
+                        {
+                            angle = fmod(angle + 2.0 * RAD_360, RAD_360);
+                            if (angle <= RAD_90 + 1e-12)
+                                take(start + 2.0 * halfLine + angle * radius);
+                        }
+                    }
+                }
+                if (result >= 0)
+                    return result;
+            }
+            return -1;
+        }
+
+    private:
+        double halfLine;
+        double radius;
+        double quarterLength;
+
+        static void TurnClockwise(double& x, double& y)
+        {
+            auto oldX = x;
+            x = y;
+            y = -oldX;
+        }
+
+        static void TurnCounterclockwise(double& x, double& y)
+        {
+            auto oldX = x;
+            x = -y;
+            y = oldX;
+        }
+    };
+
+    // signed distance to a square of 2 * halfLine lines rounded by radius, negative inside;
+    // a negative radius leaves a sharp square that much smaller
+    inline double RoundedSquareDistance(double x, double y, double halfLine, double radius)
+    {
+        if (radius < 0)
+        {
+            halfLine += radius;
+            radius = 0;
+        }
+        auto qx = fabs(x) - halfLine;
+        auto qy = fabs(y) - halfLine;
+        auto outX = std::max(qx, 0.0);
+        auto outY = std::max(qy, 0.0);
+        return sqrt(outX * outX + outY * outY) + std::min(std::max(qx, qy), 0.0) - radius;
+    }
+
+    // the frames of the squares are turned by 45 degrees around their centers
+    inline void ToGlobal(const PlainPoint3D& center, double x, double y, double& globalX, double& globalY)
+    {
+        globalX = center.x + (x - y) * SQRT_HALF;
+        globalY = center.y + (x + y) * SQRT_HALF;
+    }
+
+    inline void ToLocal(const PlainPoint3D& center, double globalX, double globalY, double& x, double& y)
+    {
+        auto dx = globalX - center.x;
+        auto dy = globalY - center.y;
+        x = (dx + dy) * SQRT_HALF;
+        y = (dy - dx) * SQRT_HALF;
+    }
+}
+
+double SquaresClearance::minGap() const
+{
+    return std::min(std::min(innerWallGap, outerWallGap), std::min(volfGap, crossingGap));
+}
+
+SquaresClearance VerifySquaresClearance(const Rings2D2SquaresParams& params, const Rings2D2SquaresLayout& layout, bool isRectangled, int sampleCount)
+{
+    auto& basePart = layout.basePart;
+    auto halfLine = basePart.lineLength / 2.0;
+    auto cornerRadius = basePart.cornerMiddleRadius;
+    auto volfDiameter = 2.0 * layout.clearedVolfRadius;
+    auto wallsThickness = isRectangled ? basePart.wallThickness + layout.roofPart.wallThickness : basePart.wallThickness;
+    auto innerRadius = cornerRadius - (basePart.innerWidth - wallsThickness);
+    auto outerRadius = cornerRadius + (basePart.outerWidth - wallsThickness);
+    auto volfCount = 4 * ((int)params.lineVolfCount + (int)params.cornerVolfCount);
+
+    SquarePath path(basePart.lineLength, cornerRadius);
+    sampleCount = std::max(1, sampleCount);
+    PlainPoint3D centers[2] = { basePart.leftCenterPoint, basePart.rightCenterPoint };
+
+    auto quarterLength = basePart.lineLength + cornerRadius * RAD_90;
+
+    SquaresClearance clearance;
+    clearance.innerWallGap = clearance.outerWallGap = clearance.volfGap = clearance.crossingGap = volfDiameter;
+    auto tightestGap = volfDiameter;
+    auto tighten = [&](double gap, const PlainPoint3D& center, double x, double y)
+    {
+        if (gap >= tightestGap)
+            return;
+        tightestGap = gap;
+        ToGlobal(center, x, y, clearance.tightestPoint.x, clearance.tightestPoint.y);
+    };
+
+    // the pushed volfs are the same after a quarter, only turned, so the first one
+    // starts within the first quarter; all chains go one volf further at a time
+    auto chainCount = std::max(1, sampleCount / 4);
+    std::vector<double> firstS(chainCount);
+    std::vector<double> lastS(chainCount);
+    std::vector<double> firstX(chainCount);
+    std::vector<double> firstY(chainCount);
+    std::vector<double> lastX(chainCount);
+    std::vector<double> lastY(chainCount);
+    std::vector<char> isJammed(chainCount, 0);
+    for (int i = 0; i < chainCount; i++)
+    {
+        firstS[i] = lastS[i] = quarterLength * i / chainCount;
+        path.point(firstS[i], firstX[i], firstY[i]);
+        lastX[i] = firstX[i];
+        lastY[i] = firstY[i];
+    }
+    for (int volf = 1; volf < volfCount; volf++)
+        for (int i = 0; i < chainCount; i++)
+        {
+            if (isJammed[i])
+                continue;
+            lastS[i] = path.next(lastS[i], lastX[i], lastY[i], volfDiameter);
+            isJammed[i] = lastS[i] < 0 || lastS[i] >= firstS[i] + path.length();
+            if (!isJammed[i])
+                path.point(lastS[i], lastX[i], lastY[i]);
+        }
+    for (int i = 0; i < chainCount; i++)
+    {
+        auto dx = firstX[i] - lastX[i];
+        auto dy = firstY[i] - lastY[i];
+        auto gap = isJammed[i] ? -volfDiameter : sqrt(dx * dx + dy * dy) - volfDiameter;
+        clearance.volfGap = std::min(clearance.volfGap, gap);
+        tighten(gap, centers[0], lastX[i], lastY[i]);
+    }
+
+    // every volf passes every point of the path, so the walls are checked along it
+    std::vector<double> xs(sampleCount);
+    std::vector<double> ys(sampleCount);
+    std::vector<double> otherXs(sampleCount);
+    std::vector<double> otherYs(sampleCount);
+    std::vector<double> innerGaps(sampleCount);
+    std::vector<double> outerGaps(sampleCount);
+    for (int i = 0; i < sampleCount; i++)
+        path.point(path.length() * i / sampleCount, xs[i], ys[i]);
+
+    for (int square = 0; square < 2; square++)
+    {
+        auto& center = centers[square];
+        auto& otherCenter = centers[1 - square];
+        for (int i = 0; i < sampleCount; i++)
+        {
+            double globalX, globalY;
+            ToGlobal(center, xs[i], ys[i], globalX, globalY);
+            ToLocal(otherCenter, globalX, globalY, otherXs[i], otherYs[i]);
+        }
+
+        // where the way crosses the other one that way cuts the walls
+        for (int i = 0; i < sampleCount; i++)
+        {
+            auto otherGap = std::min(RoundedSquareDistance(otherXs[i], otherYs[i], halfLine, innerRadius), -RoundedSquareDistance(otherXs[i], otherYs[i], halfLine, outerRadius));
+            innerGaps[i] = std::max(RoundedSquareDistance(xs[i], ys[i], halfLine, innerRadius), otherGap) - layout.clearedVolfRadius;
+            outerGaps[i] = std::max(-RoundedSquareDistance(xs[i], ys[i], halfLine, outerRadius), otherGap) - layout.clearedVolfRadius;
+        }
+        auto inner = std::min_element(innerGaps.begin(), innerGaps.end()) - innerGaps.begin();
+        auto outer = std::min_element(outerGaps.begin(), outerGaps.end()) - outerGaps.begin();
+        clearance.innerWallGap = std::min(clearance.innerWallGap, innerGaps[inner]);
+        clearance.outerWallGap = std::min(clearance.outerWallGap, outerGaps[outer]);
+        tighten(innerGaps[inner], center, xs[inner], ys[inner]);
+        tighten(outerGaps[outer], center, xs[outer], ys[outer]);
+
+        // the other square rests, the volf on the crossing goes with this one
+        for (auto& place : GetSquaresVolfPlaces(params, layout, otherCenter))
+        {
+            double x, y;
+            ToLocal(center, place.x, place.y, x, y);
+            auto distance = fabs(RoundedSquareDistance(x, y, halfLine, cornerRadius));
+            if (distance < 1e-6)
+                continue;
+            clearance.crossingGap = std::min(clearance.crossingGap, distance - volfDiameter);
+            tighten(distance - volfDiameter, center, x, y);
+        }
+    }
+    return clearance;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include "Geometry.h"
+#include "Rings2D2SquaresLayout.h"
+
+// Smallest gaps a printed volf gets while its square ring turns, all in cm and negative
+// on a collision. The volfs run on the middle path of Sketcher::AddSquareCurves (lineLength,
+// cornerMiddleRadius): the first one steps along it and pushes the others, every next one
+// touches the one before, so the ring closes with whatever length the clearance left.
+struct SquaresClearance
+{
+    double innerWallGap = 0;     // to the inner wall of the way
+    double outerWallGap = 0;     // to the outer wall of the way
+    double volfGap = 0;          // between the last and the first pushed volf
+    double crossingGap = 0;      // to the resting volfs of the other square
+    PlainPoint3D tightestPoint;  // center of the volf with the smallest gap
+
+    double minGap() const;
+    bool isClear() const { return minGap() >= 0; }
+};
+
+// The walls are checked at sampleCount points of the middle path, which every volf passes;
+// the resting volfs of the other square against the whole path. The pushed volfs are solved
+// for sampleCount / 4 starts within a quarter, the other quarters only turn them. No meshes,
+// so it is cheap enough to check every build.
+SquaresClearance VerifySquaresClearance(const Rings2D2SquaresParams& params, const Rings2D2SquaresLayout& layout, bool isRectangled, int sampleCount = 4096);
\ No newline at end of file
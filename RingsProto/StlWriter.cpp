@@ -0,0 +1,101 @@
+#include "StlWriter.h"
+#include <cstring>
+
+// long is 32 bits on Windows, the files of large meshes pass 2 GB
+static bool SeekFile(FILE* file, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+StlWriter::StlWriter() : file(nullptr), buffer(BUFFER_TRIANGLE_COUNT * TRIANGLE_SIZE), bufferSize(0), triangleCount(0), addedCount(0), isOk(false)
+{
+}
+
+StlWriter::~StlWriter()
+{
+    if (file != nullptr)
+        fclose(file);
+}
+
+bool StlWriter::open(const std::string& filepath, uint32_t triangleCount, const std::string& name)
+{
+    if (file != nullptr)
+        close();
+    file = fopen(filepath.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+    // the buffer here is the only one
+    setvbuf(file, nullptr, _IONBF, 0);
+
+    this->triangleCount = triangleCount;
+    addedCount = 0;
+    bufferSize = 0;
+
+    char header[80] = {};
+    snprintf(header, sizeof(header), "RingsProto %s", name.c_str());
+    isOk = fwrite(header, sizeof(header), 1, file) == 1 && fwrite(&triangleCount, sizeof(triangleCount), 1, file) == 1;
+
+    // reserve the whole file so it is not grown buffer by buffer
+    auto fileSize = 84ull + (uint64_t)TRIANGLE_SIZE * triangleCount;
+    if (isOk && triangleCount > 0)
+        isOk = SeekFile(file, fileSize - 1) && fputc(0, file) != EOF && SeekFile(file, 84);
+    return isOk;
+}
+
+void StlWriter::addTriangle(const PlainPoint3D& p1, const PlainPoint3D& p2, const PlainPoint3D& p3)
+{
+    if (!isOk || addedCount == triangleCount)
+    {
+        isOk = false;
+        return;
+    }
+
+    auto nx = (p2.y - p1.y) * (p3.z - p1.z) - (p2.z - p1.z) * (p3.y - p1.y);
+    auto ny = (p2.z - p1.z) * (p3.x - p1.x) - (p2.x - p1.x) * (p3.z - p1.z);
+    auto nz = (p2.x - p1.x) * (p3.y - p1.y) - (p2.y - p1.y) * (p3.x - p1.x);
+    auto length = sqrt(nx * nx + ny * ny + nz * nz);
+    if (length > 0)
+    {
+        nx /= length;
+        ny /= length;
+        nz /= length;
+    }
+
+    float record[12] = {
+        (float)nx, (float)ny, (float)nz,
+        (float)(p1.x * STL_SCALE), (float)(p1.y * STL_SCALE), (float)(p1.z * STL_SCALE),
+        (float)(p2.x * STL_SCALE), (float)(p2.y * STL_SCALE), (float)(p2.z * STL_SCALE),
+        (float)(p3.x * STL_SCALE), (float)(p3.y * STL_SCALE), (float)(p3.z * STL_SCALE),
+    };
+    auto target = buffer.data() + bufferSize;
+    memcpy(target, record, sizeof(record));
+    memset(target + sizeof(record), 0, TRIANGLE_SIZE - sizeof(record));
+    bufferSize += TRIANGLE_SIZE;
+    addedCount++;
+
+    if (bufferSize == buffer.size())
+        flush();
+}
+
+void StlWriter::flush()
+{
+    if (isOk && bufferSize > 0)
+        isOk = fwrite(buffer.data(), bufferSize, 1, file) == 1;
+    bufferSize = 0;
+}
+
+bool StlWriter::close()
+{
+    if (file == nullptr)
+        return false;
+    flush();
+    auto result = isOk && addedCount == triangleCount;
+    result = fclose(file) == 0 && result;
+    file = nullptr;
+    isOk = false;
+    return result;
+}
\ No newline at end of file
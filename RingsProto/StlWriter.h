@@ -0,0 +1,38 @@
+#pragma once
+#include "Geometry.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// STL is in millimeters, the models are in Fusion centimeters
+#define STL_SCALE 10.0
+
+// Binary STL streamed through one fixed buffer, so memory use does not depend on the
+// mesh size and nothing is allocated per triangle. The file is sized up front from
+// the triangle count given to open, and close fails unless exactly that many
+// triangles were added.
+class StlWriter
+{
+public:
+    StlWriter();
+    ~StlWriter();
+
+    bool open(const std::string& filepath, uint32_t triangleCount, const std::string& name = "");
+    // The normal is calculated from the counter-clockwise points.
+    void addTriangle(const PlainPoint3D& p1, const PlainPoint3D& p2, const PlainPoint3D& p3);
+    bool close();
+
+private:
+    static const size_t BUFFER_TRIANGLE_COUNT = 8192;
+    static const size_t TRIANGLE_SIZE = 50;
+
+    FILE* file;
+    std::vector<char> buffer;
+    size_t bufferSize;
+    uint32_t triangleCount;
+    uint32_t addedCount;
+    bool isOk;
+
+    void flush();
+};
\ No newline at end of file
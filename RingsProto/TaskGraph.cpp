@@ -0,0 +1,141 @@
+#include "TaskGraph.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    class WorkerQueue
+    {
+    public:
+        void push(int task)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(task);
+        }
+
+        // the newest task, for the owner
+        bool pop(int& task)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.empty())
+                return false;
+            task = tasks.back();
+            tasks.pop_back();
+            return true;
+        }
+
+        // the oldest task, for the other workers
+        bool steal(int& task)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tasks.empty())
+                return false;
+            task = tasks.front();
+            tasks.pop_front();
+            return true;
+        }
+
+    private:
+        std::mutex mutex;
+        std::deque<int> tasks;
+    };
+}
+
+int TaskGraph::add(std::function<void()> task, const std::vector<int>& dependencies)
+{
+    auto id = (int)tasks.size();
+    for (auto dependency : dependencies)
+        if (dependency < 0 || dependency >= id)
+            return -1;
+
+    tasks.push_back({ task, {}, (int)dependencies.size() });
+    for (auto dependency : dependencies)
+        tasks[dependency].dependents.push_back(id);
+    return id;
+}
+
+void TaskGraph::run(int threadCount)
+{
+    if (threadCount <= 0)
+        threadCount = (int)std::thread::hardware_concurrency();
+    threadCount = std::max(1, std::min(threadCount, count()));
+    if (tasks.empty())
+        return;
+
+    if (threadCount == 1)
+    {
+        // the ids are in a topological order already
+        for (auto& task : tasks)
+            task.function();
+        return;
+    }
+
+    std::unique_ptr<std::atomic<int>[]> remaining(new std::atomic<int>[tasks.size()]);
+    for (size_t i = 0; i < tasks.size(); i++)
+        remaining[i] = tasks[i].dependencyCount;
+
+    std::vector<WorkerQueue> queues(threadCount);
+    std::atomic<int> finishedCount(0);
+    // queued tasks not taken yet, the idle workers sleep while it is 0
+    std::atomic<int> readyCount(0);
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    auto queue = [&](int worker, int task)
+    {
+        queues[worker].push(task);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            readyCount++;
+        }
+        wakeUp.notify_one();
+    };
+
+    auto rootIndex = 0;
+    for (size_t i = 0; i < tasks.size(); i++)
+        if (tasks[i].dependencyCount == 0)
+            queues[rootIndex++ % threadCount].push((int)i);
+    readyCount = rootIndex;
+
+    auto worker = [&](int index)
+    {
+        auto taskCount = count();
+        while (finishedCount < taskCount)
+        {
+            int task = -1;
+            auto isFound = queues[index].pop(task);
+            for (int i = 1; i < threadCount && !isFound; i++)
+                isFound = queues[(index + i) % threadCount].steal(task);
+            if (!isFound)
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                wakeUp.wait(lock, [&]() { return readyCount > 0 || finishedCount == taskCount; });
+                continue;
+            }
+            readyCount--;
+
+            tasks[task].function();
+            for (auto dependent : tasks[task].dependents)
+                if (--remaining[dependent] == 0)
+                    queue(index, dependent);
+
+            if (++finishedCount == taskCount)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                wakeUp.notify_all();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++)
+        threads.emplace_back(worker, i);
+    worker(0);
+    for (auto& thread : threads)
+        thread.join();
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#include <functional>
+#include <vector>
+
+// Independent part builds as a DAG run on a work-stealing pool. Every worker has a deque
+// of its own: it takes its newest task first and an idle worker steals the oldest task of
+// another one. A task is queued when its last dependency finishes, on the worker that
+// finished it. Only for thread-safe backends (meshes, distance fields), the Fusion API
+// must stay on its own thread.
+//
+// Tasks write their results into slots of their own and the caller joins them after run
+// in a fixed order, so the results do not depend on the order the tasks ran in.
+class TaskGraph
+{
+public:
+    // dependencies are ids of tasks added before, returns -1 for any other id
+    int add(std::function<void()> task, const std::vector<int>& dependencies = {});
+    int count() const { return (int)tasks.size(); }
+    // runs every task once, threadCount 0 takes all cores; one thread runs them in order
+    void run(int threadCount = 0);
+
+private:
+    struct Task
+    {
+        std::function<void()> function;
+        std::vector<int> dependents;
+        int dependencyCount;
+    };
+
+    std::vector<Task> tasks;
+};
\ No newline at end of file
@@ -0,0 +1,446 @@
+#include "ThreeMfWriter.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+#define RINGS_3MF_NAMESPACE "urn:niatron:rings:3mf"
+
+namespace
+{
+    const char* contentTypesXml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"model\" ContentType=\"application/vnd.ms-package.3dmanufacturing-3dmodel+xml\"/>"
+        "</Types>";
+
+    const char* relationshipsXml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Target=\"/3D/3dmodel.model\" Id=\"rel0\" Type=\"http://schemas.microsoft.com/3dmanufacturing/2013/01/3dmodel\"/>"
+        "</Relationships>";
+
+    void AppendEscaped(std::string& xml, const std::string& text)
+    {
+        for (auto c : text)
+        {
+            switch (c)
+            {
+            case '&': xml += "&amp;"; break;
+            case '<': xml += "&lt;"; break;
+            case '>': xml += "&gt;"; break;
+            case '"': xml += "&quot;"; break;
+            default: xml += c;
+            }
+        }
+    }
+
+    void AppendMetadata(std::string& xml, const std::string& name, const std::string& value)
+    {
+        xml += "<metadata name=\"";
+        AppendEscaped(xml, name);
+        xml += "\">";
+        AppendEscaped(xml, value);
+        xml += "</metadata>";
+    }
+
+    // centimeters to the millimeters of the file, 0.1 micron is far below any printer
+    void AppendNumber(std::string& xml, double value)
+    {
+        char text[32];
+        auto length = snprintf(text, sizeof(text), "%.4f", value * THREE_MF_SCALE);
+        while (length > 1 && text[length - 1] == '0')
+            length--;
+        if (text[length - 1] == '.')
+            length--;
+        if (length == 2 && text[0] == '-' && text[1] == '0')
+        {
+            text[0] = '0';
+            length = 1;
+        }
+        xml.append(text, length);
+    }
+
+    uint32_t GetCrc32(const std::string& data)
+    {
+        static uint32_t table[256] = {};
+        static bool isTableReady = false;
+        if (!isTableReady)
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                auto crc = i;
+                for (int j = 0; j < 8; j++)
+                    crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+                table[i] = crc;
+            }
+            isTableReady = true;
+        }
+        uint32_t crc = 0xFFFFFFFFu;
+        for (auto c : data)
+            crc = table[(crc ^ (uint8_t)c) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    class BitWriter
+    {
+    public:
+        std::string data;
+
+        BitWriter() : bits(0), bitCount(0)
+        {
+        }
+
+        void write(uint32_t value, int count)
+        {
+            bits |= value << bitCount;
+            bitCount += count;
+            while (bitCount >= 8)
+            {
+                data += (char)(bits & 0xFF);
+                bits >>= 8;
+                bitCount -= 8;
+            }
+        }
+
+        // Huffman codes go most significant bit first
+        void writeCode(uint32_t code, int count)
+        {
+            uint32_t reversed = 0;
+            for (int i = 0; i < count; i++)
+                reversed |= ((code >> i) & 1) << (count - 1 - i);
+            write(reversed, count);
+        }
+
+        void finish()
+        {
+            if (bitCount > 0)
+                write(0, 8 - bitCount);
+        }
+
+    private:
+        uint32_t bits;
+        int bitCount;
+    };
+
+    void WriteLiteral(BitWriter& writer, int symbol)
+    {
+        if (symbol < 144)
+            writer.writeCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            writer.writeCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            writer.writeCode(symbol - 256, 7);
+        else
+            writer.writeCode(0xC0 + symbol - 280, 8);
+    }
+
+    void WriteMatch(BitWriter& writer, int length, int distance)
+    {
+        static const int lengthBases[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const int lengthExtraBits[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static const int distanceBases[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        static const int distanceExtraBits[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        auto lengthCode = 28;
+        while (lengthBases[lengthCode] > length)
+            lengthCode--;
+        WriteLiteral(writer, 257 + lengthCode);
+        writer.write(length - lengthBases[lengthCode], lengthExtraBits[lengthCode]);
+
+        auto distanceCode = 29;
+        while (distanceBases[distanceCode] > distance)
+            distanceCode--;
+        writer.writeCode(distanceCode, 5);
+        writer.write(distance - distanceBases[distanceCode], distanceExtraBits[distanceCode]);
+    }
+
+    // One deflate block with the fixed Huffman codes and hash chained LZ77 matches. The
+    // model XML is a few tags repeated with different numbers, which the matches take
+    // almost all of, so building dynamic code tables would not pay.
+    std::string Deflate(const std::string& data)
+    {
+        const int windowSize = 32768;
+        const int hashSize = 1 << 15;
+        const int minLength = 3;
+        const int maxLength = 258;
+        const int maxChainLength = 32;
+
+        BitWriter writer;
+        writer.write(1, 1); // final block
+        writer.write(1, 2); // fixed codes
+
+        auto bytes = (const uint8_t*)data.data();
+        auto size = (int)data.size();
+        std::vector<int> head(hashSize, -1);
+        std::vector<int> previous(windowSize, -1);
+        auto getHash = [&](int i) { return ((bytes[i] << 10) ^ (bytes[i + 1] << 5) ^ bytes[i + 2]) & (hashSize - 1); };
+        auto insert = [&](int i)
+        {
+            if (i + minLength > size)
+                return;
+            auto hash = getHash(i);
+            previous[i & (windowSize - 1)] = head[hash];
+            head[hash] = i;
+        };
+
+        auto i = 0;
+        while (i < size)
+        {
+            auto bestLength = 0;
+            auto bestDistance = 0;
+            if (i + minLength <= size)
+            {
+                auto limit = std::min(maxLength, size - i);
+                auto candidate = head[getHash(i)];
+                for (int chain = 0; chain < maxChainLength && candidate >= 0 && i - candidate <= windowSize; chain++)
+                {
+                    if (bytes[candidate + bestLength] == bytes[i + bestLength])
+                    {
+                        auto length = 0;
+                        while (length < limit && bytes[candidate + length] == bytes[i + length])
+                            length++;
+                        if (length > bestLength)
+                        {
+                            bestLength = length;
+                            bestDistance = i - candidate;
+                            if (length == limit)
+                                break;
+                        }
+                    }
+                    auto next = previous[candidate & (windowSize - 1)];
+                    if (next >= candidate)
+                        break;
+                    candidate = next;
+                }
+            }
+
+            if (bestLength >= minLength)
+            {
+                WriteMatch(writer, bestLength, bestDistance);
+                for (int j = 0; j < bestLength; j++)
+                    insert(i + j);
+                i += bestLength;
+            }
+            else
+            {
+                WriteLiteral(writer, bytes[i]);
+                insert(i);
+                i++;
+            }
+        }
+        WriteLiteral(writer, 256);
+        writer.finish();
+        return writer.data;
+    }
+
+    // Deflated ZIP, the 3MF package format.
+    class ZipWriter
+    {
+    public:
+        explicit ZipWriter(FILE* file) : file(file), offset(0), isOk(true)
+        {
+        }
+
+        void addEntry(const std::string& name, const std::string& data)
+        {
+            auto deflated = Deflate(data);
+            Entry entry = { name, GetCrc32(data), (uint32_t)deflated.size(), (uint32_t)data.size(), offset };
+            writeUint32(0x04034B50);
+            writeHeaderFields(entry);
+            writeUint16(0); // extra field length
+            write(name.data(), name.size());
+            write(deflated.data(), deflated.size());
+            entries.push_back(entry);
+        }
+
+        bool finish()
+        {
+            auto directoryOffset = offset;
+            for (auto& entry : entries)
+            {
+                writeUint32(0x02014B50);
+                writeUint16(20); // version made by
+                writeHeaderFields(entry);
+                writeUint16(0); // extra field length
+                writeUint16(0); // comment length
+                writeUint16(0); // disk number
+                writeUint16(0); // internal attributes
+                writeUint32(0); // external attributes
+                writeUint32(entry.offset);
+                write(entry.name.data(), entry.name.size());
+            }
+            auto directorySize = offset - directoryOffset;
+            writeUint32(0x06054B50);
+            writeUint16(0);
+            writeUint16(0);
+            writeUint16((uint16_t)entries.size());
+            writeUint16((uint16_t)entries.size());
+            writeUint32(directorySize);
+            writeUint32(directoryOffset);
+            writeUint16(0); // comment length
+            return isOk;
+        }
+
+    private:
+        struct Entry
+        {
+            std::string name;
+            uint32_t crc;
+            uint32_t compressedSize;
+            uint32_t size;
+            uint32_t offset;
+        };
+
+        FILE* file;
+        uint32_t offset;
+        bool isOk;
+        std::vector<Entry> entries;
+
+        void write(const void* data, size_t size)
+        {
+            isOk = isOk && (size == 0 || fwrite(data, size, 1, file) == 1);
+            offset += (uint32_t)size;
+        }
+
+        void writeUint16(uint16_t value)
+        {
+            uint8_t bytes[2] = { (uint8_t)value, (uint8_t)(value >> 8) };
+            write(bytes, sizeof(bytes));
+        }
+
+        void writeUint32(uint32_t value)
+        {
+            uint8_t bytes[4] = { (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24) };
+            write(bytes, sizeof(bytes));
+        }
+
+        // the part the local header and the central directory record share
+        void writeHeaderFields(const Entry& entry)
+        {
+            writeUint16(20); // version needed
+            writeUint16(0); // flags
+            writeUint16(8); // deflated
+            writeUint16(0); // time
+            writeUint16(0x21); // date, 1980-01-01
+            writeUint32(entry.crc);
+            writeUint32(entry.compressedSize);
+            writeUint32(entry.size);
+            writeUint16((uint16_t)entry.name.size());
+        }
+    };
+}
+
+void ThreeMfWriter::addMetadata(const std::string& name, const std::string& value)
+{
+    AppendMetadata(metadataXml, name, value);
+}
+
+int ThreeMfWriter::addObject(const MeshBody& body, const ThreeMfMetadata& metadata)
+{
+    auto id = (int)objectBoxes.size() + 1;
+    objectBoxes.push_back(body.boundingBox());
+
+    auto& xml = objectsXml;
+    xml += "<object id=\"" + std::to_string(id) + "\" type=\"model\" name=\"";
+    AppendEscaped(xml, body.name);
+    xml += "\">";
+    if (!metadata.empty())
+    {
+        xml += "<metadatagroup>";
+        for (auto& item : metadata)
+            AppendMetadata(xml, item.first, item.second);
+        xml += "</metadatagroup>";
+    }
+
+    xml += "<mesh><vertices>";
+    for (auto& vertex : body.vertices)
+    {
+        xml += "<vertex x=\"";
+        AppendNumber(xml, vertex.x);
+        xml += "\" y=\"";
+        AppendNumber(xml, vertex.y);
+        xml += "\" z=\"";
+        AppendNumber(xml, vertex.z);
+        xml += "\"/>";
+    }
+    xml += "</vertices><triangles>";
+    for (auto& triangle : body.triangles)
+        xml += "<triangle v1=\"" + std::to_string(triangle.a) + "\" v2=\"" + std::to_string(triangle.b) + "\" v3=\"" + std::to_string(triangle.c) + "\"/>";
+    xml += "</triangles></mesh></object>\n";
+    return id;
+}
+
+void ThreeMfWriter::addItem(int objectId, const PlainPoint3D& shift)
+{
+    items.push_back({ objectId, shift });
+}
+
+void ThreeMfWriter::arrange(double plateWidth, double gap)
+{
+    // tallest footprints first, so every row is about as deep as its items
+    std::vector<size_t> order(items.size());
+    for (size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    auto getDepth = [&](size_t i)
+    {
+        auto& box = objectBoxes[items[i].objectId - 1];
+        return box.maxPoint.y - box.minPoint.y;
+    };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return getDepth(a) > getDepth(b); });
+
+    auto x = 0.0;
+    auto y = 0.0;
+    auto rowDepth = 0.0;
+    for (auto i : order)
+    {
+        auto& box = objectBoxes[items[i].objectId - 1];
+        auto width = box.maxPoint.x - box.minPoint.x;
+        if (x > 0 && x + width > plateWidth)
+        {
+            x = 0;
+            y += rowDepth + gap;
+            rowDepth = 0;
+        }
+        items[i].shift = { x - box.minPoint.x, y - box.minPoint.y, -box.minPoint.z };
+        x += width + gap;
+        rowDepth = std::max(rowDepth, getDepth(i));
+    }
+}
+
+std::string ThreeMfWriter::getModelXml() const
+{
+    std::string xml =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<model unit=\"millimeter\" xml:lang=\"en-US\" xmlns=\"http://schemas.microsoft.com/3dmanufacturing/core/2015/02\" xmlns:rings=\"" RINGS_3MF_NAMESPACE "\">\n";
+    xml.reserve(xml.size() + metadataXml.size() + objectsXml.size() + 100 * items.size() + 100);
+    xml += metadataXml;
+    xml += "\n<resources>\n";
+    xml += objectsXml;
+    xml += "</resources>\n<build>\n";
+    for (auto& item : items)
+    {
+        xml += "<item objectid=\"" + std::to_string(item.objectId) + "\" transform=\"1 0 0 0 1 0 0 0 1 ";
+        AppendNumber(xml, item.shift.x);
+        xml += " ";
+        AppendNumber(xml, item.shift.y);
+        xml += " ";
+        AppendNumber(xml, item.shift.z);
+        xml += "\"/>\n";
+    }
+    xml += "</build>\n</model>";
+    return xml;
+}
+
+bool ThreeMfWriter::save(const std::string& filepath) const
+{
+    auto file = fopen(filepath.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+    ZipWriter zip(file);
+    zip.addEntry("[Content_Types].xml", contentTypesXml);
+    zip.addEntry("_rels/.rels", relationshipsXml);
+    zip.addEntry("3D/3dmodel.model", getModelXml());
+    auto isOk = zip.finish();
+    return fclose(file) == 0 && isOk;
+}
\ No newline at end of file
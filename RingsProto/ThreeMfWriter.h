@@ -0,0 +1,43 @@
+#pragma once
+#include "MeshBody.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+// 3MF is in millimeters as STL, the models are in Fusion centimeters
+#define THREE_MF_SCALE 10.0
+
+// Metadata names without a prefix must be the 3MF well known ones (Title, Designer,
+// Description...). Our own names take the rings: prefix, the model declares it.
+typedef std::vector<std::pair<std::string, std::string>> ThreeMfMetadata;
+
+// One build plate packed into a 3MF file. An object is one vertex pool with indexed
+// triangles, and build items only reference objects, so a part printed many times
+// (volfs) is stored once. The object XML is made when the object is added, the
+// meshes themselves are not kept.
+class ThreeMfWriter
+{
+public:
+    void addMetadata(const std::string& name, const std::string& value);
+    // The object is named after the body. Returns the object id for addItem.
+    int addObject(const MeshBody& body, const ThreeMfMetadata& metadata = ThreeMfMetadata());
+    void addItem(int objectId, const PlainPoint3D& shift = PlainPoint3D());
+    // Lays the items out in rows on the plate, each one standing on z = 0, instead of
+    // the places they were added with. plateWidth and gap are in centimeters.
+    void arrange(double plateWidth = 25.0, double gap = 0.5);
+    bool save(const std::string& filepath) const;
+
+private:
+    struct Item
+    {
+        int objectId;
+        PlainPoint3D shift;
+    };
+
+    std::string metadataXml;
+    std::string objectsXml;
+    std::vector<MeshBox> objectBoxes;
+    std::vector<Item> items;
+
+    std::string getModelXml() const;
+};
\ No newline at end of file
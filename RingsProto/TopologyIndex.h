@@ -0,0 +1,20 @@
+#pragma once
+#include <string>
+#include <unordered_set>
+#include "FusionEnvironment.h"
+
+// Hashed matching of topology. Edges and faces are keyed by their entity tokens, so a
+// lookup does not depend on how many edges a filleted body has. Nothing is matched by
+// coordinates: the base and the tooth joins pick their edges by the faces they touch
+// (tokens) or by the BodyTopology columns, which are read in one pass.
+
+typedef std::unordered_set<std::string> EntityTokenSet;
+
+// tokens of BRepEdges, BRepFaces, BRepEdges of a face and the like
+template <class T> EntityTokenSet GetEntityTokens(Ptr<T> items)
+{
+    EntityTokenSet tokens;
+    for (int i = 0; i < items->count(); i++)
+        tokens.insert(items->item(i)->entityToken());
+    return tokens;
+}
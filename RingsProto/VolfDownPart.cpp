@@ -1,13 +1,59 @@
 #include "VolfDownPart.h"
+#include "Instrumentation.h"
+#include "FilletPlanner.h"
 
-bool VolfDownPart::edgeIsInHole(Ptr<BRepEdge> edge)
+void VolfDownPart::setLayout(const VolfDownPartLayout& layout)
 {
-    auto point = edge->endVertex()->geometry();
-    point->z(centerPoint->z());
-    return point->distanceTo(centerPoint) <= holeRadius + 0.01;
+    radius = layout.radius;
+    height = layout.height;
+    middleRadius = layout.middleRadius;
+    middleHeight = layout.middleHeight;
+    holeRadius = layout.holeRadius;
+    holeHeight = layout.holeHeight;
+    holeUpRadius = layout.holeUpRadius;
+    holeUpHeight = layout.holeUpHeight;
+    holeDownRadius = layout.holeDownRadius;
+    holeDownHeight = layout.holeDownHeight;
+    zMoveShift = layout.zMoveShift;
+    filletRadius = layout.filletRadius;
+}
+
+bool VolfDownPart::edgeIsInHole(const BodyTopology& topology, int edge)
+{
+    return hypot(topology.endX[edge] - centerPoint->x(), topology.endY[edge] - centerPoint->y()) <= holeRadius + 0.01;
+}
+
+BodyCacheKey VolfDownPart::getCacheKey()
+{
+    return BodyCacheKey("VolfDownPart")
+        .add(radius)
+        .add(height)
+        .add(middleRadius)
+        .add(middleHeight)
+        .add(holeRadius)
+        .add(holeHeight)
+        .add(holeUpRadius)
+        .add(holeUpHeight)
+        .add(holeDownRadius)
+        .add(holeDownHeight)
+        .add(zMoveShift)
+        .add(filletRadius);
 }
 
 Ptr<BRepBody> VolfDownPart::createBody(Ptr<Component> component)
+{
+    INSTRUMENT_PART("VolfDownPart");
+    auto key = getCacheKey();
+    auto body = bodyCache.find(component, key, centerPoint);
+    if (body != nullptr)
+        return body;
+
+    body = buildBody(component);
+    bodyCache.add(key, body, centerPoint);
+    return body;
+}
+
+Ptr<BRepBody> VolfDownPart::buildBody(Ptr<Component> component)
 {
     auto body = CreateCylinder(component, centerPoint, radius, height);
 
@@ -37,14 +83,12 @@ Ptr<BRepBody> VolfDownPart::createBody(Ptr<Component> component)
         body = Combine(component, CutFeatureOperation, body, holeBody);
     }
 
-    auto edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && (edge->endVertex()->geometry()->z() > height * 1.1 || edgeIsInHole(edge)); });
-    Fillet(component, edges, filletRadius / 2.0);
-
-    edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && Equal(edge->length(), GetCircleLength(holeDownRadius), 0.1) && Equal(edge->endVertex()->geometry()->z(), holeDownHeight, 0.01); });
-    Fillet(component, edges, filletRadius / 3.0 * 2.0);
-
-    edges = GetEdges(body, EdgeIsHorizontal);
-    Fillet(component, edges, filletRadius);
+    body = CommitBody(component, body);
+    FilletPlanner planner;
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && (topology.endZ[edge] > height * 1.1 || edgeIsInHole(topology, edge)); }, filletRadius / 2.0);
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && Equal(topology.length[edge], GetCircleLength(holeDownRadius), 0.1) && Equal(topology.endZ[edge], holeDownHeight, 0.01); }, filletRadius / 3.0 * 2.0);
+    planner.add(IsHorizontalEdge, filletRadius);
+    planner.fillet(component, body);
     
     body = Move(component, body, component->zConstructionAxis(), zMoveShift);
 
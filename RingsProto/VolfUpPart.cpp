@@ -1,13 +1,67 @@
 #include "VolfUpPart.h"
+#include "Instrumentation.h"
+#include "FilletPlanner.h"
 
-bool VolfUpPart::edgeIsInHole(Ptr<BRepEdge> edge)
+void VolfUpPart::setLayout(const VolfUpPartLayout& layout)
 {
-    auto point = edge->endVertex()->geometry();
-    point->z(centerPoint->z());
-    return point->distanceTo(centerPoint) <= holeRadius + 0.01;
+    radius = layout.radius;
+    height = layout.height;
+    middleRadius = layout.middleRadius;
+    middleHeight = layout.middleHeight;
+    holeRadius = layout.holeRadius;
+    holeHeight = layout.holeHeight;
+    holeUpRadius = layout.holeUpRadius;
+    holeUpHeight = layout.holeUpHeight;
+    holeDownRadius = layout.holeDownRadius;
+    holeDownHeight = layout.holeDownHeight;
+    zMoveShift = layout.zMoveShift;
+    filletRadius = layout.filletRadius;
+    form = layout.form == VolfUpForm::Convex ? convex : (layout.form == VolfUpForm::Concave ? concave : straight);
+    concaveHeight = layout.concaveHeight;
+    concaveRadius = layout.concaveRadius;
+    convexRadius = layout.convexRadius;
+}
+
+bool VolfUpPart::edgeIsInHole(const BodyTopology& topology, int edge)
+{
+    return hypot(topology.endX[edge] - centerPoint->x(), topology.endY[edge] - centerPoint->y()) <= holeRadius + 0.01;
+}
+
+BodyCacheKey VolfUpPart::getCacheKey()
+{
+    return BodyCacheKey("VolfUpPart")
+        .add(radius)
+        .add(height)
+        .add(middleRadius)
+        .add(middleHeight)
+        .add(holeRadius)
+        .add(holeHeight)
+        .add(holeUpRadius)
+        .add(holeUpHeight)
+        .add(holeDownRadius)
+        .add(holeDownHeight)
+        .add(zMoveShift)
+        .add(filletRadius)
+        .add(form)
+        .add(concaveHeight)
+        .add(concaveRadius)
+        .add(convexRadius);
 }
 
 Ptr<BRepBody> VolfUpPart::createBody(Ptr<Component> component)
+{
+    INSTRUMENT_PART("VolfUpPart");
+    auto key = getCacheKey();
+    auto body = bodyCache.find(component, key, centerPoint);
+    if (body != nullptr)
+        return body;
+
+    body = buildBody(component);
+    bodyCache.add(key, body, centerPoint);
+    return body;
+}
+
+Ptr<BRepBody> VolfUpPart::buildBody(Ptr<Component> component)
 {
     auto body = CreateCylinder(component, centerPoint, radius, height);
 
@@ -48,11 +102,11 @@ Ptr<BRepBody> VolfUpPart::createBody(Ptr<Component> component)
         body = Combine(component, IntersectFeatureOperation, body, sphereBody);
     }
 
-    auto edges = GetEdges(body, [=](Ptr<BRepEdge> edge) {return EdgeIsHorizontal(edge) && edge->endVertex()->geometry()->z() > middleHeight * 0.9 && !edgeIsInHole(edge); });
-    Fillet(component, edges, filletRadius);
-
-    edges = GetEdges(body, EdgeIsHorizontal);
-    Fillet(component, edges, filletRadius / 2.0);
+    body = CommitBody(component, body);
+    FilletPlanner planner;
+    planner.add([=](const BodyTopology& topology, int edge) {return IsHorizontalEdge(topology, edge) && topology.endZ[edge] > middleHeight * 0.9 && !edgeIsInHole(topology, edge); }, filletRadius);
+    planner.add(IsHorizontalEdge, filletRadius / 2.0);
+    planner.fillet(component, body);
 
     body = Move(component, body, component->zConstructionAxis(), zMoveShift - middleHeight);
 
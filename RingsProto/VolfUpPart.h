@@ -1,5 +1,8 @@
 #pragma once
 #include "FusionEnvironment.h"
+#include "BodyTopology.h"
+#include "BodyCache.h"
+#include "PartLayouts.h"
 
 
 
@@ -21,12 +24,18 @@ public:
     Ptr<Point3D> centerPoint;
     double zMoveShift = 0;
     double filletRadius = 0;
+    // bodies by all the params but centerPoint. The volfs of a puzzle are instances of one
+    // body already; the cache saves its build on a rebuild that moves only the volf places.
+    BodyCache bodyCache;
     Form form = straight;
     double concaveHeight = 0;
     double concaveRadius = 0;
     double convexRadius = 0;
 
+    void setLayout(const VolfUpPartLayout& layout);
     Ptr<BRepBody> createBody(Ptr<Component> component);
 private:
-    bool edgeIsInHole(Ptr<BRepEdge> edge);
+    BodyCacheKey getCacheKey();
+    Ptr<BRepBody> buildBody(Ptr<Component> component);
+    bool edgeIsInHole(const BodyTopology& topology, int edge);
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Measures the speedup of the parallel part builds. A batch of Rings2D2Squares variants
+// is built as one task graph on 1, 2, 4 ... --threads threads and every thread count must
+// give the same bodies as one thread. Build on Linux from this directory with:
+//   g++ -O2 -std=c++14 -pthread -o BuildBenchmark BuildBenchmark.cpp ../RingsProto/Geometry.cpp
+//       ../RingsProto/Rings2D2SquaresLayout.cpp ../RingsProto/MeshBody.cpp ../RingsProto/MeshCsg.cpp
+//       ../RingsProto/MeshEnvironment.cpp ../RingsProto/MeshParts.cpp ../RingsProto/StlWriter.cpp ../RingsProto/TaskGraph.cpp
+//
+//   BuildBenchmark --variants 32 --threads 32 --repeat 3
+
+#include "../RingsProto/MeshParts.h"
+#include "../RingsProto/Rings2D2SquaresLayout.h"
+#include "../RingsProto/TaskGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void PrintUsage()
+{
+    printf("usage: BuildBenchmark [--variants 16] [--threads 32] [--repeat 1] [--plain]\n");
+    printf("  variants differ in squareMiddleSize by 0.1 from the default one\n");
+}
+
+// triangle counts and volumes of all bodies, equal for equal builds
+static std::vector<double> GetSignature(const std::vector<std::vector<MeshBody>>& variantBodies)
+{
+    std::vector<double> signature;
+    for (auto& bodies : variantBodies)
+        for (auto& body : bodies)
+        {
+            signature.push_back((double)body.triangles.size());
+            signature.push_back(body.volume());
+        }
+    return signature;
+}
+
+static double Build(const std::vector<Rings2D2SquaresLayout>& layouts, bool isRectangled, int threadCount, std::vector<std::vector<MeshBody>>& variantBodies)
+{
+    variantBodies.assign(layouts.size(), std::vector<MeshBody>());
+    auto startTime = std::chrono::steady_clock::now();
+    TaskGraph graph;
+    for (size_t i = 0; i < layouts.size(); i++)
+        AddRings2D2SquaresTasks(graph, layouts[i], isRectangled, variantBodies[i]);
+    graph.run(threadCount);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+int main(int argc, char** argv)
+{
+    auto variantCount = 16;
+    auto maxThreadCount = 32;
+    auto repeatCount = 1;
+    auto isRectangled = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--plain")
+        {
+            isRectangled = false;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+        auto value = atoi(argv[++i]);
+        if (option == "--variants")
+            variantCount = value;
+        else if (option == "--threads")
+            maxThreadCount = value;
+        else if (option == "--repeat")
+            repeatCount = value;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (variantCount < 1 || maxThreadCount < 1 || repeatCount < 1)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<Rings2D2SquaresLayout> layouts;
+    for (int i = 0; i < variantCount; i++)
+    {
+        Rings2D2SquaresParams params;
+        params.squareMiddleSize += 0.1 * i;
+        layouts.push_back(SolveRings2D2SquaresLayout(params, isRectangled));
+    }
+
+    TaskGraph countGraph;
+    std::vector<std::vector<MeshBody>> countBodies(layouts.size());
+    for (size_t i = 0; i < layouts.size(); i++)
+        AddRings2D2SquaresTasks(countGraph, layouts[i], isRectangled, countBodies[i]);
+    printf("%d variants, %d tasks, %u cores\n", variantCount, countGraph.count(), std::thread::hardware_concurrency());
+    printf("threads   seconds   speedup  efficiency\n");
+
+    std::vector<double> referenceSignature;
+    double referenceSeconds = 0;
+    auto isOk = true;
+    for (int threadCount = 1; threadCount <= maxThreadCount; threadCount = threadCount < maxThreadCount ? std::min(2 * threadCount, maxThreadCount) : threadCount + 1)
+    {
+        double seconds = 0;
+        std::vector<std::vector<MeshBody>> variantBodies;
+        for (int i = 0; i < repeatCount; i++)
+        {
+            auto time = Build(layouts, isRectangled, threadCount, variantBodies);
+            seconds = i == 0 ? time : std::min(seconds, time);
+        }
+
+        auto signature = GetSignature(variantBodies);
+        if (threadCount == 1)
+        {
+            referenceSignature = signature;
+            referenceSeconds = seconds;
+        }
+        auto isSame = signature == referenceSignature;
+        isOk = isOk && isSame;
+        auto speedup = referenceSeconds / seconds;
+        printf("%7d %9.3f %9.2f %10.0f%%%s\n", threadCount, seconds, speedup, 100.0 * speedup / threadCount, isSame ? "" : "  bodies differ from 1 thread");
+    }
+    return isOk ? 0 : 1;
+}
\ No newline at end of file
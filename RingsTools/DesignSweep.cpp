@@ -0,0 +1,727 @@
+#include "DesignSweep.h"
+#include "../RingsProto/Rings2D2SquaresLayout.h"
+#include "../RingsProto/Rings2D2CirclesLayout.h"
+#include "../RingsProto/RingsProtoCreatorLayout.h"
+#include "../RingsProto/SquaresClearance.h"
+#include "../RingsProto/GearPair.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+uint64_t SweepAxis::count() const
+{
+    if (step <= 0 || to <= from)
+        return 1;
+    return (uint64_t)floor((to - from) / step + 1e-9) + 1;
+}
+
+double SweepAxis::value(uint64_t index) const
+{
+    return from + step * index;
+}
+
+bool ParseSweepAxis(const std::string& text, SweepAxis& axis)
+{
+    double values[3] = { 0, 0, 1 };
+    int count = 0;
+    size_t start = 0;
+    while (count < 3)
+    {
+        auto end = text.find(':', start);
+        auto part = text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        char* tail = nullptr;
+        values[count] = strtod(part.c_str(), &tail);
+        if (part.empty() || *tail != 0)
+            return false;
+        count++;
+        if (end == std::string::npos)
+            break;
+        start = end + 1;
+    }
+    if (count == 3 && text.find(':', start) != std::string::npos)
+        return false;
+
+    axis.from = values[0];
+    axis.to = count == 1 ? values[0] : values[1];
+    axis.step = count == 3 ? values[2] : 1.0;
+    return axis.step > 0 && axis.to >= axis.from;
+}
+
+namespace
+{
+    enum SquaresFlags
+    {
+        SquaresVolfNotHeld = 1 << 0,      // roof separation is wider than the volf, the volf falls out
+        SquaresVolfHoleWall = 1 << 1,     // wall around the volf down hole is thinner than one nozzle line
+        SquaresCornerCollapsed = 1 << 2,  // inner corner wall does not fit inside the corner radius
+        SquaresLinkerOverlap = 1 << 3,    // corner linkers run into the central linker
+        SquaresOverBed = 1 << 4,
+        SquaresInvalid = 1 << 5,
+        SquaresVolfJammed = 1 << 6,       // a volf hits a wall or another volf on its way
+    };
+
+    class SquaresSweepDesign : public SweepDesign
+    {
+    public:
+        SquaresSweepDesign(double bedSize, int clearanceSampleCount) : bedSize(bedSize), clearanceSampleCount(clearanceSampleCount) {}
+
+        const char* name() const override { return "squares"; }
+
+        std::vector<SweepAxis> defaultAxes() const override
+        {
+            Rings2D2SquaresParams params;
+            return {
+                { "lineVolfCount", params.lineVolfCount, params.lineVolfCount, 1 },
+                { "cornerVolfCount", params.cornerVolfCount, params.cornerVolfCount, 1 },
+                { "squareMiddleSize", params.squareMiddleSize, params.squareMiddleSize, 1 },
+                { "moovableClearence", params.moovableClearence, params.moovableClearence, 1 },
+                { "unmoovableClearence", params.unmoovableClearence, params.unmoovableClearence, 1 },
+                { "rectangled", 1, 1, 1 },
+            };
+        }
+
+        std::vector<std::string> outputNames() const override
+        {
+            return { "volfRadius", "clearedVolfRadius", "lineLength", "cornerOuterRadius", "squareShift",
+                "baseInnerWidth", "baseOuterWidth", "baseHeight", "roofHeight", "totalWidth", "totalHeight" };
+        }
+
+        std::vector<std::string> flagNames() const override
+        {
+            return { "volfNotHeld", "volfHoleWall", "cornerCollapsed", "linkerOverlap", "overBed", "invalid", "volfJammed" };
+        }
+
+        uint32_t evaluate(const double* inputs, double* outputs) const override
+        {
+            Rings2D2SquaresParams params;
+            params.lineVolfCount = round(inputs[0]);
+            params.cornerVolfCount = round(inputs[1]);
+            params.squareMiddleSize = inputs[2];
+            params.moovableClearence = inputs[3];
+            params.unmoovableClearence = inputs[4];
+            auto isRectangled = inputs[5] != 0;
+
+            if (params.lineVolfCount < 0 || params.cornerVolfCount < 1 || params.squareMiddleSize <= 0)
+            {
+                for (int i = 0; i < 11; i++)
+                    outputs[i] = 0;
+                return SquaresInvalid;
+            }
+
+            Rings2D2SquaresLayout layout;
+            SolveRings2D2SquaresLayout(params, isRectangled, layout);
+            auto& basePart = layout.basePart;
+            auto& roofPart = layout.roofPart;
+
+            auto outerWidth = std::max(basePart.outerWidth, roofPart.outerWidth);
+            auto size = layout.lineLength / sqrt(2.0) + basePart.cornerMiddleRadius + outerWidth;
+            auto totalWidth = 2.0 * (layout.squareShift + size);
+            auto totalHeight = 2.0 * size;
+
+            outputs[0] = layout.volfRadius;
+            outputs[1] = layout.clearedVolfRadius;
+            outputs[2] = layout.lineLength;
+            outputs[3] = layout.cornerOuterRadius;
+            outputs[4] = layout.squareShift;
+            outputs[5] = basePart.innerWidth;
+            outputs[6] = basePart.outerWidth;
+            outputs[7] = basePart.height;
+            outputs[8] = roofPart.height;
+            outputs[9] = totalWidth;
+            outputs[10] = totalHeight;
+
+            uint32_t flags = 0;
+            if (roofPart.separationInnerWidth >= layout.clearedVolfRadius)
+                flags |= SquaresVolfNotHeld;
+            if (layout.clearedVolfRadius - layout.volfDownPart.holeDownRadius < nozzleWidth)
+                flags |= SquaresVolfHoleWall;
+            if (basePart.cornerMiddleRadius <= basePart.innerWidth)
+                flags |= SquaresCornerCollapsed;
+            if (isRectangled)
+            {
+                auto& linker = basePart.linkerPoints[0];
+                auto centralDistance = sqrt(linker.x * linker.x + linker.y * linker.y);
+                if (centralDistance < basePart.linkingPart.radius + basePart.centralLinkerRadius + basePart.wallThickness)
+                    flags |= SquaresLinkerOverlap;
+            }
+            if (totalWidth > bedSize || totalHeight > bedSize)
+                flags |= SquaresOverBed;
+            // the sampled check costs hundreds of the rest, only the rows it can still reject pay it
+            if (flags == 0 && clearanceSampleCount > 0 && !VerifySquaresClearance(params, layout, isRectangled, clearanceSampleCount).isClear())
+                flags |= SquaresVolfJammed;
+            return flags;
+        }
+    private:
+        double bedSize;
+        double nozzleWidth = 0.04;
+        int clearanceSampleCount;
+    };
+
+    enum CirclesFlags
+    {
+        CirclesVolfNotHeld = 1 << 0,    // volf head is narrower than the roof slot around the leg
+        CirclesLegHole = 1 << 1,        // leg hole leaves no wall in the leg
+        CirclesNoCross = 1 << 2,        // circles do not cross, or cross through the wrong volf count
+        CirclesSector = 1 << 3,         // roof sectors between the legs vanish
+        CirclesMagnet = 1 << 4,         // magnet does not fit into the base floor
+        CirclesOverBed = 1 << 5,
+        CirclesInvalid = 1 << 6,
+    };
+
+    class CirclesSweepDesign : public SweepDesign
+    {
+    public:
+        explicit CirclesSweepDesign(double bedSize) : bedSize(bedSize) {}
+
+        const char* name() const override { return "circles"; }
+
+        std::vector<SweepAxis> defaultAxes() const override
+        {
+            Rings2D2CirclesParams params;
+            return {
+                { "volfCount", (double)params.volfCount, (double)params.volfCount, 1 },
+                { "crossVolfCount", (double)params.crossVolfCount, (double)params.crossVolfCount, 1 },
+                { "circleRadius", params.circleRadius, params.circleRadius, 1 },
+                { "volfLegRadius", params.volfLegRadius, params.volfLegRadius, 1 },
+                { "magnetRadius", params.magnetRadius, params.magnetRadius, 1 },
+                { "moovableClearence", params.moovableClearence, params.moovableClearence, 1 },
+                { "unmoovableClearence", params.unmoovableClearence, params.unmoovableClearence, 1 },
+            };
+        }
+
+        std::vector<std::string> outputNames() const override
+        {
+            return { "volfRadius", "circleShift", "baseOuterRadius", "baseInnerRadius", "baseWallHeight",
+                "roofOuterOuterRadius", "roofInnerInnerRadius", "sectorAngel", "totalWidth" };
+        }
+
+        std::vector<std::string> flagNames() const override
+        {
+            return { "volfNotHeld", "legHole", "noCross", "sector", "magnet", "overBed", "invalid" };
+        }
+
+        uint32_t evaluate(const double* inputs, double* outputs) const override
+        {
+            Rings2D2CirclesParams params;
+            params.volfCount = (int)lround(inputs[0]);
+            params.crossVolfCount = (int)lround(inputs[1]);
+            params.circleRadius = inputs[2];
+            params.volfLegRadius = inputs[3];
+            params.magnetRadius = inputs[4];
+            params.moovableClearence = inputs[5];
+            params.unmoovableClearence = inputs[6];
+
+            if (params.volfCount < 3 || params.crossVolfCount < 1 || params.circleRadius <= 0)
+            {
+                for (int i = 0; i < 9; i++)
+                    outputs[i] = 0;
+                return CirclesInvalid;
+            }
+
+            Rings2D2CirclesLayout layout;
+            SolveRings2D2CirclesLayout(params, layout);
+            auto totalWidth = 2.0 * (layout.circleShift + layout.roofOuterOuterRadius);
+
+            outputs[0] = layout.volfRadius;
+            outputs[1] = layout.circleShift;
+            outputs[2] = layout.baseOuterRadius;
+            outputs[3] = layout.baseInnerRadius;
+            outputs[4] = layout.baseWallHeight;
+            outputs[5] = layout.roofOuterOuterRadius;
+            outputs[6] = layout.roofInnerInnerRadius;
+            outputs[7] = layout.sectorAngel;
+            outputs[8] = totalWidth;
+
+            uint32_t flags = 0;
+            if (layout.volfRadius <= params.volfLegRadius + params.moovableClearence)
+                flags |= CirclesVolfNotHeld;
+            if (params.volfLegHoleRadius + params.moovableClearence >= params.volfLegRadius)
+                flags |= CirclesLegHole;
+            if (2 * params.crossVolfCount > params.volfCount || layout.circleShift <= 0)
+                flags |= CirclesNoCross;
+            if (layout.sectorAngel <= 0 || layout.roofInnerInnerRadius <= 0)
+                flags |= CirclesSector;
+            if (2.0 * params.magnetRadius >= layout.baseOuterRadius - layout.baseInnerRadius - 2.0 * params.wallThickness)
+                flags |= CirclesMagnet;
+            if (totalWidth > bedSize || 2.0 * layout.roofOuterOuterRadius > bedSize)
+                flags |= CirclesOverBed;
+            return flags;
+        }
+    private:
+        double bedSize;
+    };
+
+    enum ProtoFlags
+    {
+        ProtoFloorsOverlap = 1 << 0,    // inner and outer floors meet
+        ProtoLegRate = 1 << 1,          // volf leg is not narrower than the volf
+        ProtoTopTooth = 1 << 2,
+        ProtoBottomTooth = 1 << 3,
+        ProtoCutting = 1 << 4,          // cutting middle segment vanishes
+        ProtoOverBed = 1 << 5,
+        ProtoInvalid = 1 << 6,
+    };
+
+    class ProtoSweepDesign : public SweepDesign
+    {
+    public:
+        explicit ProtoSweepDesign(double bedSize) : bedSize(bedSize) {}
+
+        const char* name() const override { return "proto"; }
+
+        // Defaults are the arguments run() used to pass to RingsProtoCreator.
+        std::vector<SweepAxis> defaultAxes() const override
+        {
+            return {
+                { "outerRadius", 3.2, 3.2, 1 },
+                { "innerRadius", 2.4, 2.4, 1 },
+                { "volfCount", 12, 12, 1 },
+                { "wallThickness", 0.1, 0.1, 1 },
+                { "floorTopThickness", 0.3, 0.3, 1 },
+                { "floorBottomThickness", 0.3, 0.3, 1 },
+                { "volfLegRate", 0.25, 0.25, 1 },
+            };
+        }
+
+        std::vector<std::string> outputNames() const override
+        {
+            return { "volfAngel", "volfLegAngel", "baseOuterLength", "baseInnerLength", "cuttingMiidleLength",
+                "baseTopFloorToothSize", "baseBottomFloorToothSize", "volfHeadSize", "totalSize" };
+        }
+
+        std::vector<std::string> flagNames() const override
+        {
+            return { "floorsOverlap", "legRate", "topTooth", "bottomTooth", "cutting", "overBed", "invalid" };
+        }
+
+        uint32_t evaluate(const double* inputs, double* outputs) const override
+        {
+            RingsProtoCreatorParams params;
+            params.outerRadius = inputs[0];
+            params.innerRadius = inputs[1];
+            params.volfCount = (int)lround(inputs[2]);
+            params.wallThickness = inputs[3];
+            params.floorTopThickness = inputs[4];
+            params.floorBottomThickness = inputs[5];
+            params.volfLegRate = inputs[6];
+
+            if (params.volfCount < 1 || params.innerRadius <= 0)
+            {
+                for (int i = 0; i < 9; i++)
+                    outputs[i] = 0;
+                return ProtoInvalid;
+            }
+
+            RingsProtoCreatorLayout layout;
+            SolveRingsProtoCreatorLayout(params, layout);
+            auto totalSize = 2.0 * layout.volfTop;
+
+            outputs[0] = layout.volfAngel;
+            outputs[1] = layout.volfLegAngel;
+            outputs[2] = layout.baseOuterLength;
+            outputs[3] = layout.baseInnerLength;
+            outputs[4] = layout.cuttingMiidleLength;
+            outputs[5] = layout.baseTopFloorToothSize;
+            outputs[6] = layout.baseBottomFloorToothSize;
+            outputs[7] = layout.volfHeadSize;
+            outputs[8] = totalSize;
+
+            uint32_t flags = 0;
+            if (layout.cuttingInnerRadius >= layout.cuttingMiddleRadius)
+                flags |= ProtoFloorsOverlap;
+            if (params.volfLegRate <= 0 || params.volfLegRate >= 1)
+                flags |= ProtoLegRate;
+            if (layout.baseTopFloorToothSize <= 0)
+                flags |= ProtoTopTooth;
+            if (layout.baseBottomFloorToothSize <= 0)
+                flags |= ProtoBottomTooth;
+            if (layout.cuttingMiidleLength <= 0)
+                flags |= ProtoCutting;
+            if (totalSize > bedSize)
+                flags |= ProtoOverBed;
+            return flags;
+        }
+    private:
+        double bedSize;
+    };
+
+    enum GearsFlags
+    {
+        GearsLowContactRatio = 1 << 0,  // fewer than minContactRatio teeth in contact on average
+        GearsUndercut = 1 << 1,         // a tip runs below the other base circle, off the involute
+        GearsTipInterference = 1 << 2,  // a printed tip reaches the other root circle
+        GearsBinding = 1 << 3,          // printed flanks leave no backlash
+        GearsPointed = 1 << 4,          // flanks meet below the outside circle
+        GearsOverBed = 1 << 5,
+        GearsInvalid = 1 << 6,
+    };
+
+    class GearsSweepDesign : public SweepDesign
+    {
+    public:
+        explicit GearsSweepDesign(double bedSize) : bedSize(bedSize) {}
+
+        const char* name() const override { return "gears"; }
+
+        // Defaults are the gear of DexpSpurGear running with its copy.
+        std::vector<SweepAxis> defaultAxes() const override
+        {
+            return {
+                { "diametralPitch", 24.8, 24.8, 1 },
+                { "toothCount1", 66, 66, 1 },
+                { "toothCount2", 66, 66, 1 },
+                { "pressureAngle", 0.4, 0.4, 1 },
+                { "backlash", 0, 0, 1 },
+                { "printerHorizontalDelta", 0.04, 0.04, 1 },
+                { "centerDistance", 0, 0, 1 },
+            };
+        }
+
+        std::vector<std::string> outputNames() const override
+        {
+            return { "pitchDiameter1", "pitchDiameter2", "operatingCenterDistance", "contactRatio", "tipClearance",
+                "drawnBacklash", "effectiveBacklash", "transmissionError", "outsideDiameter" };
+        }
+
+        std::vector<std::string> flagNames() const override
+        {
+            return { "lowContactRatio", "undercut", "tipInterference", "binding", "pointed", "overBed", "invalid" };
+        }
+
+        uint32_t evaluate(const double* inputs, double* outputs) const override
+        {
+            GearPairParams params;
+            params.gear1.diametralPitch = params.gear2.diametralPitch = inputs[0];
+            params.gear1.toothCount = (int)lround(inputs[1]);
+            params.gear2.toothCount = (int)lround(inputs[2]);
+            params.gear1.pressureAngle = params.gear2.pressureAngle = inputs[3];
+            params.gear1.backlash = params.gear2.backlash = inputs[4];
+            params.printerHorizontalDelta = inputs[5];
+            params.centerDistance = inputs[6];
+
+            if (params.gear1.diametralPitch <= 0 || params.gear1.toothCount < 3 || params.gear2.toothCount < 3
+                || params.gear1.pressureAngle <= 0 || params.gear1.pressureAngle >= RAD_90)
+            {
+                for (int i = 0; i < 9; i++)
+                    outputs[i] = 0;
+                return GearsInvalid;
+            }
+
+            // the closed form checks first, the transmission error only for the pairs they pass
+            auto analysis = AnalyzeGearPair(params, 0);
+            auto outsideDiameter = 2.0 * GetGearDimensions(params.gear1.toothCount >= params.gear2.toothCount ? params.gear1 : params.gear2).outsideRadius;
+
+            uint32_t flags = 0;
+            if (analysis.contactRatio < minContactRatio)
+                flags |= GearsLowContactRatio;
+            if (analysis.isUndercut1 || analysis.isUndercut2)
+                flags |= GearsUndercut;
+            if (analysis.isTipInterference())
+                flags |= GearsTipInterference;
+            if (analysis.isBinding())
+                flags |= GearsBinding;
+            if (analysis.isPointed1 || analysis.isPointed2)
+                flags |= GearsPointed;
+            if (outsideDiameter > bedSize)
+                flags |= GearsOverBed;
+            if (flags == 0)
+                analysis.transmissionError = AnalyzeGearPair(params, transmissionSampleCount).transmissionError;
+
+            outputs[0] = 2.0 * GetGearDimensions(params.gear1).pitchRadius;
+            outputs[1] = 2.0 * GetGearDimensions(params.gear2).pitchRadius;
+            outputs[2] = analysis.centerDistance;
+            outputs[3] = analysis.contactRatio;
+            outputs[4] = analysis.tipClearance;
+            outputs[5] = analysis.backlash;
+            outputs[6] = analysis.effectiveBacklash;
+            outputs[7] = analysis.transmissionError;
+            outputs[8] = outsideDiameter;
+            return flags;
+        }
+    private:
+        double bedSize;
+        double minContactRatio = 1.2;
+        int transmissionSampleCount = 16;
+    };
+
+    uint64_t AlignUp(uint64_t value)
+    {
+        return (value + SWEEP_FILE_ALIGNMENT - 1) / SWEEP_FILE_ALIGNMENT * SWEEP_FILE_ALIGNMENT;
+    }
+}
+
+std::unique_ptr<SweepDesign> CreateSweepDesign(const std::string& kind, double bedSize, int clearanceSampleCount)
+{
+    if (kind == "squares")
+        return std::make_unique<SquaresSweepDesign>(bedSize, clearanceSampleCount);
+    if (kind == "circles")
+        return std::make_unique<CirclesSweepDesign>(bedSize);
+    if (kind == "proto")
+        return std::make_unique<ProtoSweepDesign>(bedSize);
+    if (kind == "gears")
+        return std::make_unique<GearsSweepDesign>(bedSize);
+    return nullptr;
+}
+
+bool RunSweep(const SweepDesign& design, const std::vector<SweepAxis>& axes, const SweepOptions& options, SweepSummary& summary, std::string& error)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    auto outputNames = design.outputNames();
+    auto flagNames = design.flagNames();
+    auto axisCount = axes.size();
+    auto outputCount = outputNames.size();
+
+    uint64_t rowCount = 1;
+    for (auto& axis : axes)
+    {
+        auto count = axis.count();
+        if (rowCount > UINT64_MAX / count)
+        {
+            error = "too many combinations";
+            return false;
+        }
+        rowCount *= count;
+    }
+
+    // input columns, derived columns, flags
+    std::vector<std::string> columnNames;
+    for (auto& axis : axes)
+        columnNames.push_back(axis.name);
+    for (auto& name : outputNames)
+        columnNames.push_back(name);
+    columnNames.push_back("flags");
+    uint32_t columnCount = (uint32_t)columnNames.size();
+
+    std::vector<SweepColumnEntry> columns(columnCount);
+    uint64_t offset = AlignUp(sizeof(SweepFileHeader) + columnCount * sizeof(SweepColumnEntry));
+    for (uint32_t i = 0; i < columnCount; i++)
+    {
+        auto& column = columns[i];
+        memset(&column, 0, sizeof(column));
+        strncpy(column.name, columnNames[i].c_str(), sizeof(column.name) - 1);
+        column.type = (uint32_t)(i + 1 == columnCount ? SweepColumnType::UInt32 : SweepColumnType::Double);
+        column.offset = offset;
+        offset = AlignUp(offset + rowCount * (i + 1 == columnCount ? sizeof(uint32_t) : sizeof(double)));
+    }
+    auto fileSize = offset;
+
+    auto fd = ::open(options.outPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        error = "cannot create " + options.outPath + ": " + strerror(errno);
+        return false;
+    }
+    if (ftruncate(fd, (off_t)fileSize) != 0)
+    {
+        error = "cannot resize " + options.outPath + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    auto data = (uint8_t*)mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        error = "cannot map " + options.outPath + ": " + strerror(errno);
+        return false;
+    }
+
+    auto header = (SweepFileHeader*)data;
+    memset(header, 0, sizeof(SweepFileHeader));
+    memcpy(header->magic, SWEEP_FILE_MAGIC, sizeof(header->magic));
+    header->version = SWEEP_FILE_VERSION;
+    header->columnCount = columnCount;
+    header->rowCount = rowCount;
+    memcpy(data + sizeof(SweepFileHeader), columns.data(), columnCount * sizeof(SweepColumnEntry));
+
+    std::vector<double*> inputColumns(axisCount);
+    std::vector<double*> outputColumns(outputCount);
+    for (size_t i = 0; i < axisCount; i++)
+        inputColumns[i] = (double*)(data + columns[i].offset);
+    for (size_t i = 0; i < outputCount; i++)
+        outputColumns[i] = (double*)(data + columns[axisCount + i].offset);
+    auto flagsColumn = (uint32_t*)(data + columns[columnCount - 1].offset);
+
+    auto threadCount = options.threadCount > 0 ? options.threadCount : (int)std::thread::hardware_concurrency();
+    if (threadCount < 1)
+        threadCount = 1;
+    auto chunkSize = options.chunkSize > 0 ? options.chunkSize : 4096;
+
+    std::atomic<uint64_t> nextRow(0);
+    std::vector<uint64_t> threadPassed(threadCount, 0);
+    std::vector<std::vector<uint64_t>> threadFlagCounts(threadCount, std::vector<uint64_t>(32, 0));
+
+    auto worker = [&](int threadIndex)
+    {
+        std::vector<uint64_t> digits(axisCount);
+        std::vector<double> inputs(axisCount);
+        std::vector<double> outputs(outputCount);
+        auto& flagCounts = threadFlagCounts[threadIndex];
+        uint64_t passed = 0;
+
+        while (true)
+        {
+            auto begin = nextRow.fetch_add(chunkSize);
+            if (begin >= rowCount)
+                break;
+            auto end = std::min(begin + chunkSize, rowCount);
+
+            // the last axis changes fastest
+            auto rest = begin;
+            for (size_t a = axisCount; a-- > 0;)
+            {
+                auto count = axes[a].count();
+                digits[a] = rest % count;
+                rest /= count;
+                inputs[a] = axes[a].value(digits[a]);
+            }
+
+            for (auto row = begin; row < end; row++)
+            {
+                auto flags = design.evaluate(inputs.data(), outputs.data());
+                for (size_t i = 0; i < axisCount; i++)
+                    inputColumns[i][row] = inputs[i];
+                for (size_t i = 0; i < outputCount; i++)
+                    outputColumns[i][row] = outputs[i];
+                flagsColumn[row] = flags;
+
+                if (flags == 0)
+                    passed++;
+                else
+                    for (int bit = 0; bit < 32; bit++)
+                        if (flags & (1u << bit))
+                            flagCounts[bit]++;
+
+                for (size_t a = axisCount; a-- > 0;)
+                {
+                    if (++digits[a] < axes[a].count())
+                    {
+                        inputs[a] = axes[a].value(digits[a]);
+                        break;
+                    }
+                    digits[a] = 0;
+                    inputs[a] = axes[a].value(0);
+                }
+            }
+        }
+        threadPassed[threadIndex] = passed;
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++)
+        threads.emplace_back(worker, i);
+    worker(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    summary = SweepSummary();
+    summary.rowCount = rowCount;
+    summary.flagCounts.assign(flagNames.size(), 0);
+    for (int i = 0; i < threadCount; i++)
+    {
+        summary.passedCount += threadPassed[i];
+        for (size_t bit = 0; bit < flagNames.size(); bit++)
+            summary.flagCounts[bit] += threadFlagCounts[i][bit];
+    }
+    header->passedCount = summary.passedCount;
+
+    munmap(data, fileSize);
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return true;
+}
+
+SweepFile::~SweepFile()
+{
+    if (data != nullptr)
+        munmap(data, size);
+}
+
+bool SweepFile::open(const std::string& path, std::string& error)
+{
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "cannot open " + path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(SweepFileHeader))
+    {
+        error = path + " is not a sweep file";
+        close(fd);
+        return false;
+    }
+    size = (size_t)st.st_size;
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        data = nullptr;
+        error = "cannot map " + path + ": " + strerror(errno);
+        return false;
+    }
+
+    if (memcmp(header()->magic, SWEEP_FILE_MAGIC, sizeof(SWEEP_FILE_MAGIC)) != 0 || header()->version != SWEEP_FILE_VERSION
+        || sizeof(SweepFileHeader) + columnCount() * sizeof(SweepColumnEntry) > size)
+    {
+        error = path + " is not a sweep file";
+        return false;
+    }
+    for (uint32_t i = 0; i < columnCount(); i++)
+    {
+        auto width = column(i).type == (uint32_t)SweepColumnType::Double ? sizeof(double) : sizeof(uint32_t);
+        if (column(i).offset + rowCount() * width > size)
+        {
+            error = path + " is truncated";
+            return false;
+        }
+    }
+    return true;
+}
+
+const SweepFileHeader* SweepFile::header() const
+{
+    return (const SweepFileHeader*)data;
+}
+
+uint64_t SweepFile::rowCount() const
+{
+    return header()->rowCount;
+}
+
+uint32_t SweepFile::columnCount() const
+{
+    return header()->columnCount;
+}
+
+const SweepColumnEntry& SweepFile::column(uint32_t index) const
+{
+    return ((const SweepColumnEntry*)((const uint8_t*)data + sizeof(SweepFileHeader)))[index];
+}
+
+int SweepFile::findColumn(const std::string& name) const
+{
+    for (uint32_t i = 0; i < columnCount(); i++)
+        if (name == column(i).name)
+            return (int)i;
+    return -1;
+}
+
+const double* SweepFile::doubles(uint32_t index) const
+{
+    return (const double*)((const uint8_t*)data + column(index).offset);
+}
+
+const uint32_t* SweepFile::uints(uint32_t index) const
+{
+    return (const uint32_t*)((const uint8_t*)data + column(index).offset);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Design-space sweep over the pure layout solvers. Every combination of the axis values is
+// evaluated on all cores and written straight into a memory-mapped columnar file:
+//
+//   SweepFileHeader (64 bytes)
+//   SweepColumnEntry[columnCount] (64 bytes each)
+//   column data, every column starts on a 64 byte boundary
+
+constexpr char SWEEP_FILE_MAGIC[8] = { 'R', 'S', 'W', 'E', 'E', 'P', '1', 0 };
+constexpr uint32_t SWEEP_FILE_VERSION = 1;
+constexpr uint64_t SWEEP_FILE_ALIGNMENT = 64;
+
+enum class SweepColumnType : uint32_t { Double = 0, UInt32 = 1 };
+
+struct SweepFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t columnCount;
+    uint64_t rowCount;
+    uint64_t passedCount;
+    uint8_t reserved[32];
+};
+
+struct SweepColumnEntry
+{
+    char name[48];
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+};
+
+static_assert(sizeof(SweepFileHeader) == 64, "sweep header must stay 64 bytes");
+static_assert(sizeof(SweepColumnEntry) == 64, "sweep column entry must stay 64 bytes");
+
+struct SweepAxis
+{
+    std::string name;
+    double from = 0;
+    double to = 0;
+    double step = 1;
+
+    uint64_t count() const;
+    double value(uint64_t index) const;
+};
+
+// Accepts "from:to:step", "from:to" (step 1) or a single value.
+bool ParseSweepAxis(const std::string& text, SweepAxis& axis);
+
+class SweepDesign
+{
+public:
+    virtual ~SweepDesign() = default;
+    virtual const char* name() const = 0;
+    // Axes with their default (single) values, in the order evaluate() receives them.
+    virtual std::vector<SweepAxis> defaultAxes() const = 0;
+    // Derived double columns written after the input columns.
+    virtual std::vector<std::string> outputNames() const = 0;
+    virtual std::vector<std::string> flagNames() const = 0;
+    // inputs holds one value per axis; returns the feasibility flags, 0 means the variant passed.
+    virtual uint32_t evaluate(const double* inputs, double* outputs) const = 0;
+};
+
+// kind is "squares", "circles", "proto" or "gears"; bedSize is the printer bed edge in cm.
+// clearanceSampleCount turns on the sampled volf clearance check of squares, 0 leaves it off.
+std::unique_ptr<SweepDesign> CreateSweepDesign(const std::string& kind, double bedSize, int clearanceSampleCount = 0);
+
+struct SweepOptions
+{
+    std::string outPath;
+    int threadCount = 0; // 0 - all cores
+    uint64_t chunkSize = 4096;
+};
+
+struct SweepSummary
+{
+    uint64_t rowCount = 0;
+    uint64_t passedCount = 0;
+    std::vector<uint64_t> flagCounts;
+    double seconds = 0;
+};
+
+bool RunSweep(const SweepDesign& design, const std::vector<SweepAxis>& axes, const SweepOptions& options, SweepSummary& summary, std::string& error);
+
+class SweepFile
+{
+public:
+    ~SweepFile();
+    bool open(const std::string& path, std::string& error);
+    uint64_t rowCount() const;
+    uint32_t columnCount() const;
+    const SweepColumnEntry& column(uint32_t index) const;
+    int findColumn(const std::string& name) const;
+    const double* doubles(uint32_t index) const;
+    const uint32_t* uints(uint32_t index) const;
+private:
+    void* data = nullptr;
+    size_t size = 0;
+    const SweepFileHeader* header() const;
+};
\ No newline at end of file
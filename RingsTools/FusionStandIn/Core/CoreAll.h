@@ -0,0 +1,131 @@
+#pragma once
+// A recording stand-in for the part of the Fusion core API the headless checks compile
+// against. Objects hold only what the checks read back, every call that makes something
+// is appended to RecordedCalls. It is not the API: nothing is computed, a body is a
+// name and a temporary flag.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace adsk {
+namespace core {
+
+inline std::vector<std::string>& RecordedCalls()
+{
+    static std::vector<std::string> calls;
+    return calls;
+}
+
+inline void RecordCall(const std::string& call)
+{
+    RecordedCalls().push_back(call);
+}
+
+template <class T> class Ptr
+{
+public:
+    Ptr() {}
+    Ptr(std::nullptr_t) {}
+    Ptr(std::shared_ptr<T> object) : object(object) {}
+    template <class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+    Ptr(const Ptr<U>& other) : object(other.get()) {}
+
+    T* operator->() const { return object.get(); }
+    explicit operator bool() const { return object != nullptr; }
+    std::shared_ptr<T> get() const { return object; }
+
+    bool operator==(std::nullptr_t) const { return object == nullptr; }
+    bool operator!=(std::nullptr_t) const { return object != nullptr; }
+    template <class U> bool operator==(const Ptr<U>& other) const { return object == other.get(); }
+    template <class U> bool operator!=(const Ptr<U>& other) const { return object != other.get(); }
+
+private:
+    std::shared_ptr<T> object;
+};
+
+class Base : public std::enable_shared_from_this<Base>
+{
+public:
+    virtual ~Base() {}
+    bool isValid() const { return true; }
+    template <class T> Ptr<T> cast() { return std::dynamic_pointer_cast<T>(shared_from_this()); }
+};
+
+template <class T, class... Args> Ptr<T> MakeStandIn(Args&&... args)
+{
+    return Ptr<T>(std::make_shared<T>(std::forward<Args>(args)...));
+}
+
+class Vector3D : public Base
+{
+public:
+    double x_, y_, z_;
+
+    Vector3D(double x, double y, double z) : x_(x), y_(y), z_(z) {}
+    static Ptr<Vector3D> create(double x = 0, double y = 0, double z = 0) { return MakeStandIn<Vector3D>(x, y, z); }
+    double x() const { return x_; }
+    double y() const { return y_; }
+    double z() const { return z_; }
+    bool normalize() { return true; }
+    bool scaleBy(double scale) { x_ *= scale; y_ *= scale; z_ *= scale; return true; }
+};
+
+class Point3D : public Base
+{
+public:
+    double x_, y_, z_;
+
+    Point3D(double x, double y, double z) : x_(x), y_(y), z_(z) {}
+    static Ptr<Point3D> create(double x = 0, double y = 0, double z = 0) { return MakeStandIn<Point3D>(x, y, z); }
+    double x() const { return x_; }
+    double y() const { return y_; }
+    double z() const { return z_; }
+};
+
+class Matrix3D : public Base
+{
+public:
+    static Ptr<Matrix3D> create() { return MakeStandIn<Matrix3D>(); }
+    bool translation(Ptr<Vector3D> /*vector*/) { return true; }
+    bool setToRotation(double /*angle*/, Ptr<Vector3D> /*axis*/, Ptr<Point3D> /*origin*/) { return true; }
+};
+
+class BoundingBox3D : public Base {};
+
+class OrientedBoundingBox3D : public Base
+{
+public:
+    static Ptr<OrientedBoundingBox3D> create(Ptr<Point3D> /*centerPoint*/, Ptr<Vector3D> /*lengthDirection*/, Ptr<Vector3D> /*widthDirection*/,
+        double /*length*/, double /*width*/, double /*height*/)
+    {
+        return MakeStandIn<OrientedBoundingBox3D>();
+    }
+};
+
+class ObjectCollection : public Base
+{
+public:
+    static Ptr<ObjectCollection> create() { return MakeStandIn<ObjectCollection>(); }
+    bool add(Ptr<Base> item) { items.push_back(item); return true; }
+    bool removeByIndex(size_t index) { items.erase(items.begin() + index); return true; }
+    size_t count() const { return items.size(); }
+    Ptr<Base> item(size_t index) const { return items[index]; }
+
+private:
+    std::vector<Ptr<Base>> items;
+};
+
+class ValueInput : public Base
+{
+public:
+    static Ptr<ValueInput> createByReal(double /*value*/) { return MakeStandIn<ValueInput>(); }
+};
+
+enum DialogResults { DialogError = -1, DialogOK = 0, DialogCancel = 1, DialogYes = 2, DialogNo = 3 };
+enum MessageBoxButtonTypes { OKButtonType = 0, OKCancelButtonType = 1, RetryCancelButtonType = 2, YesNoButtonType = 3, YesNoCancelButtonType = 4 };
+
+}
+}
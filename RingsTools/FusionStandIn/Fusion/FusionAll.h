@@ -0,0 +1,226 @@
+#pragma once
+// The fusion half of the recording stand-in, see Core/CoreAll.h. Timeline features are
+// recorded by their kind ("BaseFeature", "Move"), the temporary B-rep calls with the
+// "Temporary" prefix.
+
+#include "../Core/CoreAll.h"
+
+namespace adsk {
+namespace fusion {
+
+using adsk::core::Base;
+using adsk::core::Ptr;
+using adsk::core::MakeStandIn;
+using adsk::core::RecordCall;
+
+enum FeatureOperations { JoinFeatureOperation, CutFeatureOperation, IntersectFeatureOperation, NewBodyFeatureOperation, NewComponentFeatureOperation };
+enum BooleanTypes { DifferenceBooleanType, IntersectionBooleanType, UnionBooleanType };
+enum DesignTypes { DirectDesignType, ParametricDesignType };
+
+class Component;
+
+class BRepBody : public Base
+{
+public:
+    bool isTemporary_;
+
+    explicit BRepBody(bool isTemporary) : isTemporary_(isTemporary) {}
+    bool isTemporary() const { return isTemporary_; }
+    Ptr<BRepBody> copyToComponent(Ptr<Component> /*component*/)
+    {
+        RecordCall("CopyBody");
+        return MakeStandIn<BRepBody>(false);
+    }
+};
+
+class BaseFeature : public Base
+{
+public:
+    bool startEdit() { return true; }
+    bool finishEdit() { return true; }
+};
+
+class BRepBodies : public Base
+{
+public:
+    std::vector<Ptr<BRepBody>> bodies;
+
+    size_t count() const { return bodies.size(); }
+    Ptr<BRepBody> item(size_t index) const { return bodies[index]; }
+    // the body gets into the design as a new design body
+    Ptr<BRepBody> add(Ptr<BRepBody> /*body*/, Ptr<BaseFeature> /*baseFeature*/ = nullptr)
+    {
+        auto designBody = MakeStandIn<BRepBody>(false);
+        bodies.push_back(designBody);
+        return designBody;
+    }
+};
+
+class BaseFeatures : public Base
+{
+public:
+    Ptr<BaseFeature> add()
+    {
+        RecordCall("BaseFeature");
+        return MakeStandIn<BaseFeature>();
+    }
+};
+
+class ConstructionAxis : public Base
+{
+public:
+    Ptr<adsk::core::Vector3D> direction;
+
+    explicit ConstructionAxis(Ptr<adsk::core::Vector3D> direction) : direction(direction) {}
+};
+
+class MoveFeatureInput : public Base
+{
+public:
+    bool defineAsTranslateAlongEntity(Ptr<Base> /*linearEntity*/, Ptr<adsk::core::ValueInput> /*distance*/) { return true; }
+    bool defineAsRotate(Ptr<Base> /*axisEntity*/, Ptr<adsk::core::ValueInput> /*angle*/) { return true; }
+};
+
+class MoveFeatures : public Base
+{
+public:
+    Ptr<MoveFeatureInput> createInput2(Ptr<adsk::core::ObjectCollection> /*inputEntities*/) { return MakeStandIn<MoveFeatureInput>(); }
+    Ptr<Base> add(Ptr<MoveFeatureInput> /*input*/)
+    {
+        RecordCall("Move");
+        return MakeStandIn<Base>();
+    }
+};
+
+class Features : public Base
+{
+public:
+    Ptr<BaseFeatures> baseFeatures() { return MakeStandIn<BaseFeatures>(); }
+    Ptr<MoveFeatures> moveFeatures() { return MakeStandIn<MoveFeatures>(); }
+};
+
+class Design : public Base
+{
+public:
+    DesignTypes designType_ = ParametricDesignType;
+
+    DesignTypes designType() const { return designType_; }
+};
+
+class ConstructionPlane : public Base {};
+
+class Component : public Base
+{
+public:
+    Ptr<Design> design = MakeStandIn<Design>();
+    Ptr<BRepBodies> bodies = MakeStandIn<BRepBodies>();
+
+    Ptr<Design> parentDesign() const { return design; }
+    Ptr<BRepBodies> bRepBodies() const { return bodies; }
+    Ptr<Features> features() const { return MakeStandIn<Features>(); }
+    Ptr<ConstructionPlane> xYConstructionPlane() const { return MakeStandIn<ConstructionPlane>(); }
+    Ptr<ConstructionAxis> xConstructionAxis() const { return MakeStandIn<ConstructionAxis>(adsk::core::Vector3D::create(1, 0, 0)); }
+    Ptr<ConstructionAxis> yConstructionAxis() const { return MakeStandIn<ConstructionAxis>(adsk::core::Vector3D::create(0, 1, 0)); }
+    Ptr<ConstructionAxis> zConstructionAxis() const { return MakeStandIn<ConstructionAxis>(adsk::core::Vector3D::create(0, 0, 1)); }
+};
+
+class TemporaryBRepManager : public Base
+{
+public:
+    // makes every booleanOperation fail, as the kernel does on some inputs
+    bool isFailingBooleans = false;
+
+    static Ptr<TemporaryBRepManager> get()
+    {
+        static auto manager = MakeStandIn<TemporaryBRepManager>();
+        return manager;
+    }
+    Ptr<BRepBody> createBox(Ptr<adsk::core::OrientedBoundingBox3D> /*box*/) { return createBody("TemporaryBox"); }
+    Ptr<BRepBody> createCylinderOrCone(Ptr<adsk::core::Point3D> /*pointOne*/, double /*pointOneRadius*/, Ptr<adsk::core::Point3D> /*pointTwo*/, double /*pointTwoRadius*/)
+    {
+        return createBody("TemporaryCylinder");
+    }
+    Ptr<BRepBody> createSphere(Ptr<adsk::core::Point3D> /*center*/, double /*radius*/) { return createBody("TemporarySphere"); }
+    Ptr<BRepBody> copy(Ptr<Base> /*body*/) { return createBody("TemporaryCopy"); }
+    bool transform(Ptr<BRepBody> /*body*/, Ptr<adsk::core::Matrix3D> /*transform*/)
+    {
+        RecordCall("TemporaryTransform");
+        return true;
+    }
+    bool booleanOperation(Ptr<BRepBody> /*targetBody*/, Ptr<BRepBody> /*toolBody*/, BooleanTypes /*booleanType*/)
+    {
+        RecordCall("TemporaryBoolean");
+        return !isFailingBooleans;
+    }
+
+private:
+    static Ptr<BRepBody> createBody(const std::string& call)
+    {
+        RecordCall(call);
+        return MakeStandIn<BRepBody>(true);
+    }
+};
+
+// declared only, the checks do not reach them
+class BRepEdge : public Base {};
+class BRepFace : public Base {};
+class Profile : public Base {};
+class SketchCircle : public Base {};
+class SketchArc : public Base {};
+class SectionAnalysis : public Base {};
+class ConstructionPoint : public Base {};
+class Occurrence : public Base {};
+class FilletFeature : public Base {};
+
+class Profiles : public Base
+{
+public:
+    size_t count() const { return 1; }
+    Ptr<Profile> item(size_t /*index*/) const { return MakeStandIn<Profile>(); }
+};
+
+class Sketch : public Base
+{
+public:
+    Ptr<Profiles> profiles() const { return MakeStandIn<Profiles>(); }
+};
+
+class SketchPoint : public Base
+{
+public:
+    Ptr<adsk::core::Point3D> geometry() const { return adsk::core::Point3D::create(); }
+};
+
+class SketchLine : public Base
+{
+public:
+    Ptr<SketchPoint> startSketchPoint() const { return MakeStandIn<SketchPoint>(); }
+    Ptr<SketchPoint> endSketchPoint() const { return MakeStandIn<SketchPoint>(); }
+};
+
+class ExtrudeFeature : public Base
+{
+public:
+    Ptr<BRepBodies> bodies_ = MakeStandIn<BRepBodies>();
+
+    Ptr<BRepBodies> bodies() const { return bodies_; }
+};
+
+class CombineFeature : public Base
+{
+public:
+    Ptr<BRepBodies> bodies_ = MakeStandIn<BRepBodies>();
+
+    Ptr<BRepBodies> bodies() const { return bodies_; }
+};
+
+class RevolveFeature : public Base
+{
+public:
+    Ptr<BRepBodies> bodies_ = MakeStandIn<BRepBodies>();
+
+    Ptr<BRepBodies> bodies() const { return bodies_; }
+};
+
+}
+}
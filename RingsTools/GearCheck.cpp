@@ -0,0 +1,146 @@
+// Checks the tooth profiles of GearProfile against the closed form involute for a range of
+// tooth counts, pressure angles, pitches and backlashes, exits with 1 if any fails.
+// Build on Linux from this directory with:
+//   g++ -O2 -std=c++14 -o GearCheck GearCheck.cpp ../RingsProto/Geometry.cpp ../RingsProto/GearProfile.cpp
+//
+//   GearCheck
+//   GearCheck --tolerance 0.00001 --verbose
+
+#include "../RingsProto/GearProfile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static void PrintUsage()
+{
+    printf("usage: GearCheck [--tolerance 0.0001] [--verbose]\n");
+}
+
+// The worst deviations of one profile, all in centimeters.
+struct ProfileErrors
+{
+    double pitchPoint = 0;  // the involute at the pitch radius from the pitch circle and -pitchHalfAngle
+    double sampledPitchPoint = 0; // the same of the flank crossing the pitch circle
+    double involute = 0;    // flank samples from the involute of their radius
+    double sag = 0;         // chords from the curve between their ends
+    double tip = 0;         // the tip from the outside circle, or a pointed tip from the axis
+};
+
+static double GetPolarAngleError(double radius, double angle, double expectedAngle)
+{
+    return radius * fabs(remainder(angle - expectedAngle, 2.0 * M_PI));
+}
+
+static ProfileErrors CheckProfile(const GearParams& params, double chordTolerance)
+{
+    ProfileErrors errors;
+    auto profile = GetGearToothProfile(params, chordTolerance);
+    auto& dimensions = profile.dimensions;
+    auto baseRadius = dimensions.baseRadius;
+    auto rotation = -(GetInvolute(params.pressureAngle) + dimensions.pitchHalfAngle);
+
+    // the pitch point closed form: tan(a) - a turned by the rotation, at the pitch radius
+    auto pitchRoll = GetInvoluteRoll(baseRadius, dimensions.pitchRadius);
+    double pitchX, pitchY;
+    EvaluateInvolute(baseRadius, rotation, &pitchRoll, 1, &pitchX, &pitchY);
+    errors.pitchPoint = fabs(hypot(pitchX, pitchY) - dimensions.pitchRadius) +
+        GetPolarAngleError(dimensions.pitchRadius, atan2(pitchY, pitchX), -dimensions.pitchHalfAngle);
+
+    auto& xs = profile.flankXs;
+    auto& ys = profile.flankYs;
+    for (size_t i = 0; i < xs.size(); i++)
+    {
+        auto radius = hypot(xs[i], ys[i]);
+        auto angle = GetInvolute(acos(std::min(1.0, baseRadius / radius))) + rotation;
+        // the meeting point of a pointed tooth is moved onto the axis
+        if (profile.isPointed() && i + 1 == xs.size())
+            continue;
+        errors.involute = std::max(errors.involute, GetPolarAngleError(radius, atan2(ys[i], xs[i]), angle));
+    }
+
+    for (size_t i = 0; i + 1 < xs.size(); i++)
+    {
+        auto radius1 = hypot(xs[i], ys[i]);
+        auto radius2 = hypot(xs[i + 1], ys[i + 1]);
+        if (radius1 <= dimensions.pitchRadius && radius2 > dimensions.pitchRadius)
+        {
+            auto part = (dimensions.pitchRadius - radius1) / (radius2 - radius1);
+            auto x = xs[i] + (xs[i + 1] - xs[i]) * part;
+            auto y = ys[i] + (ys[i + 1] - ys[i]) * part;
+            errors.sampledPitchPoint = GetPolarAngleError(dimensions.pitchRadius, atan2(y, x), -dimensions.pitchHalfAngle);
+        }
+
+        auto roll1 = GetInvoluteRoll(baseRadius, radius1);
+        auto roll2 = GetInvoluteRoll(baseRadius, radius2);
+        auto length = hypot(xs[i + 1] - xs[i], ys[i + 1] - ys[i]);
+        if (length == 0)
+            continue;
+        for (int k = 1; k < 8; k++)
+        {
+            auto roll = roll1 + (roll2 - roll1) * k / 8;
+            double x, y;
+            EvaluateInvolute(baseRadius, rotation, &roll, 1, &x, &y);
+            auto sag = fabs((xs[i + 1] - xs[i]) * (y - ys[i]) - (ys[i + 1] - ys[i]) * (x - xs[i])) / length;
+            errors.sag = std::max(errors.sag, sag);
+        }
+    }
+
+    if (profile.isPointed())
+        errors.tip = fabs(ys.back());
+    else
+        errors.tip = fabs(hypot(profile.tipXs.back(), profile.tipYs.back()) - dimensions.outsideRadius) + fabs(profile.tipYs.back());
+    return errors;
+}
+
+int main(int argc, char** argv)
+{
+    auto chordTolerance = 0.0001;
+    auto isVerbose = false;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--verbose")
+        {
+            isVerbose = true;
+            continue;
+        }
+        if (option == "--tolerance" && i + 1 < argc)
+            chordTolerance = atof(argv[++i]);
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    auto checkCount = 0;
+    auto failCount = 0;
+    for (auto toothCount : { 6, 8, 12, 17, 24, 66, 200 })
+        for (auto pressureAngle : { 14.5, 20.0, 25.0 })
+            for (auto diametralPitch : { 2.0, 24.8, 64.0 })
+                for (auto backlash : { 0.0, 0.01 })
+                {
+                    GearParams params;
+                    params.toothCount = toothCount;
+                    params.pressureAngle = pressureAngle * M_PI / 180.0;
+                    params.diametralPitch = diametralPitch;
+                    params.backlash = backlash;
+                    auto errors = CheckProfile(params, chordTolerance);
+                    // the flank crossing is on a chord off the curve by the sag at most, the flank
+                    // meets the pitch circle at the pressure angle so the crossing moves sag / cos along it
+                    auto isOk = errors.pitchPoint < 1e-12 && errors.involute < 1e-12 && errors.tip < 1e-12 &&
+                        errors.sag <= chordTolerance * 1.05 &&
+                        errors.sampledPitchPoint <= chordTolerance / cos(params.pressureAngle) * 1.05;
+                    checkCount++;
+                    if (!isOk)
+                        failCount++;
+                    if (!isOk || isVerbose)
+                        printf("%s %3d teeth %4.1f deg %5.1f dp backlash %.2f: pitch point %.1e sampled %.1e involute %.1e sag %.1e tip %.1e\n",
+                            isOk ? "ok  " : "FAIL", toothCount, pressureAngle, diametralPitch, backlash, errors.pitchPoint,
+                            errors.sampledPitchPoint, errors.involute, errors.sag, errors.tip);
+                }
+    printf("%d of %d profiles within %g cm\n", checkCount - failCount, checkCount, chordTolerance);
+    return failCount == 0 ? 0 : 1;
+}
\ No newline at end of file
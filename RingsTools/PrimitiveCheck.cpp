@@ -0,0 +1,279 @@
+// Builds LinkingPart and VolfUpPart against the recording stand-in of the Fusion API in
+// FusionStandIn, with and without transient primitives, and counts the timeline features
+// they emit. Exits with 1 when the transient path emits more than its budget or a failed
+// temporary boolean does not fall back to a combine feature.
+// Build on Linux from this directory with:
+//   g++ -O2 -std=c++14 -IFusionStandIn -o PrimitiveCheck PrimitiveCheck.cpp ../RingsProto/FusionPrimitives.cpp ../RingsProto/VolfUpPart.cpp
+//
+//   PrimitiveCheck
+//   PrimitiveCheck --verbose
+
+#include "../RingsProto/LinkingPart.h"
+#include "../RingsProto/VolfUpPart.h"
+#include "../RingsProto/FilletPlanner.h"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+
+static void PrintUsage()
+{
+    printf("usage: PrimitiveCheck [--verbose]\n");
+}
+
+// The FusionEnvironment helpers the primitives and the parts call, outside FusionPrimitives.cpp.
+// Each records the timeline features the real one adds.
+
+void MarkDesignModified()
+{
+}
+
+Ptr<Vector3D> ConstructionAxisToVector3D(Ptr<ConstructionAxis> axis)
+{
+    return Vector3D::create(axis->direction->x(), axis->direction->y(), axis->direction->z());
+}
+
+VectorPoint ConstructionAxisToVectorPoint(Ptr<ConstructionAxis> axis)
+{
+    VectorPoint vectorPoint;
+    vectorPoint.vector = ConstructionAxisToVector3D(axis);
+    vectorPoint.point = Point3D::create();
+    return vectorPoint;
+}
+
+Ptr<Sketch> CreateSketch(Ptr<Component> /*component*/, Ptr<ConstructionPlane> /*plane*/, std::string /*name*/)
+{
+    RecordCall("Sketch");
+    return MakeStandIn<Sketch>();
+}
+
+Ptr<SketchCircle> AddCircle(Ptr<Sketch> /*sketch*/, Ptr<Point3D> /*circleCentr*/, double /*radius*/)
+{
+    return MakeStandIn<SketchCircle>();
+}
+
+Ptr<SketchArc> AddArc(Ptr<Sketch> /*sketch*/, Ptr<Point3D> /*circleCentr*/, Ptr<Point3D> /*startPoint*/, Ptr<Point3D> /*endPoint*/)
+{
+    return MakeStandIn<SketchArc>();
+}
+
+Ptr<SketchLine> AddLine(Ptr<Sketch> /*sketch*/, Ptr<Base> /*startPoint*/, Ptr<Base> /*endPoint*/)
+{
+    return MakeStandIn<SketchLine>();
+}
+
+template <class T> static Ptr<T> CreateBodyFeature(const char* call)
+{
+    RecordCall(call);
+    auto feature = MakeStandIn<T>();
+    feature->bodies_->bodies.push_back(MakeStandIn<BRepBody>(false));
+    return feature;
+}
+
+Ptr<RevolveFeature> Revolve(Ptr<Component> /*component*/, Ptr<Sketch> /*sketch*/, Ptr<ConstructionAxis> /*axis*/, double /*angelRad*/)
+{
+    return CreateBodyFeature<RevolveFeature>("Revolve");
+}
+
+Ptr<ExtrudeFeature> Extrude(Ptr<Component> /*component*/, Ptr<Profile> /*profile*/, double /*distance*/, bool /*isSymetric*/)
+{
+    return CreateBodyFeature<ExtrudeFeature>("Extrude");
+}
+
+Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> /*component*/, FeatureOperations /*operation*/, Ptr<BRepBody> body, Ptr<ObjectCollection> toolBodies)
+{
+    for (size_t i = 0; i < toolBodies->count(); i++)
+        if (toolBodies->item(i)->cast<BRepBody>()->isTemporary())
+            RecordCall("TemporaryTool");
+    if (body->isTemporary())
+        RecordCall("TemporaryTool");
+    return CreateBodyFeature<CombineFeature>("Combine");
+}
+
+Ptr<CombineFeature> CreateCombineFeature(Ptr<Component> component, FeatureOperations operation, Ptr<BRepBody> body1, Ptr<BRepBody> body2)
+{
+    auto toolBodies = ObjectCollection::create();
+    toolBodies->add(body2);
+    return CreateCombineFeature(component, operation, body1, toolBodies);
+}
+
+Ptr<ObjectCollection> GetEdges(Ptr<BRepBody> /*body*/, std::function <bool(Ptr<BRepEdge>)> /*isGoodEdge*/)
+{
+    return ObjectCollection::create();
+}
+
+bool EdgeIsVerticalLine(Ptr<BRepEdge> /*edge*/)
+{
+    return true;
+}
+
+Ptr<FilletFeature> Fillet(Ptr<Component> /*component*/, Ptr<ObjectCollection> /*edges*/, double /*val*/)
+{
+    RecordCall("Fillet");
+    return MakeStandIn<FilletFeature>();
+}
+
+// The part helpers VolfUpPart uses: the cache always misses, the planner makes one fillet
+// feature per pass as it does when the merged feature succeeds.
+
+BodyCacheKey::BodyCacheKey(const std::string& partName) : partName(partName), hash(0)
+{
+}
+
+BodyCacheKey& BodyCacheKey::add(double value)
+{
+    values.push_back(value);
+    return *this;
+}
+
+Ptr<BRepBody> BodyCache::find(Ptr<Component> /*component*/, const BodyCacheKey& /*key*/, Ptr<Point3D> /*origin*/)
+{
+    return nullptr;
+}
+
+void BodyCache::add(const BodyCacheKey& /*key*/, Ptr<BRepBody> /*body*/, Ptr<Point3D> /*origin*/)
+{
+}
+
+bool IsHorizontalEdge(const BodyTopology& /*topology*/, int /*edge*/)
+{
+    return true;
+}
+
+void FilletPlanner::add(EdgeRule isGoodEdge, double radius, EdgeNarrowing narrowing)
+{
+    passes.back().push_back({ isGoodEdge, radius, narrowing });
+}
+
+int FilletPlanner::fillet(Ptr<Component> /*component*/, Ptr<BRepBody> /*body*/)
+{
+    for (size_t i = 0; i < passes.size(); i++)
+        RecordCall("Fillet");
+    return (int)passes.size();
+}
+
+static const std::set<std::string> TimelineFeatures = { "Sketch", "Extrude", "Revolve", "Move", "Combine", "Fillet", "BaseFeature" };
+
+struct Emitted
+{
+    int timelineFeatures = 0;
+    int temporaryCalls = 0;
+    int temporaryTools = 0;
+    std::map<std::string, int> calls;
+};
+
+static Emitted Count(bool isVerbose, const char* name)
+{
+    Emitted emitted;
+    for (auto& call : RecordedCalls())
+    {
+        emitted.calls[call]++;
+        if (TimelineFeatures.count(call) != 0)
+            emitted.timelineFeatures++;
+        else if (call == "TemporaryTool")
+            emitted.temporaryTools++;
+        else if (call.compare(0, 9, "Temporary") == 0)
+            emitted.temporaryCalls++;
+    }
+    if (isVerbose)
+    {
+        printf("%s:", name);
+        for (auto& call : emitted.calls)
+            printf(" %s %d", call.first.c_str(), call.second);
+        printf("\n");
+    }
+    RecordedCalls().clear();
+    return emitted;
+}
+
+static Ptr<BRepBody> BuildLinkers(Ptr<Component> component, int count)
+{
+    LinkingPart linkingPart;
+    linkingPart.radius = 0.5;
+    linkingPart.height = 1.2;
+    linkingPart.z = 0.3;
+    linkingPart.wallThickness = 0.12;
+    linkingPart.floorThickness = 0.1;
+    linkingPart.floorHoleRadius = 0.15;
+    std::vector<Ptr<Point3D>> centers;
+    for (int i = 0; i < count; i++)
+        centers.push_back(Point3D::create(i * 2.0, 1.0));
+    return linkingPart.createBodies(component, centers);
+}
+
+static Ptr<BRepBody> BuildVolfUp(Ptr<Component> component)
+{
+    VolfUpPart volfUpPart;
+    volfUpPart.radius = 0.8;
+    volfUpPart.height = 0.6;
+    volfUpPart.middleRadius = 0.5;
+    volfUpPart.middleHeight = 0.2;
+    volfUpPart.holeRadius = 0.2;
+    volfUpPart.holeHeight = 0.4;
+    volfUpPart.holeUpRadius = 0.3;
+    volfUpPart.holeUpHeight = 0.1;
+    volfUpPart.holeDownRadius = 0.3;
+    volfUpPart.holeDownHeight = 0.1;
+    volfUpPart.zMoveShift = 0.5;
+    volfUpPart.filletRadius = 0.05;
+    volfUpPart.form = VolfUpPart::concave;
+    volfUpPart.concaveHeight = 0.05;
+    volfUpPart.concaveRadius = 1.5;
+    volfUpPart.centerPoint = Point3D::create();
+    return volfUpPart.createBody(component);
+}
+
+int main(int argc, char** argv)
+{
+    auto isVerbose = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--verbose") == 0)
+        {
+            isVerbose = true;
+            continue;
+        }
+        PrintUsage();
+        return 1;
+    }
+
+    auto component = MakeStandIn<Component>();
+    auto checkCount = 0;
+    auto failCount = 0;
+    auto check = [&](const char* name, const std::function<Ptr<BRepBody>()>& build, int maxTransientFeatures)
+    {
+        SetTransientPrimitives(false);
+        build();
+        auto features = Count(isVerbose, name);
+        SetTransientPrimitives(true);
+        auto body = build();
+        auto transient = Count(isVerbose, name);
+        // a part body leaves the transient path committed, with no temporary tool in a feature
+        auto isFailed = transient.timelineFeatures > maxTransientFeatures || transient.temporaryTools > 0 || body == nullptr || body->isTemporary();
+        checkCount++;
+        failCount += isFailed ? 1 : 0;
+        printf("%s %-24s features %3d, transient %3d (at most %d) and %3d temporary calls\n",
+            isFailed ? "FAIL" : "ok  ", name, features.timelineFeatures, transient.timelineFeatures, maxTransientFeatures, transient.temporaryCalls);
+    };
+
+    // LinkingPart is a cylinder chain, it commits once
+    check("LinkingPart", [&]() { return BuildLinkers(component, 1); }, 1);
+    check("LinkingPart x8", [&]() { return BuildLinkers(component, 8); }, 1);
+    // VolfUpPart commits before its fillets, one fillet pass and the final move follow
+    check("VolfUpPart", [&]() { return BuildVolfUp(component); }, 3);
+    // the two boxes and four cylinders of a rounded box take one commit, not a sketch, extrude and fillet
+    check("rounded box", [&]() { return CommitBody(component, CreateBox(component, Point3D::create(-1, -1), Point3D::create(1, 2), 0.5, 0.25)); }, 1);
+
+    // a failed temporary boolean is done again by a combine feature of the committed bodies
+    TemporaryBRepManager::get()->isFailingBooleans = true;
+    check("failed boolean", [&]()
+    {
+        auto body = CreateBox(component, Point3D::create(-1, -1), Point3D::create(1, 1), 0.5);
+        return Combine(component, CutFeatureOperation, body, CreateCylinder(component, Point3D::create(), 0.5, 0.5));
+    }, 3);
+    TemporaryBRepManager::get()->isFailingBooleans = false;
+
+    printf("%d of %d checks passed\n", checkCount - failCount, checkCount);
+    return failCount == 0 ? 0 : 1;
+}
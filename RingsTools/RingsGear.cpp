@@ -0,0 +1,102 @@
+// Writes the gear of drawGear as an STL straight from its outline, twisted layer by layer
+// instead of the swept tooth Fusion builds for a twist. The defaults are the DexpSpurGear gear.
+// Build on Linux from this directory with:
+//   g++ -O2 -std=c++14 -o RingsGear RingsGear.cpp ../RingsProto/Geometry.cpp ../RingsProto/GearProfile.cpp
+//       ../RingsProto/GearMesh.cpp ../RingsProto/MeshBody.cpp ../RingsProto/StlWriter.cpp
+//
+//   RingsGear --out models/Gear.stl
+//   RingsGear --toothCount 33 --herringbone --tolerance 0.0002 --out models/Gear33.stl
+
+#include "../RingsProto/GearMesh.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static GearMeshParams GetDexpSpurGearParams()
+{
+    GearMeshParams params;
+    params.gear.diametralPitch = 24.8;
+    params.gear.toothCount = 66;
+    params.gear.pressureAngle = 0.4;
+    params.thickness = 0.84;
+    params.twist = 2 * M_PI / params.gear.toothCount / 2.1;
+    return params;
+}
+
+static void PrintUsage()
+{
+    auto params = GetDexpSpurGearParams();
+    printf("usage: RingsGear [--diametralPitch %g] [--toothCount %d] [--pressureAngle %g] [--backlash %g]\n",
+        params.gear.diametralPitch, params.gear.toothCount, params.gear.pressureAngle, params.gear.backlash);
+    printf("                 [--thickness %g] [--twist %g] [--herringbone] [--holeDiameter %g]\n", params.thickness, params.twist, params.holeDiameter);
+    printf("                 [--tolerance %g] [--layers 0] --out <file>\n", params.chordTolerance);
+}
+
+int main(int argc, char** argv)
+{
+    auto params = GetDexpSpurGearParams();
+    std::string filepath;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--herringbone")
+        {
+            params.isHerringbone = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+        auto value = argv[++i];
+        if (option == "--diametralPitch")
+            params.gear.diametralPitch = atof(value);
+        else if (option == "--toothCount")
+            params.gear.toothCount = atoi(value);
+        else if (option == "--pressureAngle")
+            params.gear.pressureAngle = atof(value);
+        else if (option == "--backlash")
+            params.gear.backlash = atof(value);
+        else if (option == "--thickness")
+            params.thickness = atof(value);
+        else if (option == "--twist")
+            params.twist = atof(value);
+        else if (option == "--holeDiameter")
+            params.holeDiameter = atof(value);
+        else if (option == "--tolerance")
+            params.chordTolerance = atof(value);
+        else if (option == "--layers")
+            params.layerCount = atoi(value);
+        else if (option == "--out")
+            filepath = value;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (filepath.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto triangleCount = GetGearMeshTriangleCount(params);
+    if (triangleCount == 0)
+    {
+        fprintf(stderr, "the gear is invalid or its hole does not fit inside the root circle\n");
+        return 1;
+    }
+    if (!SaveGearAsStl(params, filepath))
+    {
+        fprintf(stderr, "failed to write %s\n", filepath.c_str());
+        return 1;
+    }
+    auto milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    printf("%s: %u triangles, %.2f ms\n", filepath.c_str(), triangleCount, milliseconds);
+    return 0;
+}
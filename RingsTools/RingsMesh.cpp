@@ -0,0 +1,151 @@
+// Builds the Rings2D2Squares parts as meshes without Fusion and writes one STL per body.
+// --field meshes the filleted distance field builds of the plain parts instead.
+// --3mf also writes all of them as one build plate with every volf place filled.
+// --threads builds the parts side by side, 0 takes all cores.
+// Nothing is built when a volf does not clear the walls or the other volfs on its way.
+// A body that is not closed and manifold is not written and the exit code is 1.
+// Build on Linux from this directory with:
+//   g++ -O2 -std=c++14 -pthread -o RingsMesh RingsMesh.cpp ../RingsProto/Geometry.cpp ../RingsProto/Rings2D2SquaresLayout.cpp
+//       ../RingsProto/MeshBody.cpp ../RingsProto/MeshCsg.cpp ../RingsProto/MeshEnvironment.cpp ../RingsProto/MeshParts.cpp
+//       ../RingsProto/DistanceField.cpp ../RingsProto/DistanceFieldParts.cpp ../RingsProto/StlWriter.cpp
+//       ../RingsProto/ThreeMfWriter.cpp ../RingsProto/PuzzlePlates.cpp ../RingsProto/TaskGraph.cpp
+//       ../RingsProto/SquaresClearance.cpp
+//
+//   RingsMesh --squareMiddleSize 5.5 --cornerVolfCount 3 --out models/
+//   RingsMesh --field --cell 0.02 --threads 8 --out models/
+//   RingsMesh --3mf models/Rings2D2Squares.3mf --out models/
+
+#include "../RingsProto/DistanceFieldParts.h"
+#include "../RingsProto/MeshParts.h"
+#include "../RingsProto/PuzzlePlates.h"
+#include "../RingsProto/Rings2D2SquaresLayout.h"
+#include "../RingsProto/SquaresClearance.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static void PrintUsage()
+{
+    Rings2D2SquaresParams params;
+    printf("usage: RingsMesh [--lineVolfCount %g] [--cornerVolfCount %g] [--squareMiddleSize %g]\n", params.lineVolfCount, params.cornerVolfCount, params.squareMiddleSize);
+    printf("                 [--moovableClearence %g] [--unmoovableClearence %g] [--plain]\n", params.moovableClearence, params.unmoovableClearence);
+    printf("                 [--field [--cell 0.02]] [--threads 0] [--3mf <file>] --out <folder>\n");
+}
+
+int main(int argc, char** argv)
+{
+    Rings2D2SquaresParams params;
+    std::string folder;
+    std::string plateFilepath;
+    auto isRectangled = true;
+    auto isField = false;
+    auto cellSize = 0.02;
+    auto threadCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--plain")
+        {
+            isRectangled = false;
+            continue;
+        }
+        if (option == "--field")
+        {
+            isField = true;
+            isRectangled = false;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+        auto value = argv[++i];
+        if (option == "--out")
+            folder = value;
+        else if (option == "--3mf")
+            plateFilepath = value;
+        else if (option == "--lineVolfCount")
+            params.lineVolfCount = atof(value);
+        else if (option == "--cornerVolfCount")
+            params.cornerVolfCount = atof(value);
+        else if (option == "--squareMiddleSize")
+            params.squareMiddleSize = atof(value);
+        else if (option == "--moovableClearence")
+            params.moovableClearence = atof(value);
+        else if (option == "--unmoovableClearence")
+            params.unmoovableClearence = atof(value);
+        else if (option == "--cell")
+            cellSize = atof(value);
+        else if (option == "--threads")
+            threadCount = atoi(value);
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (folder.empty() || cellSize <= 0)
+    {
+        PrintUsage();
+        return 1;
+    }
+    if (folder.back() != '/')
+        folder += '/';
+
+    auto layout = SolveRings2D2SquaresLayout(params, isRectangled);
+    auto clearance = VerifySquaresClearance(params, layout, isRectangled);
+    printf("clearance: inner wall %.4f, outer wall %.4f, volfs %.4f, crossing %.4f cm\n",
+        clearance.innerWallGap, clearance.outerWallGap, clearance.volfGap, clearance.crossingGap);
+    if (!clearance.isClear())
+    {
+        fprintf(stderr, "a volf jams at %.3f, %.3f\n", clearance.tightestPoint.x, clearance.tightestPoint.y);
+        return 1;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    auto bodies = isField ? CreateRings2D2SquaresFieldBodies(layout, cellSize, threadCount) : CreateRings2D2SquaresBodies(layout, isRectangled, threadCount);
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    auto isOk = true;
+    auto isClosed = true;
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        auto& body = bodies[i];
+        auto name = body.name.empty() ? "Body" + std::to_string(i) : body.name;
+        auto path = folder + name + ".stl";
+        auto box = body.boundingBox();
+        printf("%-20s %8zu triangles %10.4f cm3  %.2f x %.2f x %.2f cm\n", name.c_str(), body.triangles.size(), body.volume(),
+            box.maxPoint.x - box.minPoint.x, box.maxPoint.y - box.minPoint.y, box.maxPoint.z - box.minPoint.z);
+        // a slicer repairs an open mesh its own way, a broken body is not written
+        auto openEdgeCount = body.countOpenEdges();
+        if (openEdgeCount > 0)
+        {
+            fprintf(stderr, "%s is not closed, %zu open edges\n", name.c_str(), openEdgeCount);
+            isOk = false;
+            isClosed = false;
+            continue;
+        }
+        if (!SaveAsStl(body, path))
+        {
+            fprintf(stderr, "cannot write %s\n", path.c_str());
+            isOk = false;
+        }
+    }
+    if (!plateFilepath.empty() && isClosed)
+    {
+        for (auto& body : bodies)
+            body.weld();
+        if (!SaveRings2D2SquaresAs3mf(bodies, params, layout, plateFilepath))
+        {
+            fprintf(stderr, "cannot write %s\n", plateFilepath.c_str());
+            isOk = false;
+        }
+    }
+    printf("built in %.2f s\n", seconds);
+    return isOk ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+// Rates how hard a Rings2D2Squares or Rings2D2Circles configuration is before it is printed:
+// scrambles it by random turns and solves every scramble optimally. Build on Linux from this
+// directory with:
+//   g++ -O2 -std=c++14 -o RingsSolve RingsSolve.cpp ../RingsProto/Geometry.cpp
+//       ../RingsProto/Rings2D2SquaresLayout.cpp ../RingsProto/Rings2D2CirclesLayout.cpp
+//       ../RingsProto/RingsPuzzle.cpp
+//
+//   RingsSolve --cornerVolfCount 2 --scrambles 100 --turns 1000
+//   RingsSolve --cornerVolfCount 3 --scrambles 20 --maxLength 30
+//   RingsSolve --circles --volfCount 12 --crossVolfCount 4 --scrambles 100
+
+#include "../RingsProto/RingsPuzzle.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+static void PrintUsage()
+{
+    Rings2D2SquaresParams params;
+    Rings2D2CirclesParams circlesParams;
+    printf("usage: RingsSolve [--lineVolfCount %g] [--cornerVolfCount %g] [--scrambles 100] [--turns 1000]\n", params.lineVolfCount, params.cornerVolfCount);
+    printf("                  [--seed 1] [--maxLength 40] [--table 16777216] [--print]\n");
+    printf("       RingsSolve --circles [--volfCount %d] [--crossVolfCount %d] [...]\n", circlesParams.volfCount, circlesParams.crossVolfCount);
+}
+
+template <int WordCount>
+static int Run(const RingsPuzzle& puzzle, int scrambleCount, int turnCount, unsigned seed, int maxLength, uint64_t maxTableSize, bool isPrint)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    RingsPuzzleSolver<WordCount> solver(puzzle, maxTableSize);
+    auto tableSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    printf("%d places, %d shared, %d-bit states, %llu table entries in %.2f s\n", puzzle.getPlaceCount(), puzzle.getSharedCount(),
+        64 * WordCount, (unsigned long long)solver.getTableSize(), tableSeconds);
+
+    std::mt19937 random(seed);
+    std::vector<int> lengthCounts(maxLength + 1, 0);
+    auto unsolvedCount = 0;
+    auto lengthSum = 0;
+    const char* moveNames[] = { "L", "L'", "R", "R'" };
+
+    startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < scrambleCount; i++)
+    {
+        auto state = solver.getSolvedState();
+        for (int turn = 0; turn < turnCount; turn++)
+            state = solver.applyMove(state, (int)(random() % RingsPuzzle::MoveCount));
+
+        std::vector<int> solution;
+        if (!solver.solve(state, solution, maxLength))
+        {
+            unsolvedCount++;
+            continue;
+        }
+        lengthCounts[solution.size()]++;
+        lengthSum += (int)solution.size();
+        if (isPrint)
+        {
+            printf("%3zu:", solution.size());
+            for (auto move : solution)
+                printf(" %s", moveNames[move]);
+            printf("\n");
+        }
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    printf("length  scrambles\n");
+    for (int length = 0; length <= maxLength; length++)
+        if (lengthCounts[length] != 0)
+            printf("%6d %10d\n", length, lengthCounts[length]);
+    if (unsolvedCount != 0)
+        printf("longer than %d: %d\n", maxLength, unsolvedCount);
+
+    auto solvedCount = scrambleCount - unsolvedCount;
+    printf("mean length %.2f, %llu nodes, %.2f M nodes/s, %.1f scrambles/s\n", solvedCount != 0 ? (double)lengthSum / solvedCount : 0.0,
+        (unsigned long long)solver.getNodeCount(), solver.getNodeCount() / seconds / 1e6, scrambleCount / seconds);
+    return unsolvedCount == 0 ? 0 : 1;
+}
+
+int main(int argc, char** argv)
+{
+    Rings2D2SquaresParams params;
+    Rings2D2CirclesParams circlesParams;
+    auto isCircles = false;
+    auto scrambleCount = 100;
+    auto turnCount = 1000;
+    unsigned seed = 1;
+    auto maxLength = 40;
+    uint64_t maxTableSize = 1ull << 24;
+    auto isPrint = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--print")
+        {
+            isPrint = true;
+            continue;
+        }
+        if (option == "--circles")
+        {
+            isCircles = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+        auto value = argv[++i];
+        if (option == "--lineVolfCount")
+            params.lineVolfCount = atof(value);
+        else if (option == "--cornerVolfCount")
+            params.cornerVolfCount = atof(value);
+        else if (option == "--volfCount")
+            circlesParams.volfCount = atoi(value);
+        else if (option == "--crossVolfCount")
+            circlesParams.crossVolfCount = atoi(value);
+        else if (option == "--scrambles")
+            scrambleCount = atoi(value);
+        else if (option == "--turns")
+            turnCount = atoi(value);
+        else if (option == "--seed")
+            seed = (unsigned)atoi(value);
+        else if (option == "--maxLength")
+            maxLength = atoi(value);
+        else if (option == "--table")
+            maxTableSize = strtoull(value, nullptr, 10);
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (scrambleCount < 1 || turnCount < 0 || maxLength < 0 || circlesParams.volfCount < 2 || circlesParams.crossVolfCount < 1)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    auto puzzle = isCircles ? CreateRings2D2CirclesPuzzle(circlesParams) : CreateRings2D2SquaresPuzzle(params);
+    if (!puzzle.isValid())
+    {
+        fprintf(stderr, "the puzzle has no places or more than %d\n", RingsPuzzle::MaxPlaceCount);
+        return 1;
+    }
+    if (puzzle.getPlaceCount() <= 32)
+        return Run<1>(puzzle, scrambleCount, turnCount, seed, maxLength, maxTableSize, isPrint);
+    return Run<2>(puzzle, scrambleCount, turnCount, seed, maxLength, maxTableSize, isPrint);
+}
\ No newline at end of file
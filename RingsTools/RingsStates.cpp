@@ -0,0 +1,108 @@
+// Counts every state of a Rings2D2Squares or Rings2D2Circles configuration and how many turns
+// each needs, by a breadth-first search over all of them. Build on Linux from this directory with:
+//   g++ -O2 -std=c++14 -pthread -o RingsStates RingsStates.cpp StateSpace.cpp ../RingsProto/Geometry.cpp
+//       ../RingsProto/Rings2D2SquaresLayout.cpp ../RingsProto/Rings2D2CirclesLayout.cpp
+//       ../RingsProto/RingsPuzzle.cpp
+//
+//   RingsStates squares --cornerVolfCount 1
+//   RingsStates circles --volfCount 12 --crossVolfCount 4 --memory 256 --temp /var/tmp
+
+#include "StateSpace.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void PrintUsage()
+{
+    Rings2D2SquaresParams squaresParams;
+    Rings2D2CirclesParams circlesParams;
+    printf("usage:\n");
+    printf("  RingsStates squares [--lineVolfCount %g] [--cornerVolfCount %g] [options]\n", squaresParams.lineVolfCount, squaresParams.cornerVolfCount);
+    printf("  RingsStates circles [--volfCount %d] [--crossVolfCount %d] [options]\n", circlesParams.volfCount, circlesParams.crossVolfCount);
+    printf("options: [--threads N] [--memory MB] [--temp folder] [--quiet]\n");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || (strcmp(argv[1], "squares") != 0 && strcmp(argv[1], "circles") != 0))
+    {
+        PrintUsage();
+        return 1;
+    }
+    auto isCircles = strcmp(argv[1], "circles") == 0;
+
+    Rings2D2SquaresParams squaresParams;
+    Rings2D2CirclesParams circlesParams;
+    StateSpaceOptions options;
+    auto isQuiet = false;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (option == "--quiet")
+        {
+            isQuiet = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+        auto value = argv[++i];
+        if (option == "--lineVolfCount" && !isCircles)
+            squaresParams.lineVolfCount = atof(value);
+        else if (option == "--cornerVolfCount" && !isCircles)
+            squaresParams.cornerVolfCount = atof(value);
+        else if (option == "--volfCount" && isCircles)
+            circlesParams.volfCount = atoi(value);
+        else if (option == "--crossVolfCount" && isCircles)
+            circlesParams.crossVolfCount = atoi(value);
+        else if (option == "--threads")
+            options.threadCount = atoi(value);
+        else if (option == "--memory")
+            options.memoryLimit = strtoull(value, nullptr, 10) << 20;
+        else if (option == "--temp")
+            options.tempFolder = value;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (circlesParams.volfCount < 2 || circlesParams.crossVolfCount < 1)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    auto puzzle = isCircles ? CreateRings2D2CirclesPuzzle(circlesParams) : CreateRings2D2SquaresPuzzle(squaresParams);
+    if (!puzzle.isValid())
+    {
+        fprintf(stderr, "the puzzle has no places or more than %d\n", RingsPuzzle::MaxPlaceCount);
+        return 1;
+    }
+    printf("%d places, %d shared\n", puzzle.getPlaceCount(), puzzle.getSharedCount());
+    if (!isQuiet)
+        options.onLayer = [](int depth, uint64_t count)
+        {
+            printf("depth %d: %llu\n", depth, (unsigned long long)count);
+            fflush(stdout);
+        };
+
+    StateSpaceSummary summary;
+    std::string error;
+    if (!EnumerateStateSpace(puzzle, options, summary, error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    printf("depth %16s %9s\n", "states", "share");
+    for (size_t depth = 0; depth < summary.depthCounts.size(); depth++)
+        printf("%5zu %16llu %8.4f%%\n", depth, (unsigned long long)summary.depthCounts[depth], 100.0 * summary.depthCounts[depth] / summary.stateCount);
+    printf("%llu states reachable of %llu with the solved color counts\n", (unsigned long long)summary.stateCount,
+        (unsigned long long)summary.indexStateCount);
+    printf("god's number %d, %.1f MB spilled, %.2f s\n", summary.diameter(), summary.spilledBytes / 1048576.0, summary.seconds);
+    return 0;
+}
\ No newline at end of file
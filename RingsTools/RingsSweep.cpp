@@ -0,0 +1,191 @@
+// Screens ring puzzle variants without Fusion. Build on Linux from this directory with:
+//   g++ -O2 -std=c++17 -pthread -o RingsSweep RingsSweep.cpp DesignSweep.cpp ../RingsProto/Geometry.cpp
+//       ../RingsProto/Rings2D2SquaresLayout.cpp ../RingsProto/Rings2D2CirclesLayout.cpp ../RingsProto/RingsProtoCreatorLayout.cpp
+//       ../RingsProto/SquaresClearance.cpp ../RingsProto/GearProfile.cpp ../RingsProto/GearPair.cpp
+//
+//   RingsSweep squares --squareMiddleSize 3:8:0.01 --cornerVolfCount 1:4 --out squares.sweep
+//   RingsSweep squares --lineVolfCount 0:5 --clearance 256 --out squares.sweep
+//   RingsSweep gears --toothCount1 8:40 --toothCount2 20:80 --backlash 0:0.06:0.005 --out gears.sweep
+//   RingsSweep show squares.sweep --limit 20
+
+#include "DesignSweep.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+
+static void PrintUsage()
+{
+    printf("usage:\n");
+    printf("  RingsSweep <squares|circles|proto|gears> [--<axis> from:to:step]... --out <file> [--threads N] [--bed cm] [--print N]\n");
+    printf("  squares only: [--clearance samples] also checks the volf ways, 256 samples run about 200 times slower\n");
+    printf("  RingsSweep show <file> [--limit N] [--all]\n\n");
+    const char* kinds[] = { "squares", "circles", "proto", "gears" };
+    for (auto kind : kinds)
+    {
+        auto design = CreateSweepDesign(kind, 0);
+        printf("  %s axes:", kind);
+        for (auto& axis : design->defaultAxes())
+            printf(" %s=%g", axis.name.c_str(), axis.from);
+        printf("\n");
+    }
+}
+
+static void PrintRows(const SweepFile& file, uint64_t limit, bool isAll)
+{
+    auto flagsIndex = file.findColumn("flags");
+    auto flags = flagsIndex >= 0 ? file.uints(flagsIndex) : nullptr;
+
+    for (uint32_t i = 0; i < file.columnCount(); i++)
+        printf(i == 0 ? "%s" : "\t%s", file.column(i).name);
+    printf("\n");
+
+    uint64_t printed = 0;
+    for (uint64_t row = 0; row < file.rowCount() && printed < limit; row++)
+    {
+        if (!isAll && flags != nullptr && flags[row] != 0)
+            continue;
+        for (uint32_t i = 0; i < file.columnCount(); i++)
+        {
+            if (i != 0)
+                printf("\t");
+            if (file.column(i).type == (uint32_t)SweepColumnType::Double)
+                printf("%.6g", file.doubles(i)[row]);
+            else
+                printf("%u", file.uints(i)[row]);
+        }
+        printf("\n");
+        printed++;
+    }
+}
+
+static int Show(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        PrintUsage();
+        return 1;
+    }
+    uint64_t limit = 50;
+    bool isAll = false;
+    for (int i = 3; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc)
+            limit = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--all") == 0)
+            isAll = true;
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    SweepFile file;
+    std::string error;
+    if (!file.open(argv[2], error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    PrintRows(file, limit, isAll);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 1;
+    }
+    if (strcmp(argv[1], "show") == 0)
+        return Show(argc, argv);
+
+    double bedSize = 22.0;
+    auto clearanceSampleCount = 0;
+    for (int i = 2; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--bed") == 0)
+            bedSize = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--clearance") == 0)
+            clearanceSampleCount = atoi(argv[i + 1]);
+    }
+
+    auto design = CreateSweepDesign(argv[1], bedSize, clearanceSampleCount);
+    if (design == nullptr)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    auto axes = design->defaultAxes();
+    SweepOptions options;
+    uint64_t printCount = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc)
+        {
+            fprintf(stderr, "unexpected argument %s\n", argv[i]);
+            return 1;
+        }
+        std::string option = argv[i] + 2;
+        std::string value = argv[++i];
+        if (option == "out")
+            options.outPath = value;
+        else if (option == "threads")
+            options.threadCount = atoi(value.c_str());
+        else if (option == "print")
+            printCount = strtoull(value.c_str(), nullptr, 10);
+        else if (option == "bed" || option == "clearance")
+            continue;
+        else
+        {
+            auto axis = std::find_if(axes.begin(), axes.end(), [&](const SweepAxis& a) { return a.name == option; });
+            if (axis == axes.end())
+            {
+                fprintf(stderr, "%s has no axis %s\n", design->name(), option.c_str());
+                return 1;
+            }
+            if (!ParseSweepAxis(value, *axis))
+            {
+                fprintf(stderr, "bad range %s for %s, expected from:to:step\n", value.c_str(), option.c_str());
+                return 1;
+            }
+        }
+    }
+    if (options.outPath.empty())
+    {
+        fprintf(stderr, "--out is required\n");
+        return 1;
+    }
+
+    SweepSummary summary;
+    std::string error;
+    if (!RunSweep(*design, axes, options, summary, error))
+    {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    printf("%s: %llu variants in %.3f s (%.0f/s), %llu passed\n", design->name(),
+        (unsigned long long)summary.rowCount, summary.seconds, summary.seconds > 0 ? summary.rowCount / summary.seconds : 0.0,
+        (unsigned long long)summary.passedCount);
+    auto flagNames = design->flagNames();
+    for (size_t i = 0; i < flagNames.size(); i++)
+        if (summary.flagCounts[i] != 0)
+            printf("  %-16s %llu\n", flagNames[i].c_str(), (unsigned long long)summary.flagCounts[i]);
+
+    if (printCount != 0)
+    {
+        SweepFile file;
+        if (!file.open(options.outPath, error))
+        {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+        PrintRows(file, printCount, false);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "StateSpace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "the visited set is mapped as plain words");
+
+namespace
+{
+    // an unlinked file in folder, gone as soon as it is closed and unmapped
+    int CreateTempFile(const std::string& folder, std::string& error)
+    {
+        auto path = folder + "/RingsStatesXXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back(0);
+        auto fd = mkstemp(name.data());
+        if (fd < 0)
+        {
+            error = "cannot create a temp file in " + folder + ": " + strerror(errno);
+            return -1;
+        }
+        unlink(name.data());
+        return fd;
+    }
+
+    // Ranks one thread discovers on a layer. They stay in entries up to capacity, past it
+    // entries go to the temp file every time it fills up.
+    class FrontierPart
+    {
+    public:
+        FrontierPart(const std::string& tempFolder, uint64_t capacity) : tempFolder(tempFolder), capacity(capacity) {}
+        FrontierPart(const FrontierPart&) = delete;
+        FrontierPart& operator=(const FrontierPart&) = delete;
+
+        ~FrontierPart()
+        {
+            if (fd >= 0)
+                close(fd);
+            if (map != nullptr)
+                munmap(map, mapSize);
+        }
+
+        bool append(uint64_t rank, std::string& error)
+        {
+            entries.push_back(rank);
+            return entries.size() < capacity || spill(error);
+        }
+
+        // maps the spilled entries back, data() and size() are the whole part after it
+        bool finish(std::string& error)
+        {
+            if (fd < 0)
+                return true;
+            if (!spill(error))
+                return false;
+            mapSize = (size_t)(spilledCount * sizeof(uint64_t));
+            auto data = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            fd = -1;
+            if (data == MAP_FAILED)
+            {
+                error = std::string("cannot map a frontier file: ") + strerror(errno);
+                return false;
+            }
+            map = data;
+            madvise(map, mapSize, MADV_SEQUENTIAL);
+            return true;
+        }
+
+        const uint64_t* data() const { return map != nullptr ? (const uint64_t*)map : entries.data(); }
+        uint64_t size() const { return map != nullptr ? spilledCount : entries.size(); }
+        uint64_t spilledBytes() const { return spilledCount * sizeof(uint64_t); }
+
+    private:
+        std::string tempFolder;
+        uint64_t capacity;
+        std::vector<uint64_t> entries;
+        int fd = -1;
+        uint64_t spilledCount = 0;
+        void* map = nullptr;
+        size_t mapSize = 0;
+
+        bool spill(std::string& error)
+        {
+            if (fd < 0 && (fd = CreateTempFile(tempFolder, error)) < 0)
+                return false;
+            auto bytes = (const char*)entries.data();
+            auto left = entries.size() * sizeof(uint64_t);
+            while (left > 0)
+            {
+                auto written = write(fd, bytes, left);
+                if (written < 0 && errno == EINTR)
+                    continue;
+                if (written <= 0)
+                {
+                    error = std::string("cannot write a frontier file: ") + strerror(errno);
+                    return false;
+                }
+                bytes += written;
+                left -= (size_t)written;
+            }
+            spilledCount += entries.size();
+            entries.clear();
+            return true;
+        }
+    };
+
+    // zeroed words, anonymous or in a temp file
+    uint64_t* MapVisited(uint64_t wordCount, bool isFile, const std::string& tempFolder, std::string& error)
+    {
+        auto size = (size_t)(wordCount * sizeof(uint64_t));
+        void* data = MAP_FAILED;
+        if (isFile)
+        {
+            auto fd = CreateTempFile(tempFolder, error);
+            if (fd < 0)
+                return nullptr;
+            if (ftruncate(fd, (off_t)size) != 0)
+            {
+                error = std::string("cannot resize the visited file: ") + strerror(errno);
+                close(fd);
+                return nullptr;
+            }
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+        }
+        else
+            data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (data == MAP_FAILED)
+        {
+            error = std::string("cannot map the visited set: ") + strerror(errno);
+            return nullptr;
+        }
+        return (uint64_t*)data;
+    }
+
+    template <int WordCount>
+    bool Enumerate(const RingsPuzzle& puzzle, const StateSpaceOptions& options, StateSpaceSummary& summary, std::string& error)
+    {
+        auto startTime = std::chrono::steady_clock::now();
+        RingsStateIndex<WordCount> index(puzzle);
+        auto stateCount = index.getStateCount();
+        if (stateCount == 0)
+        {
+            error = "the states do not fit 64-bit ranks";
+            return false;
+        }
+
+        auto wordCount = (stateCount + 63) / 64;
+        auto visitedWords = MapVisited(wordCount, wordCount * sizeof(uint64_t) > options.memoryLimit, options.tempFolder, error);
+        if (visitedWords == nullptr)
+            return false;
+        auto visited = (std::atomic<uint64_t>*)visitedWords;
+
+        auto threadCount = options.threadCount > 0 ? options.threadCount : (int)std::thread::hardware_concurrency();
+        if (threadCount < 1)
+            threadCount = 1;
+        auto chunkSize = options.chunkSize > 0 ? options.chunkSize : 4096;
+        // half of the memory for the layer being read, half for the one being written
+        auto partCapacity = std::max<uint64_t>(options.memoryLimit / sizeof(uint64_t) / 2 / threadCount, 1024);
+
+        summary = StateSpaceSummary();
+        summary.indexStateCount = stateCount;
+
+        auto solvedRank = index.rank(GetSolvedState<WordCount>(puzzle));
+        visited[solvedRank / 64].fetch_or(1ull << (solvedRank % 64));
+        std::vector<std::unique_ptr<FrontierPart>> layer;
+        layer.emplace_back(new FrontierPart(options.tempFolder, partCapacity));
+        layer.back()->append(solvedRank, error);
+
+        auto isFailed = false;
+        while (true)
+        {
+            uint64_t layerCount = 0;
+            std::vector<uint64_t> partStarts;
+            for (auto& part : layer)
+            {
+                partStarts.push_back(layerCount);
+                layerCount += part->size();
+                summary.spilledBytes += part->spilledBytes();
+            }
+            if (layerCount == 0)
+                break;
+            summary.depthCounts.push_back(layerCount);
+            summary.stateCount += layerCount;
+            if (options.onLayer)
+                options.onLayer((int)summary.depthCounts.size() - 1, layerCount);
+
+            std::vector<std::unique_ptr<FrontierPart>> nextLayer;
+            for (int i = 0; i < threadCount; i++)
+                nextLayer.emplace_back(new FrontierPart(options.tempFolder, partCapacity));
+
+            std::atomic<uint64_t> nextEntry(0);
+            std::atomic<bool> isStopped(false);
+            std::mutex errorMutex;
+            auto worker = [&](int threadIndex)
+            {
+                auto& next = *nextLayer[threadIndex];
+                std::string threadError;
+                while (!isStopped)
+                {
+                    auto begin = nextEntry.fetch_add(chunkSize);
+                    if (begin >= layerCount)
+                        break;
+                    auto end = std::min(begin + chunkSize, layerCount);
+
+                    // a chunk can run over the end of a part
+                    auto partIndex = std::upper_bound(partStarts.begin(), partStarts.end(), begin) - partStarts.begin() - 1;
+                    for (auto entry = begin; entry < end; entry++)
+                    {
+                        while (entry >= partStarts[partIndex] + layer[partIndex]->size())
+                            partIndex++;
+                        auto state = index.unrank(layer[partIndex]->data()[entry - partStarts[partIndex]]);
+                        for (int move = 0; move < RingsPuzzle::MoveCount; move++)
+                        {
+                            auto rank = index.rank(ApplyMove(puzzle, state, move));
+                            auto bit = 1ull << (rank % 64);
+                            if ((visited[rank / 64].fetch_or(bit, std::memory_order_relaxed) & bit) != 0)
+                                continue;
+                            if (!next.append(rank, threadError))
+                            {
+                                std::lock_guard<std::mutex> lock(errorMutex);
+                                if (!isStopped.exchange(true))
+                                    error = threadError;
+                                return;
+                            }
+                        }
+                    }
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (int i = 1; i < threadCount; i++)
+                threads.emplace_back(worker, i);
+            worker(0);
+            for (auto& thread : threads)
+                thread.join();
+            if (isStopped)
+            {
+                isFailed = true;
+                break;
+            }
+
+            for (auto& part : nextLayer)
+                if (!part->finish(error))
+                    isFailed = true;
+            if (isFailed)
+                break;
+            layer.swap(nextLayer);
+        }
+
+        munmap(visitedWords, (size_t)(wordCount * sizeof(uint64_t)));
+        summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        return !isFailed;
+    }
+}
+
+bool EnumerateStateSpace(const RingsPuzzle& puzzle, const StateSpaceOptions& options, StateSpaceSummary& summary, std::string& error)
+{
+    if (!puzzle.isValid())
+    {
+        error = "the puzzle has no places or more than " + std::to_string(RingsPuzzle::MaxPlaceCount);
+        return false;
+    }
+    if (puzzle.getPlaceCount() <= 32)
+        return Enumerate<1>(puzzle, options, summary, error);
+    return Enumerate<2>(puzzle, options, summary, error);
+}
\ No newline at end of file
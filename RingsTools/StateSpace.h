@@ -0,0 +1,39 @@
+#pragma once
+#include "../RingsProto/RingsPuzzle.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Breadth-first enumeration of every state a puzzle reaches from the solved one by ring turns.
+// A state is its RingsStateIndex rank: the visited set is one bit a rank, set by the workers
+// with an atomic or, and a frontier is a list of ranks. Every thread appends the states it
+// discovers to its own part of the next frontier, kept in memory until the part outgrows its
+// share of memoryLimit and then spilled to an unlinked temp file, mapped back for the next
+// layer. The visited set is mapped from a temp file as well when it is larger than memoryLimit.
+
+struct StateSpaceOptions
+{
+    int threadCount = 0; // 0 - all cores
+    uint64_t memoryLimit = 1ull << 30; // bytes of frontier held in memory
+    std::string tempFolder = "/tmp";
+    uint64_t chunkSize = 4096;
+    // called after every layer with its depth and state count
+    std::function<void(int, uint64_t)> onLayer;
+};
+
+struct StateSpaceSummary
+{
+    std::vector<uint64_t> depthCounts;
+    uint64_t stateCount = 0;
+    // all states with the solved color counts, reachable or not
+    uint64_t indexStateCount = 0;
+    uint64_t spilledBytes = 0;
+    double seconds = 0;
+
+    // god's number: the most turns any reachable state needs
+    int diameter() const { return (int)depthCounts.size() - 1; }
+};
+
+bool EnumerateStateSpace(const RingsPuzzle& puzzle, const StateSpaceOptions& options, StateSpaceSummary& summary, std::string& error);
\ No newline at end of file